@@ -41,11 +41,26 @@ void SimulationGame::Update() {
 }
 
 void SimulationGame::SetWorld(std::unique_ptr<World::World>&& p_world) {
-    m_p_world = std::move(p_world);
+    m_p_world_query.reset();
+    m_p_simulation.reset();
+
+    if (p_world != nullptr) {
+        m_p_simulation = std::make_unique<World::WorldSimulation>(std::move(p_world));
+        m_p_world_query = std::make_unique<World::WorldQuery>(m_p_simulation->GetWorld());
+        m_p_simulation->Start(WORLD_TICKS_PER_SECOND);
+    }
+}
+
+const World::World* SimulationGame::GetWorld() const {
+    return (m_p_simulation != nullptr) ? &m_p_simulation->GetWorld() : nullptr;
+}
+
+const World::WorldQuery* SimulationGame::GetWorldQuery() const {
+    return m_p_world_query.get();
 }
 
-World::World* SimulationGame::GetWorld() {
-    return m_p_world.get();
+const World::WorldSimulation* SimulationGame::GetSimulation() const {
+    return m_p_simulation.get();
 }
 
 void SimulationGame::InitializeGUI() {
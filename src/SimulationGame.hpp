@@ -6,6 +6,8 @@
 #include "graphics/Font.hpp"
 #include "menu/MenuManager.hpp"
 #include "world/World.hpp"
+#include "world/WorldQuery.hpp"
+#include "world/WorldSimulation.hpp"
 #include <memory>
 
 namespace World {
@@ -16,12 +18,17 @@ class SimulationGame : public Core::IGame {
 
     public:
 
+        //! Rate the world is simulated at. Each tick is a day.
+        static constexpr float WORLD_TICKS_PER_SECOND = 1.0F;
+
         explicit SimulationGame(Core::Engine& engine);
 
         void Update() override;
 
         void SetWorld(std::unique_ptr<World::World>&& p_world);
-        World::World* GetWorld();
+        const World::World* GetWorld() const;
+        const World::WorldQuery* GetWorldQuery() const;
+        const World::WorldSimulation* GetSimulation() const;
 
     private:
 
@@ -31,5 +38,9 @@ class SimulationGame : public Core::IGame {
 
         Menu::MenuManager m_menu_manager;
 
-        std::unique_ptr<World::World> m_p_world {nullptr};
+        //! The current world, simulated on a thread of its own. Restarted whenever the world changes.
+        std::unique_ptr<World::WorldSimulation> m_p_simulation {nullptr};
+
+        //! Spatial queries over the current world. Rebuilt whenever the world changes.
+        std::unique_ptr<World::WorldQuery> m_p_world_query {nullptr};
 };
\ No newline at end of file
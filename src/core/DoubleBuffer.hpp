@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+namespace Core {
+
+    //! Two copies of a value, one written by a single producer thread while readers on other threads read the other.
+    //!
+    //! Readers never block, and never see a value while it is being written. Each buffer counts the readers holding
+    //! it, and the producer waits for the readers of the back buffer to let go before writing it, so a reader should
+    //! only hold a value for a short time, for example for one frame.
+    template<typename T>
+    class DoubleBuffer {
+
+        public:
+
+            //! A published value, held until the handle is destroyed.
+            class ReadHandle {
+
+                public:
+
+                    ReadHandle(const ReadHandle& other) = delete;
+                    ReadHandle(ReadHandle&& other) noexcept
+                        : m_p_buffer(std::exchange(other.m_p_buffer, nullptr))
+                        , m_index(other.m_index) {
+                    }
+                    ReadHandle& operator=(const ReadHandle& other) = delete;
+                    ReadHandle& operator=(ReadHandle&& other) = delete;
+
+                    ~ReadHandle() {
+                        if (m_p_buffer != nullptr) {
+                            m_p_buffer->m_num_readers[m_index].fetch_sub(1U);
+                        }
+                    }
+
+                    const T& operator*() const {
+                        return m_p_buffer->m_buffers[m_index];
+                    }
+
+                    const T* operator->() const {
+                        return &m_p_buffer->m_buffers[m_index];
+                    }
+
+                private:
+
+                    friend class DoubleBuffer;
+
+                    ReadHandle(const DoubleBuffer* p_buffer, uint32_t index)
+                        : m_p_buffer(p_buffer)
+                        , m_index(index) {
+                    }
+
+                    const DoubleBuffer* m_p_buffer;
+                    uint32_t m_index;
+            };
+
+            //! @brief Create the buffers, with both copies set to the same value.
+            explicit DoubleBuffer(const T& value)
+                : m_buffers {value, value} {
+            }
+
+            DoubleBuffer(const DoubleBuffer& other) = delete;
+            DoubleBuffer(DoubleBuffer&& other) = delete;
+            DoubleBuffer& operator=(const DoubleBuffer& other) = delete;
+            DoubleBuffer& operator=(DoubleBuffer&& other) = delete;
+            ~DoubleBuffer() = default;
+
+            //! @brief Get the most recently published value. Lock free, and safe to call from any thread.
+            ReadHandle Read() const {
+
+                // the front buffer is checked again once counted, in case it was swapped in the meantime, and the
+                // producer started writing it before it saw this reader.
+                for (;;) {
+                    uint32_t index = m_front.load();
+                    m_num_readers[index].fetch_add(1U);
+                    if (m_front.load() == index) {
+                        return ReadHandle(this, index);
+                    }
+                    m_num_readers[index].fetch_sub(1U);
+                }
+            }
+
+            //! @brief Write the back buffer, and publish it. Only called from the producer thread.
+            //!
+            //! Waits for readers still holding the back buffer from before the last swap.
+            //!
+            //! @param[in] write Function called as write(front, back), with the value last published, and the buffer to
+            //!                  write the next value into.
+            template<typename Write_t>
+            void Publish(const Write_t& write) {
+
+                const uint32_t front = m_front.load();
+                const uint32_t back = 1U - front;
+                while (m_num_readers[back].load() != 0U) {
+                    std::this_thread::yield();
+                }
+
+                write(static_cast<const T&>(m_buffers[front]), m_buffers[back]);
+                m_front.store(back);
+            }
+
+        private:
+
+            //! The two values.
+            std::array<T, 2> m_buffers;
+
+            //! Index of the buffer holding the most recently published value.
+            std::atomic<uint32_t> m_front {0U};
+
+            //! Number of readers holding each buffer.
+            mutable std::array<std::atomic<uint32_t>, 2> m_num_readers {};
+    };
+}
@@ -124,9 +124,9 @@ void Core::Engine::AddNameGenerator(
     const std::string& name_type, const std::string& name_file) {
 
     std::string path = m_assetLoader.GetDataDir() + "/" + name_file;
-    
-    m_name_generator[name_type] = 
-        std::make_unique<NameGenerator>(NameGenerator::Load(path, "Regions"));
+
+    m_name_generator[name_type] =
+        std::make_unique<NameGenerator>(NameGenerator::Load(path, name_type));
 
 }
 
@@ -0,0 +1,176 @@
+#include "MappedFile.hpp"
+#include "Engine.hpp"
+
+#include <filesystem>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+Core::MappedFile Core::MappedFile::CreateTemporary(size_t size, const std::string& directory) {
+
+    if (size == 0U) {
+        throw EngineException("Cannot map an empty file.");
+    }
+
+    char tempDirectory[MAX_PATH + 1] = {};
+    if (directory.empty() && (GetTempPathA(MAX_PATH + 1, tempDirectory) == 0U)) {
+        throw EngineException("Failed to find the temporary directory.");
+    }
+
+    char path[MAX_PATH + 1] = {};
+    if (GetTempFileNameA(directory.empty() ? tempDirectory : directory.c_str(), "sim", 0U, path) == 0U) {
+        throw EngineException("Failed to create a temporary file name.");
+    }
+
+    MappedFile mapping;
+    mapping.m_p_file = CreateFileA(
+        path,
+        GENERIC_READ | GENERIC_WRITE,
+        0U,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+        nullptr);
+    if (mapping.m_p_file == INVALID_HANDLE_VALUE) {
+        mapping.m_p_file = nullptr;
+        throw EngineException("Failed to create temporary file " + std::string(path));
+    }
+
+    // creating the mapping object also grows the file to its size.
+    uint64_t size64 = static_cast<uint64_t>(size);
+    mapping.m_p_mapping = CreateFileMappingA(
+        mapping.m_p_file,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(size64 >> 32U), // NOLINT
+        static_cast<DWORD>(size64 & 0xFFFFFFFFU), // NOLINT
+        nullptr);
+    if (mapping.m_p_mapping == nullptr) {
+        throw EngineException("Failed to create mapping of temporary file " + std::string(path));
+    }
+
+    mapping.m_p_data = static_cast<uint8_t*>(MapViewOfFile(mapping.m_p_mapping, FILE_MAP_ALL_ACCESS, 0U, 0U, size));
+    if (mapping.m_p_data == nullptr) {
+        throw EngineException("Failed to map temporary file " + std::string(path));
+    }
+    mapping.m_size = size;
+
+    return mapping;
+}
+
+void Core::MappedFile::Close() {
+    if (m_p_data != nullptr) {
+        UnmapViewOfFile(m_p_data);
+    }
+    if (m_p_mapping != nullptr) {
+        CloseHandle(m_p_mapping);
+    }
+    if (m_p_file != nullptr) {
+        CloseHandle(m_p_file);
+    }
+
+    m_p_data = nullptr;
+    m_p_mapping = nullptr;
+    m_p_file = nullptr;
+    m_size = 0U;
+}
+
+#else
+
+Core::MappedFile Core::MappedFile::CreateTemporary(size_t size, const std::string& directory) {
+
+    if (size == 0U) {
+        throw EngineException("Cannot map an empty file.");
+    }
+
+    const std::filesystem::path parent =
+        directory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(directory);
+    std::string path = (parent / "simXXXXXX").string();
+
+    MappedFile mapping;
+    mapping.m_descriptor = mkstemp(path.data());
+    if (mapping.m_descriptor < 0) {
+        throw EngineException("Failed to create temporary file " + path + ": " + std::strerror(errno));
+    }
+
+    // the file stays usable through the descriptor, and is removed by the system once it is closed.
+    unlink(path.c_str());
+
+    if (ftruncate(mapping.m_descriptor, static_cast<off_t>(size)) != 0) {
+        throw EngineException("Failed to resize temporary file " + path + ": " + std::strerror(errno));
+    }
+
+    void* p_data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mapping.m_descriptor, 0);
+    if (p_data == MAP_FAILED) { // NOLINT
+        throw EngineException("Failed to map temporary file " + path + ": " + std::strerror(errno));
+    }
+    mapping.m_p_data = static_cast<uint8_t*>(p_data);
+    mapping.m_size = size;
+
+    return mapping;
+}
+
+void Core::MappedFile::Close() {
+    if (m_p_data != nullptr) {
+        munmap(m_p_data, m_size);
+    }
+    if (m_descriptor >= 0) {
+        close(m_descriptor);
+    }
+
+    m_p_data = nullptr;
+    m_descriptor = -1;
+    m_size = 0U;
+}
+
+#endif
+
+Core::MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+Core::MappedFile& Core::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        std::swap(m_p_data, other.m_p_data);
+        std::swap(m_size, other.m_size);
+#ifdef _WIN32
+        std::swap(m_p_file, other.m_p_file);
+        std::swap(m_p_mapping, other.m_p_mapping);
+#else
+        std::swap(m_descriptor, other.m_descriptor);
+#endif
+    }
+
+    return *this;
+}
+
+Core::MappedFile::~MappedFile() {
+    Close();
+}
+
+uint8_t* Core::MappedFile::GetData() const {
+    return m_p_data;
+}
+
+size_t Core::MappedFile::GetSize() const {
+    return m_size;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Core {
+
+    //! Read and write memory mapping of a temporary file.
+    //!
+    //! Used for data sets that may not fit in memory. The operating system pages the data in as it is touched, and
+    //! writes it back to the file when memory runs low, so only the parts in use need to be resident. The file is
+    //! deleted when the mapping is closed.
+    class MappedFile {
+
+        public:
+
+            //! @brief Create a temporary file and map it into memory.
+            //!
+            //! The contents of the file start out as zero. Throws Core::EngineException on failure.
+            //!
+            //! @param[in] size      Size of the file, in bytes. Must not be zero.
+            //! @param[in] directory Existing directory to create the file in. When empty, the temporary directory of
+            //!                      the system is used instead. That is often a tmpfs held in memory, where paging the
+            //!                      data out saves nothing, so callers should pass a directory on disk when they have
+            //!                      one.
+            //!
+            //! @returns The mapping.
+            static MappedFile CreateTemporary(size_t size, const std::string& directory = "");
+
+            //! Create an empty mapping.
+            MappedFile() = default;
+            MappedFile(const MappedFile& other) = delete;
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(const MappedFile& other) = delete;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+            ~MappedFile();
+
+            //! Get the start of the mapped memory, or nullptr if nothing is mapped.
+            uint8_t* GetData() const;
+
+            //! Get the size of the mapped memory, in bytes.
+            size_t GetSize() const;
+
+        private:
+
+            //! Unmap the file and close it.
+            void Close();
+
+            //! Start of the mapped memory.
+            uint8_t* m_p_data {nullptr};
+
+            //! Size of the mapped memory.
+            size_t m_size {0U};
+
+#ifdef _WIN32
+            //! Handle of the file, deleted when closed.
+            void* m_p_file {nullptr};
+
+            //! Handle of the file mapping object.
+            void* m_p_mapping {nullptr};
+#else
+            //! Descriptor of the file. The file is unlinked as soon as it is created, so it has no name.
+            int m_descriptor {-1};
+#endif
+    };
+}
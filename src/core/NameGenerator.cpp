@@ -1,71 +1,327 @@
 #include "NameGenerator.hpp"
+#include "Filesystem.hpp"
+#include "Logger.hpp"
+#include "math/Hash.hpp"
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
+#include <map>
 #include <nlohmann/json.hpp>
 #include <random>
+#include <stdexcept>
 
 namespace Core {
 
-NameGenerator NameGenerator::Load(const std::string& filepath, const std::string& name_type) {
+//! Identifies a compiled name model cache, and its version.
+static constexpr uint32_t NAME_CACHE_MAGIC = 0x4E47454EU; // "NGEN"
+static constexpr uint32_t NAME_CACHE_VERSION = 1U;
+
+//! Order of the generators loaded from JSON files.
+static constexpr int32_t DEFAULT_ORDER = 2;
+
+//! Marks the end of a name while counting transitions. Every other symbol is a byte of a name.
+static constexpr uint16_t END_SYMBOL = 256U;
+
+//! One above the largest 32 bit random number, so that a threshold of this accepts every number.
+static constexpr uint64_t ALIAS_SCALE = 1ULL << 32U;
+
+template<typename T>
+static void WriteBinary(std::ostream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+static T ReadBinary(std::istream& stream) {
+    T value {};
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+template<typename T>
+static void WriteArray(std::ostream& stream, const std::vector<T>& values) {
+    WriteBinary(stream, static_cast<uint32_t>(values.size()));
+    stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template<typename T>
+static std::vector<T> ReadArray(std::istream& stream, size_t max_size) {
+    uint32_t size = ReadBinary<uint32_t>(stream);
+    if (!stream || (size > max_size)) {
+        return {};
+    }
+    std::vector<T> values(size);
+    stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    return values;
+}
+
+//! The cache is kept next to the JSON file, with the extension replaced by the type of name, e.g. names.Regions.cache.
+static std::string GetCachePath(const std::string& filepath, const std::string& name_type) {
+    size_t extension = filepath.rfind('.');
+    size_t directory = filepath.find_last_of("/\\");
+    if ((extension == std::string::npos) || ((directory != std::string::npos) && (extension < directory))) {
+        extension = filepath.length();
+    }
+    return filepath.substr(0U, extension) + "." + name_type + ".cache";
+}
+
+size_t NameBatch::GetCount() const {
+    return m_offsets.empty() ? 0U : m_offsets.size() - 1U;
+}
+
+std::string_view NameBatch::GetName(size_t index) const {
+    return std::string_view(m_characters).substr(m_offsets.at(index), m_offsets.at(index + 1U) - m_offsets[index]);
+}
 
+NameGenerator NameGenerator::Load(const std::string& filepath, const std::string& name_type) {
     std::random_device rand;
-    NameGenerator generator(2U, rand());
+    return Load(filepath, name_type, rand());
+}
+
+NameGenerator NameGenerator::Load(const std::string& filepath, const std::string& name_type, uint32_t seed) {
+
+    NameGenerator generator(DEFAULT_ORDER, seed);
+
+    // the cache is only used if it was compiled from exactly the same training data.
+    std::string source = Filesystem::LoadFileAsString(filepath);
+    uint64_t sourceHash = Math::HashFNV1A64(source.data(), source.size());
+    sourceHash = Math::HashFNV1A64(name_type.data(), name_type.size(), sourceHash);
+    sourceHash = Math::HashFNV1A64(&generator.m_order, sizeof(generator.m_order), sourceHash);
+
+    std::string cachePath = GetCachePath(filepath, name_type);
+    if (generator.ReadCache(cachePath, sourceHash)) {
+        return generator;
+    }
 
     // train the generator
-    std::ifstream nameFile(filepath);
-    nlohmann::json object = nlohmann::json::parse(nameFile);
+    nlohmann::json object = nlohmann::json::parse(source);
 
     std::vector<std::string> trainingData = object[name_type];
     generator.Train(trainingData);
+
+    if (!generator.WriteCache(cachePath, sourceHash)) {
+        Logger::Warning("Could not write name generator cache " + cachePath);
+    }
     return generator;
 }
 
 NameGenerator::NameGenerator(int32_t order, uint32_t seed)
     : m_order(order)
-    , m_generator(seed)
-    , m_start(m_order,'^') {
+    , m_generator(seed) {
+    if ((order < 1) || (order > MAX_ORDER)) {
+        throw std::invalid_argument("NameGenerator: order must be between 1 and 8.");
+    }
+    Train({});
 }
 
 void NameGenerator::Train(const std::vector<std::string>& names) {
+
+    // a state is the last m_order bytes of the name, packed into a key, with zero standing in for the start of the
+    // name.
+    const uint64_t keyMask = (m_order == MAX_ORDER) ? UINT64_MAX : ((1ULL << (8U * m_order)) - 1U);
+
+    // a. count how often each symbol follows each state. Ordered maps keep the compiled tables deterministic.
+    std::map<uint64_t, std::map<uint16_t, uint32_t>> counts;
+    counts[0U];
     for (const std::string& name : names) {
+        uint64_t key = 0U;
+        for (char character : name) {
+            uint8_t byte = static_cast<uint8_t>(character);
+            counts[key][byte]++;
+            key = ((key << 8U) | byte) & keyMask;
+        }
+        counts[key][END_SYMBOL]++;
+    }
+
+    // b. number the states. Every state a character leads to has been counted, since the character was followed by
+    // something.
+    std::map<uint64_t, uint32_t> stateIds;
+    for (const auto& state : counts) {
+        stateIds.emplace(state.first, static_cast<uint32_t>(stateIds.size()));
+    }
+    m_start_state = stateIds.at(0U);
+
+    m_state_offsets.clear();
+    m_outcome_characters.clear();
+    m_outcome_next_states.clear();
+    m_alias_thresholds.clear();
+    m_aliases.clear();
+
+    // c. lay out the outcomes of each state, and build its alias table with Vose's method.
+    std::vector<uint64_t> scaled;
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (const auto& state : counts) {
+
+        const uint32_t first = static_cast<uint32_t>(m_outcome_characters.size());
+        m_state_offsets.push_back(first);
 
-        std::string padded = m_start + name + '$';
-        size_t numKeys = padded.length() - m_order; // number of keys generated from name
+        uint64_t total = 0U;
+        for (const auto& outcome : state.second) {
+            uint16_t symbol = outcome.first;
+            m_outcome_characters.push_back((symbol == END_SYMBOL) ? '\0' : static_cast<char>(symbol));
+            m_outcome_next_states.push_back(
+                (symbol == END_SYMBOL) ? END_OF_NAME : stateIds.at(((state.first << 8U) | symbol) & keyMask));
+            total += outcome.second;
+        }
+
+        // each outcome is scaled so that the average is ALIAS_SCALE, and the columns are filled from the largest.
+        const uint64_t numOutcomes = state.second.size();
+        scaled.clear();
+        small.clear();
+        large.clear();
+        for (const auto& outcome : state.second) {
+            uint64_t index = scaled.size();
+            scaled.push_back(static_cast<uint64_t>(
+                (static_cast<double>(outcome.second) * static_cast<double>(numOutcomes) * ALIAS_SCALE) / total));
+            (scaled.back() < ALIAS_SCALE ? small : large).push_back(static_cast<uint32_t>(index));
+        }
+
+        m_alias_thresholds.resize(first + numOutcomes, ALIAS_SCALE);
+        m_aliases.resize(first + numOutcomes);
+        for (uint32_t index = 0U; index < numOutcomes; index++) {
+            m_aliases[first + index] = first + index;
+        }
 
-        for (size_t keyIndex = 0; keyIndex < numKeys; keyIndex++) {
-            std::string key = padded.substr(keyIndex, m_order);
-            m_chains[key].push_back(padded[keyIndex + m_order]);
+        while (!small.empty() && !large.empty()) {
+            uint32_t less = small.back();
+            uint32_t more = large.back();
+            small.pop_back();
+
+            m_alias_thresholds[first + less] = scaled[less];
+            m_aliases[first + less] = first + more;
+
+            scaled[more] -= ALIAS_SCALE - scaled[less];
+            if (scaled[more] < ALIAS_SCALE) {
+                large.pop_back();
+                small.push_back(more);
+            }
         }
     }
+
+    m_state_offsets.push_back(static_cast<uint32_t>(m_outcome_characters.size()));
 }
 
 std::string NameGenerator::Generate(size_t max_characters) {
-
-    std::string current = m_start;
     std::string result;
     result.reserve(max_characters);
+    GenerateInto(max_characters, result);
+    return result;
+}
+
+void NameGenerator::Generate(size_t count, size_t max_characters, NameBatch& batch) {
+
+    batch.m_characters.clear();
+    batch.m_offsets.clear();
+    batch.m_offsets.reserve(count + 1U);
+
+    batch.m_offsets.push_back(0U);
+    for (size_t index = 0U; index < count; index++) {
+        GenerateInto(max_characters, batch.m_characters);
+        batch.m_offsets.push_back(static_cast<uint32_t>(batch.m_characters.size()));
+    }
+}
+
+NameBatch NameGenerator::Generate(size_t count, size_t max_characters) {
+    NameBatch batch;
+    batch.m_characters.reserve(count * max_characters);
+    Generate(count, max_characters, batch);
+    return batch;
+}
 
-    while(result.length() < max_characters) {
+void NameGenerator::GenerateInto(size_t max_characters, std::string& out) {
 
-        std::vector<char>& chooseFrom = m_chains[current];
+    uint32_t state = m_start_state;
+    for (size_t length = 0U; length < max_characters; length++) {
 
-        if (chooseFrom.empty()) {
+        const uint32_t first = m_state_offsets[state];
+        const uint64_t numOutcomes = m_state_offsets[state + 1U] - first;
+        if (numOutcomes == 0U) {
             break;
         }
 
-        std::uniform_int_distribution<uint32_t> choiceDistribution(0U, chooseFrom.size() - 1);
-        char next = chooseFrom.at(choiceDistribution(m_generator));
+        uint32_t outcome = first + static_cast<uint32_t>((numOutcomes * m_generator()) >> 32U);
+        if (m_generator() >= m_alias_thresholds[outcome]) {
+            outcome = m_aliases[outcome];
+        }
 
-        if (next == '$') {
+        state = m_outcome_next_states[outcome];
+        if (state == END_OF_NAME) {
             break; // reached end of word.
         }
 
-        result += next;
-        current = current.substr(1) + next;
+        out += m_outcome_characters[outcome];
     }
+}
 
-    return result;
+bool NameGenerator::WriteCache(const std::string& filepath, uint64_t source_hash) const {
+
+    std::ofstream stream(filepath, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        return false;
+    }
+
+    WriteBinary(stream, NAME_CACHE_MAGIC);
+    WriteBinary(stream, NAME_CACHE_VERSION);
+    WriteBinary(stream, source_hash);
+    WriteBinary(stream, m_start_state);
+    WriteArray(stream, m_state_offsets);
+    WriteArray(stream, m_outcome_characters);
+    WriteArray(stream, m_outcome_next_states);
+    WriteArray(stream, m_alias_thresholds);
+    WriteArray(stream, m_aliases);
+
+    return static_cast<bool>(stream);
 }
 
-}
\ No newline at end of file
+bool NameGenerator::ReadCache(const std::string& filepath, uint64_t source_hash) {
+
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream || (ReadBinary<uint32_t>(stream) != NAME_CACHE_MAGIC) ||
+        (ReadBinary<uint32_t>(stream) != NAME_CACHE_VERSION) || (ReadBinary<uint64_t>(stream) != source_hash)) {
+        return false;
+    }
+
+    // every size is bounded by the size of the file, so that a damaged cache cannot ask for huge allocations.
+    stream.seekg(0, std::ios::end);
+    const size_t fileSize = static_cast<size_t>(stream.tellg());
+    stream.seekg(sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t));
+
+    uint32_t startState = ReadBinary<uint32_t>(stream);
+    std::vector<uint32_t> stateOffsets = ReadArray<uint32_t>(stream, fileSize);
+    std::vector<char> characters = ReadArray<char>(stream, fileSize);
+    std::vector<uint32_t> nextStates = ReadArray<uint32_t>(stream, fileSize);
+    std::vector<uint64_t> thresholds = ReadArray<uint64_t>(stream, fileSize);
+    std::vector<uint32_t> aliases = ReadArray<uint32_t>(stream, fileSize);
+    if (!stream || stateOffsets.empty()) {
+        return false;
+    }
+
+    // check every index, since the tables are walked without bounds checks.
+    const size_t numStates = stateOffsets.size() - 1U;
+    const size_t numOutcomes = characters.size();
+    if ((startState >= numStates) || (stateOffsets.front() != 0U) || (stateOffsets.back() != numOutcomes) ||
+        (nextStates.size() != numOutcomes) || (thresholds.size() != numOutcomes) || (aliases.size() != numOutcomes)) {
+        return false;
+    }
+    for (size_t state = 0U; state < numStates; state++) {
+        if (stateOffsets[state] > stateOffsets[state + 1U]) {
+            return false;
+        }
+        for (uint32_t outcome = stateOffsets[state]; outcome < stateOffsets[state + 1U]; outcome++) {
+            if (((nextStates[outcome] >= numStates) && (nextStates[outcome] != END_OF_NAME)) ||
+                (aliases[outcome] < stateOffsets[state]) || (aliases[outcome] >= stateOffsets[state + 1U])) {
+                return false;
+            }
+        }
+    }
+
+    m_start_state = startState;
+    m_state_offsets = std::move(stateOffsets);
+    m_outcome_characters = std::move(characters);
+    m_outcome_next_states = std::move(nextStates);
+    m_alias_thresholds = std::move(thresholds);
+    m_aliases = std::move(aliases);
+    return true;
+}
+
+}
@@ -1,39 +1,129 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 namespace Core {
 
+//! A batch of generated names, stored end to end in a single buffer.
+//!
+//! Reusing a batch for the next call to NameGenerator::Generate() reuses its memory, so generating names in batches
+//! does not allocate once the batch has grown to size.
+class NameBatch {
+
+    public:
+
+        //! Get the number of names in the batch.
+        size_t GetCount() const;
+
+        //! Get a name. Valid until the batch is next generated into.
+        std::string_view GetName(size_t index) const;
+
+    private:
+
+        friend class NameGenerator;
+
+        //! Characters of every name.
+        std::string m_characters;
+
+        //! Offset of the first character of each name, followed by the total number of characters.
+        std::vector<uint32_t> m_offsets;
+};
+
+//! Markov chain name generator.
+//!
+//! The generator is trained on a list of names, and predicts each character of a new name from the characters before
+//! it. Training compiles the model into flat tables, with a state for every sequence of characters seen, and for each
+//! state the characters that can follow it, the state that each leads to, and an alias table to pick one in constant
+//! time. Generating a name only walks these tables, without hashing or allocating.
 class NameGenerator {
 
     public:
 
-        //! @brief Load a name generator with given training data.
+        //! Largest order supported, as the characters of a state are packed into a 64 bit key while training.
+        static constexpr int32_t MAX_ORDER = 8;
+
+        //! @brief Load a name generator trained on one of the lists of names in a JSON file.
+        //!
+        //! The compiled model is cached in a binary file next to the JSON file, and is loaded from there instead of
+        //! training again as long as the JSON file does not change. If the cache cannot be written, the generator is
+        //! still trained, and a warning logged.
+        //!
+        //! @param[in] filepath  Path to the JSON file.
+        //! @param[in] name_type Key of the list of names in the JSON file.
+        //! @param[in] seed      Seed for the random number generator.
+        static NameGenerator Load(const std::string& filepath, const std::string& name_type, uint32_t seed);
+
+        //! @brief Load a name generator as above, seeded from std::random_device.
         static NameGenerator Load(const std::string& filepath, const std::string& name_type);
 
         //! @brief Constructor for the name generator.
+        //!
+        //! @param[in] order Number of characters used to predict the next one. Between one and MAX_ORDER.
+        //! @param[in] seed  Seed for the random number generator.
         NameGenerator(int32_t order, uint32_t seed);
 
-        //! @brief Training data for the name generator.
+        //! @brief Train the generator on a list of names, replacing the model from any earlier training.
         void Train(const std::vector<std::string>& names);
 
         //! @brief Generate a random name.
         std::string Generate(size_t max_characters);
 
+        //! @brief Generate a batch of random names.
+        //!
+        //! @param[in]  count          The number of names to generate.
+        //! @param[in]  max_characters Longest name to generate. Longer names are cut short.
+        //! @param[out] batch          Receives the names, replacing any names already in it.
+        void Generate(size_t count, size_t max_characters, NameBatch& batch);
+
+        //! @brief Generate a batch of random names, into a new batch.
+        NameBatch Generate(size_t count, size_t max_characters);
+
     private:
 
-        //! Set of markov chains used for name generation.
-        std::unordered_map<std::string, std::vector<char>> m_chains;
+        //! Marks an outcome that ends the name, rather than leading to another state.
+        static constexpr uint32_t END_OF_NAME = UINT32_MAX;
+
+        //! Append a random name to a string, for at most a number of characters.
+        void GenerateInto(size_t max_characters, std::string& out);
 
-        //! The size of the key used for sliding window of characters used for predicting the next character.
+        //! @brief Write the compiled model to a cache file.
+        //!
+        //! @param[in] filepath    Path of the cache.
+        //! @param[in] source_hash Hash of the training data the model was compiled from.
+        //!
+        //! @returns Whether the cache was written.
+        bool WriteCache(const std::string& filepath, uint64_t source_hash) const;
+
+        //! @brief Read the compiled model from a cache file.
+        //!
+        //! @returns Whether the cache exists, was compiled from the same training data, and is valid. The model is
+        //!          only changed if it was.
+        bool ReadCache(const std::string& filepath, uint64_t source_hash);
+
+        //! The number of characters used to predict the next one.
         int32_t m_order;
 
-        //! The random number generator used for selecting next character in name;
+        //! The random number generator used for selecting next character in name.
         std::mt19937 m_generator;
 
-        //! The string used for for starting generation of a character sequence.
-        std::string m_start;
+        //! State that every name starts in, before any characters.
+        uint32_t m_start_state {0U};
+
+        //! Index of the first outcome of each state, followed by the total number of outcomes.
+        std::vector<uint32_t> m_state_offsets;
+
+        //! Character added by each outcome, and the state it leads to, or END_OF_NAME.
+        std::vector<char> m_outcome_characters;
+        std::vector<uint32_t> m_outcome_next_states;
+
+        //! Alias table over the outcomes of each state. An outcome picked uniformly is kept if a random 32 bit number
+        //! is below its threshold, and is otherwise replaced by its alias.
+        std::vector<uint64_t> m_alias_thresholds;
+        std::vector<uint32_t> m_aliases;
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,194 @@
+#include "ThreadPool.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace {
+
+    //! Shared state for a single ParallelFor call. Helpers may outlive the call, so this is reference counted.
+    struct ParallelForState {
+        Core::ThreadPool::RangeFunction_t func;
+        size_t count {0U};
+        size_t grain_size {1U};
+        size_t num_blocks {0U};
+        std::atomic<size_t> next_block {0U};
+        std::atomic<size_t> finished_blocks {0U};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+
+        //! Claim and run blocks until none are left.
+        void Work() {
+            size_t block = next_block.fetch_add(1U);
+            while (block < num_blocks) {
+                size_t begin = block * grain_size;
+                size_t end = std::min(begin + grain_size, count);
+
+                try {
+                    func(begin, end);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (error == nullptr) {
+                        error = std::current_exception();
+                    }
+                }
+
+                if (finished_blocks.fetch_add(1U) + 1U == num_blocks) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.notify_all();
+                }
+
+                block = next_block.fetch_add(1U);
+            }
+        }
+    };
+
+    //! Pool set by the innermost ScopedInstance on this thread, if any.
+    thread_local Core::ThreadPool* t_p_scoped_pool = nullptr;
+}
+
+Core::ThreadPool& Core::ThreadPool::GetInstance() {
+    if (t_p_scoped_pool != nullptr) {
+        return *t_p_scoped_pool;
+    }
+
+    static ThreadPool s_pool(std::max(std::thread::hardware_concurrency(), 2U) - 1U);
+    return s_pool;
+}
+
+Core::ThreadPool::ScopedInstance::ScopedInstance(ThreadPool& pool)
+    : m_p_previous(t_p_scoped_pool) {
+    t_p_scoped_pool = &pool;
+}
+
+Core::ThreadPool::ScopedInstance::~ScopedInstance() {
+    t_p_scoped_pool = m_p_previous;
+}
+
+Core::ThreadPool::ThreadPool(size_t num_workers) {
+
+    m_workers.reserve(num_workers);
+    for (size_t workerIndex = 0U; workerIndex < num_workers; workerIndex++) {
+        m_workers.emplace_back(&ThreadPool::WorkerMain, this);
+    }
+}
+
+Core::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_task_available.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t Core::ThreadPool::GetWorkerCount() const {
+    return m_workers.size();
+}
+
+void Core::ThreadPool::Submit(Task_t&& task) {
+
+    if (m_workers.empty()) {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_task_available.notify_one();
+}
+
+void Core::ThreadPool::ParallelFor(size_t count, size_t grain_size, const RangeFunction_t& func) {
+
+    if (count == 0U) {
+        return;
+    }
+
+    grain_size = std::max<size_t>(grain_size, 1U);
+    size_t numBlocks = (count + grain_size - 1U) / grain_size;
+
+    // Not worth waking anyone up for a single block.
+    if ((numBlocks == 1U) || m_workers.empty()) {
+        func(0U, count);
+        return;
+    }
+
+    std::shared_ptr<ParallelForState> p_state = std::make_shared<ParallelForState>();
+    p_state->func = func;
+    p_state->count = count;
+    p_state->grain_size = grain_size;
+    p_state->num_blocks = numBlocks;
+
+    size_t numHelpers = std::min(numBlocks - 1U, m_workers.size());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t helper = 0U; helper < numHelpers; helper++) {
+            m_tasks.emplace_back([p_state]() { p_state->Work(); });
+        }
+    }
+    m_task_available.notify_all();
+
+    // the calling thread helps out, which guarantees progress even when every worker is busy.
+    p_state->Work();
+
+    std::unique_lock<std::mutex> lock(p_state->mutex);
+    p_state->done.wait(lock, [&p_state]() {
+        return p_state->finished_blocks.load() == p_state->num_blocks;
+    });
+
+    if (p_state->error != nullptr) {
+        std::rethrow_exception(p_state->error);
+    }
+}
+
+void Core::ThreadPool::WaitIdle() {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task_finished.wait(lock, [this]() {
+        return m_tasks.empty() && (m_num_active == 0U);
+    });
+}
+
+void Core::ThreadPool::WorkerMain() {
+
+    while (true) {
+
+        Task_t task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_task_available.wait(lock, [this]() {
+                return m_shutdown || !m_tasks.empty();
+            });
+
+            if (m_shutdown && m_tasks.empty()) {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            m_num_active++;
+        }
+
+        try {
+            task();
+        }
+        catch (std::exception& error) {
+            Core::Logger::Error(std::string("ThreadPool: task threw exception: ") + error.what());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_num_active--;
+        }
+        m_task_finished.notify_all();
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core {
+
+    //! Fixed size pool of worker threads, used for background jobs and data parallel loops.
+    class ThreadPool {
+
+        public:
+
+            using Task_t = std::function<void()>;
+            using RangeFunction_t = std::function<void(size_t begin, size_t end)>;
+
+            //! @brief Get the shared thread pool.
+            //!
+            //! The pool is created on first use with one worker per hardware thread, minus the calling thread. A
+            //! ScopedInstance on the calling thread replaces it.
+            static ThreadPool& GetInstance();
+
+            //! Makes GetInstance() return another pool on the calling thread, for as long as this object exists. Used
+            //! to run code that shares the pool with a different number of workers, for example with none.
+            class ScopedInstance {
+
+                public:
+
+                    explicit ScopedInstance(ThreadPool& pool);
+                    ScopedInstance(const ScopedInstance& other) = delete;
+                    ScopedInstance(ScopedInstance&& other) = delete;
+                    ScopedInstance& operator=(const ScopedInstance& other) = delete;
+                    ScopedInstance& operator=(ScopedInstance&& other) = delete;
+                    ~ScopedInstance();
+
+                private:
+
+                    //! Pool that was in use before this one, restored on destruction.
+                    ThreadPool* m_p_previous;
+            };
+
+            //! @brief Create a thread pool.
+            //!
+            //! @param[in] num_workers The number of worker threads to spawn. Zero means all work is run on the calling
+            //!                        thread.
+            explicit ThreadPool(size_t num_workers);
+            ThreadPool(const ThreadPool& other) = delete;
+            ThreadPool(ThreadPool&& other) = delete;
+            ThreadPool& operator=(const ThreadPool& other) = delete;
+            ThreadPool& operator=(ThreadPool&& other) = delete;
+            ~ThreadPool();
+
+            //! Get the number of worker threads.
+            size_t GetWorkerCount() const;
+
+            //! @brief Queue a task to be run by one of the workers. Returns immediately.
+            //!
+            //! If the pool has no workers, the task is run immediately on the calling thread.
+            void Submit(Task_t&& task);
+
+            //! @brief Split the range [0, count) into blocks of grain_size, and run func(begin, end) for each block.
+            //!
+            //! The calling thread works on blocks as well, so it is safe to call from within a task running on the
+            //! pool. Blocks until every block has been processed. The first exception thrown by func is rethrown on
+            //! the calling thread.
+            //!
+            //! @param[in] count      The number of elements in the range.
+            //! @param[in] grain_size The number of elements processed by each call to func.
+            //! @param[in] func       The function to call for each block.
+            void ParallelFor(size_t count, size_t grain_size, const RangeFunction_t& func);
+
+            //! Block until all submitted tasks have finished.
+            void WaitIdle();
+
+        private:
+
+            //! Main loop for each worker.
+            void WorkerMain();
+
+            //! Set of worker threads.
+            std::vector<std::thread> m_workers;
+
+            //! Queue of tasks waiting to be run.
+            std::deque<Task_t> m_tasks;
+
+            //! Protects the task queue.
+            std::mutex m_mutex;
+
+            //! Signalled when a task is queued, or the pool is shutting down.
+            std::condition_variable m_task_available;
+
+            //! Signalled when a worker finishes a task.
+            std::condition_variable m_task_finished;
+
+            //! Number of tasks currently being run by workers.
+            size_t m_num_active {0U};
+
+            //! Whether workers should exit.
+            bool m_shutdown {false};
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Core {
+
+    //! Index of a type within a family of types.
+    using TypeId_t = uint32_t;
+
+    //! Assigns each type a small index within a family of types, such as components or systems, without RTTI.
+    //!
+    //! Each type is given the next free index of its family the first time it is looked up, and keeps it for the life
+    //! of the process, so the indices of a family are dense, starting from zero, and can be used to index arrays.
+    //! Indices depend on the order types are first looked up in, so should not be saved.
+    //!
+    //! @tparam Family Tag type that the indices are counted for, usually the base class of the types.
+    template<typename Family>
+    class TypeId {
+
+        public:
+
+            //! Get the index of a type.
+            template<typename T>
+            static TypeId_t Get() {
+                static const TypeId_t id = s_next_id.fetch_add(1U);
+                return id;
+            }
+
+            //! Get the number of types given an index so far.
+            static TypeId_t GetCount() {
+                return s_next_id.load();
+            }
+
+        private:
+
+            //! The index given to the next type looked up.
+            static inline std::atomic<TypeId_t> s_next_id {0U};
+    };
+}
@@ -0,0 +1,314 @@
+#include "ArchetypeStorage.hpp"
+#include <cstring>
+#include <utility>
+
+namespace ECS {
+
+    //! Round an offset up to a multiple of an alignment.
+    static size_t AlignUp(size_t offset, size_t alignment) {
+        return ((offset + alignment - 1U) / alignment) * alignment;
+    }
+
+    ArchetypeStorage::ArchetypeStorage()
+        : m_locations(MAX_ENTITIES) {
+        m_components.reserve(MAX_COMPONENTS);
+    }
+
+    ArchetypeStorage& ArchetypeStorage::operator=(ArchetypeStorage&& other) noexcept {
+
+        if (this != &other) {
+            DestroyComponents();
+            m_components = std::move(other.m_components);
+            m_component_types = std::move(other.m_component_types);
+            m_archetypes = std::move(other.m_archetypes);
+            m_archetype_index = std::move(other.m_archetype_index);
+            m_locations = std::move(other.m_locations);
+            m_size = std::exchange(other.m_size, 0U);
+        }
+        return *this;
+    }
+
+    ArchetypeStorage::~ArchetypeStorage() {
+        DestroyComponents();
+    }
+
+    void ArchetypeStorage::DestroyComponents() {
+
+        for (Archetype& archetype : m_archetypes) {
+            for (ComponentType type : archetype.types) {
+
+                const ComponentInfo& info = m_components[type];
+                if (info.p_destroy == nullptr) {
+                    continue;
+                }
+
+                for (uint32_t row = 0U; row < archetype.size; row++) {
+                    info.p_destroy(GetSlot(archetype, archetype.column_offsets[type], info.size, row));
+                }
+            }
+        }
+    }
+
+    bool ArchetypeStorage::Contains(EntityID_t entity) const {
+        return (entity < MAX_ENTITIES) && (m_locations[entity].archetype != NONE);
+    }
+
+    Signature_t ArchetypeStorage::GetSignature(EntityID_t entity) const {
+        if (!Contains(entity)) {
+            return Signature_t();
+        }
+        return m_archetypes[m_locations[entity].archetype].signature;
+    }
+
+    size_t ArchetypeStorage::GetSize() const {
+        return m_size;
+    }
+
+    size_t ArchetypeStorage::GetNumArchetypes() const {
+        return m_archetypes.size();
+    }
+
+    void ArchetypeStorage::Erase(EntityID_t entity) {
+
+        if (!Contains(entity)) {
+            return;
+        }
+
+        Location location = m_locations[entity];
+        const Archetype& archetype = m_archetypes[location.archetype];
+        for (ComponentType type : archetype.types) {
+
+            const ComponentInfo& info = m_components[type];
+            if (info.p_destroy != nullptr) {
+                info.p_destroy(GetSlot(archetype, archetype.column_offsets[type], info.size, location.row));
+            }
+        }
+
+        FillRow(location.archetype, location.row);
+        m_locations[entity] = Location();
+        m_size--;
+    }
+
+    void ArchetypeStorage::CheckEntity(EntityID_t entity) {
+        if (entity >= MAX_ENTITIES) {
+            throw Exception("Entity ID " + std::to_string(entity) + " is out of range");
+        }
+    }
+
+    uint32_t ArchetypeStorage::FindOrCreateArchetype(const Signature_t& signature) {
+
+        auto archetypeIter = m_archetype_index.find(signature);
+        if (archetypeIter != m_archetype_index.end()) {
+            return archetypeIter->second;
+        }
+
+        Archetype archetype;
+        archetype.signature = signature;
+        archetype.column_offsets.fill(NONE);
+        archetype.with.fill(NONE);
+        archetype.without.fill(NONE);
+
+        size_t rowSize = sizeof(EntityID_t);
+        for (ComponentType type = 0U; type < m_components.size(); type++) {
+            if (signature.test(type)) {
+                archetype.types.push_back(type);
+                rowSize += m_components[type].size;
+            }
+        }
+
+        // fit as many rows as possible, allowing for the padding between columns.
+        uint32_t capacity = static_cast<uint32_t>(CHUNK_SIZE / rowSize);
+        while (capacity > 0U) {
+
+            size_t offset = capacity * sizeof(EntityID_t);
+            for (ComponentType type : archetype.types) {
+                offset = AlignUp(offset, m_components[type].alignment);
+                archetype.column_offsets[type] = static_cast<uint32_t>(offset);
+                offset += capacity * m_components[type].size;
+            }
+
+            if (offset <= CHUNK_SIZE) {
+                break;
+            }
+            capacity--;
+        }
+
+        if (capacity == 0U) {
+            throw Exception("Components of an archetype do not fit in a chunk. Consider increasing CHUNK_SIZE.");
+        }
+        archetype.chunk_capacity = capacity;
+
+        uint32_t index = static_cast<uint32_t>(m_archetypes.size());
+        m_archetypes.push_back(std::move(archetype));
+        m_archetype_index[signature] = index;
+        return index;
+    }
+
+    uint32_t ArchetypeStorage::GetArchetypeWith(uint32_t archetype, ComponentType type) {
+
+        uint32_t target = m_archetypes[archetype].with[type];
+        if (target == NONE) {
+
+            Signature_t signature = m_archetypes[archetype].signature;
+            signature.set(type);
+            target = FindOrCreateArchetype(signature);
+
+            m_archetypes[archetype].with[type] = target;
+            m_archetypes[target].without[type] = archetype;
+        }
+        return target;
+    }
+
+    uint32_t ArchetypeStorage::GetArchetypeWithout(uint32_t archetype, ComponentType type) {
+
+        uint32_t target = m_archetypes[archetype].without[type];
+        if (target == NONE) {
+
+            Signature_t signature = m_archetypes[archetype].signature;
+            signature.reset(type);
+            target = FindOrCreateArchetype(signature);
+
+            m_archetypes[archetype].without[type] = target;
+            m_archetypes[target].with[type] = archetype;
+        }
+        return target;
+    }
+
+    void ArchetypeStorage::MoveEntity(EntityID_t entity, uint32_t archetype) {
+
+        Location source = m_locations[entity];
+        uint32_t row = AddRow(archetype, entity);
+
+        const Archetype& from = m_archetypes[source.archetype];
+        const Archetype& to = m_archetypes[archetype];
+        for (ComponentType type : from.types) {
+
+            const ComponentInfo& info = m_components[type];
+            std::byte* p_source = GetSlot(from, from.column_offsets[type], info.size, source.row);
+
+            if (to.column_offsets[type] == NONE) {
+                if (info.p_destroy != nullptr) {
+                    info.p_destroy(p_source);
+                }
+            }
+            else {
+                std::byte* p_destination = GetSlot(to, to.column_offsets[type], info.size, row);
+                if (info.p_move != nullptr) {
+                    info.p_move(p_destination, p_source);
+                }
+                else {
+                    std::memcpy(p_destination, p_source, info.size);
+                }
+            }
+        }
+
+        FillRow(source.archetype, source.row);
+    }
+
+    uint32_t ArchetypeStorage::AddRow(uint32_t archetype, EntityID_t entity) {
+
+        Archetype& to = m_archetypes[archetype];
+        if (to.size == to.chunks.size() * to.chunk_capacity) {
+            to.chunks.push_back(std::make_unique<ChunkStorage>());
+        }
+
+        uint32_t row = to.size++;
+        GetEntityAt(to, row) = entity;
+        m_locations[entity] = {archetype, row};
+        return row;
+    }
+
+    void ArchetypeStorage::FillRow(uint32_t archetype, uint32_t row) {
+
+        Archetype& from = m_archetypes[archetype];
+        uint32_t last = from.size - 1U;
+
+        if (row != last) {
+            for (ComponentType type : from.types) {
+
+                const ComponentInfo& info = m_components[type];
+                std::byte* p_destination = GetSlot(from, from.column_offsets[type], info.size, row);
+                std::byte* p_source = GetSlot(from, from.column_offsets[type], info.size, last);
+                if (info.p_move != nullptr) {
+                    info.p_move(p_destination, p_source);
+                }
+                else {
+                    std::memcpy(p_destination, p_source, info.size);
+                }
+            }
+
+            EntityID_t moved = GetEntityAt(from, last);
+            GetEntityAt(from, row) = moved;
+            m_locations[moved].row = row;
+        }
+        from.size--;
+
+        // release the last chunk once it is empty.
+        if (from.size == (from.chunks.size() - 1U) * from.chunk_capacity) {
+            from.chunks.pop_back();
+        }
+    }
+
+    void* ArchetypeStorage::AddComponentSlot(EntityID_t entity, ComponentType type) {
+
+        CheckEntity(entity);
+
+        uint32_t archetype = m_locations[entity].archetype;
+        if (archetype == NONE) {
+
+            Signature_t signature;
+            signature.set(type);
+            AddRow(FindOrCreateArchetype(signature), entity);
+            m_size++;
+        }
+        else if (m_archetypes[archetype].signature.test(type)) {
+            throw Exception("Entity " + std::to_string(entity) + " already has component!");
+        }
+        else {
+            MoveEntity(entity, GetArchetypeWith(archetype, type));
+        }
+
+        const Location& location = m_locations[entity];
+        const Archetype& to = m_archetypes[location.archetype];
+        return GetSlot(to, to.column_offsets[type], m_components[type].size, location.row);
+    }
+
+    void ArchetypeStorage::RemoveComponent(EntityID_t entity, ComponentType type) {
+
+        if (!GetSignature(entity).test(type)) {
+            throw Exception(
+                "Entity " + std::to_string(entity) + " with component " + std::to_string(type) + " not found.");
+        }
+
+        uint32_t archetype = m_locations[entity].archetype;
+        if (m_archetypes[archetype].types.size() == 1U) {
+            Erase(entity);
+        }
+        else {
+            MoveEntity(entity, GetArchetypeWithout(archetype, type));
+        }
+    }
+
+    void* ArchetypeStorage::GetComponent(EntityID_t entity, ComponentType type) const {
+
+        if (!GetSignature(entity).test(type)) {
+            throw Exception(
+                "Entity " + std::to_string(entity) + " with component " + std::to_string(type) + " not found.");
+        }
+
+        const Location& location = m_locations[entity];
+        const Archetype& archetype = m_archetypes[location.archetype];
+        return GetSlot(archetype, archetype.column_offsets[type], m_components[type].size, location.row);
+    }
+
+    std::byte* ArchetypeStorage::GetSlot(
+        const Archetype& archetype, uint32_t column_offset, size_t size, uint32_t row) {
+
+        std::byte* p_chunk = archetype.chunks[row / archetype.chunk_capacity]->bytes;
+        return p_chunk + column_offset + ((row % archetype.chunk_capacity) * size);
+    }
+
+    EntityID_t& ArchetypeStorage::GetEntityAt(const Archetype& archetype, uint32_t row) {
+        return *reinterpret_cast<EntityID_t*>(GetSlot(archetype, 0U, sizeof(EntityID_t), row));
+    }
+}
@@ -0,0 +1,392 @@
+#pragma once
+
+#include "Types.hpp"
+#include "core/TypeId.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ECS {
+
+    //! @brief Components of the entities in one chunk of an ArchetypeStorage.
+    //!
+    //! The components are stored as one column per component type, so each column is a plain array that can be looped
+    //! over. Column i holds the components of the entity in row i of GetEntities().
+    template<typename... Component_t>
+    class ArchetypeChunk {
+
+        public:
+
+            ArchetypeChunk(const EntityID_t* p_entities, size_t size, Component_t*... p_columns)
+                : m_p_entities(p_entities)
+                , m_size(size)
+                , m_columns(p_columns...) {
+            }
+
+            //! Get the number of entities in the chunk.
+            size_t GetSize() const {
+                return m_size;
+            }
+
+            //! Get the entity of each row.
+            const EntityID_t* GetEntities() const {
+                return m_p_entities;
+            }
+
+            //! Get the column of a component type, such as GetColumn<const Transform>() for a view of const Transform.
+            template<typename T>
+            T* GetColumn() const {
+                return std::get<T*>(m_columns);
+            }
+
+        private:
+
+            const EntityID_t* m_p_entities;
+            size_t m_size;
+            std::tuple<Component_t*...> m_columns;
+    };
+
+    //! @brief Component storage that keeps entities with the same components together, in chunks of columns.
+    //!
+    //! Each set of component types that an entity has is an archetype. The entities of an archetype are packed into
+    //! chunks of CHUNK_SIZE bytes, each holding a column of every component type of the archetype, so walking a few
+    //! components of many entities reads a few contiguous arrays per chunk, rather than an array per component type
+    //! in entity order. This suits large populations, such as creatures, that are updated every frame.
+    //!
+    //! Storage is opt in, and separate from the component arrays of a Registry. A registry creates its storage on the
+    //! first call to Registry::GetArchetypeStorage(), and erases entities from it as they are destroyed, so components
+    //! stored here are not part of the entity signature, and are not seen by systems or views.
+    //!
+    //! Adding or removing a component moves the entity to another archetype, moving only the components the two have
+    //! in common. The archetype reached by adding or removing each component type is cached, so moves do not look
+    //! archetypes up by signature.
+    //!
+    //! Components are moved when entities change archetype, or when another entity is removed from their chunk, so
+    //! references to components are only valid until the next component is added or removed. Components must be
+    //! nothrow move constructible.
+    class ArchetypeStorage {
+
+        public:
+
+            //! Size of a chunk, in bytes.
+            static constexpr size_t CHUNK_SIZE = 16U * 1024U;
+
+            //! Alignment of a chunk, which is the largest supported alignment of a component.
+            static constexpr size_t CHUNK_ALIGNMENT = 64U;
+
+            ArchetypeStorage();
+            ArchetypeStorage(const ArchetypeStorage& other) = delete;
+
+            //! Moving takes the components of the other storage, which can then only be assigned to or destroyed.
+            ArchetypeStorage(ArchetypeStorage&& other) noexcept = default;
+            ArchetypeStorage& operator=(const ArchetypeStorage& other) = delete;
+            ArchetypeStorage& operator=(ArchetypeStorage&& other) noexcept;
+            ~ArchetypeStorage();
+
+            template<typename T>
+            void RegisterComponent() {
+
+                static_assert(alignof(T) <= CHUNK_ALIGNMENT, "Component alignment is larger than a chunk supports.");
+                static_assert(std::is_nothrow_move_constructible_v<T>, "Components must be nothrow movable.");
+
+                Core::TypeId_t typeId = ComponentTypeIds::Get<T>();
+                if ((typeId < m_component_types.size()) && (m_component_types[typeId] != UNREGISTERED_COMPONENT)) {
+                    throw Exception("Component type " + std::string(typeid(T).name()) + " already registered.");
+                }
+
+                if (m_components.size() == MAX_COMPONENTS) {
+                    throw Exception("Already registered max number of component types. Consider increasing MAX_COMPONENTS.");
+                }
+
+                // trivially copyable components are moved with memcpy, and never destroyed.
+                ComponentInfo info;
+                info.size = sizeof(T);
+                info.alignment = alignof(T);
+                if constexpr (!std::is_trivially_copyable_v<T>) {
+                    info.p_move = [](void* p_destination, void* p_source) {
+                        new (p_destination) T(std::move(*static_cast<T*>(p_source)));
+                        static_cast<T*>(p_source)->~T();
+                    };
+                    info.p_destroy = [](void* p_component) {
+                        static_cast<T*>(p_component)->~T();
+                    };
+                }
+
+                if (typeId >= m_component_types.size()) {
+                    m_component_types.resize(typeId + 1U, UNREGISTERED_COMPONENT);
+                }
+                m_component_types[typeId] = static_cast<ComponentType>(m_components.size());
+                m_components.push_back(info);
+            }
+
+            template<typename T>
+            ComponentType GetComponentType() const {
+                Core::TypeId_t typeId = ComponentTypeIds::Get<T>();
+                if ((typeId >= m_component_types.size()) || (m_component_types[typeId] == UNREGISTERED_COMPONENT)) {
+                    throw Exception("Could not find code for type " + std::string(typeid(T).name()));
+                }
+                return m_component_types[typeId];
+            }
+
+            template<typename T>
+            Signature_t GetComponentSignature() const {
+                Signature_t signature;
+                signature.set(GetComponentType<T>());
+                return signature;
+            }
+
+            //! Check if an entity has any components in the storage.
+            bool Contains(EntityID_t entity) const;
+
+            //! Get the signature of the components an entity has in the storage.
+            Signature_t GetSignature(EntityID_t entity) const;
+
+            //! Get the number of entities in the storage.
+            size_t GetSize() const;
+
+            //! Get the number of archetypes that have been created.
+            size_t GetNumArchetypes() const;
+
+            //! @brief Add a component to an entity, moving it to the archetype with the component.
+            //!
+            //! @throws ECS::Exception if the entity already has the component.
+            template<typename T>
+            T& Add(EntityID_t entity, T component) {
+                ComponentType type = GetComponentType<T>();
+                void* p_component = AddComponentSlot(entity, type);
+                return *new (p_component) T(std::move(component));
+            }
+
+            //! @brief Add a default constructed component to an entity.
+            template<typename T>
+            T& Emplace(EntityID_t entity) {
+                ComponentType type = GetComponentType<T>();
+                void* p_component = AddComponentSlot(entity, type);
+                return *new (p_component) T();
+            }
+
+            //! @brief Remove a component from an entity. An entity left without components is erased.
+            //!
+            //! @throws ECS::Exception if the entity does not have the component.
+            template<typename T>
+            void Remove(EntityID_t entity) {
+                RemoveComponent(entity, GetComponentType<T>());
+            }
+
+            //! Check if an entity has a component.
+            template<typename T>
+            bool Has(EntityID_t entity) const {
+                return GetSignature(entity).test(GetComponentType<T>());
+            }
+
+            //! @brief Get a component of an entity.
+            //!
+            //! @throws ECS::Exception if the entity does not have the component.
+            template<typename T>
+            T& Get(EntityID_t entity) {
+                return *static_cast<T*>(GetComponent(entity, GetComponentType<T>()));
+            }
+
+            template<typename T>
+            const T& Get(EntityID_t entity) const {
+                return *static_cast<const T*>(GetComponent(entity, GetComponentType<T>()));
+            }
+
+            //! Remove every component of an entity. Does nothing if it has none.
+            void Erase(EntityID_t entity);
+
+            //! @brief Call func(ArchetypeChunk<Component_t...>&) for each chunk of entities with all of the components.
+            //!
+            //! Components listed as const are given out as const columns. Components must not be added or removed while
+            //! walking the chunks.
+            template<typename... Component_t, typename Func_t>
+            void ForEachChunk(Func_t&& func) {
+                ForEachChunk<Component_t...>(Exclude<>(), std::forward<Func_t>(func));
+            }
+
+            //! @brief Call func(ArchetypeChunk<Component_t...>&) for each chunk of entities with all of the components,
+            //!        and none of the excluded ones.
+            template<typename... Component_t, typename... Excluded_t, typename Func_t>
+            void ForEachChunk(Exclude<Excluded_t...> /*exclude*/, Func_t&& func) {
+
+                static_assert(sizeof...(Component_t) > 0U, "A query needs at least one component type.");
+
+                const Signature_t include =
+                    (Signature_t() | ... | GetComponentSignature<std::remove_const_t<Component_t>>());
+                const Signature_t mask = include | (Signature_t() | ... | GetComponentSignature<Excluded_t>());
+                const std::array<ComponentType, sizeof...(Component_t)> types = {
+                    GetComponentType<std::remove_const_t<Component_t>>()...};
+
+                for (Archetype& archetype : m_archetypes) {
+                    if ((archetype.signature & mask) != include) {
+                        continue;
+                    }
+
+                    for (size_t chunk = 0U; chunk < archetype.chunks.size(); chunk++) {
+                        ArchetypeChunk<Component_t...> view = MakeChunk<Component_t...>(
+                            archetype, chunk, types, std::index_sequence_for<Component_t...>());
+                        func(view);
+                    }
+                }
+            }
+
+            //! @brief Call func(entity, components...) for each entity with all of the components.
+            template<typename... Component_t, typename Func_t>
+            void ForEach(Func_t&& func) {
+                ForEach<Component_t...>(Exclude<>(), std::forward<Func_t>(func));
+            }
+
+            //! @brief Call func(entity, components...) for each entity with all of the components, and none of the
+            //!        excluded ones.
+            template<typename... Component_t, typename... Excluded_t, typename Func_t>
+            void ForEach(Exclude<Excluded_t...> exclude, Func_t&& func) {
+                ForEachChunk<Component_t...>(exclude, [&func](const ArchetypeChunk<Component_t...>& chunk) {
+
+                    const EntityID_t* p_entities = chunk.GetEntities();
+                    std::tuple<Component_t*...> columns(chunk.template GetColumn<Component_t>()...);
+                    for (size_t row = 0U; row < chunk.GetSize(); row++) {
+                        func(p_entities[row], std::get<Component_t*>(columns)[row]...);
+                    }
+                });
+            }
+
+        private:
+
+            //! Index of component types, assigned on first use rather than at registration.
+            using ComponentTypeIds = Core::TypeId<ArchetypeStorage>;
+
+            //! Marks a type index with no registered component type.
+            static constexpr ComponentType UNREGISTERED_COMPONENT = MAX_COMPONENTS;
+
+            //! Marks an entity that is not in the storage, an archetype transition that has not been cached yet, and a
+            //! component type that an archetype has no column for.
+            static constexpr uint32_t NONE = UINT32_MAX;
+
+            //! How to move and destroy a type of component.
+            struct ComponentInfo {
+                size_t size {0U};
+                size_t alignment {0U};
+
+                //! Move construct a component, and destroy the source. Null if it can be copied with memcpy.
+                void (*p_move)(void* p_destination, void* p_source) {nullptr};
+
+                //! Destroy a component. Null if it is trivially destructible.
+                void (*p_destroy)(void* p_component) {nullptr};
+            };
+
+            //! Memory of a chunk.
+            struct alignas(CHUNK_ALIGNMENT) ChunkStorage {
+                std::byte bytes[CHUNK_SIZE];
+            };
+
+            //! Entities with the same signature, packed into chunks.
+            struct Archetype {
+                Signature_t signature;
+
+                //! Component types of the archetype, in ascending order.
+                std::vector<ComponentType> types;
+
+                //! Offset of the column of each component type within a chunk, or NONE. The entity column is first.
+                std::array<uint32_t, MAX_COMPONENTS> column_offsets {};
+
+                //! Number of entities that fit in a chunk.
+                uint32_t chunk_capacity {0U};
+
+                //! Number of entities in the archetype.
+                uint32_t size {0U};
+
+                //! Chunks holding the entities. All but the last are full.
+                std::vector<std::unique_ptr<ChunkStorage>> chunks;
+
+                //! Archetype reached by adding, or removing, each component type, or NONE until it is first needed.
+                std::array<uint32_t, MAX_COMPONENTS> with {};
+                std::array<uint32_t, MAX_COMPONENTS> without {};
+            };
+
+            //! Where an entity is stored.
+            struct Location {
+                uint32_t archetype {NONE};
+                uint32_t row {0U};
+            };
+
+            template<typename... Component_t, size_t... Index>
+            ArchetypeChunk<Component_t...> MakeChunk(
+                Archetype& archetype,
+                size_t chunk,
+                const std::array<ComponentType, sizeof...(Component_t)>& types,
+                std::index_sequence<Index...> /*unused*/) {
+
+                std::byte* p_bytes = archetype.chunks[chunk]->bytes;
+                size_t first = chunk * archetype.chunk_capacity;
+                size_t count = std::min<size_t>(archetype.chunk_capacity, archetype.size - first);
+
+                return ArchetypeChunk<Component_t...>(
+                    reinterpret_cast<const EntityID_t*>(p_bytes),
+                    count,
+                    std::launder(reinterpret_cast<Component_t*>(p_bytes + archetype.column_offsets[types[Index]]))...);
+            }
+
+            //! Destroy the components of every entity, leaving the chunks to be freed with their archetypes.
+            void DestroyComponents();
+
+            //! Check that an entity ID is in range.
+            static void CheckEntity(EntityID_t entity);
+
+            //! Get the archetype with a signature, creating it if there is none.
+            uint32_t FindOrCreateArchetype(const Signature_t& signature);
+
+            //! Get the archetype with the components of another plus, or minus, one component type.
+            uint32_t GetArchetypeWith(uint32_t archetype, ComponentType type);
+            uint32_t GetArchetypeWithout(uint32_t archetype, ComponentType type);
+
+            //! Move an entity to another archetype, keeping the components both have and destroying the rest.
+            void MoveEntity(EntityID_t entity, uint32_t archetype);
+
+            //! Add a row to the end of an archetype for an entity, and return it.
+            uint32_t AddRow(uint32_t archetype, EntityID_t entity);
+
+            //! Fill a row whose components have been moved out or destroyed, with the last row of its archetype.
+            void FillRow(uint32_t archetype, uint32_t row);
+
+            //! Move an entity to the archetype with a component type, and return the memory to construct it in.
+            void* AddComponentSlot(EntityID_t entity, ComponentType type);
+
+            void RemoveComponent(EntityID_t entity, ComponentType type);
+
+            void* GetComponent(EntityID_t entity, ComponentType type) const;
+
+            //! Get the memory of a row of a column, given the offset of the column and the size of its elements.
+            static std::byte* GetSlot(const Archetype& archetype, uint32_t column_offset, size_t size, uint32_t row);
+
+            //! Get the memory of the entity ID of a row.
+            static EntityID_t& GetEntityAt(const Archetype& archetype, uint32_t row);
+
+            //! Registered component types.
+            std::vector<ComponentInfo> m_components;
+
+            //! Component type of each type index, or UNREGISTERED_COMPONENT.
+            std::vector<ComponentType> m_component_types;
+
+            //! Archetypes, in the order they were created.
+            std::vector<Archetype> m_archetypes;
+
+            //! Archetype of each signature.
+            std::unordered_map<Signature_t, uint32_t> m_archetype_index;
+
+            //! Where each entity is stored, indexed by entity ID.
+            std::vector<Location> m_locations;
+
+            //! Number of entities in the storage.
+            size_t m_size {0U};
+    };
+}
@@ -1,19 +1,31 @@
 #pragma once
 
 #include "core/Logger.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/TypeId.hpp"
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <cstddef>
 #include <cstdint>
 #include <bitset>
 #include <queue>
-#include <set>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 #include <memory>
 #include <sstream>
-#include "math/Graph.hpp"
+#include "math/CsrGraph.hpp"
+#include "ArchetypeStorage.hpp"
+#include "Types.hpp"
 
 namespace Core {
     class Engine;
@@ -25,46 +37,6 @@ namespace Core {
 // Tried using a more modern library, however the header files were difficult to follow.
 namespace ECS {
 
-    // A simple type alias
-    using EntityID_t = uint32_t;
-
-    // Used to define the size of arrays later on
-    const EntityID_t MAX_ENTITIES = 10000;
-
-    // A simple type alias
-    using ComponentType = std::uint32_t;
-
-    // The maximum number of types of component
-    const ComponentType MAX_COMPONENTS = 32;
-
-    // Signature of an entity.
-    using Signature_t = std::bitset<MAX_COMPONENTS>;
-
-    // System type code
-    using SystemTypeCode_t = size_t;
-
-    // Maximum number of systems
-    const SystemTypeCode_t MAX_SYSTEMS = 256;
-
-    //! System Signature
-    using SystemDependencies = std::bitset<MAX_SYSTEMS>;
-
-    // Error type
-    class Exception : public std::exception {
-
-        public:
-            Exception(const std::string& msg)
-                : m_msg(msg) {
-            }
-
-            const char* what() const override {
-                return m_msg.c_str();
-            }
-
-        private:
-            std::string m_msg;
-    };
-
     class EntityManager {
 
         public:
@@ -119,6 +91,11 @@ namespace ECS {
                 return m_signatures.at(entity);
             }
 
+            //! Get the signatures of every entity, indexed by entity ID.
+            const std::array<Signature_t, MAX_ENTITIES>& GetSignatures() const {
+                return m_signatures;
+            }
+
         private:
 
             //! list of free entity IDs.
@@ -131,6 +108,85 @@ namespace ECS {
             uint32_t m_entity_count{0};
     };
 
+    //! Paged sparse array, mapping entity IDs to indices into a packed array.
+    //!
+    //! The entries are split into pages of PAGE_SIZE entries, which are only allocated once an entity in them is given
+    //! an index. Pages that have not been allocated point at a shared page of INVALID_INDEX, so looking an entity up
+    //! is two loads, with no hashing and no check for a missing page.
+    class SparseIndex {
+
+        public:
+
+            //! Index of entities that are not in the array.
+            static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+            //! Number of bits of an entity ID that select the entry within a page.
+            static constexpr uint32_t PAGE_SHIFT = 12U;
+
+            //! Number of entries in each page.
+            static constexpr uint32_t PAGE_SIZE = 1U << PAGE_SHIFT;
+
+            SparseIndex()
+                : m_pages(NUM_PAGES)
+                , m_lookup(NUM_PAGES, GetEmptyPage().data()) {
+            }
+
+            //! Get the index of an entity, or INVALID_INDEX if it does not have one.
+            uint32_t Get(EntityID_t entity) const {
+                if (entity >= MAX_ENTITIES) {
+                    return INVALID_INDEX;
+                }
+                return m_lookup[entity >> PAGE_SHIFT][entity & PAGE_MASK];
+            }
+
+            //! Check whether an entity has an index.
+            bool Has(EntityID_t entity) const {
+                return Get(entity) != INVALID_INDEX;
+            }
+
+            //! Set the index of an entity, allocating its page if needed. The entity must be below MAX_ENTITIES.
+            void Set(EntityID_t entity, uint32_t index) {
+
+                std::unique_ptr<Page_t>& p_page = m_pages[entity >> PAGE_SHIFT];
+                if (p_page == nullptr) {
+                    p_page = std::make_unique<Page_t>(GetEmptyPage());
+                    m_lookup[entity >> PAGE_SHIFT] = p_page->data();
+                }
+                (*p_page)[entity & PAGE_MASK] = index;
+            }
+
+            //! Remove the index of an entity. Does nothing if it does not have one.
+            void Remove(EntityID_t entity) {
+                if (Has(entity)) {
+                    (*m_pages[entity >> PAGE_SHIFT])[entity & PAGE_MASK] = INVALID_INDEX;
+                }
+            }
+
+        private:
+
+            using Page_t = std::array<uint32_t, PAGE_SIZE>;
+
+            static constexpr uint32_t PAGE_MASK = PAGE_SIZE - 1U;
+
+            static constexpr size_t NUM_PAGES = (MAX_ENTITIES + PAGE_SIZE - 1U) / PAGE_SIZE;
+
+            //! Page shared by every page that has not been allocated.
+            static const Page_t& GetEmptyPage() {
+                static const Page_t emptyPage = []() {
+                    Page_t page;
+                    page.fill(INVALID_INDEX);
+                    return page;
+                }();
+                return emptyPage;
+            }
+
+            //! Pages that have been allocated, or null.
+            std::vector<std::unique_ptr<Page_t>> m_pages;
+
+            //! Entries of each page, or of the empty page if it has not been allocated.
+            std::vector<const uint32_t*> m_lookup;
+    };
+
     class IComponentArray {
         public:
             IComponentArray() = default;
@@ -160,65 +216,65 @@ namespace ECS {
 
             void Add(EntityID_t entity, T&& component) {
 
-                if (m_entity_to_component_id.find(entity) != m_entity_to_component_id.end()) {
-                    throw Exception("Entity " + std::to_string(entity) + " already has component!");
-                }
+                CheckCanAdd(entity);
 
                 if (m_components.capacity() == m_components.size()) {
                     Resize();
                 }
 
-                size_t newIndex = m_components.size();
-                m_entity_to_component_id[entity] = newIndex;
+                uint32_t newIndex = static_cast<uint32_t>(m_components.size());
+                m_entity_to_component_id.Set(entity, newIndex);
                 m_component_to_entity_id.push_back(entity);
                 m_components.push_back(std::move(component));
             }
 
             T& Emplace(EntityID_t entity) {
-                if (m_entity_to_component_id.find(entity) != m_entity_to_component_id.end()) {
-                    throw Exception("Entity " + std::to_string(entity) + " already has component!");
-                }
 
-                if (m_components.max_size() == m_components.size()) {
+                CheckCanAdd(entity);
+
+                if (m_components.capacity() == m_components.size()) {
                     Resize();
                 }
 
-                size_t newIndex = m_components.size();
-                m_entity_to_component_id[entity] = newIndex;
+                uint32_t newIndex = static_cast<uint32_t>(m_components.size());
+                m_entity_to_component_id.Set(entity, newIndex);
                 m_component_to_entity_id.push_back(entity);
                 return m_components.emplace_back();
             }
 
             void Remove(EntityID_t entity) {
 
-                auto removeIter = m_entity_to_component_id.find(entity);
-                if (removeIter == m_entity_to_component_id.end()) {
+                uint32_t removeIndex = m_entity_to_component_id.Get(entity);
+                if (removeIndex == SparseIndex::INVALID_INDEX) {
                     std::string componentName = std::string(typeid(T).name());
                     throw Exception("Entity " + std::to_string(entity) + " with component " + componentName + " not found.");
                 }
 
-                size_t removeIndex = removeIter->second;
                 size_t lastIndex = m_components.size() - 1;
                 EntityID_t lastEntity = m_component_to_entity_id[lastIndex];
 
-                m_components[removeIndex] = std::move(m_components.at(lastIndex));
+                m_components[removeIndex] = std::move(m_components[lastIndex]);
                 m_components.pop_back();
 
-                m_entity_to_component_id[lastEntity] = removeIndex;
-                m_entity_to_component_id.erase(entity);
+                m_entity_to_component_id.Set(lastEntity, removeIndex);
+                m_entity_to_component_id.Remove(entity);
                 m_component_to_entity_id[removeIndex] = lastEntity;
                 m_component_to_entity_id.pop_back();
             }
 
             T& GetByEntity(EntityID_t entity) {
 
-                auto componentIter = m_entity_to_component_id.find(entity);
-                if (componentIter == m_entity_to_component_id.end()) {
+                uint32_t index = m_entity_to_component_id.Get(entity);
+                if (index == SparseIndex::INVALID_INDEX) {
                     std::string componentName = std::string(typeid(T).name());
                     throw Exception("Entity " + std::to_string(entity) + " with component " + componentName +" not found.");
                 }
 
-                return m_components.at(componentIter->second);
+                return m_components[index];
+            }
+
+            bool Has(EntityID_t entity) const {
+                return m_entity_to_component_id.Has(entity);
             }
 
             size_t GetSize() const {
@@ -229,15 +285,45 @@ namespace ECS {
                 return m_components.at(index);
             }
 
+            //! Get the index of the component of an entity, or SparseIndex::INVALID_INDEX if it has none.
+            uint32_t GetIndex(EntityID_t entity) const {
+                return m_entity_to_component_id.Get(entity);
+            }
+
+            //! Get the packed components.
+            T* GetData() {
+                return m_components.data();
+            }
+
+            const T* GetData() const {
+                return m_components.data();
+            }
+
+            //! Get the entity of each packed component.
+            const std::vector<EntityID_t>& GetEntities() const {
+                return m_component_to_entity_id;
+            }
+
             void HandleEntityDestroyed(EntityID_t entity) override {
 
-                if (m_entity_to_component_id.find(entity) != m_entity_to_component_id.end()) {
+                if (m_entity_to_component_id.Has(entity)) {
                     Remove(entity);
                 }
             }
 
         private:
 
+            void CheckCanAdd(EntityID_t entity) const {
+
+                if (entity >= MAX_ENTITIES) {
+                    throw Exception("Entity ID " + std::to_string(entity) + " is out of range");
+                }
+
+                if (m_entity_to_component_id.Has(entity)) {
+                    throw Exception("Entity " + std::to_string(entity) + " already has component!");
+                }
+            }
+
             void Resize() {
 
                 size_t newSize = m_components.size();
@@ -256,7 +342,7 @@ namespace ECS {
             std::vector<EntityID_t> m_component_to_entity_id;
 
             //! map of entity to component IDs.
-            std::unordered_map<EntityID_t, size_t> m_entity_to_component_id;
+            SparseIndex m_entity_to_component_id;
     };
 
     class ComponentManager {
@@ -269,25 +355,30 @@ namespace ECS {
             template<typename T>
             void RegisterComponent() {
 
-                const char* p_type_name = typeid(T).name();
+                Core::TypeId_t typeId = ComponentTypeIds::Get<T>();
+                if ((typeId < m_component_types.size()) && (m_component_types[typeId] != UNREGISTERED_COMPONENT)) {
+                    throw Exception("Component type " + std::string(typeid(T).name()) + " already registered.");
+                }
 
                 if (m_component_arrays.size() == MAX_COMPONENTS) {
                     throw Exception("Already registered max number of component types. Consider increasing MAX_COMPONENTS.");
                 }
 
-                m_component_types[p_type_name] = m_component_arrays.size();
+                if (typeId >= m_component_types.size()) {
+                    m_component_types.resize(typeId + 1U, UNREGISTERED_COMPONENT);
+                }
+                m_component_types[typeId] = static_cast<ComponentType>(m_component_arrays.size());
                 m_component_arrays.emplace_back(std::make_unique<ComponentArray<T>>());
             }
 
             template<typename T>
             ComponentType GetComponentType() const
             {
-                const char* typeName = typeid(T).name();
-                auto typeIter = m_component_types.find(typeName);
-                if (typeIter == m_component_types.end()) {
-                    throw Exception("Could not find code for type " + std::string(typeName));
+                Core::TypeId_t typeId = ComponentTypeIds::Get<T>();
+                if ((typeId >= m_component_types.size()) || (m_component_types[typeId] == UNREGISTERED_COMPONENT)) {
+                    throw Exception("Could not find code for type " + std::string(typeid(T).name()));
                 }
-                return typeIter->second;
+                return m_component_types[typeId];
             }
 
             template<typename T>
@@ -308,29 +399,13 @@ namespace ECS {
 
             template<typename T>
             void RemoveComponent(EntityID_t entity) {
-
-                const char* typeName = typeid(T).name();
-                auto typeCodeIter = m_component_types.find(typeName);
-                if (typeCodeIter == m_component_types.end()) {
-
-                    throw Exception("Component type not registered for " + std::string(typeName));
-                }
-
-                ComponentArray<T>* array = GetComponentArray<T>(typeCodeIter->second);
+                ComponentArray<T>* array = GetComponentArray<T>(GetComponentType<T>());
                 array->Remove(entity);
             }
 
             template<typename T>
             T& GetComponent(EntityID_t entity) {
-
-                const char* typeName = typeid(T).name();
-                auto typeCodeIter = m_component_types.find(typeName);
-                if (typeCodeIter == m_component_types.end()) {
-
-                    throw Exception("Component type not registered for " + std::string(typeName));
-                }
-
-                ComponentArray<T>* array = GetComponentArray<T>(typeCodeIter->second);
+                ComponentArray<T>* array = GetComponentArray<T>(GetComponentType<T>());
                 return array->GetByEntity(entity);
             }
 
@@ -342,28 +417,369 @@ namespace ECS {
 
             template<typename T>
             ComponentArray<T>* GetComponentArray(ComponentType typecode) {
-                IComponentArray* p_array = m_component_arrays.at(typecode).get();
+                IComponentArray* p_array = m_component_arrays[typecode].get();
                 return static_cast<ComponentArray<T>*>(p_array);
             }
 
             template<typename T>
             const ComponentArray<T>* GetComponentArray(ComponentType typecode) const {
-                IComponentArray* p_array = m_component_arrays.at(typecode).get();
+                IComponentArray* p_array = m_component_arrays[typecode].get();
                 return static_cast<ComponentArray<T>*>(p_array);
             }
         private:
 
-            //! Map from type name to component type integer.
-            std::unordered_map<const char*, ComponentType> m_component_types;
+            //! Index of component types, assigned on first use rather than at registration.
+            using ComponentTypeIds = Core::TypeId<IComponentArray>;
+
+            //! Marks a type index with no registered component type.
+            static constexpr ComponentType UNREGISTERED_COMPONENT = MAX_COMPONENTS;
+
+            //! Component type integer of each type index, or UNREGISTERED_COMPONENT.
+            std::vector<ComponentType> m_component_types;
 
             //! Map from type name to a componenet array.
             std::vector<std::unique_ptr<IComponentArray>> m_component_arrays;
     };
 
+    //! @brief View of every entity that has a set of components, created by Registry::View().
+    //!
+    //! The view walks the packed entities of its smallest component array, and uses the entity signatures to skip
+    //! entities that are missing any of the other components, or that have an excluded component, before looking the
+    //! other components up in their sparse indices. Components listed as const are only given out as const references.
+    //!
+    //! Components of the viewed types must not be added or removed while walking the view, though other components
+    //! and entities can be.
+    template<typename... Component_t>
+    class ComponentView {
+
+            //! Component array of a component type, const if the component type is.
+            template<typename C>
+            using Array_t = std::conditional_t<
+                std::is_const_v<C>, const ComponentArray<std::remove_const_t<C>>, ComponentArray<C>>;
+
+        public:
+
+            static_assert(sizeof...(Component_t) > 0U, "A view needs at least one component type.");
+
+            //! What the view yields for each entity.
+            using Value_t = std::tuple<EntityID_t, Component_t&...>;
+
+            class Iterator {
+
+                public:
+
+                    Value_t operator*() const {
+                        return m_p_view->Get((*m_p_view->m_p_entities)[m_position]);
+                    }
+
+                    Iterator& operator++() {
+                        m_position++;
+                        SkipUnmatched();
+                        return *this;
+                    }
+
+                    bool operator==(const Iterator& other) const {
+                        return m_position == other.m_position;
+                    }
+
+                    bool operator!=(const Iterator& other) const {
+                        return m_position != other.m_position;
+                    }
+
+                private:
+
+                    friend class ComponentView;
+
+                    Iterator(const ComponentView& view, size_t position)
+                        : m_p_view(&view)
+                        , m_position(position) {
+                        SkipUnmatched();
+                    }
+
+                    void SkipUnmatched() {
+                        const std::vector<EntityID_t>& entities = *m_p_view->m_p_entities;
+                        while ((m_position < entities.size()) && !m_p_view->Matches(entities[m_position])) {
+                            m_position++;
+                        }
+                    }
+
+                    const ComponentView* m_p_view;
+                    size_t m_position;
+            };
+
+            ComponentView(
+                const std::array<Signature_t, MAX_ENTITIES>& signatures,
+                const Signature_t& include,
+                const Signature_t& exclude,
+                Array_t<Component_t>*... p_arrays)
+                : m_p_signatures(&signatures)
+                , m_include(include)
+                , m_mask(include | exclude)
+                , m_arrays(p_arrays...) {
+
+                // walk the smallest array, as every entity in the view is in all of them.
+                const std::vector<EntityID_t>* candidates[] = {&p_arrays->GetEntities()...};
+                m_p_entities = candidates[0];
+                for (const std::vector<EntityID_t>* p_candidate : candidates) {
+                    if (p_candidate->size() < m_p_entities->size()) {
+                        m_p_entities = p_candidate;
+                    }
+                }
+            }
+
+            Iterator begin() const {
+                return Iterator(*this, 0U);
+            }
+
+            Iterator end() const {
+                return Iterator(*this, m_p_entities->size());
+            }
+
+            //! Call func(entity, components...) for each entity in the view.
+            template<typename Func_t>
+            void ForEach(Func_t&& func) const {
+                ForEach(std::forward<Func_t>(func), std::index_sequence_for<Component_t...>());
+            }
+
+        private:
+
+            template<typename Func_t, size_t... Index>
+            void ForEach(Func_t&& func, std::index_sequence<Index...> /*unused*/) const {
+
+                const std::vector<EntityID_t>& entities = *m_p_entities;
+                for (size_t position = 0U; position < entities.size(); position++) {
+
+                    EntityID_t entity = entities[position];
+                    if (Matches(entity)) {
+                        func(entity, GetComponent<Index>(entity)...);
+                    }
+                }
+            }
+
+            //! Check if an entity has every included component, and no excluded one.
+            bool Matches(EntityID_t entity) const {
+                return ((*m_p_signatures)[entity] & m_mask) == m_include;
+            }
+
+            template<size_t Index>
+            auto& GetComponent(EntityID_t entity) const {
+                auto* p_array = std::get<Index>(m_arrays);
+                return p_array->GetData()[p_array->GetIndex(entity)];
+            }
+
+            Value_t Get(EntityID_t entity) const {
+                return Get(entity, std::index_sequence_for<Component_t...>());
+            }
+
+            template<size_t... Index>
+            Value_t Get(EntityID_t entity, std::index_sequence<Index...> /*unused*/) const {
+                return Value_t(entity, GetComponent<Index>(entity)...);
+            }
+
+            //! Signatures of every entity.
+            const std::array<Signature_t, MAX_ENTITIES>* m_p_signatures;
+
+            //! Signature of the included components.
+            Signature_t m_include;
+
+            //! Signature of the included and excluded components.
+            Signature_t m_mask;
+
+            //! Component array of each component type.
+            std::tuple<Array_t<Component_t>*...> m_arrays;
+
+            //! Entities of the smallest component array.
+            const std::vector<EntityID_t>* m_p_entities {nullptr};
+    };
+
+    //! Set of entities, stored as a sparse set.
+    //!
+    //! The entities are kept packed together in a dense array, in the order they were inserted, and a sparse array
+    //! indexed by entity ID holds the position of each one in the dense array. Insert, erase and lookup are constant
+    //! time, iterating reads the dense array in order, and both arrays are allocated up front for MAX_ENTITIES, so
+    //! changing the set never allocates.
+    //!
+    //! Entities can be inserted and erased while the set is being walked with ForEach(). Erased entities are left as
+    //! holes that are skipped, and packed away once the walk is over, and inserted entities are added after the end of
+    //! the walk, so the walk neither misses nor repeats an entity.
+    class EntitySet {
+
+        public:
+
+            //! Position of entities that are not in the set.
+            static constexpr uint32_t NOT_IN_SET = UINT32_MAX;
+
+            EntitySet()
+                : m_positions(MAX_ENTITIES, NOT_IN_SET) {
+                m_entities.reserve(MAX_ENTITIES);
+            }
+
+            //! Add an entity to the set. Returns false if it was already in the set.
+            bool Insert(EntityID_t entity) {
+                if (Contains(entity)) {
+                    return false;
+                }
+                m_positions.at(entity) = static_cast<uint32_t>(m_entities.size());
+                m_entities.push_back(entity);
+                return true;
+            }
+
+            //! Remove an entity from the set. Returns false if it was not in the set.
+            bool Erase(EntityID_t entity) {
+                if (!Contains(entity)) {
+                    return false;
+                }
+
+                uint32_t position = m_positions[entity];
+                m_positions[entity] = NOT_IN_SET;
+
+                if (m_walk_depth > 0U) {
+                    // leave a hole, rather than moving entities the walk has yet to reach.
+                    m_entities[position] = MAX_ENTITIES;
+                    m_num_holes++;
+                }
+                else {
+                    // move the last entity into the gap.
+                    EntityID_t last = m_entities.back();
+                    m_entities[position] = last;
+                    m_positions[last] = position;
+                    m_entities.pop_back();
+                }
+                return true;
+            }
+
+            //! Check whether an entity is in the set.
+            bool Contains(EntityID_t entity) const {
+                return (entity < MAX_ENTITIES) && (m_positions[entity] != NOT_IN_SET);
+            }
+
+            //! Get the number of entities in the set.
+            size_t GetSize() const {
+                return m_entities.size() - m_num_holes;
+            }
+
+            bool IsEmpty() const {
+                return GetSize() == 0U;
+            }
+
+            //! @brief Call func(entity) for each entity in the set, in the order they were inserted.
+            //!
+            //! The set may be changed by func. Entities erased before the walk reaches them are skipped, and entities
+            //! inserted during the walk are not visited.
+            template<typename Func_t>
+            void ForEach(Func_t&& func) {
+
+                const size_t end = m_entities.size();
+                m_walk_depth++;
+                try {
+                    for (size_t position = 0U; position < end; position++) {
+                        EntityID_t entity = m_entities[position];
+                        if (entity != MAX_ENTITIES) {
+                            func(entity);
+                        }
+                    }
+                }
+                catch (...) {
+                    EndWalk();
+                    throw;
+                }
+                EndWalk();
+            }
+
+        private:
+
+            //! Finish a walk, and pack the holes left by erased entities once no walk is in progress.
+            void EndWalk() {
+                m_walk_depth--;
+                if ((m_walk_depth > 0U) || (m_num_holes == 0U)) {
+                    return;
+                }
+
+                size_t packed = 0U;
+                for (EntityID_t entity : m_entities) {
+                    if (entity != MAX_ENTITIES) {
+                        m_positions[entity] = static_cast<uint32_t>(packed);
+                        m_entities[packed++] = entity;
+                    }
+                }
+                m_entities.resize(packed);
+                m_num_holes = 0U;
+            }
+
+            //! The entities, packed together, with MAX_ENTITIES marking holes left during a walk.
+            std::vector<EntityID_t> m_entities;
+
+            //! Position of each entity in m_entities, indexed by entity ID.
+            std::vector<uint32_t> m_positions;
+
+            //! Number of walks in progress, as ForEach() can be called from within ForEach().
+            uint32_t m_walk_depth {0U};
+
+            //! Number of holes in m_entities.
+            size_t m_num_holes {0U};
+    };
+
+    //! Threads that a system may be updated on.
+    enum class SystemAffinity {
+
+        //! Any thread of the thread pool, as well as the main thread.
+        ANY_THREAD,
+
+        //! Only the thread that calls Registry::Update(), for systems that use SDL or the GPU.
+        MAIN_THREAD
+    };
+
+    //! @brief Components that a system reads and writes in Update(), used to decide which systems can run at once.
+    //!
+    //! Until its access is declared, a system is assumed to touch everything, including creating and destroying
+    //! entities and adding and removing components, so it runs on the main thread with no other system running.
+    //! Systems that declare their access must only touch the components they declare, and must not create or destroy
+    //! entities, or add or remove components, as other systems may be running.
+    struct SystemAccess {
+        Signature_t reads;
+        Signature_t writes;
+        SystemAffinity affinity {SystemAffinity::MAIN_THREAD};
+        bool declared {false};
+
+        //! Check if two systems must not run at the same time.
+        bool ConflictsWith(const SystemAccess& other) const {
+            if (!declared || !other.declared) {
+                return true;
+            }
+            return (writes & (other.reads | other.writes)).any() || (other.writes & reads).any();
+        }
+    };
+
+    //! When and where a system was updated in a frame.
+    struct SystemTrace {
+        const char* p_name {nullptr};
+        std::thread::id thread;
+        uint32_t lane {0U};     //!< 0 for the main thread, then other threads in the order they first ran a system.
+        double start_ms {0.0};  //!< Time from the start of the frame that the update started.
+        double end_ms {0.0};    //!< Time from the start of the frame that the update finished.
+    };
+
+    //! Schedule that the systems ran to in a frame, to see how much of it ran in parallel.
+    struct ScheduleTrace {
+        uint64_t frame {0U};
+        double wall_ms {0.0};           //!< Time from the start of the first update to the end of the last.
+        double busy_ms {0.0};           //!< Total time spent in updates, on every thread.
+        uint32_t num_lanes {0U};        //!< Number of threads that ran a system.
+        std::vector<SystemTrace> systems; //!< Trace of each system, indexed by typecode.
+
+        //! Get the average number of systems running at once.
+        double GetParallelism() const {
+            return (wall_ms > 0.0) ? (busy_ms / wall_ms) : 1.0;
+        }
+    };
+
     class System {
 
         public:
             System(Core::Engine& engine) : m_p_engine(&engine) {};
+
+            //! Create a system that does not use the engine, such as in tests. GetEngine() must not be called.
+            System() : m_p_engine(nullptr) {};
             System(const System& other) = delete;
             System(System&& other) noexcept = default;
             System& operator=(const System& other) = delete;
@@ -374,16 +790,19 @@ namespace ECS {
             virtual void NotifyEntityDestroyed(EntityID_t entityID) {};
 
             Core::Engine& GetEngine() { return *m_p_engine;};
-            std::set<EntityID_t>& GetEntities() { return m_entities;};
+            EntitySet& GetEntities() { return m_entities;};
             Signature_t& GetSignature() {return m_signature;};
 
             SystemDependencies& GetDependencies() {return m_dependencies;};
 
+            SystemAccess& GetAccess() {return m_access;};
+
         private:
             Core::Engine* m_p_engine;
-            std::set<EntityID_t> m_entities;
+            EntitySet m_entities;
             Signature_t m_signature;
             SystemDependencies m_dependencies;
+            SystemAccess m_access;
     };
 
     class SystemManager {
@@ -410,7 +829,8 @@ namespace ECS {
             template<typename T>
             void RegisterSystem(std::unique_ptr<T>&& system) {
                 const char* typeName = typeid(T).name();
-                if (m_system_index.find(typeName) != m_system_index.end()) {
+                Core::TypeId_t typeId = SystemTypeIds::Get<T>();
+                if ((typeId < m_system_index.size()) && (m_system_index[typeId] != UNREGISTERED_SYSTEM)) {
                     std::stringstream errorMsg;
                     errorMsg << "System, " << typeName << " , already registered.";
                     throw Exception(errorMsg.str());
@@ -419,7 +839,11 @@ namespace ECS {
                     throw Exception("Already registered maximum number of systems. Consider increasing MAX_SYSTEMS");
                 }
 
-                m_system_index[typeName] = m_systems.size();
+                if (typeId >= m_system_index.size()) {
+                    m_system_index.resize(typeId + 1U, UNREGISTERED_SYSTEM);
+                }
+                m_system_index[typeId] = m_systems.size();
+                m_system_names.push_back(typeName);
                 m_systems.push_back(std::move(system));
 
                 m_update_run_order = true;
@@ -429,7 +853,7 @@ namespace ECS {
             T& GetSystem() {
                 SystemTypeCode_t typecode = GetTypeCode<T>();
 
-                return *dynamic_cast<T*>(m_systems.at(typecode).get());
+                return *static_cast<T*>(m_systems[typecode].get());
             }
 
             template<typename T>
@@ -451,12 +875,26 @@ namespace ECS {
                 SystemTypeCode_t typecode = GetTypeCode<T>();
 
                 m_systems.at(typecode)->GetDependencies() = dependencies;
+                m_update_run_order = true;
+            }
+
+            template<typename T>
+            void SetAccess(const SystemAccess& access) {
+                SystemTypeCode_t typecode = GetTypeCode<T>();
+
+                m_systems.at(typecode)->GetAccess() = access;
+                m_update_run_order = true;
+            }
+
+            //! Get the schedule of the last frame.
+            const ScheduleTrace& GetScheduleTrace() const {
+                return m_trace;
             }
 
             void EntityDestroyed(EntityID_t entity) {
 
                 for (auto& systemIter : m_systems) {
-                    systemIter->GetEntities().erase(entity);
+                    systemIter->GetEntities().Erase(entity);
                 }
             }
 
@@ -469,76 +907,345 @@ namespace ECS {
                     if (systemSignature.any()) {
 
                         if ((newSignature & systemSignature) == systemSignature) {
-                            p_system->GetEntities().insert(entity);
+                            p_system->GetEntities().Insert(entity);
                         }
                         else if ((oldSignature & systemSignature) == systemSignature) {
-                            p_system->GetEntities().erase(entity);
+                            p_system->GetEntities().Erase(entity);
                         }
                     }
                 }
             }
 
+            //! @brief Update every system, in parallel where their dependencies and component access allow.
+            //!
+            //! Systems run in the order of their dependencies. Two systems that do not depend on each other still run
+            //! one after the other if their access conflicts, in run order, so the result does not depend on timing.
+            //! Others may run at once on the thread pool, while the calling thread runs the systems that must be on
+            //! the main thread, and helps with the rest. The first exception thrown by a system is rethrown once every
+            //! system has run.
             void Update() {
                 if (m_update_run_order) {
+                    BuildSchedule();
+                }
+
+                Core::ThreadPool& pool = Core::ThreadPool::GetInstance();
+                m_frame_start = Clock_t::now();
+                m_trace.frame++;
+
+                if ((pool.GetWorkerCount() == 0U) || !m_has_parallel_systems) {
+                    for (SystemTypeCode_t typecode : m_run_order) {
+                        Clock_t::time_point start = Clock_t::now();
+                        m_systems[typecode]->Update();
+                        TraceSystem(typecode, start);
+                    }
+                }
+                else {
+                    RunParallel(pool);
+                }
+
+                FinishTrace();
+
+                if (m_p_schedule->error != nullptr) {
+                    std::rethrow_exception(std::exchange(m_p_schedule->error, nullptr));
+                }
+            }
+
+            template<typename T>
+            SystemTypeCode_t GetTypeCode() const {
+                Core::TypeId_t typeId = SystemTypeIds::Get<T>();
+                if ((typeId >= m_system_index.size()) || (m_system_index[typeId] == UNREGISTERED_SYSTEM)) {
+                    throw Exception("System, " + std::string(typeid(T).name()) + " not registered.");
+                }
+                return m_system_index[typeId];
+            }
+
+        private:
 
-                    Math::Graph<SystemTypeCode_t> systemGraph;
-                    std::vector<SystemTypeCode_t> typecodes;
-                    std::unordered_map<SystemTypeCode_t, const char*> names;
+            using Clock_t = std::chrono::steady_clock;
 
-                    typecodes.reserve(m_system_index.size());
-                    // Add nodes to graph
-                    for (auto& typecodeIter : m_system_index) {
+            //! State of the systems of the frame being run in parallel.
+            struct ScheduleState {
 
-                        systemGraph.AddNode(typecodeIter.second);
-                        typecodes.push_back(typecodeIter.second);
-                        names[typecodeIter.second] = typecodeIter.first;
+                //! Protects the rest of the state.
+                std::mutex mutex;
+
+                //! Signalled when a system finishes.
+                std::condition_variable changed;
+
+                //! Systems that can be run, as every system they wait for has finished.
+                std::deque<SystemTypeCode_t> ready;
+
+                //! Number of systems each system is still waiting for.
+                std::vector<uint32_t> waiting;
+
+                //! Number of systems that have finished.
+                size_t num_finished {0U};
+
+                //! Number of tasks submitted to the thread pool that have not finished.
+                size_t num_tasks {0U};
+
+                //! First exception thrown by a system.
+                std::exception_ptr error;
+            };
+
+            //! Sort the systems, and work out which must wait for which.
+            void BuildSchedule() {
+
+                // Systems are numbered by their typecode, and each dependency is an edge to the system that
+                // depends on it.
+                Math::CsrGraph<>::Builder systemGraph(m_systems.size());
+
+                for (SystemTypeCode_t typecode = 0U; typecode < m_systems.size(); typecode++) {
+
+                    const SystemDependencies& incoming = m_systems[typecode]->GetDependencies();
+                    for (SystemTypeCode_t dependency = 0U; dependency < m_systems.size(); dependency++) {
+                        if (incoming.test(dependency)) {
+
+                            systemGraph.AddEdge(
+                                static_cast<Math::GraphNode_t>(dependency),
+                                static_cast<Math::GraphNode_t>(typecode));
+                        }
                     }
+                }
 
-                    // Add edges to graph
-                    for (auto& typecodeIter : m_system_index) {
+                // Run topological sort to get a sorted list of typecodes
+                std::vector<Math::GraphNode_t> sorted = Math::TopologicalSort(systemGraph.Build());
+                m_run_order.assign(sorted.begin(), sorted.end());
 
-                        SystemDependencies incoming = m_systems.at(typecodeIter.second)->GetDependencies();
+                // systems that conflict also wait for each other, in run order, which keeps the graph acyclic.
+                m_has_parallel_systems = false;
+                for (size_t first = 0U; first < m_run_order.size(); first++) {
 
-                        for (SystemTypeCode_t dependency : typecodes) {
-                            if (incoming.test(dependency)) {
+                    const SystemAccess& access = m_systems[m_run_order[first]]->GetAccess();
+                    m_has_parallel_systems |= access.declared && (access.affinity == SystemAffinity::ANY_THREAD);
 
-                                systemGraph.AddTransition(dependency, typecodeIter.second);
-                            }
+                    for (size_t second = first + 1U; second < m_run_order.size(); second++) {
+                        if (access.ConflictsWith(m_systems[m_run_order[second]]->GetAccess())) {
+
+                            systemGraph.AddEdge(
+                                static_cast<Math::GraphNode_t>(m_run_order[first]),
+                                static_cast<Math::GraphNode_t>(m_run_order[second]));
                         }
                     }
+                }
+                m_schedule = systemGraph.Build();
 
-                    // Run topological sort to get a sorted list of typecodes
-                    m_run_order = Math::TopologicalSort(systemGraph);
+                m_num_waiting.assign(m_systems.size(), 0U);
+                for (SystemTypeCode_t typecode = 0U; typecode < m_systems.size(); typecode++) {
+                    for (Math::GraphNode_t next : m_schedule.GetNeighbors(static_cast<Math::GraphNode_t>(typecode))) {
+                        m_num_waiting[next]++;
+                    }
+                }
 
-                    std::stringstream msg;
-                    for (SystemTypeCode_t typecode : m_run_order) {
-                        msg << "    - " << names[typecode] << "\n";
+                m_p_schedule = std::make_unique<ScheduleState>();
+                m_trace.systems.assign(m_systems.size(), SystemTrace());
+                for (SystemTypeCode_t typecode = 0U; typecode < m_systems.size(); typecode++) {
+                    m_trace.systems[typecode].p_name = m_system_names[typecode];
+                }
+
+                std::stringstream msg;
+                for (SystemTypeCode_t typecode : m_run_order) {
+                    const SystemAccess& access = m_systems[typecode]->GetAccess();
+                    msg << "    - " << m_system_names[typecode];
+                    if (access.declared && (access.affinity == SystemAffinity::ANY_THREAD)) {
+                        msg << " (any thread)";
                     }
-                    Core::Logger::Info("System Run Order: \n" + msg.str());
-                    m_update_run_order = false;
+                    msg << "\n";
                 }
+                Core::Logger::Info("System Run Order: \n" + msg.str());
+                m_update_run_order = false;
+            }
 
-                for (SystemTypeCode_t typeCode : m_run_order) {
+            //! Run the systems of a frame on the calling thread and the thread pool.
+            void RunParallel(Core::ThreadPool& pool) {
 
-                    // can start adding parallelization here...
-                    m_systems.at(typeCode)->Update();
+                ScheduleState& state = *m_p_schedule;
+                state.waiting = m_num_waiting;
+                state.num_finished = 0U;
+
+                std::vector<SystemTypeCode_t> submit;
+                std::unique_lock<std::mutex> lock(state.mutex);
+                for (SystemTypeCode_t typecode : m_run_order) {
+                    if (state.waiting[typecode] == 0U) {
+                        MakeReady(typecode, submit);
+                    }
                 }
+                SubmitSystems(pool, submit);
+
+                while (state.num_finished < m_systems.size()) {
+
+                    // prefer systems that only the main thread can run, then help with the others.
+                    auto readyIter = std::find_if(
+                        state.ready.begin(), state.ready.end(), [this](SystemTypeCode_t code) {
+                            return !CanRunOnPool(code);
+                        });
+                    if ((readyIter == state.ready.end()) && !state.ready.empty()) {
+                        readyIter = state.ready.begin();
+                    }
+
+                    if (readyIter == state.ready.end()) {
+                        state.changed.wait(lock);
+                        continue;
+                    }
+
+                    SystemTypeCode_t typecode = *readyIter;
+                    state.ready.erase(readyIter);
+
+                    lock.unlock();
+                    RunSystem(pool, typecode);
+                    lock.lock();
+                }
+
+                // tasks for systems that the main thread ran itself may still be queued, and must not outlive the
+                // frame.
+                state.changed.wait(lock, [&state]() { return state.num_tasks == 0U; });
             }
 
-            template<typename T>
-            SystemTypeCode_t GetTypeCode() const {
-                const char* typeName = typeid(T).name();
-                auto typecodeIter = m_system_index.find(typeName);
-                if (typecodeIter == m_system_index.end()) {
-                    throw Exception("System, " + std::string(typeName) + " not registered.");
+            //! Check if a system can be run by the thread pool.
+            bool CanRunOnPool(SystemTypeCode_t typecode) const {
+                const SystemAccess& access = m_systems[typecode]->GetAccess();
+                return access.declared && (access.affinity == SystemAffinity::ANY_THREAD);
+            }
+
+            //! Add a system to the ready list, and to the systems to submit to the pool if it can run there. Must be
+            //! called with the schedule mutex held.
+            void MakeReady(SystemTypeCode_t typecode, std::vector<SystemTypeCode_t>& submit) {
+                m_p_schedule->ready.push_back(typecode);
+                if (CanRunOnPool(typecode)) {
+                    submit.push_back(typecode);
+                    m_p_schedule->num_tasks++;
                 }
-                return typecodeIter->second;
             }
 
-        private:
+            //! Submit a task for each ready system that can run on the pool. The task runs the system, unless another
+            //! thread took it from the ready list first.
+            void SubmitSystems(Core::ThreadPool& pool, std::vector<SystemTypeCode_t>& submit) {
+
+                for (SystemTypeCode_t typecode : submit) {
+                    pool.Submit([this, &pool, typecode]() {
+
+                        ScheduleState& state = *m_p_schedule;
+                        bool claimed = false;
+                        {
+                            std::lock_guard<std::mutex> lock(state.mutex);
+                            auto readyIter = std::find(state.ready.begin(), state.ready.end(), typecode);
+                            if (readyIter != state.ready.end()) {
+                                state.ready.erase(readyIter);
+                                claimed = true;
+                            }
+                        }
+
+                        if (claimed) {
+                            RunSystem(pool, typecode);
+                        }
+
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        state.num_tasks--;
+                        state.changed.notify_all();
+                    });
+                }
+                submit.clear();
+            }
+
+            //! Update a system, then release the systems waiting for it.
+            void RunSystem(Core::ThreadPool& pool, SystemTypeCode_t typecode) {
+
+                ScheduleState& state = *m_p_schedule;
+                Clock_t::time_point start = Clock_t::now();
+                try {
+                    m_systems[typecode]->Update();
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    if (state.error == nullptr) {
+                        state.error = std::current_exception();
+                    }
+                }
+                TraceSystem(typecode, start);
+
+                std::vector<SystemTypeCode_t> submit;
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    for (Math::GraphNode_t next : m_schedule.GetNeighbors(static_cast<Math::GraphNode_t>(typecode))) {
+                        if (--state.waiting[next] == 0U) {
+                            MakeReady(next, submit);
+                        }
+                    }
+                    state.num_finished++;
+                }
+                state.changed.notify_all();
+
+                SubmitSystems(pool, submit);
+            }
+
+            //! Record when and where a system ran, once it has finished.
+            void TraceSystem(SystemTypeCode_t typecode, Clock_t::time_point start) {
+
+                using Milliseconds_t = std::chrono::duration<double, std::milli>;
 
-            // System index
-            std::unordered_map<const char*, SystemTypeCode_t> m_system_index;
+                // each system only writes its own entry, so no lock is needed.
+                SystemTrace& trace = m_trace.systems[typecode];
+                trace.thread = std::this_thread::get_id();
+                trace.start_ms = Milliseconds_t(start - m_frame_start).count();
+                trace.end_ms = Milliseconds_t(Clock_t::now() - m_frame_start).count();
+            }
+
+            //! Number the threads of the frame trace, sum it up, and log it at trace level.
+            void FinishTrace() {
+
+                const std::thread::id mainThread = std::this_thread::get_id();
+                std::vector<std::thread::id> lanes = {mainThread};
+                std::vector<SystemTrace*> byStart;
+                for (SystemTrace& trace : m_trace.systems) {
+                    byStart.push_back(&trace);
+                }
+                std::sort(byStart.begin(), byStart.end(), [](const SystemTrace* p_lhs, const SystemTrace* p_rhs) {
+                    return p_lhs->start_ms < p_rhs->start_ms;
+                });
+
+                double firstStart = byStart.empty() ? 0.0 : byStart.front()->start_ms;
+                double lastEnd = firstStart;
+                m_trace.busy_ms = 0.0;
+                for (SystemTrace* p_trace : byStart) {
+
+                    auto laneIter = std::find(lanes.begin(), lanes.end(), p_trace->thread);
+                    p_trace->lane = static_cast<uint32_t>(laneIter - lanes.begin());
+                    if (laneIter == lanes.end()) {
+                        lanes.push_back(p_trace->thread);
+                    }
+
+                    m_trace.busy_ms += p_trace->end_ms - p_trace->start_ms;
+                    lastEnd = std::max(lastEnd, p_trace->end_ms);
+                }
+                m_trace.wall_ms = lastEnd - firstStart;
+                m_trace.num_lanes = static_cast<uint32_t>(lanes.size());
+
+                if (Core::Logger::GetLevel() < Core::Logger::Level::TRACE) {
+                    return;
+                }
+
+                std::stringstream msg;
+                msg << "System schedule, frame " << m_trace.frame << ": " << m_trace.wall_ms << " ms on "
+                    << m_trace.num_lanes << " threads, parallelism " << m_trace.GetParallelism() << "\n";
+                for (SystemTypeCode_t typecode : m_run_order) {
+                    const SystemTrace& trace = m_trace.systems[typecode];
+                    msg << "    - " << trace.p_name << ": thread " << trace.lane << ", " << trace.start_ms << " to "
+                        << trace.end_ms << " ms\n";
+                }
+                Core::Logger::Trace(msg.str());
+            }
+
+            // Index of system types, assigned on first use rather than at registration.
+            using SystemTypeIds = Core::TypeId<System>;
+
+            // Marks a type index with no registered system.
+            static constexpr SystemTypeCode_t UNREGISTERED_SYSTEM = MAX_SYSTEMS;
+
+            // System typecode of each type index, or UNREGISTERED_SYSTEM.
+            std::vector<SystemTypeCode_t> m_system_index;
+
+            // Type name of each system, for logging.
+            std::vector<const char*> m_system_names;
 
             // Map from system type string to system pointer.
             std::vector<std::unique_ptr<System>> m_systems;
@@ -547,7 +1254,25 @@ namespace ECS {
             bool m_update_run_order{true};
 
             // The order in which systems should be run.
-            std::list<SystemTypeCode_t> m_run_order;
+            std::vector<SystemTypeCode_t> m_run_order;
+
+            // Edges from each system to the systems that must wait for it, from dependencies and conflicting access.
+            Math::CsrGraph<> m_schedule;
+
+            // Number of systems that each system waits for.
+            std::vector<uint32_t> m_num_waiting;
+
+            // Whether any system can run on the thread pool.
+            bool m_has_parallel_systems {false};
+
+            // State of the systems while running a frame.
+            std::unique_ptr<ScheduleState> m_p_schedule;
+
+            // Schedule of the last frame.
+            ScheduleTrace m_trace;
+
+            // When the frame being run started.
+            Clock_t::time_point m_frame_start;
     };
 
     class Registry {
@@ -569,6 +1294,9 @@ namespace ECS {
             void DestroyEntity(EntityID_t entity) {
                 m_entity_manager.DestroyEntity(entity);
                 m_component_manager.EntityDestroyed(entity);
+                if (m_p_archetype_storage != nullptr) {
+                    m_p_archetype_storage->Erase(entity);
+                }
                 if (m_systemcallbacks_enabled) {
                     m_system_manager.EntityDestroyed(entity);
                 }
@@ -661,6 +1389,35 @@ namespace ECS {
                 return m_component_manager.GetComponentArray<T>(typecode);
             }
 
+            //! @brief View every entity that has all of a set of components.
+            //!
+            //! Component types listed as const are only given out as const references. Walk the view with a range-for,
+            //! which yields a tuple of the entity and references to its components, or with ComponentView::ForEach().
+            //!
+            //! @param[in] exclude Component types that entities in the view must not have.
+            template<typename... Component_t, typename... Excluded_t>
+            ComponentView<Component_t...> View(Exclude<Excluded_t...> /*exclude*/ = {}) {
+                return ComponentView<Component_t...>(
+                    m_entity_manager.GetSignatures(),
+                    (Signature_t() | ... | GetComponentSignature<std::remove_const_t<Component_t>>()),
+                    (Signature_t() | ... | GetComponentSignature<Excluded_t>()),
+                    GetViewArray<Component_t>()...);
+            }
+
+            //! @brief View every entity that has all of a set of components, which must all be const.
+            template<typename... Component_t, typename... Excluded_t>
+            ComponentView<Component_t...> View(Exclude<Excluded_t...> /*exclude*/ = {}) const {
+                static_assert(
+                    (std::is_const_v<Component_t> && ...),
+                    "Only const components can be viewed from a const registry.");
+
+                return ComponentView<Component_t...>(
+                    m_entity_manager.GetSignatures(),
+                    (Signature_t() | ... | GetComponentSignature<std::remove_const_t<Component_t>>()),
+                    (Signature_t() | ... | GetComponentSignature<Excluded_t>()),
+                    GetComponentArray<std::remove_const_t<Component_t>>()...);
+            }
+
             template<typename T>
             void RegisterSystem(std::unique_ptr<T>&& p_system) {
                 m_system_manager.RegisterSystem(std::move(p_system));
@@ -684,15 +1441,59 @@ namespace ECS {
                 m_system_manager.SetDependencies<Target>(dependencies);
             }
 
+            //! @brief Declare the components a system reads and writes in Update(), so that it can run at the same time
+            //!        as systems it does not conflict with.
+            //!
+            //! @param[in] reads    Components the system only reads.
+            //! @param[in] writes   Components the system writes.
+            //! @param[in] affinity Threads the system may run on.
+            template<typename T>
+            void SetSystemAccess(const Signature_t& reads, const Signature_t& writes, SystemAffinity affinity) {
+                SystemAccess access;
+                access.reads = reads;
+                access.writes = writes;
+                access.affinity = affinity;
+                access.declared = true;
+                m_system_manager.SetAccess<T>(access);
+            }
+
             void Update() {
                 m_system_manager.Update();
             }
 
+            //! @brief Get the archetype storage of the registry, creating it on first use.
+            //!
+            //! Components kept in archetype storage suit large populations that are walked chunk by chunk, rather than
+            //! by systems. They are registered and added through the storage, and erased when their entity is
+            //! destroyed. See ArchetypeStorage.
+            ArchetypeStorage& GetArchetypeStorage() {
+                if (m_p_archetype_storage == nullptr) {
+                    m_p_archetype_storage = std::make_unique<ArchetypeStorage>();
+                }
+                return *m_p_archetype_storage;
+            }
+
+            //! Get the schedule that the systems ran to in the last frame.
+            const ScheduleTrace& GetScheduleTrace() const {
+                return m_system_manager.GetScheduleTrace();
+            }
+
         private:
 
+            template<typename T>
+            auto* GetViewArray() {
+                using Component_t = std::remove_const_t<T>;
+                return m_component_manager.GetComponentArray<Component_t>(
+                    m_component_manager.GetComponentType<Component_t>());
+            }
+
             SystemManager m_system_manager;
             ComponentManager m_component_manager;
             EntityManager m_entity_manager;
+
+            //! Archetype storage, or null until it is first used.
+            std::unique_ptr<ArchetypeStorage> m_p_archetype_storage;
+
             bool m_systemcallbacks_enabled{true};
     };
 
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+
+namespace ECS {
+
+    // A simple type alias
+    using EntityID_t = uint32_t;
+
+    // Used to define the size of arrays later on
+    const EntityID_t MAX_ENTITIES = 10000;
+
+    // A simple type alias
+    using ComponentType = std::uint32_t;
+
+    // The maximum number of types of component
+    const ComponentType MAX_COMPONENTS = 32;
+
+    // Signature of an entity.
+    using Signature_t = std::bitset<MAX_COMPONENTS>;
+
+    // System type code
+    using SystemTypeCode_t = size_t;
+
+    // Maximum number of systems
+    const SystemTypeCode_t MAX_SYSTEMS = 256;
+
+    //! System Signature
+    using SystemDependencies = std::bitset<MAX_SYSTEMS>;
+
+    // Error type
+    class Exception : public std::exception {
+
+        public:
+            Exception(const std::string& msg)
+                : m_msg(msg) {
+            }
+
+            const char* what() const noexcept override {
+                return m_msg.c_str();
+            }
+
+        private:
+            std::string m_msg;
+    };
+
+    //! Lists component types that entities must not have to be part of a ComponentView.
+    template<typename... Component_t>
+    struct Exclude {};
+}
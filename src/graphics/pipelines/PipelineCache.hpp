@@ -1,9 +1,10 @@
 #pragma once
 
 #include "core/Engine.hpp"
+#include "core/TypeId.hpp"
 #include "sdl/SDL.hpp"
-#include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace Systems {
     class RenderSystem;
@@ -54,13 +55,12 @@ namespace Graphics {
             template<typename T>
             IPipeline* Build(Systems::RenderSystem& rendersys, const std::string& shaderpath) {
                 PipelineId_t pipelineId = NULL_PIPELINE;
-                const char* pipelineName = typeid(T).name();
+                Core::TypeId_t typeId = Core::TypeId<IPipeline>::Get<T>();
 
-                const auto& idIter = m_ids.find(pipelineName);
-                if (idIter != m_ids.end()) {
+                if ((typeId < m_ids.size()) && (m_ids[typeId] != NULL_PIPELINE)) {
 
                     // Pipeline is already built, no need to build again.
-                    pipelineId = idIter->second;
+                    pipelineId = m_ids[typeId];
                 }
                 else if (m_pipelines.size() < MAX_PIPELINES) {
 
@@ -68,7 +68,10 @@ namespace Graphics {
                     std::unique_ptr<IPipeline> pipeline = std::make_unique<T>();
                     pipeline->Build(rendersys, shaderpath);
                     pipelineId = m_pipelines.size();
-                    m_ids[pipelineName] = pipelineId;
+                    if (typeId >= m_ids.size()) {
+                        m_ids.resize(typeId + 1U, NULL_PIPELINE);
+                    }
+                    m_ids[typeId] = pipelineId;
                     m_pipelines.push_back(std::move(pipeline));
                 }
                 else {
@@ -79,7 +82,8 @@ namespace Graphics {
             }
 
         private:
-            std::unordered_map<const char*, PipelineId_t> m_ids;
+            //! Pipeline built for each pipeline type index, or NULL_PIPELINE.
+            std::vector<PipelineId_t> m_ids;
             std::vector<std::unique_ptr<IPipeline>> m_pipelines;
     };
 }
\ No newline at end of file
@@ -7,7 +7,9 @@
 #include "components/Text.hpp"
 #include "components/Transform.hpp"
 #include "components/Sprite.hpp"
+#include "core/AssetLoader.hpp"
 #include "core/Engine.hpp"
+#include "core/Environment.hpp"
 #include "core/Logger.hpp"
 #include "ecs/ECS.hpp"
 #include "systems/CreatureSystem.hpp"
@@ -16,6 +18,7 @@
 #include "systems/RenderSystem.hpp"
 #include "systems/SpriteSystem.hpp"
 #include "systems/TextSystem.hpp"
+#include "world/GenerationCheck.hpp"
 #include <exception>
 #include <memory>
 
@@ -32,6 +35,15 @@ int main(int argc, const char** argv) {
 
     try {
 
+        // check world generation without starting the engine, for use from scripts. See World::RunGenerationCheck().
+        Core::Environment environment(args);
+        const std::string& worldCheck = environment.Get("worldCheck");
+        if (!worldCheck.empty()) {
+            Core::AssetLoader assetLoader(environment.Get("gamePath"));
+            bool passed = World::RunGenerationCheck(assetLoader.GetDataDir() + "/world_digests.txt", worldCheck == "record");
+            return passed ? 0 : 1;
+        }
+
         std::unique_ptr<Core::Engine> p_engine = std::make_unique<Core::Engine>(args);
         Core::Engine::SetInstance(std::move(p_engine));
 
@@ -0,0 +1,428 @@
+#pragma once
+
+#include "core/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//! Directed graphs stored in compressed sparse row form, and the algorithms that run over them.
+//!
+//! The targets of every edge are kept in one array, grouped by the node the edges leave from, with a second array
+//! holding the offset of the first edge of each node. Visiting the neighbors of a node reads a single contiguous run of
+//! memory, and the whole graph is two or three allocations however many edges it has. Graphs are immutable once
+//! built, so they can be read from any number of threads at once.
+namespace Math {
+
+    //! Index of a node in a graph. Nodes are numbered from zero.
+    using GraphNode_t = uint32_t;
+
+    //! Marks a node that could not be reached, or that has no parent.
+    static constexpr GraphNode_t INVALID_GRAPH_NODE = std::numeric_limits<GraphNode_t>::max();
+
+    //! Number of frontier nodes expanded by each task of a parallel breadth first search.
+    static constexpr size_t GRAPH_BFS_GRAIN = 1024U;
+
+    //! A contiguous run of elements in one of the arrays of a graph.
+    template<typename T>
+    class GraphRange {
+
+        public:
+
+            GraphRange(T* p_begin, T* p_end)
+                : m_p_begin(p_begin)
+                , m_p_end(p_end) {
+            }
+
+            T* begin() const { return m_p_begin; }
+            T* end() const { return m_p_end; }
+            size_t size() const { return static_cast<size_t>(m_p_end - m_p_begin); }
+            bool empty() const { return m_p_begin == m_p_end; }
+            T& operator[](size_t index) const { return m_p_begin[index]; }
+
+        private:
+
+            T* m_p_begin;
+            T* m_p_end;
+    };
+
+    //! @brief A directed graph with a weight on every edge.
+    //!
+    //! Undirected graphs are stored with an edge in each direction.
+    //!
+    //! @tparam Weight_t Type of the edge weights.
+    template<typename Weight_t = float>
+    class CsrGraph {
+
+        public:
+
+            //! Collects edges in any order, and sorts them into a graph.
+            class Builder {
+
+                public:
+
+                    //! @brief Start a graph with a number of nodes, and no edges.
+                    explicit Builder(size_t num_nodes)
+                        : m_num_nodes(num_nodes) {
+                        if (num_nodes >= INVALID_GRAPH_NODE) {
+                            throw std::length_error("CsrGraph: too many nodes.");
+                        }
+                    }
+
+                    //! Reserve memory for a number of edges.
+                    void Reserve(size_t num_edges) {
+                        m_sources.reserve(num_edges);
+                        m_targets.reserve(num_edges);
+                        m_weights.reserve(num_edges);
+                    }
+
+                    //! @brief Add an edge from one node to another.
+                    //!
+                    //! Edges leaving a node keep the order they were added in.
+                    //!
+                    //! @throws std::out_of_range if either node is not in the graph.
+                    void AddEdge(GraphNode_t from, GraphNode_t to, Weight_t weight = Weight_t(1)) {
+                        if ((from >= m_num_nodes) || (to >= m_num_nodes)) {
+                            throw std::out_of_range("CsrGraph: edge between nodes that are not in the graph.");
+                        }
+                        m_sources.push_back(from);
+                        m_targets.push_back(to);
+                        m_weights.push_back(weight);
+                    }
+
+                    //! @brief Add an edge in both directions between two nodes.
+                    void AddUndirectedEdge(GraphNode_t node_a, GraphNode_t node_b, Weight_t weight = Weight_t(1)) {
+                        AddEdge(node_a, node_b, weight);
+                        AddEdge(node_b, node_a, weight);
+                    }
+
+                    //! @brief Build the graph, with a counting sort of the edges by the node they leave from.
+                    CsrGraph Build() const {
+
+                        CsrGraph graph;
+                        graph.m_offsets.assign(m_num_nodes + 1U, 0U);
+                        for (GraphNode_t source : m_sources) {
+                            graph.m_offsets[source + 1U]++;
+                        }
+                        std::partial_sum(graph.m_offsets.begin(), graph.m_offsets.end(), graph.m_offsets.begin());
+
+                        std::vector<size_t> next(graph.m_offsets.begin(), graph.m_offsets.end() - 1);
+                        graph.m_targets.resize(m_targets.size());
+                        graph.m_weights.resize(m_weights.size());
+                        for (size_t edge = 0U; edge < m_sources.size(); edge++) {
+                            const size_t slot = next[m_sources[edge]]++;
+                            graph.m_targets[slot] = m_targets[edge];
+                            graph.m_weights[slot] = m_weights[edge];
+                        }
+
+                        return graph;
+                    }
+
+                private:
+
+                    size_t m_num_nodes;
+                    std::vector<GraphNode_t> m_sources;
+                    std::vector<GraphNode_t> m_targets;
+                    std::vector<Weight_t> m_weights;
+            };
+
+            //! Create a graph with no nodes.
+            CsrGraph() : m_offsets(1U, 0U) {
+            }
+
+            //! @brief Build a graph from the list of neighbors of each node, with every weight set to one.
+            //!
+            //! @throws std::out_of_range if a neighbor is not in the graph.
+            template<typename Index_t>
+            static CsrGraph FromAdjacency(const std::vector<std::vector<Index_t>>& adjacency) {
+
+                Builder builder(adjacency.size());
+                size_t numEdges = 0U;
+                for (const std::vector<Index_t>& neighbors : adjacency) {
+                    numEdges += neighbors.size();
+                }
+                builder.Reserve(numEdges);
+
+                for (size_t node = 0U; node < adjacency.size(); node++) {
+                    for (Index_t neighbor : adjacency[node]) {
+                        builder.AddEdge(static_cast<GraphNode_t>(node), static_cast<GraphNode_t>(neighbor));
+                    }
+                }
+
+                return builder.Build();
+            }
+
+            //! Get the number of nodes.
+            size_t GetNumNodes() const {
+                return m_offsets.size() - 1U;
+            }
+
+            //! Get the number of edges.
+            size_t GetNumEdges() const {
+                return m_targets.size();
+            }
+
+            //! Get the number of edges leaving a node.
+            size_t GetDegree(GraphNode_t node) const {
+                return m_offsets[node + 1U] - m_offsets[node];
+            }
+
+            //! Get the nodes that the edges leaving a node lead to.
+            GraphRange<const GraphNode_t> GetNeighbors(GraphNode_t node) const {
+                return {m_targets.data() + m_offsets[node], m_targets.data() + m_offsets[node + 1U]};
+            }
+
+            //! Get the weights of the edges leaving a node, in the same order as GetNeighbors().
+            GraphRange<const Weight_t> GetWeights(GraphNode_t node) const {
+                return {m_weights.data() + m_offsets[node], m_weights.data() + m_offsets[node + 1U]};
+            }
+
+            //! @brief Build the graph with every edge reversed.
+            CsrGraph Transpose() const {
+
+                Builder builder(GetNumNodes());
+                builder.Reserve(GetNumEdges());
+                for (GraphNode_t node = 0U; node < GetNumNodes(); node++) {
+                    for (size_t edge = m_offsets[node]; edge < m_offsets[node + 1U]; edge++) {
+                        builder.AddEdge(m_targets[edge], node, m_weights[edge]);
+                    }
+                }
+
+                return builder.Build();
+            }
+
+        private:
+
+            //! Index of the first edge of each node, followed by the number of edges.
+            std::vector<size_t> m_offsets;
+
+            //! Node each edge leads to, and its weight.
+            std::vector<GraphNode_t> m_targets;
+            std::vector<Weight_t> m_weights;
+    };
+
+    //! @brief Find the number of edges on the shortest path to every node from the nearest of a set of sources.
+    //!
+    //! The search runs one level at a time, and large levels are split over the shared thread pool. The result does not
+    //! depend on how the work was split.
+    //!
+    //! @param[in] graph   The graph to search.
+    //! @param[in] sources Nodes to start from, at level zero.
+    //!
+    //! @returns The level of each node, or INVALID_GRAPH_NODE for nodes that cannot be reached.
+    template<typename Weight_t>
+    std::vector<GraphNode_t> BreadthFirstSearch(
+        const CsrGraph<Weight_t>& graph, const std::vector<GraphNode_t>& sources) {
+
+        const size_t numNodes = graph.GetNumNodes();
+        std::vector<std::atomic<GraphNode_t>> levels(numNodes);
+        for (std::atomic<GraphNode_t>& level : levels) {
+            level.store(INVALID_GRAPH_NODE, std::memory_order_relaxed);
+        }
+
+        std::vector<GraphNode_t> frontier;
+        for (GraphNode_t source : sources) {
+            if (levels.at(source).exchange(0U, std::memory_order_relaxed) == INVALID_GRAPH_NODE) {
+                frontier.push_back(source);
+            }
+        }
+
+        // each block of the frontier gathers the nodes it claims first into a list of its own. Whichever block claims
+        // a node, it is given the same level.
+        std::vector<std::vector<GraphNode_t>> blockFrontiers;
+        for (GraphNode_t level = 1U; !frontier.empty(); level++) {
+
+            const size_t numBlocks = (frontier.size() + GRAPH_BFS_GRAIN - 1U) / GRAPH_BFS_GRAIN;
+            blockFrontiers.resize(std::max(blockFrontiers.size(), numBlocks));
+
+            Core::ThreadPool& pool = Core::ThreadPool::GetInstance();
+            pool.ParallelFor(frontier.size(), GRAPH_BFS_GRAIN, [&](size_t begin, size_t end) {
+                std::vector<GraphNode_t>& next = blockFrontiers[begin / GRAPH_BFS_GRAIN];
+                next.clear();
+                for (size_t index = begin; index < end; index++) {
+                    for (GraphNode_t neighbor : graph.GetNeighbors(frontier[index])) {
+                        GraphNode_t unvisited = INVALID_GRAPH_NODE;
+                        if ((levels[neighbor].load(std::memory_order_relaxed) == INVALID_GRAPH_NODE) &&
+                            levels[neighbor].compare_exchange_strong(unvisited, level, std::memory_order_relaxed)) {
+                            next.push_back(neighbor);
+                        }
+                    }
+                }
+            });
+
+            frontier.clear();
+            for (size_t block = 0U; block < numBlocks; block++) {
+                frontier.insert(frontier.end(), blockFrontiers[block].begin(), blockFrontiers[block].end());
+            }
+        }
+
+        std::vector<GraphNode_t> result(numNodes);
+        for (size_t node = 0U; node < numNodes; node++) {
+            result[node] = levels[node].load(std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    //! @brief Order the nodes of a graph so that every edge leads from an earlier node to a later one.
+    //!
+    //! Uses Kahn's algorithm: https://en.wikipedia.org/wiki/Topological_sorting. Nodes that are free to go in any order
+    //! are kept in the order of their index.
+    //!
+    //! @throws std::runtime_error if the graph has a cycle.
+    template<typename Weight_t>
+    std::vector<GraphNode_t> TopologicalSort(const CsrGraph<Weight_t>& graph) {
+
+        const size_t numNodes = graph.GetNumNodes();
+        std::vector<size_t> inDegrees(numNodes, 0U);
+        for (GraphNode_t node = 0U; node < numNodes; node++) {
+            for (GraphNode_t neighbor : graph.GetNeighbors(node)) {
+                inDegrees[neighbor]++;
+            }
+        }
+
+        // the sorted nodes double as the queue of nodes whose incoming edges have all been removed.
+        std::vector<GraphNode_t> sorted;
+        sorted.reserve(numNodes);
+        for (GraphNode_t node = 0U; node < numNodes; node++) {
+            if (inDegrees[node] == 0U) {
+                sorted.push_back(node);
+            }
+        }
+
+        for (size_t next = 0U; next < sorted.size(); next++) {
+            for (GraphNode_t neighbor : graph.GetNeighbors(sorted[next])) {
+                if (--inDegrees[neighbor] == 0U) {
+                    sorted.push_back(neighbor);
+                }
+            }
+        }
+
+        if (sorted.size() != numNodes) {
+            throw std::runtime_error("TopologicalSort(): Graph has at least one cycle.");
+        }
+
+        return sorted;
+    }
+
+    //! @brief Split the nodes of a graph into groups connected by edges, ignoring the direction of the edges.
+    //!
+    //! @param[out] components Set to the component of each node. Components are numbered from zero, in the order of the
+    //!                        lowest node in each.
+    //!
+    //! @returns The number of components.
+    template<typename Weight_t>
+    size_t FindConnectedComponents(const CsrGraph<Weight_t>& graph, std::vector<GraphNode_t>& components) {
+
+        // union find, with every set rooted at its lowest node, so that the roots come out in order.
+        const size_t numNodes = graph.GetNumNodes();
+        std::vector<GraphNode_t> parents(numNodes);
+        std::iota(parents.begin(), parents.end(), 0U);
+
+        auto findRoot = [&parents](GraphNode_t node) {
+            while (parents[node] != node) {
+                parents[node] = parents[parents[node]];
+                node = parents[node];
+            }
+            return node;
+        };
+
+        for (GraphNode_t node = 0U; node < numNodes; node++) {
+            for (GraphNode_t neighbor : graph.GetNeighbors(node)) {
+                GraphNode_t rootA = findRoot(node);
+                GraphNode_t rootB = findRoot(neighbor);
+                if (rootA != rootB) {
+                    parents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+                }
+            }
+        }
+
+        components.resize(numNodes);
+        size_t numComponents = 0U;
+        for (GraphNode_t node = 0U; node < numNodes; node++) {
+            GraphNode_t root = findRoot(node);
+            components[node] = (root == node) ? static_cast<GraphNode_t>(numComponents++) : components[root];
+        }
+
+        return numComponents;
+    }
+
+    //! Shortest paths from a set of sources to every node of a graph.
+    template<typename Weight_t>
+    struct ShortestPaths {
+
+        //! Length of the shortest path to each node, or the largest weight for nodes that cannot be reached.
+        std::vector<Weight_t> distances;
+
+        //! Node before each node on its shortest path, or INVALID_GRAPH_NODE for sources and unreachable nodes.
+        std::vector<GraphNode_t> parents;
+
+        //! @brief Follow the parents back from a node to the source it was reached from.
+        //!
+        //! @returns The nodes from the source to the node inclusive, or nothing if the node cannot be reached.
+        std::vector<GraphNode_t> GetPath(GraphNode_t node) const {
+            std::vector<GraphNode_t> path;
+            if (distances.at(node) == std::numeric_limits<Weight_t>::max()) {
+                return path;
+            }
+            for (; node != INVALID_GRAPH_NODE; node = parents[node]) {
+                path.push_back(node);
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+    };
+
+    //! @brief Find the shortest paths to every node from the nearest of a set of sources, with Dijkstra's algorithm.
+    //!
+    //! @param[in] graph   The graph to search. Every weight must be zero or more.
+    //! @param[in] sources Nodes to start from, at distance zero.
+    template<typename Weight_t>
+    ShortestPaths<Weight_t> Dijkstra(const CsrGraph<Weight_t>& graph, const std::vector<GraphNode_t>& sources) {
+
+        using HeapEntry_t = std::pair<Weight_t, GraphNode_t>;
+
+        ShortestPaths<Weight_t> paths;
+        paths.distances.assign(graph.GetNumNodes(), std::numeric_limits<Weight_t>::max());
+        paths.parents.assign(graph.GetNumNodes(), INVALID_GRAPH_NODE);
+
+        std::vector<HeapEntry_t> heap;
+        for (GraphNode_t source : sources) {
+            paths.distances.at(source) = Weight_t(0);
+            heap.emplace_back(Weight_t(0), source);
+        }
+        std::make_heap(heap.begin(), heap.end(), std::greater<HeapEntry_t>());
+
+        while (!heap.empty()) {
+
+            std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry_t>());
+            const auto [distance, node] = heap.back();
+            heap.pop_back();
+
+            // nodes are pushed again whenever a shorter path is found, rather than updated in place.
+            if (distance > paths.distances[node]) {
+                continue;
+            }
+
+            GraphRange<const GraphNode_t> neighbors = graph.GetNeighbors(node);
+            GraphRange<const Weight_t> weights = graph.GetWeights(node);
+            for (size_t edge = 0U; edge < neighbors.size(); edge++) {
+                const Weight_t candidate = distance + weights[edge];
+                if (candidate < paths.distances[neighbors[edge]]) {
+                    paths.distances[neighbors[edge]] = candidate;
+                    paths.parents[neighbors[edge]] = node;
+                    heap.emplace_back(candidate, neighbors[edge]);
+                    std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry_t>());
+                }
+            }
+        }
+
+        return paths;
+    }
+}
@@ -17,4 +17,17 @@ namespace Math {
 
         return hash;
     }
+
+    uint64_t HashFNV1A64(const void* p_data, size_t size, uint64_t hash) {
+
+        static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+        const uint8_t* p_bytes = static_cast<const uint8_t*>(p_data);
+        for (size_t index = 0U; index < size; index++) {
+            hash = hash ^ p_bytes[index]; // NOLINT
+            hash *= FNV_PRIME;
+        }
+
+        return hash;
+    }
 }
\ No newline at end of file
@@ -1,8 +1,21 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace Math {
 
+    static constexpr uint64_t FNV1A64_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
     uint32_t HashFNV1A(const std::string& str);
+
+    //! @brief Compute the 64 bit FNV-1a hash of a block of memory.
+    //!
+    //! @param[in] p_data Pointer to the data to hash.
+    //! @param[in] size   Size of the data, in bytes.
+    //! @param[in] hash   Hash to continue from, so that several blocks can be hashed as one.
+    //!
+    //! @returns The hash.
+    uint64_t HashFNV1A64(const void* p_data, size_t size, uint64_t hash = FNV1A64_OFFSET_BASIS);
 }
\ No newline at end of file
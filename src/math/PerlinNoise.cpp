@@ -1,8 +1,9 @@
 #include "PerlinNoise.hpp"
+#include "Random.hpp"
 #include <glm/common.hpp>
 #include <glm/trigonometric.hpp>
 #include <algorithm>
-#include <random>
+#include <utility>
 
 namespace Math {
 
@@ -15,9 +16,12 @@ namespace Math {
             m_permutation_table[i] = static_cast<uint8_t>(i);
         }
 
-        // Shuffle using seeded random number generator
-        std::mt19937 rng(seed);
-        std::shuffle(m_permutation_table.begin(), m_permutation_table.begin() + TABLE_SIZE, rng);
+        // Fisher-Yates shuffle using the counter based generator, which gives the same table on every platform.
+        RandomStream rng(seed, PERMUTATION_STREAM);
+        for (int i = TABLE_SIZE - 1; i > 0; --i) {
+            int j = static_cast<int>(rng.Below(static_cast<uint64_t>(i), static_cast<uint32_t>(i + 1)));
+            std::swap(m_permutation_table[i], m_permutation_table[j]);
+        }
 
         // Duplicate the permutation table for wrapping
         for (int i = 0; i < TABLE_SIZE; ++i) {
@@ -64,6 +64,9 @@ namespace Math {
         private:
             static constexpr int TABLE_SIZE = 256;
 
+            //! Random number stream used for shuffling the permutation table.
+            static constexpr uint32_t PERMUTATION_STREAM = 0x5045524DU; // "PERM"
+
             //! Permutation table for noise generation
             std::vector<uint8_t> m_permutation_table;
 
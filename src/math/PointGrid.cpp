@@ -0,0 +1,116 @@
+#include "PointGrid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Math {
+
+    PointGrid::PointGrid(const std::vector<glm::vec2>& points)
+        : m_points(points) {
+
+        if (m_points.empty()) {
+            return;
+        }
+
+        glm::vec2 minimum = m_points.front();
+        glm::vec2 maximum = m_points.front();
+        for (const glm::vec2& point : m_points) {
+            minimum = glm::vec2(std::min(minimum.x, point.x), std::min(minimum.y, point.y));
+            maximum = glm::vec2(std::max(maximum.x, point.x), std::max(maximum.y, point.y));
+        }
+
+        // aim for about one point per cell.
+        glm::vec2 extent = maximum - minimum;
+        float area = std::max(extent.x, 1.0F) * std::max(extent.y, 1.0F);
+        m_cell_size = std::max(std::sqrt(area / static_cast<float>(m_points.size())), 1.0F);
+        m_origin = minimum;
+        m_dimensions = glm::ivec2(
+            static_cast<int32_t>(extent.x / m_cell_size) + 1,
+            static_cast<int32_t>(extent.y / m_cell_size) + 1);
+
+        // counting sort of the points into cells.
+        size_t numCells = static_cast<size_t>(m_dimensions.x) * static_cast<size_t>(m_dimensions.y);
+        std::vector<size_t> pointCells(m_points.size());
+        m_cell_offsets.assign(numCells + 1U, 0U);
+
+        for (size_t pointIndex = 0U; pointIndex < m_points.size(); pointIndex++) {
+            glm::ivec2 cell = GetCell(m_points[pointIndex]);
+            pointCells[pointIndex] = (static_cast<size_t>(cell.y) * m_dimensions.x) + cell.x;
+            m_cell_offsets[pointCells[pointIndex] + 1U]++;
+        }
+
+        for (size_t cell = 0U; cell < numCells; cell++) {
+            m_cell_offsets[cell + 1U] += m_cell_offsets[cell];
+        }
+
+        std::vector<uint32_t> cellFill(m_cell_offsets.begin(), m_cell_offsets.end() - 1);
+        m_cell_points.resize(m_points.size());
+        for (size_t pointIndex = 0U; pointIndex < m_points.size(); pointIndex++) {
+            m_cell_points[cellFill[pointCells[pointIndex]]++] = static_cast<int32_t>(pointIndex);
+        }
+    }
+
+    int32_t PointGrid::FindNearest(glm::vec2 position) const {
+
+        if (m_points.empty()) {
+            return -1;
+        }
+
+        glm::ivec2 center = GetCell(position);
+        float bestDistance = std::numeric_limits<float>::max();
+        int32_t bestIndex = -1;
+
+        int32_t maxRing = std::max(m_dimensions.x, m_dimensions.y);
+        for (int32_t ring = 0; ring <= maxRing; ring++) {
+
+            // every cell in later rings is at least this far away, so stop once something closer has been found.
+            // Strictly closer, since a point at the same distance with a lower index could still be in a later ring.
+            float ringDistance = static_cast<float>(ring - 1) * m_cell_size;
+            if ((ring > 0) && (bestIndex >= 0) && (bestDistance < ringDistance * ringDistance)) {
+                break;
+            }
+
+            int32_t minX = center.x - ring;
+            int32_t maxX = center.x + ring;
+            int32_t minY = center.y - ring;
+            int32_t maxY = center.y + ring;
+
+            for (int32_t cellY = std::max(minY, 0); cellY <= std::min(maxY, m_dimensions.y - 1); cellY++) {
+                bool isEdgeRow = (cellY == minY) || (cellY == maxY);
+                int32_t step = isEdgeRow ? 1 : (maxX - minX);
+                for (int32_t cellX = minX; cellX <= maxX; cellX += std::max(step, 1)) {
+                    if ((cellX >= 0) && (cellX < m_dimensions.x)) {
+                        SearchCell({cellX, cellY}, position, bestDistance, bestIndex);
+                    }
+                }
+            }
+        }
+
+        return bestIndex;
+    }
+
+    glm::ivec2 PointGrid::GetCell(glm::vec2 position) const {
+        glm::vec2 local = (position - m_origin) / m_cell_size;
+        return glm::ivec2(
+            std::clamp(static_cast<int32_t>(std::floor(local.x)), 0, m_dimensions.x - 1),
+            std::clamp(static_cast<int32_t>(std::floor(local.y)), 0, m_dimensions.y - 1));
+    }
+
+    void PointGrid::SearchCell(glm::ivec2 cell, glm::vec2 position, float& best_distance, int32_t& best_index) const {
+
+        size_t cellIndex = (static_cast<size_t>(cell.y) * m_dimensions.x) + cell.x;
+        for (uint32_t offset = m_cell_offsets[cellIndex]; offset < m_cell_offsets[cellIndex + 1U]; offset++) {
+
+            int32_t pointIndex = m_cell_points[offset];
+            float distanceX = position.x - m_points[pointIndex].x;
+            float distanceY = position.y - m_points[pointIndex].y;
+            float distanceSumSquare = (distanceX * distanceX) + (distanceY * distanceY);
+
+            if ((distanceSumSquare < best_distance) ||
+                ((distanceSumSquare == best_distance) && (pointIndex < best_index))) {
+                best_distance = distanceSumSquare;
+                best_index = pointIndex;
+            }
+        }
+    }
+}
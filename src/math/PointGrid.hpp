@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <glm/ext/vector_int2.hpp>
+#include <vector>
+
+namespace Math {
+
+    //! Uniform grid over a fixed set of points, for fast nearest point queries.
+    //!
+    //! The cell size is chosen so that each cell holds about one point, so a query only needs to check the cells near
+    //! the query position, rather than every point.
+    class PointGrid {
+
+        public:
+
+            PointGrid() = default;
+
+            //! @brief Build the grid.
+            //!
+            //! @param[in] points The points to index. The index of each point is returned by queries.
+            explicit PointGrid(const std::vector<glm::vec2>& points);
+
+            //! @brief Find the point nearest to a position.
+            //!
+            //! Gives the same result as a linear scan over every point. When several points are the same distance from the
+            //! position, the one with the lowest index is returned.
+            //!
+            //! @param[in] position The query position. May be outside of the bounds of the points.
+            //!
+            //! @returns The index of the nearest point, or -1 if there are no points.
+            int32_t FindNearest(glm::vec2 position) const;
+
+        private:
+
+            //! Get the cell containing a position, clamped to the grid.
+            glm::ivec2 GetCell(glm::vec2 position) const;
+
+            //! Check the points in a cell, and update the best point found so far.
+            void SearchCell(glm::ivec2 cell, glm::vec2 position, float& best_distance, int32_t& best_index) const;
+
+            //! Position of the north west corner of the grid.
+            glm::vec2 m_origin {0.0F, 0.0F};
+
+            //! Width and height of each cell.
+            float m_cell_size {1.0F};
+
+            //! Number of cells in each direction.
+            glm::ivec2 m_dimensions {0, 0};
+
+            //! Offset of the first point of each cell in m_cell_points. Has one more entry than there are cells.
+            std::vector<uint32_t> m_cell_offsets;
+
+            //! Indices of points, sorted by cell.
+            std::vector<int32_t> m_cell_points;
+
+            //! Copy of the points.
+            std::vector<glm::vec2> m_points;
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+
+//! Counter based random number generation.
+//!
+//! Unlike a sequential generator such as std::mt19937, each value is a pure function of (seed, stream, index). Any
+//! element can draw its random values without knowing how many values were drawn before it, so work can be split
+//! across threads, or processed in any order, and still produce identical results. Results are also identical across
+//! standard library implementations, which is not the case for the std distributions.
+//!
+//! The generator is a variant of Widynski's "Squares" counter based RNG, with the key derived from the seed and stream
+//! by a SplitMix64 finalizer.
+namespace Math {
+
+    //! Mix a 64-bit value, using the SplitMix64 finalizer.
+    inline uint64_t MixBits(uint64_t value) {
+        value ^= value >> 30U; // NOLINT
+        value *= 0xBF58476D1CE4E5B9ULL; // NOLINT
+        value ^= value >> 27U; // NOLINT
+        value *= 0x94D049BB133111EBULL; // NOLINT
+        value ^= value >> 31U; // NOLINT
+        return value;
+    }
+
+    //! Derive the key for a stream of random numbers.
+    //!
+    //! @param[in] seed   The seed, normally WorldParams::GetSeed().
+    //! @param[in] stream Identifies the use of the random numbers, so different uses of the same seed are uncorrelated.
+    inline uint64_t MakeRandomKey(uint64_t seed, uint32_t stream) {
+        // keys need high entropy in every byte, and must be odd.
+        return MixBits(MixBits(seed) ^ (static_cast<uint64_t>(stream) * 0x9E3779B97F4A7C15ULL)) | 1U; // NOLINT
+    }
+
+    //! @brief Get a random 32-bit value.
+    //!
+    //! @param[in] key   Key from MakeRandomKey()
+    //! @param[in] index The counter, e.g. the index of the element that the value is drawn for.
+    inline uint32_t RandomU32(uint64_t key, uint64_t index) {
+
+        uint64_t xValue = index * key;
+        uint64_t yValue = xValue;
+        uint64_t zValue = yValue + key;
+
+        xValue = (xValue * xValue) + yValue;
+        xValue = (xValue >> 32U) | (xValue << 32U); // NOLINT
+        xValue = (xValue * xValue) + zValue;
+        xValue = (xValue >> 32U) | (xValue << 32U); // NOLINT
+        xValue = (xValue * xValue) + yValue;
+        xValue = (xValue >> 32U) | (xValue << 32U); // NOLINT
+        return static_cast<uint32_t>(((xValue * xValue) + zValue) >> 32U); // NOLINT
+    }
+
+    //! A stream of random numbers, for when the seed and stream are fixed but the index varies.
+    class RandomStream {
+
+        public:
+
+            RandomStream(uint64_t seed, uint32_t stream)
+                : m_key(MakeRandomKey(seed, stream)) {
+            }
+
+            //! Get a random 32-bit value for an index.
+            uint32_t U32(uint64_t index) const {
+                return RandomU32(m_key, index);
+            }
+
+            //! Get a random float in [0, 1) for an index.
+            float Float(uint64_t index) const {
+                // use the top 24 bits, which is all a float can represent exactly.
+                return static_cast<float>(U32(index) >> 8U) * (1.0F / 16777216.0F); // NOLINT
+            }
+
+            //! Get a random float in [min, max) for an index.
+            float Range(uint64_t index, float min, float max) const {
+                return min + ((max - min) * Float(index));
+            }
+
+            //! Get a random integer in [0, bound) for an index. Returns 0 if bound is 0.
+            uint32_t Below(uint64_t index, uint32_t bound) const {
+                // multiply and shift, rather than modulo. The bias is negligible for the bounds used here.
+                return static_cast<uint32_t>((static_cast<uint64_t>(U32(index)) * bound) >> 32U); // NOLINT
+            }
+
+        private:
+
+            //! Key derived from the seed and stream.
+            uint64_t m_key;
+    };
+
+    //! Get a random 32-bit value for an element of a stream.
+    inline uint32_t RandomU32(uint64_t seed, uint32_t stream, uint64_t index) {
+        return RandomStream(seed, stream).U32(index);
+    }
+
+    //! Get a random float, uniformly distributed in [0, 1).
+    inline float RandomFloat(uint64_t seed, uint32_t stream, uint64_t index) {
+        return RandomStream(seed, stream).Float(index);
+    }
+
+    //! Get a random float, uniformly distributed in [min, max).
+    inline float RandomRange(uint64_t seed, uint32_t stream, uint64_t index, float min, float max) {
+        return RandomStream(seed, stream).Range(index, min, max);
+    }
+
+    //! Get a random integer in [0, bound). Returns 0 if bound is 0.
+    inline uint32_t RandomBelow(uint64_t seed, uint32_t stream, uint64_t index, uint32_t bound) {
+        return RandomStream(seed, stream).Below(index, bound);
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MATH_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define MATH_SIMD_SSE2 0
+#endif
+
+//! Minimal wrapper over 4-wide float vectors, used by inner loops that process rows of a grid.
+//!
+//! Uses SSE2 when the target supports it, and falls back to plain scalar code otherwise. Both paths give bit identical
+//! results, since each lane is computed with the same IEEE single precision operations.
+namespace Math::Simd {
+
+    //! Number of floats processed by each operation.
+    static constexpr size_t FLOAT4_WIDTH = 4U;
+
+#if MATH_SIMD_SSE2
+
+    struct Float4 {
+        __m128 value;
+    };
+
+    inline Float4 Load(const float* p_data) {
+        return {_mm_loadu_ps(p_data)};
+    }
+
+    inline void Store(float* p_data, Float4 vec) {
+        _mm_storeu_ps(p_data, vec.value);
+    }
+
+    inline Float4 Splat(float value) {
+        return {_mm_set1_ps(value)};
+    }
+
+    inline Float4 operator+(Float4 lhs, Float4 rhs) {
+        return {_mm_add_ps(lhs.value, rhs.value)};
+    }
+
+    inline Float4 operator-(Float4 lhs, Float4 rhs) {
+        return {_mm_sub_ps(lhs.value, rhs.value)};
+    }
+
+    inline Float4 operator*(Float4 lhs, Float4 rhs) {
+        return {_mm_mul_ps(lhs.value, rhs.value)};
+    }
+
+    inline Float4 operator/(Float4 lhs, Float4 rhs) {
+        return {_mm_div_ps(lhs.value, rhs.value)};
+    }
+
+    // clears the sign bit, as std::abs() does.
+    inline Float4 Abs(Float4 vec) {
+        return {_mm_andnot_ps(_mm_set1_ps(-0.0F), vec.value)};
+    }
+
+    inline Float4 Max(Float4 lhs, Float4 rhs) {
+        return {_mm_max_ps(lhs.value, rhs.value)};
+    }
+
+    inline Float4 Min(Float4 lhs, Float4 rhs) {
+        return {_mm_min_ps(lhs.value, rhs.value)};
+    }
+
+#else
+
+    struct Float4 {
+        float value[FLOAT4_WIDTH];
+    };
+
+    inline Float4 Load(const float* p_data) {
+        return {{p_data[0], p_data[1], p_data[2], p_data[3]}};
+    }
+
+    inline void Store(float* p_data, Float4 vec) {
+        std::copy(vec.value, vec.value + FLOAT4_WIDTH, p_data);
+    }
+
+    inline Float4 Splat(float value) {
+        return {{value, value, value, value}};
+    }
+
+    template<typename Op_t>
+    inline Float4 Apply(Float4 lhs, Float4 rhs, Op_t op) {
+        Float4 result;
+        for (size_t lane = 0U; lane < FLOAT4_WIDTH; lane++) {
+            result.value[lane] = op(lhs.value[lane], rhs.value[lane]);
+        }
+        return result;
+    }
+
+    inline Float4 operator+(Float4 lhs, Float4 rhs) {
+        return Apply(lhs, rhs, [](float left, float right) { return left + right; });
+    }
+
+    inline Float4 operator-(Float4 lhs, Float4 rhs) {
+        return Apply(lhs, rhs, [](float left, float right) { return left - right; });
+    }
+
+    inline Float4 operator*(Float4 lhs, Float4 rhs) {
+        return Apply(lhs, rhs, [](float left, float right) { return left * right; });
+    }
+
+    inline Float4 operator/(Float4 lhs, Float4 rhs) {
+        return Apply(lhs, rhs, [](float left, float right) { return left / right; });
+    }
+
+    inline Float4 Abs(Float4 vec) {
+        return Apply(vec, vec, [](float left, float /*right*/) { return std::abs(left); });
+    }
+
+    // operand order matches the SSE instructions, which return the second operand when either is NaN.
+    inline Float4 Max(Float4 lhs, Float4 rhs) {
+        return Apply(lhs, rhs, [](float left, float right) { return (left > right) ? left : right; });
+    }
+
+    inline Float4 Min(Float4 lhs, Float4 rhs) {
+        return Apply(lhs, rhs, [](float left, float right) { return (left < right) ? left : right; });
+    }
+
+#endif
+}
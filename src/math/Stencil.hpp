@@ -0,0 +1,147 @@
+#pragma once
+
+#include "core/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/ext/vector_uint2.hpp>
+#include <vector>
+
+//! Stencils run a kernel over every cell of a grid, with access to the neighbors of each cell.
+//!
+//! The grid is split into blocks, which run on the shared thread pool. Each row of a block is handed to the kernel
+//! together with the rows above and below it, copied into buffers padded with one cell on either side. The padding is
+//! filled in according to the edge mode, so a kernel can read all eight neighbors of every cell in the row without
+//! bounds checks, which keeps its inner loop free of branches, and lets it load runs of neighbors with Math::Simd.
+namespace Math {
+
+    //! How cells beyond the edge of the grid are read.
+    enum class StencilEdge : uint8_t {
+        CLAMP, //!< Repeat the nearest cell of the grid.
+        WRAP   //!< Take the cell from the opposite side of the grid.
+    };
+
+    //! Size of the blocks that a grid is split into, in cells. Each task processes a row of blocks.
+    static constexpr uint32_t STENCIL_BLOCK_WIDTH = 256U;
+    static constexpr uint32_t STENCIL_BLOCK_HEIGHT = 64U;
+
+    //! A row of a block, together with the rows above and below it. Each row is padded, so cells -1 to width are valid.
+    template<typename T>
+    struct StencilRow {
+        const T* p_north;       //!< Row above, starting at the first cell of the row.
+        const T* p_center;      //!< The row itself.
+        const T* p_south;       //!< Row below.
+        size_t first_index;     //!< Index of the first cell of the row in the grid.
+        glm::uvec2 first;       //!< Coordinate of the first cell of the row.
+        uint32_t width;         //!< Number of cells in the row.
+    };
+
+    //! Find the coordinate of a cell at most one cell beyond the edge of a grid.
+    inline size_t ResolveStencilCoordinate(int64_t coordinate, uint32_t size, StencilEdge edge) {
+        if (coordinate < 0) {
+            return (edge == StencilEdge::WRAP) ? size - 1U : 0U;
+        }
+        if (coordinate >= static_cast<int64_t>(size)) {
+            return (edge == StencilEdge::WRAP) ? 0U : size - 1U;
+        }
+        return static_cast<size_t>(coordinate);
+    }
+
+    //! @brief Copy the cells [min_x - 1, min_x + width] of a row into a padded buffer.
+    template<typename T>
+    void CopyStencilRow(const T* p_grid, glm::uvec2 extent, StencilEdge edge, int64_t y_coord, uint32_t min_x,
+                        uint32_t width, T* p_out) {
+
+        const T* p_row = p_grid + (ResolveStencilCoordinate(y_coord, extent.y, edge) * extent.x);
+        p_out[0] = p_row[ResolveStencilCoordinate(static_cast<int64_t>(min_x) - 1, extent.x, edge)];
+        std::copy(p_row + min_x, p_row + min_x + width, p_out + 1);
+        p_out[width + 1U] = p_row[ResolveStencilCoordinate(static_cast<int64_t>(min_x) + width, extent.x, edge)];
+    }
+
+    //! @brief Run a kernel for every row of a grid, in blocks on the shared thread pool.
+    //!
+    //! Blocks may run in any order, and at the same time. The kernel may only write the cells of its own row, and
+    //! must not write to the grid being read, since the rows of neighboring blocks are copied from it as they run.
+    //!
+    //! @param[in] p_grid Cells of the grid, row after row.
+    //! @param[in] extent Size of the grid, in cells.
+    //! @param[in] edge   How cells beyond the edge of the grid are read.
+    //! @param[in] kernel Function called with the StencilRow<T> of each row.
+    template<typename T, typename Kernel_t>
+    void ForEachStencilRow(const T* p_grid, glm::uvec2 extent, StencilEdge edge, const Kernel_t& kernel) {
+
+        if ((extent.x == 0U) || (extent.y == 0U)) {
+            return;
+        }
+
+        const size_t blocksX = (extent.x + STENCIL_BLOCK_WIDTH - 1U) / STENCIL_BLOCK_WIDTH;
+        const size_t blocksY = (extent.y + STENCIL_BLOCK_HEIGHT - 1U) / STENCIL_BLOCK_HEIGHT;
+        const size_t paddedWidth = static_cast<size_t>(STENCIL_BLOCK_WIDTH) + 2U;
+
+        Core::ThreadPool::GetInstance().ParallelFor(blocksX * blocksY, blocksX, [&](size_t begin, size_t end) {
+
+            std::vector<T> buffer(3U * paddedWidth);
+
+            for (size_t blockIndex = begin; blockIndex < end; blockIndex++) {
+
+                const uint32_t minX = static_cast<uint32_t>(blockIndex % blocksX) * STENCIL_BLOCK_WIDTH;
+                const uint32_t minY = static_cast<uint32_t>(blockIndex / blocksX) * STENCIL_BLOCK_HEIGHT;
+                const uint32_t width = std::min(extent.x - minX, STENCIL_BLOCK_WIDTH);
+                const uint32_t maxY = std::min(extent.y, minY + STENCIL_BLOCK_HEIGHT);
+
+                // the three rows rotate through the buffer, so each row of the grid is only copied once per block.
+                std::array<T*, 3> p_rows = {
+                    buffer.data(), buffer.data() + paddedWidth, buffer.data() + (2U * paddedWidth)};
+                CopyStencilRow(p_grid, extent, edge, static_cast<int64_t>(minY) - 1, minX, width, p_rows[0]);
+                CopyStencilRow(p_grid, extent, edge, minY, minX, width, p_rows[1]);
+
+                for (uint32_t yCoord = minY; yCoord < maxY; yCoord++) {
+
+                    CopyStencilRow(p_grid, extent, edge, static_cast<int64_t>(yCoord) + 1, minX, width, p_rows[2]);
+
+                    StencilRow<T> row {
+                        p_rows[0] + 1, p_rows[1] + 1, p_rows[2] + 1,
+                        (static_cast<size_t>(yCoord) * extent.x) + minX,
+                        {minX, yCoord},
+                        width};
+                    kernel(row);
+
+                    std::rotate(p_rows.begin(), p_rows.begin() + 1, p_rows.end());
+                }
+            }
+        });
+    }
+
+    //! @brief Run a kernel for every cell of a grid, with its four edge neighbors.
+    //!
+    //! @param[in] kernel Function called as kernel(index, center, neighbors), where neighbors holds the cells to the
+    //!                   west, east, north, and south, in that order.
+    template<typename T, typename Kernel_t>
+    void ApplyStencil4(const T* p_grid, glm::uvec2 extent, StencilEdge edge, const Kernel_t& kernel) {
+        ForEachStencilRow(p_grid, extent, edge, [&](const StencilRow<T>& row) {
+            for (ptrdiff_t xCoord = 0; xCoord < static_cast<ptrdiff_t>(row.width); xCoord++) {
+                const std::array<T, 4> neighbors = {
+                    row.p_center[xCoord - 1], row.p_center[xCoord + 1], row.p_north[xCoord], row.p_south[xCoord]};
+                kernel(row.first_index + static_cast<size_t>(xCoord), row.p_center[xCoord], neighbors);
+            }
+        });
+    }
+
+    //! @brief Run a kernel for every cell of a grid, with all eight of its neighbors.
+    //!
+    //! @param[in] kernel Function called as kernel(index, center, neighbors), where neighbors holds the cells to the
+    //!                   north west, north, north east, west, east, south west, south, and south east, in that order.
+    template<typename T, typename Kernel_t>
+    void ApplyStencil8(const T* p_grid, glm::uvec2 extent, StencilEdge edge, const Kernel_t& kernel) {
+        ForEachStencilRow(p_grid, extent, edge, [&](const StencilRow<T>& row) {
+            for (ptrdiff_t xCoord = 0; xCoord < static_cast<ptrdiff_t>(row.width); xCoord++) {
+                const std::array<T, 8> neighbors = {
+                    row.p_north[xCoord - 1], row.p_north[xCoord], row.p_north[xCoord + 1],
+                    row.p_center[xCoord - 1], row.p_center[xCoord + 1],
+                    row.p_south[xCoord - 1], row.p_south[xCoord], row.p_south[xCoord + 1]};
+                kernel(row.first_index + static_cast<size_t>(xCoord), row.p_center[xCoord], neighbors);
+            }
+        });
+    }
+}
@@ -4,10 +4,14 @@
  */
 
 #include "Voronoi.hpp"
+#include "PointGrid.hpp"
+#include "Random.hpp"
+#include "Stencil.hpp"
 #include "core/Engine.hpp"
 
 #include <glm/ext/vector_float2.hpp>
 #include <glm/geometric.hpp>
+#include <array>
 #include <random>
 #include <vector>
 #include <unordered_set>
@@ -31,12 +35,13 @@ std::vector<uint8_t> VoronoiGraph::ToPixels(glm::ivec2 resolution) {
     std::vector<size_t> owner(static_cast<size_t>(resolution.x) * static_cast<size_t>(resolution.y), -1);
 
     // assign ownership per pixel
+    PointGrid centroidGrid(m_centroids);
     for (int pixelY = 0; pixelY < resolution.y; ++pixelY) {
         for (int pixelX = 0; pixelX < resolution.x; ++pixelX) {
             const float worldX = (static_cast<float>(pixelX) + 0.5F) * pixelScale.x;
             const float worldY = (static_cast<float>(pixelY) + 0.5F) * pixelScale.y;
 
-            owner[(pixelY * resolution.x) + pixelX] = GetRegion({worldX, worldY});
+            owner[(pixelY * resolution.x) + pixelX] = static_cast<size_t>(centroidGrid.FindNearest({worldX, worldY}));
         }
     }
 
@@ -44,12 +49,13 @@ std::vector<uint8_t> VoronoiGraph::ToPixels(glm::ivec2 resolution) {
     pixels.resize(numPixels * 4U);
     const float maxDist = glm::length(m_canvasSize);
 
-    for (int pixelY = 0; pixelY < resolution.y; ++pixelY) {
-        for (int pixelX = 0; pixelX < resolution.x; ++pixelX) {
-            size_t idx = (static_cast<size_t>(pixelY) * static_cast<size_t>(resolution.x)) + static_cast<size_t>(pixelX);
-            size_t regionId = owner[idx];
+    // check 4-neighborhood for boundary. Pixels beyond the edge are clamped, so they never differ.
+    ApplyStencil4(owner.data(), glm::uvec2(resolution), StencilEdge::CLAMP,
+        [&](size_t idx, size_t regionId, const std::array<size_t, 4>& neighbors) {
 
             // compute world pos
+            const size_t pixelX = idx % static_cast<size_t>(resolution.x);
+            const size_t pixelY = idx / static_cast<size_t>(resolution.x);
             const float worldX = (static_cast<float>(pixelX) + 0.5F) * pixelScale.x;
             const float worldY = (static_cast<float>(pixelY) + 0.5F) * pixelScale.y;
 
@@ -61,25 +67,18 @@ std::vector<uint8_t> VoronoiGraph::ToPixels(glm::ivec2 resolution) {
             float norm = 1.0F - std::min(dist / std::max(1e-6F, maxDist), 1.0F); // NOLINT
             uint8_t gray = static_cast<uint8_t>(std::round(norm * 255.0F)); // NOLINT
 
-            // check 4-neighborhood for boundary, if neighbor region differs mark as black
-            bool isBoundary = false;
-            if (((pixelX > 0) && (owner[idx - 1] != regionId)) ||
-                ((pixelX + 1 < resolution.x) && (owner[idx + 1] != regionId)) ||
-                ((pixelY > 0) && (owner[idx - resolution.x] != regionId)) ||
-                ((pixelY + 1 < resolution.y) && (owner[idx + resolution.x] != regionId))) {
-                isBoundary = true;
-            }
+            bool isBoundary = (neighbors[0] != regionId) || (neighbors[1] != regionId) ||
+                              (neighbors[2] != regionId) || (neighbors[3] != regionId);
 
             uint8_t color = isBoundary ? 0 : gray;
-            uint8_t a = 255; // NOLINT set color transparent transparent
 
             size_t pixelOffset = idx * 4U;
             pixels[pixelOffset + 0] = color;
             pixels[pixelOffset + 1] = color;
             pixels[pixelOffset + 2] = color;
             pixels[pixelOffset + 3] = color;
-        }
-    }
+        });
+
     return pixels;
 }
 
@@ -109,7 +108,8 @@ VoronoiGraph VoronoiGenerator::Generate(
     int regionCount,
     const glm::ivec2& canvasSize,
     int sampleResolution,
-    uint32_t rngSeed) {
+    uint32_t rngSeed,
+    uint32_t rngStream) {
 
     VoronoiGraph out;
 
@@ -117,22 +117,19 @@ VoronoiGraph VoronoiGenerator::Generate(
         return out;
     }
 
-    std::mt19937 rng;
     if (rngSeed == 0U) {
         std::random_device random_device;
-        rng.seed(random_device());
+        rngSeed = random_device();
     }
-    else {
-        rng.seed(rngSeed);
-    }
-
-    std::uniform_real_distribution<float> uniform_dist_x(0.0F, static_cast<float>(canvasSize.x));
-    std::uniform_real_distribution<float> uniform_dist_y(0.0F, static_cast<float>(canvasSize.y));
 
-    std::vector<glm::vec2> seeds;
-    seeds.reserve(static_cast<size_t>(regionCount));
+    // each seed only depends on its own index, so seeds can be placed in any order.
+    RandomStream rng(rngSeed, rngStream);
+    std::vector<glm::vec2> seeds(static_cast<size_t>(regionCount));
     for (int i = 0; i < regionCount; ++i) {
-        seeds.push_back({uniform_dist_x(rng), uniform_dist_y(rng)});
+        uint64_t index = static_cast<uint64_t>(i) * 2U;
+        seeds[i] = {
+            rng.Range(index, 0.0F, static_cast<float>(canvasSize.x)),
+            rng.Range(index + 1U, 0.0F, static_cast<float>(canvasSize.y))};
     }
 
     // divide the canvas into a grid with the given resolution.
@@ -146,6 +143,8 @@ VoronoiGraph VoronoiGenerator::Generate(
     const float gridScaleX = static_cast<float>(canvasSize.x) / static_cast<float>(gridW);
     const float gridScaleY = static_cast<float>(canvasSize.y) / static_cast<float>(gridH);
 
+    PointGrid seedGrid(seeds);
+
     for (int gridY = 0; gridY < gridH; ++gridY) {
         for (int gridX = 0; gridX < gridW; ++gridX) {
 
@@ -154,51 +153,28 @@ VoronoiGraph VoronoiGenerator::Generate(
             const float gridCenterY = (static_cast<float>(gridY) + 0.5F) * gridScaleY;
 
             // find the closest seed to the center of the cell and assign ownership to grid.
-            owner[(gridY * gridW) + gridX] = GetClosestSeed(seeds, gridCenterX, gridCenterY);
+            owner[(gridY * gridW) + gridX] = seedGrid.FindNearest({gridCenterX, gridCenterY});
         }
     }
 
     std::unordered_map<int, std::unordered_set<int>> adjacencySet = CalculateAdjacency(owner, gridW, gridH);
 
     out.m_centroids = std::move(seeds);
-    out.m_adjacency.resize(out.m_centroids.size());
 
+    CsrGraph<>::Builder adjacency(out.m_centroids.size());
     for (auto &keyValue : adjacencySet) {
-        int regionId = keyValue.first;
-        const auto &neighborSet = keyValue.second;
-        std::vector<int> neighbors;
-        neighbors.reserve(neighborSet.size());
-        for (int neighborIdx : neighborSet) {
-            neighbors.push_back(neighborIdx);
+        GraphNode_t regionId = static_cast<GraphNode_t>(keyValue.first);
+        for (int neighborIdx : keyValue.second) {
+            adjacency.AddEdge(regionId, static_cast<GraphNode_t>(neighborIdx));
         }
-        out.m_adjacency[regionId] = std::move(neighbors);
     }
+    out.m_adjacency = adjacency.Build();
 
     out.m_canvasSize = canvasSize;
 
     return out;
 }
 
-int VoronoiGenerator::GetClosestSeed(const std::vector<glm::vec2>& seeds, float posX, float posY) {
-
-    float bestDist = std::numeric_limits<float>::max();
-    int bestIdx = -1;
-    for (int si = 0; si < static_cast<int>(seeds.size()); ++si) {
-
-        float distanceX = posX - seeds[si].x;
-        float distanceY = posY - seeds[si].y;
-        float distanceSumSquare = (distanceX*distanceX) + (distanceY*distanceY);
-
-        // note: we skip calculating the square root, since comparison of sum square will yield the same result.
-        if (distanceSumSquare < bestDist) {
-            bestDist = distanceSumSquare;
-            bestIdx = si;
-        }
-    }
-
-    return bestIdx;
-}
-
 std::unordered_map<int, std::unordered_set<int>> VoronoiGenerator::CalculateAdjacency(const std::vector<int>& owner, int gridW, int gridH) {
 
     std::unordered_map<int, std::unordered_set<int>> adjacencySet;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "CsrGraph.hpp"
 #include <glm/vec2.hpp>
 #include <glm/vec2.hpp>
 #include <vector>
@@ -12,7 +13,7 @@ namespace Math {
 
         public:
             std::vector<glm::vec2> m_centroids;
-            std::vector<std::vector<int>> m_adjacency;
+            Math::CsrGraph<> m_adjacency;
             glm::vec2 m_canvasSize{0.0F, 0.0F};
 
             //! Create pixel array from the graph to use for displaying on texture.
@@ -31,20 +32,22 @@ namespace Math {
         public:
 
 
+            //! @brief Scatter seeds over the canvas, and build the graph of regions around them.
+            //!
+            //! @param[in] regionCount      The number of regions.
+            //! @param[in] canvasSize       The size of the canvas.
+            //! @param[in] sampleResolution The resolution of the grid used to determine adjacency.
+            //! @param[in] rngSeed          Seed for placing seeds. Zero picks a random seed.
+            //! @param[in] rngStream        Random number stream, so that graphs built from the same seed differ.
             static VoronoiGraph Generate(
                 int regionCount,
                 const glm::ivec2& canvasSize,
                 int sampleResolution,
-                uint32_t rngSeed);
+                uint32_t rngSeed,
+                uint32_t rngStream = 0U);
 
         private:
 
-            //! Find the closest seed to a point.
-            static int GetClosestSeed(
-                const std::vector<glm::vec2>& seeds,
-                float posX,
-                float posY);
-
             //! Find adjacency for each region
             static std::unordered_map<int, std::unordered_set<int>> CalculateAdjacency(
                 const std::vector<int>& owner,
@@ -38,6 +38,9 @@ CreateWorldMenu::CreateWorldMenu(Core::Engine& engine, MenuManager& manager, std
     : m_p_engine(&engine)
     , m_p_manager(&manager)
     , m_p_style(std::move(p_style)) {
+
+    // large worlds are paged to a file, which should be on disk rather than in a temporary directory held in memory.
+    m_world_parameters.SetOutOfCoreDirectory(engine.GetUserSaveDir());
 }
 
 void CreateWorldMenu::Activate() {
@@ -62,7 +65,8 @@ void CreateWorldMenu::Activate() {
         m_p_style,
         overlaySelection,
         "Overlay",
-        {"Tectonic Plates", "Height Map", "Water Map", "Heat Map", "Moisture Map", "Biome Map"},
+        {"Tectonic Plates", "Height Map", "Water Map", "Heat Map", "Moisture Map", "Biome Map", "Basin Map",
+         "Weather Map", "Snow Map"},
         static_cast<size_t>(m_selected_overlay),
         [this](size_t selection){
             this->SetOverlay(static_cast<World::OverlayType>(selection));
@@ -76,11 +80,23 @@ void CreateWorldMenu::Activate() {
 void CreateWorldMenu::Deactivate() {
     m_entity = ECS::Entity();
     m_sprite = ECS::Entity();
-    m_p_world = nullptr;
+    m_p_overlay_texture = nullptr;
+    m_p_simulation = nullptr;
     m_selected_overlay = World::OverlayType::PLATE_TECTONICS;
     m_p_done_button = nullptr;
 }
 
+void CreateWorldMenu::Update() {
+
+    // overlays of the climate follow the simulation, and are drawn again after each tick.
+    if ((m_p_simulation != nullptr) && ((m_selected_overlay == World::OverlayType::WEATHER_MAP) ||
+                                        (m_selected_overlay == World::OverlayType::SNOW_MAP))) {
+        if (m_p_simulation->GetSnapshot()->version != m_overlay_version) {
+            DrawOverlay();
+        }
+    }
+}
+
 
 void CreateWorldMenu::BuildCustomizationPanel(UI::Element& panelRoot) {
 
@@ -103,14 +119,15 @@ void CreateWorldMenu::BuildCustomizationPanel(UI::Element& panelRoot) {
     });
     seedInput.InsertText(Core::SeedWords::ChooseRandomSeedWord());
 
-    // Configure World Size (Tiles)
+    // Configure World Size (Tiles). Worlds of 4096x4096 and up are generated out of core.
     AddSliderSelection(
         m_p_style,
         widgetList,
         "World Size",
-        {"Small (64x64)", "Medium (128x128)", "Large (256x256)", "Huge (512x512)"},
+        {"Small (64x64)", "Medium (128x128)", "Large (256x256)", "Huge (512x512)", "Vast (1024x1024)",
+         "Immense (2048x2048)", "Colossal (4096x4096)", "Planetary (8192x8192)"},
         3, [this](size_t selection){
-        this->m_world_parameters.SetDimension(64 << selection);
+        this->m_world_parameters.SetDimension(static_cast<size_t>(64U) << selection);
     });
 
     // Configure number of continents. Determines the number of continental plates to generate.
@@ -145,8 +162,29 @@ void CreateWorldMenu::BuildCustomizationPanel(UI::Element& panelRoot) {
             this->m_world_parameters.SetRegionSize(4 << selection);
         }
     );
+    // Configure the tectonic simulation. More steps move the plates the same distance in finer increments.
+    AddSliderSelection(
+        m_p_style,
+        widgetList,
+        "Tectonic Simulation",
+        {"Off", "100 Steps", "200 Steps", "400 Steps"},
+        0U,
+        [this](size_t selection) {
+            this->m_world_parameters.SetTectonicSteps((selection == 0U) ? 0U : (static_cast<size_t>(50U) << selection));
+        }
+    );
+    // Configure the climate. Simulating the atmosphere carries rain in from the ocean on the prevailing winds.
+    AddSliderSelection(
+        m_p_style,
+        widgetList,
+        "Atmosphere",
+        {"Off", "On"},
+        0U,
+        [this](size_t selection) {
+            this->m_world_parameters.SetSimulateAtmosphere(selection != 0U);
+        }
+    );
     // Configure Temperature
-    // Configure Rainfall
 
     // Civilization generation
 
@@ -184,8 +222,13 @@ void CreateWorldMenu::BuildNavigationPanel(UI::Element& panelRoot) {
 
 void CreateWorldMenu::GenerateWorld() {
 
-    m_p_world = std::move(World::WorldGenerator::Generate(m_world_parameters));
+    // the previous world is let go of first, so that both are not held at once.
+    m_p_simulation = nullptr;
+    m_p_simulation = std::make_unique<World::WorldSimulation>(World::WorldGenerator::Generate(m_world_parameters));
+    m_p_simulation->Start(PREVIEW_TICKS_PER_SECOND);
 
+    // the new world may be a different size, so it gets a new texture.
+    m_p_overlay_texture = nullptr;
     SetOverlay(m_selected_overlay);
 
     m_p_done_button->SetButtonState(UI::ButtonState::ENABLED);
@@ -193,11 +236,28 @@ void CreateWorldMenu::GenerateWorld() {
 
 void CreateWorldMenu::SetOverlay(World::OverlayType selection) {
 
-    if (m_p_world) {
-        uint32_t width = m_world_parameters.GetDimension();
-        uint32_t height = width;
-        // now generate image
-        std::vector<uint8_t> pixels = World::MapOverlay::GetOverlay(*m_p_world, selection);
+    m_selected_overlay = selection;
+    if (m_p_simulation) {
+        DrawOverlay();
+    }
+}
+
+void CreateWorldMenu::DrawOverlay() {
+
+    const World::World& world = m_p_simulation->GetWorld();
+    uint32_t width = world.GetParameters().GetDimension();
+    uint32_t height = width;
+
+    // now generate image. The snapshot is released before the texture is uploaded, so that it does not hold up the
+    // simulation.
+    std::vector<uint8_t> pixels;
+    {
+        Core::DoubleBuffer<World::WorldSnapshot>::ReadHandle snapshot = m_p_simulation->GetSnapshot();
+        pixels = World::MapOverlay::GetOverlay(world, *snapshot, m_selected_overlay);
+        m_overlay_version = snapshot->version;
+    }
+
+    if (m_p_overlay_texture == nullptr) {
 
         Systems::RenderSystem& renderSystem = m_p_engine->GetEcsRegistry().GetSystem<Systems::RenderSystem>();
         SDL_GPUSamplerCreateInfo samplerInfo = {};
@@ -214,27 +274,25 @@ void CreateWorldMenu::SetOverlay(World::OverlayType selection) {
         std::shared_ptr<SDL::GpuSampler> p_sampler = std::make_shared<SDL::GpuSampler>(
             renderSystem.CreateSampler(samplerInfo));
 
-        std::shared_ptr<Graphics::Texture2D> texture = std::make_shared<Graphics::Texture2D>(
+        m_p_overlay_texture = std::make_shared<Graphics::Texture2D>(
             *m_p_engine,
             std::move(p_sampler),
             width,
             height,
             true);
 
-        texture->LoadImageData(pixels, width, height);
-
         // Create the sprite entity.
         m_sprite = ECS::Entity(m_p_engine->GetEcsRegistry());
 
         Components::Sprite& sprite = m_sprite.EmplaceComponent<Components::Sprite>();
-        sprite.texture = texture;
+        sprite.texture = m_p_overlay_texture;
         sprite.layer = Components::RenderLayer::LAYER_3D_OPAQUE;
 
         m_sprite.EmplaceComponent<Components::Transform>()
             .Translate({0.0F, 0.0F, -1.0F});
     }
 
-    m_selected_overlay = selection;
+    m_p_overlay_texture->LoadImageData(pixels, width, height);
 }
 
 }
@@ -242,5 +300,5 @@ void CreateWorldMenu::SetOverlay(World::OverlayType selection) {
 
 void Menu::CreateWorldMenu::SaveWorld() {
 
-    World::SaveWorldToFile( *m_p_world);
+    World::SaveWorldToFile(m_p_simulation->GetWorld());
 }
\ No newline at end of file
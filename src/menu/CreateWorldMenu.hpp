@@ -6,22 +6,33 @@
 #include "ui/Button.hpp"
 #include "ui/Element.hpp"
 #include "ui/Style.hpp"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 #include "world/MapOverlay.hpp"
 #include "world/World.hpp"
 #include "world/WorldGenerator.hpp"
+#include "world/WorldSimulation.hpp"
+
+namespace Graphics {
+    class Texture2D;
+}
 
 namespace Menu {
 
 class CreateWorldMenu : public Menu::IMenu {
 
     public:
+        //! Rate the climate of a generated world is previewed at, so that the overlays of the simulation show the
+        //! seasons go by.
+        static constexpr float PREVIEW_TICKS_PER_SECOND = 10.0F;
+
         CreateWorldMenu(Core::Engine& engine, MenuManager& manager, std::shared_ptr<UI::Style> p_style);
 
         void Activate() override;
         void Deactivate() override;
+        void Update() override;
 
         void BuildCustomizationPanel(UI::Element& panelRoot);
         void BuildNavigationPanel(UI::Element& panelRoot);
@@ -31,6 +42,9 @@ class CreateWorldMenu : public Menu::IMenu {
         void GenerateWorld();
         void SetOverlay(World::OverlayType selection);
 
+        //! Draw the selected overlay to the overlay texture, creating the texture and its sprite if there is none.
+        void DrawOverlay();
+
         void SaveWorld();
 
         Core::Engine* m_p_engine;
@@ -43,9 +57,14 @@ class CreateWorldMenu : public Menu::IMenu {
 
         ECS::Entity m_sprite;
 
-        std::unique_ptr<World::World> m_p_world;
+        //! The generated world, simulated so that overlays of its climate can be previewed.
+        std::unique_ptr<World::WorldSimulation> m_p_simulation;
         World::OverlayType m_selected_overlay {World::OverlayType::BIOME_MAP};
 
+        //! Texture the overlay is drawn to, and the version of the snapshot it was drawn from.
+        std::shared_ptr<Graphics::Texture2D> m_p_overlay_texture;
+        uint64_t m_overlay_version {0U};
+
         UI::Button* m_p_done_button {nullptr};
 
 };
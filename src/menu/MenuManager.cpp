@@ -78,6 +78,10 @@ void Menu::MenuManager::Update() {
 
         m_request_prev = false;
     }
+
+    if (m_p_active != nullptr) {
+        m_p_active->Update();
+    }
 }
 
 void Menu::MenuManager::SetTitle(const std::string& name) {
@@ -18,6 +18,9 @@ namespace Menu {
 
             virtual void Activate() = 0;
             virtual void Deactivate() = 0;
+
+            //! Make any updates for frame, while the menu is active.
+            virtual void Update() {}
     };
 
     //! Menu manager is responsible for activating and transitioning between various game menus.
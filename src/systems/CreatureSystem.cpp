@@ -30,13 +30,13 @@ void Systems::CreatureSystem::Update() {
     ECS::Registry& registry = GetEngine().GetEcsRegistry();
     Systems::InventorySystem& inventorySystem = registry.GetSystem<Systems::InventorySystem>();
 
-    std::set<ECS::EntityID_t>& entities = GetEntities();
-    if (!entities.empty()) {
+    ECS::EntitySet& entities = GetEntities();
+    if (!entities.IsEmpty()) {
 
-        for (const ECS::EntityID_t& entityID : entities) {
-
-            Components::Transform& transform = registry.GetComponent<Components::Transform>(entityID);
-            Components::CreatureInstance& creature = registry.GetComponent<Components::CreatureInstance>(entityID);
+        registry.View<const Components::Transform, Components::CreatureInstance>().ForEach([&](
+            ECS::EntityID_t /*entityID*/,
+            const Components::Transform& transform,
+            Components::CreatureInstance& creature) {
 
             const Creature::Variant& variant = creature.m_p_species->m_variants.at(creature.m_variant_id);
 
@@ -157,7 +157,7 @@ void Systems::CreatureSystem::Update() {
                     renderable.m_p_pipeline = m_skeletal_mesh_pipeline;
                 }
             }
-        }
+        });
     }
 }
 
@@ -51,12 +51,12 @@ void Systems::GuiSystem::Update() {
         }
     }
 
-    std::set<ECS::EntityID_t> entities = GetEntities();
+    ECS::EntitySet& entities = GetEntities();
 
     // Event processing is only routed to the highest priority canvas. (where the depth value is used as a priority)
     // First, we need to find that canvas. This prevents buttons underneath a drop-down menu from being able to be selected.
     Components::Canvas* p_highestPriority = nullptr;
-    for (ECS::EntityID_t entityID : entities) {
+    entities.ForEach([&](ECS::EntityID_t entityID) {
 
         if (registry.HasComponent<Components::Canvas>(entityID)) {
 
@@ -65,14 +65,14 @@ void Systems::GuiSystem::Update() {
                 p_highestPriority = &canvas;
             }
         }
-    }
+    });
 
     if (p_highestPriority != nullptr) {
         ProcessCanvas(*p_highestPriority, events);
     }
 
     // Once we have processed events we are ready to update graphics
-    for (ECS::EntityID_t entityID : entities) {
+    entities.ForEach([&](ECS::EntityID_t entityID) {
 
         if (registry.HasComponent<Components::Canvas>(entityID)) {
 
@@ -84,7 +84,7 @@ void Systems::GuiSystem::Update() {
 
             canvas.UpdateGraphics(registry, m_window_size_px, 1U);
         }
-    }
+    });
 }
 
 void Systems::GuiSystem::NotifyEntityDestroyed(ECS::EntityID_t entityID) {
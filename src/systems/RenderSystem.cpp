@@ -347,16 +347,16 @@ std::list<Components::Renderable*> Systems::RenderSystem::SortDrawCalls() {
     std::vector<uint32_t> sortKeys;
 
     ECS::Registry& registry = GetEngine().GetEcsRegistry();
-    std::set<ECS::EntityID_t> entities = GetEntities();
-    sortKeys.reserve(entities.size());
+    ECS::EntitySet& entities = GetEntities();
+    sortKeys.reserve(entities.GetSize());
 
-    for (ECS::EntityID_t entityId : entities) {
+    entities.ForEach([&](ECS::EntityID_t entityId) {
         Components::Renderable& renderable = registry.GetComponent<Components::Renderable>(entityId);
 
         if (renderable.m_layer == Components::RenderLayer::LAYER_NONE) {
 
             // skip renderables that are not currently visible.
-            continue;
+            return;
         }
 
         uint32_t sortKey = static_cast<uint8_t>(renderable.m_layer) << RENDER_LAYER_SHIFT;
@@ -372,7 +372,7 @@ std::list<Components::Renderable*> Systems::RenderSystem::SortDrawCalls() {
 
         binnedRenderables[sortKey].push_back(&renderable);
         sortKeys.push_back(sortKey);
-    }
+    });
 
     std::sort(sortKeys.begin(), sortKeys.end(),[](const uint32_t& left, uint32_t& right){
         return left < right;
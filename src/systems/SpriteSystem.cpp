@@ -48,18 +48,15 @@ Systems::SpriteSystem::SpriteSystem(Core::Engine& engine)
 void Systems::SpriteSystem::Update() {
 
     ECS::Registry& registry = GetEngine().GetEcsRegistry();
-    std::set<ECS::EntityID_t>& entities = GetEntities();
+    ECS::EntitySet& entities = GetEntities();
 
-    if (!entities.empty()) {
+    if (!entities.IsEmpty()) {
         m_vertices.clear();
         m_indices.clear();
 
         // sort sprites into batches
-        for (ECS::EntityID_t entityID : GetEntities()) {
-
-            // inputs
-            auto& sprite = registry.GetComponent<Components::Sprite>(entityID);
-            auto& transform = registry.GetComponent<Components::Transform>(entityID);
+        registry.View<const Components::Sprite, const Components::Transform>().ForEach([&](
+            ECS::EntityID_t entityID, const Components::Sprite& sprite, const Components::Transform& transform) {
 
             // output
             auto& renderable = registry.FindOrEmplaceComponent<Components::Renderable>(entityID);
@@ -93,7 +90,7 @@ void Systems::SpriteSystem::Update() {
 
             renderable.m_layer = sprite.layer;
             renderable.m_depth_override = sprite.draw_order;
-        }
+        });
 
         m_p_sprite_mesh->LoadData(m_vertices, m_indices);
     }
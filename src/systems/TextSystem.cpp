@@ -65,9 +65,9 @@ void Systems::TextSystem::Update() {
 
     ECS::Registry& registry = GetEngine().GetEcsRegistry();
     Systems::RenderSystem& rendersystem = registry.GetSystem<Systems::RenderSystem>();
-    std::set<ECS::EntityID_t> entities = GetEntities();
+    ECS::EntitySet& entities = GetEntities();
 
-    if (!entities.empty()) {
+    if (!entities.IsEmpty()) {
 
         // update buffers
         UpdateGeometryBuffer();
@@ -77,13 +77,11 @@ void Systems::TextSystem::Update() {
 
         uint32_t indexCount = 0U;
         // Build renderable object for each entity
-        for (ECS::EntityID_t entity : entities) {
-
-            Components::Text& text = registry.GetComponent<Components::Text>(entity);
-            Components::Transform& transform = registry.GetComponent<Components::Transform>(entity);
+        registry.View<const Components::Text, const Components::Transform>().ForEach([&](
+            ECS::EntityID_t entity, const Components::Text& text, const Components::Transform& transform) {
 
             if ((text.m_p_font == nullptr) || (text.m_p_text == nullptr)) {
-                continue;
+                return;
             }
 
             Components::Renderable& renderable = registry.FindOrEmplaceComponent<Components::Renderable>(entity);
@@ -118,7 +116,7 @@ void Systems::TextSystem::Update() {
             renderable.m_drawcommand.m_num_indices = indicesInTextObject;
             indexCount += indicesInTextObject;
 
-        }
+        });
     }
 
 }
@@ -157,17 +155,15 @@ void Systems::TextSystem::GetTextMetrics(const TTF_GPUAtlasDrawSequence* p_draw_
 void Systems::TextSystem::UpdateGeometryBuffer() {
 
     ECS::Registry& registry = GetEngine().GetEcsRegistry();
-    std::set<ECS::EntityID_t>& entities = GetEntities();
     m_geometry_data.vertices.clear();
     m_geometry_data.indices.clear();
 
-    // Build renderable object for text buffer.
-    for (ECS::EntityID_t entity : entities) {
-
-        Components::Text& text = registry.GetComponent<Components::Text>(entity);
+    // Build renderable object for text buffer. Walks the same view as Update(), so that the text is in the same order.
+    registry.View<const Components::Text, const Components::Transform>().ForEach([&](
+        ECS::EntityID_t /*entity*/, const Components::Text& text, const Components::Transform& /*transform*/) {
 
         if ((text.m_p_font == nullptr) || (text.m_p_text == nullptr)) {
-            continue;
+            return;
         }
 
         // update geometry buffer.
@@ -195,5 +191,5 @@ void Systems::TextSystem::UpdateGeometryBuffer() {
 
             p_current = p_current->next;
         }
-    }
+    });
 }
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Tile.hpp"
+#include <cstdint>
+
+namespace World {
+
+    //! A drainage basin: the land that drains to the same tile, by always flowing to its steepest downhill neighbor.
+    //!
+    //! Basins that drain to a pit in the land hold water, which rises until it spills over the lowest point of their
+    //! rim into a neighboring basin. Nested basins are flooded together, into a single lake, when the water of one
+    //! spills into another that cannot drain it to the ocean before it fills up as well.
+    struct Basin {
+        TileId_t pit {INVALID_TILE_ID};             //!< Lowest tile of the basin, or the ocean tile it drains into.
+        TileId_t spill {INVALID_TILE_ID};           //!< Tile on the lowest point of the rim, where water first spills.
+        BasinId_t spill_basin {INVALID_BASIN_ID};   //!< Basin on the other side of the spill tile.
+        TileId_t outlet {INVALID_TILE_ID};          //!< Tile past the rim that water from the pit flows on to, once
+                                                    //!< the lake fills. Invalid if the basin drains to the ocean, or
+                                                    //!< never fills.
+        BasinId_t lake {INVALID_BASIN_ID};          //!< Basin holding the deepest point of the lake that floods this
+                                                    //!< basin, shared by every basin of the lake. Invalid if dry.
+        float spill_height {0.0F};                  //!< Height of the spill tile, in meters.
+        float water_level {0.0F};                   //!< Height of the lake surface, or of the pit if there is no lake.
+                                                    //!< The ocean surface for basins that drain to the ocean.
+        float volume {0.0F};                        //!< Volume of water held over the tiles of this basin, in m^3.
+        bool drains_to_ocean {false};               //!< The pit is an ocean tile, so the basin holds no lake.
+    };
+}
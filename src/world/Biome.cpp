@@ -87,4 +87,49 @@ namespace World {
 
         throw std::runtime_error("Invalid biome string: " + biomeStr);
     }
+    BiomeType ClassifyBiome(const BiomeConditions& conditions) {
+
+        const float temperature = conditions.temperature;
+        const float moisture = conditions.moisture;
+
+        if (conditions.is_ocean) {
+            return (temperature < -20.0F) ? BiomeType::SEA_ICE : BiomeType::OCEAN;
+        }
+
+        if (conditions.is_lake) {
+            return (temperature < -20.0F) ? BiomeType::FROZEN_LAKE : BiomeType::LAKE;
+        }
+
+        // Cold Biomes
+        if (temperature < -20.0F) {
+            return BiomeType::ICE_SHEET;
+        }
+        if ((temperature < 0.0F) && ((moisture < 50.0F) || conditions.is_mountain)) {
+            return BiomeType::TUNDRA;
+        }
+        if ((temperature < 10.0F) && ((moisture < 80.0F) || conditions.has_river)) {
+            return BiomeType::BOREAL_FOREST;
+        }
+        if (temperature < 10.0F) {
+            return BiomeType::COLD_BOG;
+        }
+
+        // Hot Biomes
+        if (temperature > 27.5F) {
+            if (moisture < 50.0F) {
+                return BiomeType::EXTREME_DESERT;
+            }
+            if (moisture < 60.0F) {
+                return BiomeType::DESERT;
+            }
+            return BiomeType::ARID_SHRUBLAND;
+        }
+
+        // Seperate out by variability in temperature
+        const bool isSwamp = (moisture >= 80.0F) && !conditions.has_river;
+        if (conditions.temperature_variance < 4.0F) {
+            return isSwamp ? BiomeType::TROPICAL_SWAMP : BiomeType::TROPICAL_RAINFOREST;
+        }
+        return isSwamp ? BiomeType::TEMPERATE_SWAMP : BiomeType::TEMPERATE_FOREST;
+    }
 }
\ No newline at end of file
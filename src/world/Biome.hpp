@@ -29,4 +29,18 @@ namespace World {
 
     std::string BiomeTypeToString(BiomeType biome);
     BiomeType StringToBiomeType(const std::string& biomeStr);
+
+    //! Climate and terrain of a place, used to decide which biome it belongs to.
+    struct BiomeConditions {
+        float temperature;          //!< Mean temperature, in degrees Celsius.
+        float temperature_variance; //!< Seasonal swing of the temperature, in degrees Celsius.
+        float moisture;             //!< Moisture, from 0 to 100.
+        bool is_ocean;              //!< Covered by the ocean.
+        bool is_lake;               //!< Covered by a lake.
+        bool is_mountain;           //!< Part of a mountain range.
+        bool has_river;             //!< Watered by a river.
+    };
+
+    //! @brief Use a Whittaker diagram to find the most specific type of biome that fits the conditions.
+    BiomeType ClassifyBiome(const BiomeConditions& conditions);
 }
\ No newline at end of file
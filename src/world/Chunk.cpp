@@ -0,0 +1,63 @@
+#include "Chunk.hpp"
+#include <algorithm>
+
+namespace World {
+
+    Chunk::Chunk(ChunkCoordinate_t coordinate, BlockType fill)
+        : m_coordinate(coordinate)
+        , m_fill(fill) {
+    }
+
+    ChunkCoordinate_t Chunk::GetCoordinate() const {
+        return m_coordinate;
+    }
+
+    BlockType Chunk::GetBlock(uint16_t x_coord, uint16_t z_coord, uint16_t y_coord) const {
+
+        if (m_p_blocks == nullptr) {
+            return m_fill;
+        }
+
+        return m_p_blocks->at(BLOCK_ID_FROM_PARTS(x_coord, z_coord, y_coord));
+    }
+
+    void Chunk::SetBlock(uint16_t x_coord, uint16_t z_coord, uint16_t y_coord, BlockType type) {
+
+        if ((m_p_blocks == nullptr) && (type == m_fill)) {
+            return;
+        }
+
+        GetOrAllocateBlocks().at(BLOCK_ID_FROM_PARTS(x_coord, z_coord, y_coord)) = type;
+    }
+
+    void Chunk::FillColumn(uint16_t x_coord, uint16_t z_coord, uint16_t y_begin, uint16_t y_end, BlockType type) {
+
+        y_end = std::min(y_end, CHUNK_HEIGHT);
+        if ((y_begin >= y_end) || ((m_p_blocks == nullptr) && (type == m_fill))) {
+            return;
+        }
+
+        // blocks within a column are contiguous, since the Y coordinate occupies the low bits of the block ID.
+        BlockArray_t& blocks = GetOrAllocateBlocks();
+        auto columnBegin = blocks.begin() + BLOCK_ID_FROM_PARTS(x_coord, z_coord, y_begin);
+        std::fill(columnBegin, columnBegin + (y_end - y_begin), type);
+    }
+
+    bool Chunk::IsUniform() const {
+        return m_p_blocks == nullptr;
+    }
+
+    size_t Chunk::GetMemoryUsage() const {
+        return sizeof(Chunk) + ((m_p_blocks != nullptr) ? sizeof(BlockArray_t) : 0U);
+    }
+
+    Chunk::BlockArray_t& Chunk::GetOrAllocateBlocks() {
+
+        if (m_p_blocks == nullptr) {
+            m_p_blocks = std::make_unique<BlockArray_t>();
+            m_p_blocks->fill(m_fill);
+        }
+
+        return *m_p_blocks;
+    }
+}
@@ -3,6 +3,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <array>
+#include <memory>
+#include <glm/ext/vector_int3.hpp>
 
 //! This class represents the high level types that are used to represent the world.
 namespace World {
@@ -10,7 +12,12 @@ namespace World {
     //! Type of blocks in simulation.
     enum class BlockType : uint8_t {
         AIR = 0U,
-        ROCK
+        ROCK,
+        SOIL,
+        SAND,
+        SNOW,
+        ICE,
+        WATER
     };
 
     //! CHUNK Size, total size of chunk in each direction.
@@ -21,6 +28,9 @@ namespace World {
     //! Number of blocks in a chunk.
     static const constexpr uint32_t NUM_BLOCKS = CHUNK_WIDTH*CHUNK_LENGTH*CHUNK_HEIGHT;
 
+    //! Position of a chunk in the world, measured in chunks. (x: east, y: up, z: south)
+    using ChunkCoordinate_t = glm::ivec3;
+
     //! Get the X coordinate from a block ID
     static constexpr uint16_t X_FROM_BLOCK_ID(uint16_t block_id) {
         return ((block_id >> 12) & 0x0F); // NOLINT bits 12-15 of ID are x coordinate.
@@ -59,7 +69,13 @@ namespace World {
         public:
 
             //! @brief Constructor for a chunk
-            Chunk(uint32_t dimmension);
+            //!
+            //! @param[in] coordinate The position of the chunk in the world.
+            //! @param[in] fill       The type of block used to initialize the chunk.
+            explicit Chunk(ChunkCoordinate_t coordinate, BlockType fill = BlockType::AIR);
+
+            //! @brief Get the position of the chunk in the world.
+            ChunkCoordinate_t GetCoordinate() const;
 
             //! @brief Get block.
             //!
@@ -68,7 +84,7 @@ namespace World {
             //! @param[in] y_coord Coordinate on Y axis. [0, CHUNK_HEIGHT)
             //!
             //! @returns The type of block at the position.
-            BlockType GetBlock(uint16_t x_coord, uint16_t z_coord, uint16_t y_coord);
+            BlockType GetBlock(uint16_t x_coord, uint16_t z_coord, uint16_t y_coord) const;
 
             //! @brief Set block
             //!
@@ -78,12 +94,39 @@ namespace World {
             //! @param[in] type    The type of block at the position.
             void SetBlock(uint16_t x_coord, uint16_t z_coord, uint16_t y_coord, BlockType type);
 
+            //! @brief Set a vertical run of blocks in a single column.
+            //!
+            //! @param[in] x_coord Coordinate on X axis. [0, CHUNK_WIDTH)
+            //! @param[in] z_coord Coordinate on Z axis. [0, CHUNK_LENGTH)
+            //! @param[in] y_begin First coordinate on Y axis to set.
+            //! @param[in] y_end   One past the last coordinate on Y axis to set. Clamped to CHUNK_HEIGHT.
+            //! @param[in] type    The type of block to set.
+            void FillColumn(uint16_t x_coord, uint16_t z_coord, uint16_t y_begin, uint16_t y_end, BlockType type);
+
+            //! @brief Whether the chunk is still a single block type, and has not allocated block storage.
+            bool IsUniform() const;
+
+            //! @brief Get the number of bytes of memory used by the chunk.
+            size_t GetMemoryUsage() const;
+
         private:
 
+            using BlockArray_t = std::array<BlockType, NUM_BLOCKS>;
+
+            //! Allocate block storage, initialized to the fill type. Called on first write to a uniform chunk.
+            BlockArray_t& GetOrAllocateBlocks();
+
+            //! The position of the chunk in the world.
+            ChunkCoordinate_t m_coordinate;
+
+            //! The block type for every block in a uniform chunk.
+            BlockType m_fill;
+
             //! The array of cells that make up the chunk. This contains data that is used for representing terrain features.
+            //! Null while the chunk is uniform, which is common for chunks in the sky or deep underground.
             //!
             //! Consider using RLE encoding for storage.
-            std::array<BlockType, NUM_BLOCKS> m_blocks;
+            std::unique_ptr<BlockArray_t> m_p_blocks;
     };
 
 };
\ No newline at end of file
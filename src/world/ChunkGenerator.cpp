@@ -0,0 +1,180 @@
+#include "ChunkGenerator.hpp"
+#include "Biome.hpp"
+#include "Region.hpp"
+#include "Tile.hpp"
+#include "World.hpp"
+#include "WorldParams.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/common.hpp>
+#include <limits>
+
+namespace World {
+
+    //! Frequency of the detail noise, in cycles per meter.
+    static constexpr float DETAIL_FREQUENCY = 1.0F / 128.0F;
+
+    //! Peak to peak amplitude of the detail noise, in meters.
+    static constexpr float DETAIL_AMPLITUDE = 24.0F;
+
+    //! Depth of the surface layer (soil, sand, snow) above the bedrock, in blocks.
+    static constexpr int32_t SURFACE_LAYER_DEPTH = 4;
+
+    //! Used to decorrelate the detail noise from the noise used during world generation.
+    static constexpr uint32_t DETAIL_SEED_SALT = 0x9E3779B9U;
+
+    //! Vertical extents of a single column of blocks, in world blocks.
+    struct ColumnExtents {
+        int32_t rock_top;
+        int32_t surface_top;
+        int32_t water_top;
+        BlockType surface_block;
+        BlockType water_block;
+    };
+
+    //! Choose the surface material for a biome.
+    static BlockType GetSurfaceBlock(BiomeType biome) {
+
+        switch (biome) {
+            case BiomeType::OCEAN:
+            case BiomeType::LAKE:
+            case BiomeType::SEA_ICE:
+            case BiomeType::FROZEN_LAKE:
+            case BiomeType::DESERT:
+            case BiomeType::EXTREME_DESERT:
+                return BlockType::SAND;
+
+            case BiomeType::ICE_SHEET:
+            case BiomeType::TUNDRA:
+                return BlockType::SNOW;
+
+            default:
+                return BlockType::SOIL;
+        }
+    }
+
+    //! Convert a height in meters to the number of blocks from the bottom of the world that lie at or below the height.
+    static int32_t HeightToBlockCount(float height) {
+        return static_cast<int32_t>(std::floor(height)) + 1;
+    }
+
+    //! Convert a world block range to a range within a chunk.
+    static uint16_t ToLocalY(int32_t world_y, int32_t chunk_base) {
+        return static_cast<uint16_t>(std::clamp(world_y - chunk_base, 0, static_cast<int32_t>(CHUNK_HEIGHT)));
+    }
+
+    ChunkGenerator::ChunkGenerator(const World& world)
+        : m_p_world(&world)
+        , m_detail_noise(world.GetParameters().GetSeed() ^ DETAIL_SEED_SALT) {
+    }
+
+    std::unique_ptr<Chunk> ChunkGenerator::Generate(ChunkCoordinate_t coordinate) const {
+
+        const World& world = *m_p_world;
+        const Extent_t extent = world.GetSize();
+        const glm::vec2 worldSizeMeters = glm::vec2(extent) * TILE_SIZE_METERS_F32;
+        const glm::vec2 chunkOrigin(
+            static_cast<float>(coordinate.x * CHUNK_WIDTH),
+            static_cast<float>(coordinate.z * CHUNK_LENGTH));
+        const int32_t chunkBase = coordinate.y * CHUNK_HEIGHT;
+
+        // Nothing exists outside of the world.
+        if ((coordinate.y < 0) ||
+            (chunkOrigin.x < 0.0F) || (chunkOrigin.y < 0.0F) ||
+            (chunkOrigin.x >= worldSizeMeters.x) || (chunkOrigin.y >= worldSizeMeters.y)) {
+            return std::make_unique<Chunk>(coordinate, BlockType::AIR);
+        }
+
+        // First determine the extents of each column, so that uniform chunks can skip allocating block storage.
+        std::array<ColumnExtents, CHUNK_WIDTH * CHUNK_LENGTH> columns {};
+        int32_t minRockTop = std::numeric_limits<int32_t>::max();
+
+        for (uint16_t zCoord = 0U; zCoord < CHUNK_LENGTH; zCoord++) {
+            for (uint16_t xCoord = 0U; xCoord < CHUNK_WIDTH; xCoord++) {
+
+                glm::vec2 position = chunkOrigin + glm::vec2(static_cast<float>(xCoord) + 0.5F, static_cast<float>(zCoord) + 0.5F);
+                position = glm::min(position, worldSizeMeters - glm::vec2(0.5F));
+
+                ConstTile tile = world.GetTile(world.CoordinateToTileId(world.PositionToCoordinate(position)));
+                BiomeType biome = tile.GetBiome();
+
+                float surfaceHeight = GetSurfaceHeight(position);
+
+                ColumnExtents& column = columns.at((zCoord * CHUNK_WIDTH) + xCoord);
+                column.surface_top = std::max(HeightToBlockCount(surfaceHeight), 1);
+                column.rock_top = column.surface_top - SURFACE_LAYER_DEPTH;
+                column.surface_block = GetSurfaceBlock(biome);
+                column.water_top = 0;
+                column.water_block = ((biome == BiomeType::SEA_ICE) || (biome == BiomeType::FROZEN_LAKE))?
+                    BlockType::ICE : BlockType::WATER;
+
+                if (tile.GetIsLake()) {
+                    column.water_top = HeightToBlockCount(tile.GetWaterLevel());
+                }
+                else if (tile.GetIsWater()) {
+                    column.water_top = HeightToBlockCount(world.GetOceanLevel());
+                }
+
+                minRockTop = std::min(minRockTop, column.rock_top);
+            }
+        }
+
+        BlockType fill = (minRockTop >= chunkBase + static_cast<int32_t>(CHUNK_HEIGHT))? BlockType::ROCK : BlockType::AIR;
+        std::unique_ptr<Chunk> p_chunk = std::make_unique<Chunk>(coordinate, fill);
+
+        for (uint16_t zCoord = 0U; zCoord < CHUNK_LENGTH; zCoord++) {
+            for (uint16_t xCoord = 0U; xCoord < CHUNK_WIDTH; xCoord++) {
+
+                const ColumnExtents& column = columns.at((zCoord * CHUNK_WIDTH) + xCoord);
+
+                uint16_t rockEnd = ToLocalY(column.rock_top, chunkBase);
+                uint16_t surfaceEnd = ToLocalY(column.surface_top, chunkBase);
+                uint16_t waterEnd = ToLocalY(column.water_top, chunkBase);
+
+                p_chunk->FillColumn(xCoord, zCoord, 0U, rockEnd, BlockType::ROCK);
+                p_chunk->FillColumn(xCoord, zCoord, rockEnd, surfaceEnd, column.surface_block);
+
+                if (waterEnd > surfaceEnd) {
+                    p_chunk->FillColumn(xCoord, zCoord, surfaceEnd, waterEnd, BlockType::WATER);
+
+                    // only the top of the water column freezes.
+                    if ((column.water_block == BlockType::ICE) && (column.water_top - chunkBase <= CHUNK_HEIGHT)) {
+                        p_chunk->SetBlock(xCoord, zCoord, waterEnd - 1U, BlockType::ICE);
+                    }
+                }
+            }
+        }
+
+        return p_chunk;
+    }
+
+    float ChunkGenerator::GetSurfaceHeight(glm::vec2 position) const {
+
+        float detail = m_detail_noise.Fbm(position * DETAIL_FREQUENCY) - 0.5F;
+        return SampleTileHeight(position) + (detail * DETAIL_AMPLITUDE);
+    }
+
+    float ChunkGenerator::SampleTileHeight(glm::vec2 position) const {
+
+        const World& world = *m_p_world;
+        const Extent_t extent = world.GetSize();
+
+        // tile heights are defined at the center of each tile.
+        glm::vec2 tilePosition = (position * TILE_PER_METER_F32) - glm::vec2(0.5F);
+        tilePosition = glm::clamp(tilePosition, glm::vec2(0.0F), glm::vec2(extent - Extent_t(1U)));
+
+        Coordinate_t coord0(static_cast<uint32_t>(tilePosition.x), static_cast<uint32_t>(tilePosition.y));
+        Coordinate_t coord1(std::min(coord0.x + 1U, extent.x - 1U), std::min(coord0.y + 1U, extent.y - 1U));
+        glm::vec2 weight = tilePosition - glm::vec2(coord0);
+
+        float height00 = world.GetTile(world.CoordinateToTileId({coord0.x, coord0.y})).GetAbsoluteHeight();
+        float height10 = world.GetTile(world.CoordinateToTileId({coord1.x, coord0.y})).GetAbsoluteHeight();
+        float height01 = world.GetTile(world.CoordinateToTileId({coord0.x, coord1.y})).GetAbsoluteHeight();
+        float height11 = world.GetTile(world.CoordinateToTileId({coord1.x, coord1.y})).GetAbsoluteHeight();
+
+        float height0 = glm::mix(height00, height10, weight.x);
+        float height1 = glm::mix(height01, height11, weight.x);
+        return glm::mix(height0, height1, weight.y);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Chunk.hpp"
+#include "math/PerlinNoise.hpp"
+#include <glm/vec2.hpp>
+#include <memory>
+
+namespace World {
+
+    class World;
+
+    //! Generates block data for chunks from the tile heightfield of a generated world.
+    //!
+    //! Tile heights are bilinearly interpolated across each 1024 m tile, and perlin noise adds detail below the scale of
+    //! a tile. The surface material is chosen from the biome of the region under the column, and columns below the water
+    //! level of water tiles are flooded.
+    //!
+    //! Generation only reads from the world, so chunks can be generated concurrently, as long as the world is not
+    //! modified.
+    class ChunkGenerator {
+
+        public:
+
+            //! @brief Constructor
+            //!
+            //! @param[in] world The world to generate chunks for. Must outlive the generator.
+            explicit ChunkGenerator(const World& world);
+
+            //! @brief Generate the chunk at the given coordinate.
+            //!
+            //! @param[in] coordinate The coordinate of the chunk, measured in chunks.
+            //!
+            //! @returns The generated chunk.
+            std::unique_ptr<Chunk> Generate(ChunkCoordinate_t coordinate) const;
+
+            //! @brief Get the height of the terrain surface at a position.
+            //!
+            //! @param[in] position Position in the world, in meters.
+            //!
+            //! @returns The height of the surface, in meters.
+            float GetSurfaceHeight(glm::vec2 position) const;
+
+        private:
+
+            //! Bilinear interpolation of tile heights at a position, in meters.
+            float SampleTileHeight(glm::vec2 position) const;
+
+            //! The world that chunks are generated from.
+            const World* m_p_world;
+
+            //! Noise used for adding detail smaller than a tile.
+            Math::PerlinNoise m_detail_noise;
+    };
+}
@@ -0,0 +1,247 @@
+#include "ChunkStreamer.hpp"
+#include "core/Logger.hpp"
+#include "core/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <string>
+#include <tuple>
+
+namespace World {
+
+    //! Memory used by a chunk that has allocated block storage. Used to estimate how many chunks fit in the budget.
+    static constexpr size_t MAX_CHUNK_MEMORY_USAGE = sizeof(Chunk) + (NUM_BLOCKS * sizeof(BlockType));
+
+    ChunkStreamer::ChunkStreamer(
+        const World& world,
+        Core::ThreadPool& pool,
+        int32_t load_radius,
+        int32_t vertical_radius,
+        size_t memory_budget,
+        size_t max_jobs)
+        : m_generator(world)
+        , m_p_pool(&pool)
+        , m_load_radius(std::max(load_radius, 0))
+        , m_vertical_radius(std::max(vertical_radius, 0))
+        , m_memory_budget(memory_budget)
+        , m_max_jobs(std::max<size_t>(max_jobs, 1U))
+        , m_focus(0, 0, 0) {
+    }
+
+    ChunkStreamer::~ChunkStreamer() {
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_requests.clear();
+        m_job_finished.wait(lock, [this]() {
+            return m_num_jobs == 0U;
+        });
+    }
+
+    void ChunkStreamer::SetFocus(glm::vec3 position) {
+
+        ChunkCoordinate_t focus = PositionToChunkCoordinate(position);
+        if (focus != m_focus) {
+            m_focus = focus;
+            m_focus_changed = true;
+        }
+    }
+
+    void ChunkStreamer::Update() {
+
+        std::vector<std::unique_ptr<Chunk>> completed;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            completed.swap(m_completed);
+        }
+
+        for (std::unique_ptr<Chunk>& p_chunk : completed) {
+
+            ChunkCoordinate_t coordinate = p_chunk->GetCoordinate();
+
+            // the focus may have moved away while the chunk was being generated.
+            if ((m_wanted.count(coordinate) == 0U) || (m_resident.count(coordinate) != 0U)) {
+                continue;
+            }
+
+            m_memory_usage += p_chunk->GetMemoryUsage();
+            m_lru.push_front(coordinate);
+            m_resident.emplace(coordinate, ResidentChunk{std::move(p_chunk), m_lru.begin()});
+        }
+
+        if (m_focus_changed) {
+            RebuildRequests();
+            m_focus_changed = false;
+        }
+
+        EvictOverBudget();
+        ScheduleJobs();
+    }
+
+    const Chunk* ChunkStreamer::GetChunk(ChunkCoordinate_t coordinate) const {
+
+        auto residentItr = m_resident.find(coordinate);
+        if (residentItr == m_resident.end()) {
+            return nullptr;
+        }
+
+        return residentItr->second.p_chunk.get();
+    }
+
+    size_t ChunkStreamer::GetLoadedCount() const {
+        return m_resident.size();
+    }
+
+    size_t ChunkStreamer::GetMemoryUsage() const {
+        return m_memory_usage;
+    }
+
+    ChunkCoordinate_t ChunkStreamer::PositionToChunkCoordinate(glm::vec3 position) {
+        return ChunkCoordinate_t(
+            static_cast<int32_t>(std::floor(position.x / static_cast<float>(CHUNK_WIDTH))),
+            static_cast<int32_t>(std::floor(position.y / static_cast<float>(CHUNK_HEIGHT))),
+            static_cast<int32_t>(std::floor(position.z / static_cast<float>(CHUNK_LENGTH))));
+    }
+
+    void ChunkStreamer::RebuildRequests() {
+
+        // Gather every chunk within range, nearest first.
+        std::vector<ChunkCoordinate_t> candidates;
+        for (int32_t yOffset = -m_vertical_radius; yOffset <= m_vertical_radius; yOffset++) {
+            if (m_focus.y + yOffset < 0) {
+                continue;
+            }
+
+            for (int32_t zOffset = -m_load_radius; zOffset <= m_load_radius; zOffset++) {
+                for (int32_t xOffset = -m_load_radius; xOffset <= m_load_radius; xOffset++) {
+                    if ((xOffset * xOffset) + (zOffset * zOffset) <= (m_load_radius * m_load_radius)) {
+                        candidates.emplace_back(m_focus.x + xOffset, m_focus.y + yOffset, m_focus.z + zOffset);
+                    }
+                }
+            }
+        }
+
+        auto distanceSquared = [this](const ChunkCoordinate_t& coordinate) {
+            ChunkCoordinate_t offset = coordinate - m_focus;
+            return (offset.x * offset.x) + (offset.y * offset.y) + (offset.z * offset.z);
+        };
+
+        std::sort(candidates.begin(), candidates.end(), [&distanceSquared](const ChunkCoordinate_t& lhs, const ChunkCoordinate_t& rhs) {
+            int32_t lhsDistance = distanceSquared(lhs);
+            int32_t rhsDistance = distanceSquared(rhs);
+            if (lhsDistance != rhsDistance) {
+                return lhsDistance < rhsDistance;
+            }
+            return std::tie(lhs.y, lhs.z, lhs.x) < std::tie(rhs.y, rhs.z, rhs.x);
+        });
+
+        // Drop the furthest chunks that would not fit in the budget, so that the cache does not thrash.
+        size_t estimatedUsage = 0U;
+        size_t numWanted = 0U;
+        for (; numWanted < candidates.size(); numWanted++) {
+            auto residentItr = m_resident.find(candidates[numWanted]);
+            size_t usage = (residentItr != m_resident.end()) ? residentItr->second.p_chunk->GetMemoryUsage() : MAX_CHUNK_MEMORY_USAGE;
+            if (estimatedUsage + usage > m_memory_budget) {
+                break;
+            }
+            estimatedUsage += usage;
+        }
+        candidates.resize(numWanted);
+
+        m_wanted.clear();
+        m_wanted.insert(candidates.begin(), candidates.end());
+
+        // Touch resident chunks furthest first, so the nearest end up most recently used. Anything that is not
+        // resident yet is requested, with the nearest at the back of the queue.
+        std::vector<ChunkCoordinate_t> requests;
+        for (auto candidateItr = candidates.rbegin(); candidateItr != candidates.rend(); candidateItr++) {
+            auto residentItr = m_resident.find(*candidateItr);
+            if (residentItr != m_resident.end()) {
+                Touch(residentItr->second);
+            }
+            else {
+                requests.push_back(*candidateItr);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::unordered_set<ChunkCoordinate_t> pending(m_in_progress);
+        for (const std::unique_ptr<Chunk>& p_chunk : m_completed) {
+            pending.insert(p_chunk->GetCoordinate());
+        }
+
+        requests.erase(
+            std::remove_if(requests.begin(), requests.end(), [&pending](const ChunkCoordinate_t& coordinate) {
+                return pending.count(coordinate) != 0U;
+            }),
+            requests.end());
+
+        m_requests.swap(requests);
+    }
+
+    void ChunkStreamer::ScheduleJobs() {
+
+        size_t numJobs = 0U;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_num_jobs < m_max_jobs) {
+                numJobs = std::min(m_max_jobs - m_num_jobs, m_requests.size());
+                m_num_jobs += numJobs;
+            }
+        }
+
+        for (size_t job = 0U; job < numJobs; job++) {
+            m_p_pool->Submit([this]() { RunJob(); });
+        }
+    }
+
+    void ChunkStreamer::RunJob() {
+
+        ChunkCoordinate_t coordinate;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // requests may have been cancelled by a focus change since the job was queued.
+            if (m_requests.empty()) {
+                m_num_jobs--;
+                m_job_finished.notify_all();
+                return;
+            }
+
+            coordinate = m_requests.back();
+            m_requests.pop_back();
+            m_in_progress.insert(coordinate);
+        }
+
+        std::unique_ptr<Chunk> p_chunk;
+        try {
+            p_chunk = m_generator.Generate(coordinate);
+        }
+        catch (std::exception& error) {
+            Core::Logger::Error(std::string("ChunkStreamer: failed to generate chunk: ") + error.what());
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_in_progress.erase(coordinate);
+        if (p_chunk != nullptr) {
+            m_completed.push_back(std::move(p_chunk));
+        }
+        m_num_jobs--;
+        m_job_finished.notify_all();
+    }
+
+    void ChunkStreamer::Touch(ResidentChunk& resident) {
+        m_lru.splice(m_lru.begin(), m_lru, resident.lru_position);
+    }
+
+    void ChunkStreamer::EvictOverBudget() {
+
+        while ((m_memory_usage > m_memory_budget) && !m_lru.empty()) {
+
+            auto residentItr = m_resident.find(m_lru.back());
+            m_memory_usage -= residentItr->second.p_chunk->GetMemoryUsage();
+            m_resident.erase(residentItr);
+            m_lru.pop_back();
+        }
+    }
+}
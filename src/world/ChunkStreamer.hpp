@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Chunk.hpp"
+#include "ChunkGenerator.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+#include <glm/vec3.hpp>
+
+namespace Core {
+    class ThreadPool;
+}
+
+namespace World {
+
+    class World;
+
+    //! Keeps the chunks around a focus point resident, generating them on background workers.
+    //!
+    //! Chunks are requested nearest first. Resident chunks are kept in a least recently used cache, and the least
+    //! recently wanted chunks are evicted once the memory budget is exceeded. All public methods must be called from the
+    //! same thread (normally the main loop), and none of them block on chunk generation.
+    class ChunkStreamer {
+
+        public:
+
+            //! @brief Constructor
+            //!
+            //! @param[in] world           The world to generate chunks from. Must outlive the streamer, and not be modified
+            //!                            while the streamer exists.
+            //! @param[in] pool            The pool used to run generation jobs.
+            //! @param[in] load_radius     Horizontal distance around the focus to keep loaded, in chunks.
+            //! @param[in] vertical_radius Vertical distance around the focus to keep loaded, in chunks.
+            //! @param[in] memory_budget   Maximum number of bytes used by resident chunks.
+            //! @param[in] max_jobs        Maximum number of chunks generated concurrently.
+            ChunkStreamer(
+                const World& world,
+                Core::ThreadPool& pool,
+                int32_t load_radius,
+                int32_t vertical_radius,
+                size_t memory_budget,
+                size_t max_jobs);
+            ChunkStreamer(const ChunkStreamer& other) = delete;
+            ChunkStreamer(ChunkStreamer&& other) = delete;
+            ChunkStreamer& operator=(const ChunkStreamer& other) = delete;
+            ChunkStreamer& operator=(ChunkStreamer&& other) = delete;
+
+            //! Cancels queued requests, and waits for chunks that are currently being generated.
+            ~ChunkStreamer();
+
+            //! @brief Set the point that chunks are loaded around. Takes effect on the next update.
+            //!
+            //! @param[in] position Position in the world, in meters. (x: east, y: up, z: south)
+            void SetFocus(glm::vec3 position);
+
+            //! @brief Accept finished chunks, evict chunks over the memory budget and queue new requests.
+            //!
+            //! Intended to be called once per frame.
+            void Update();
+
+            //! @brief Get a resident chunk.
+            //!
+            //! @param[in] coordinate The coordinate of the chunk.
+            //!
+            //! @returns The chunk, or nullptr if it is not loaded yet. Valid until the next call to Update().
+            const Chunk* GetChunk(ChunkCoordinate_t coordinate) const;
+
+            //! Get the number of resident chunks.
+            size_t GetLoadedCount() const;
+
+            //! Get the number of bytes used by resident chunks.
+            size_t GetMemoryUsage() const;
+
+            //! Convert a position in meters to the coordinate of the chunk containing it.
+            static ChunkCoordinate_t PositionToChunkCoordinate(glm::vec3 position);
+
+        private:
+
+            //! A chunk that has been loaded, and its position in the LRU list.
+            struct ResidentChunk {
+                std::unique_ptr<Chunk> p_chunk;
+                std::list<ChunkCoordinate_t>::iterator lru_position;
+            };
+
+            //! Work out which chunks should be resident for the current focus, and rebuild the request queue.
+            void RebuildRequests();
+
+            //! Queue generation jobs, up to the job limit.
+            void ScheduleJobs();
+
+            //! Body of a generation job. Generates the nearest queued request.
+            void RunJob();
+
+            //! Move a chunk to the most recently used end of the LRU list.
+            void Touch(ResidentChunk& resident);
+
+            //! Evict least recently used chunks until the memory budget is met.
+            void EvictOverBudget();
+
+            //! Generates chunk data. Read only, so it is shared by all jobs.
+            ChunkGenerator m_generator;
+
+            //! The pool that runs generation jobs.
+            Core::ThreadPool* m_p_pool;
+
+            int32_t m_load_radius;
+            int32_t m_vertical_radius;
+            size_t m_memory_budget;
+            size_t m_max_jobs;
+
+            //! The chunk that contains the focus point.
+            ChunkCoordinate_t m_focus;
+
+            //! Whether the focus has moved since the requests were last built.
+            bool m_focus_changed {true};
+
+            //! Chunks that are loaded, accessed only by the owning thread.
+            std::unordered_map<ChunkCoordinate_t, ResidentChunk> m_resident;
+
+            //! Coordinates of resident chunks, most recently used first.
+            std::list<ChunkCoordinate_t> m_lru;
+
+            //! Bytes used by resident chunks.
+            size_t m_memory_usage {0U};
+
+            //! Chunks that should be resident for the current focus.
+            std::unordered_set<ChunkCoordinate_t> m_wanted;
+
+            //! Protects the state shared with generation jobs below.
+            std::mutex m_mutex;
+
+            //! Signalled when a job finishes.
+            std::condition_variable m_job_finished;
+
+            //! Chunks waiting to be generated, furthest first, so the nearest request is popped from the back.
+            std::vector<ChunkCoordinate_t> m_requests;
+
+            //! Chunks currently being generated.
+            std::unordered_set<ChunkCoordinate_t> m_in_progress;
+
+            //! Chunks that have been generated, but not accepted by Update() yet.
+            std::vector<std::unique_ptr<Chunk>> m_completed;
+
+            //! Number of jobs submitted to the pool that have not finished.
+            size_t m_num_jobs {0U};
+    };
+}
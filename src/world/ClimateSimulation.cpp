@@ -0,0 +1,147 @@
+#include "ClimateSimulation.hpp"
+#include "Region.hpp"
+#include "World.hpp"
+#include "WorldParams.hpp"
+#include "math/Simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/ext/scalar_constants.hpp>
+
+namespace World {
+
+    //! Precipitation per tick of a region, in mm of water, for each point of moisture. A region with a moisture of
+    //! 100 gets about 2900 mm a year.
+    static constexpr float PRECIPITATION_PER_MOISTURE = 0.08F;
+
+    //! Fraction of the weather of a tick carried over to the next, and the largest change to it in a tick. Weather
+    //! changes the temperature by about 3 degrees, and the precipitation by about 80%, and lasts a few days.
+    static constexpr float TEMPERATURE_PERSISTENCE = 0.8F;
+    static constexpr float TEMPERATURE_CHANGE = 3.1F;
+    static constexpr float WETNESS_PERSISTENCE = 0.6F;
+    static constexpr float WETNESS_CHANGE = 1.1F;
+
+    //! Precipitation falls as snow below -2 degrees, as rain above 2 degrees, and as a mix of both in between.
+    static constexpr float SNOW_FRACTION_AT_ZERO = 0.5F;
+    static constexpr float SNOW_TEMPERATURE_RANGE = 4.0F;
+
+    //! Snow melted per tick for each degree above freezing, in mm of water.
+    static constexpr float MELT_RATE = 3.0F;
+
+    //! Deepest snow cover, in mm of water. Snow that never melts stops building up, as it would flow away as ice.
+    static constexpr float MAX_SNOW_COVER = 5000.0F;
+
+    //! Number of random numbers drawn for each region in a tick.
+    static constexpr uint64_t NOISE_PER_REGION = 2U;
+
+    //! Length of every array, padded so that the regions can be processed in groups of the SIMD width.
+    static size_t PadToSimdWidth(size_t size) {
+        return ((size + Math::Simd::FLOAT4_WIDTH - 1U) / Math::Simd::FLOAT4_WIDTH) * Math::Simd::FLOAT4_WIDTH;
+    }
+
+    //! Create a state with every array sized for a number of regions, and everything zero.
+    static ClimateState MakeEmptyState(size_t padded_size) {
+        ClimateState state;
+        state.temperatures.assign(padded_size, 0.0F);
+        state.precipitation.assign(padded_size, 0.0F);
+        state.snow_cover.assign(padded_size, 0.0F);
+        return state;
+    }
+
+    ClimateSimulation::ClimateSimulation(const World& world)
+        : m_num_regions(world.GetRegions().size())
+        , m_padded_size(PadToSimdWidth(world.GetRegions().size()))
+        , m_mean_temperatures(m_padded_size, 0.0F)
+        , m_seasonal_swings(m_padded_size, 0.0F)
+        , m_mean_precipitation(m_padded_size, 0.0F)
+        , m_land(m_padded_size, 0.0F)
+        , m_temperature_anomalies(m_padded_size, 0.0F)
+        , m_wetness_anomalies(m_padded_size, 0.0F)
+        , m_temperature_noise(m_padded_size, 0.0F)
+        , m_wetness_noise(m_padded_size, 0.0F)
+        , m_rng(world.GetParameters().GetSeed(), RNG_STREAM_WEATHER)
+        , m_state(MakeEmptyState(m_padded_size)) {
+
+        const float equator = static_cast<float>(world.GetSize().y) * 0.5F;
+        const std::vector<Region>& regions = world.GetRegions();
+        for (size_t regionId = 0U; regionId < m_num_regions; regionId++) {
+            const Region& region = regions[regionId];
+            const bool isNorth = (region.GetCentroid().y * TILE_PER_METER_F32) < equator;
+            m_mean_temperatures[regionId] = region.GetTemperature();
+            m_seasonal_swings[regionId] = isNorth ? region.GetTemperatureVariance() : -region.GetTemperatureVariance();
+            m_mean_precipitation[regionId] = region.GetMoisture() * PRECIPITATION_PER_MOISTURE;
+            m_land[regionId] = (region.GetIsOcean() || region.GetIsLake()) ? 0.0F : 1.0F;
+        }
+
+        m_state.Publish([this](const ClimateState& previous, ClimateState& next) {
+            Simulate(0U, previous, next);
+        });
+    }
+
+    size_t ClimateSimulation::GetNumRegions() const {
+        return m_num_regions;
+    }
+
+    void ClimateSimulation::Step() {
+        m_state.Publish([this](const ClimateState& previous, ClimateState& next) {
+            Simulate(previous.tick + 1U, previous, next);
+        });
+    }
+
+    Core::DoubleBuffer<ClimateState>::ReadHandle ClimateSimulation::GetState() const {
+        return m_state.Read();
+    }
+
+    void ClimateSimulation::Simulate(uint64_t tick, const ClimateState& previous, ClimateState& next) {
+
+        // a. draw the weather of each region. Padding is left without weather.
+        for (size_t regionId = 0U; regionId < m_num_regions; regionId++) {
+            const uint64_t index = ((tick * m_num_regions) + regionId) * NOISE_PER_REGION;
+            m_temperature_noise[regionId] = m_rng.Range(index, -TEMPERATURE_CHANGE, TEMPERATURE_CHANGE);
+            m_wetness_noise[regionId] = m_rng.Range(index + 1U, -WETNESS_CHANGE, WETNESS_CHANGE);
+        }
+
+        // b. the seasons follow a cosine through the year, coldest in the north at the start of the year.
+        const float yearFraction =
+            static_cast<float>(tick % DAYS_PER_YEAR) / static_cast<float>(DAYS_PER_YEAR);
+        const float season = -std::cos(2.0F * glm::pi<float>() * yearFraction);
+
+        // c. update every region, four at a time.
+        using namespace Math::Simd;
+        const Float4 zero = Splat(0.0F);
+        const Float4 one = Splat(1.0F);
+        const Float4 seasonFactor = Splat(season);
+        const Float4 temperaturePersistence = Splat(TEMPERATURE_PERSISTENCE);
+        const Float4 wetnessPersistence = Splat(WETNESS_PERSISTENCE);
+        const Float4 snowAtZero = Splat(SNOW_FRACTION_AT_ZERO);
+        const Float4 snowScale = Splat(1.0F / SNOW_TEMPERATURE_RANGE);
+        const Float4 meltRate = Splat(MELT_RATE);
+        const Float4 maxSnow = Splat(MAX_SNOW_COVER);
+
+        for (size_t index = 0U; index < m_padded_size; index += FLOAT4_WIDTH) {
+
+            const Float4 temperatureAnomaly = (temperaturePersistence * Load(&m_temperature_anomalies[index])) +
+                                              Load(&m_temperature_noise[index]);
+            const Float4 wetnessAnomaly =
+                (wetnessPersistence * Load(&m_wetness_anomalies[index])) + Load(&m_wetness_noise[index]);
+            Store(&m_temperature_anomalies[index], temperatureAnomaly);
+            Store(&m_wetness_anomalies[index], wetnessAnomaly);
+
+            const Float4 temperature = Load(&m_mean_temperatures[index]) +
+                                       (seasonFactor * Load(&m_seasonal_swings[index])) + temperatureAnomaly;
+            const Float4 precipitation = Load(&m_mean_precipitation[index]) * Max(one + wetnessAnomaly, zero);
+
+            // snow falls on land while it is freezing, and melts once it is not.
+            const Float4 snowFraction =
+                Min(Max(snowAtZero - (temperature * snowScale), zero), one) * Load(&m_land[index]);
+            const Float4 snowfall = precipitation * snowFraction;
+            const Float4 melt = meltRate * Max(temperature, zero);
+            const Float4 snow = Min(Max(Load(&previous.snow_cover[index]) + snowfall - melt, zero), maxSnow);
+
+            Store(&next.temperatures[index], temperature);
+            Store(&next.precipitation[index], precipitation);
+            Store(&next.snow_cover[index], snow);
+        }
+
+        next.tick = tick;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/DoubleBuffer.hpp"
+#include "math/Random.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World {
+
+    class World;
+
+    //! Climate of every region at one tick of a ClimateSimulation. The arrays are indexed by region ID, and are padded
+    //! past the last region to a multiple of the SIMD width.
+    struct ClimateState {
+        uint64_t tick {0U};                 //!< The tick, counting from zero.
+        std::vector<float> temperatures;    //!< Air temperature, in degrees Celsius.
+        std::vector<float> precipitation;   //!< Rain and snow that fell during the tick, in mm of water.
+        std::vector<float> snow_cover;      //!< Snow lying on the ground, in mm of water.
+    };
+
+    //! Seasons and weather of the regions of a world, advanced one day per tick.
+    //!
+    //! The climate assigned to each region by world generation is the average over a year. Each tick swings the
+    //! temperature of a region through the seasons by its temperature variance, adds weather that persists for a few
+    //! days, and lets rain and snow fall according to its moisture. Snow builds up while it is freezing, and melts in
+    //! proportion to how far the temperature is above freezing.
+    //!
+    //! The simulation is advanced one tick at a time with Step(), by the thread of the WorldSimulation that owns it.
+    //! Each tick is published to a double buffer, so any thread can read the latest climate with GetState() without
+    //! locking. Ticks only depend on the world and the tick count, so the climate at a tick is the same however it was
+    //! run.
+    class ClimateSimulation {
+
+        public:
+
+            //! Number of ticks, and so days, in a year. The year starts at the middle of the northern winter.
+            static constexpr uint32_t DAYS_PER_YEAR = 360U;
+
+            //! @brief Copy the climate of the regions of a world, and publish the climate at the first tick.
+            //!
+            //! Later changes to the regions of the world are not seen by the simulation.
+            explicit ClimateSimulation(const World& world);
+            ClimateSimulation(const ClimateSimulation& other) = delete;
+            ClimateSimulation(ClimateSimulation&& other) = delete;
+            ClimateSimulation& operator=(const ClimateSimulation& other) = delete;
+            ClimateSimulation& operator=(ClimateSimulation&& other) = delete;
+
+            ~ClimateSimulation() = default;
+
+            //! Get the number of regions simulated.
+            size_t GetNumRegions() const;
+
+            //! @brief Advance the simulation by one tick on the calling thread.
+            //!
+            //! Must only be called from one thread at a time.
+            void Step();
+
+            //! @brief Get the climate published by the latest tick. Lock free, and safe to call from any thread.
+            //!
+            //! The state is held until the handle is destroyed, which holds up the tick after next, so the handle
+            //! should not be kept for longer than a frame.
+            Core::DoubleBuffer<ClimateState>::ReadHandle GetState() const;
+
+        private:
+
+            //! @brief Simulate a tick.
+            //!
+            //! @param[in]  tick     The tick to simulate.
+            //! @param[in]  previous Climate at the previous tick, or with no snow for the first tick.
+            //! @param[out] next     Climate at the tick.
+            void Simulate(uint64_t tick, const ClimateState& previous, ClimateState& next);
+
+            //! Number of regions, and the length of every array including the padding.
+            size_t m_num_regions {0U};
+            size_t m_padded_size {0U};
+
+            //! Average temperature of each region over the year, in degrees Celsius.
+            std::vector<float> m_mean_temperatures;
+
+            //! Temperature swing of each region through the seasons, in degrees Celsius. Negative in the southern half
+            //! of the world, where the seasons are reversed.
+            std::vector<float> m_seasonal_swings;
+
+            //! Average precipitation of each region per tick, in mm of water.
+            std::vector<float> m_mean_precipitation;
+
+            //! One for land regions, and zero for water regions, where no snow lies.
+            std::vector<float> m_land;
+
+            //! Persistent weather of each region, as a change in temperature, and a relative change in precipitation.
+            //! Only touched by the thread running the ticks.
+            std::vector<float> m_temperature_anomalies;
+            std::vector<float> m_wetness_anomalies;
+
+            //! Random numbers drawn for the weather of each region during a tick.
+            std::vector<float> m_temperature_noise;
+            std::vector<float> m_wetness_noise;
+
+            //! Source of the weather.
+            Math::RandomStream m_rng;
+
+            //! The climate, as published by the latest tick.
+            Core::DoubleBuffer<ClimateState> m_state;
+    };
+}
@@ -0,0 +1,259 @@
+#include "GenerationCheck.hpp"
+#include "World.hpp"
+#include "WorldDigest.hpp"
+#include "WorldGenerator.hpp"
+#include "WorldParams.hpp"
+#include "WorldSave.hpp"
+#include "core/Logger.hpp"
+#include "core/ThreadPool.hpp"
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace World {
+
+    //! Parameters of a world in the fixed set of worlds that are checked.
+    struct CheckCase {
+        const char* name;
+        const char* seed;
+        size_t dimension;
+        size_t num_continents;
+        float percent_land;
+        size_t region_size;
+        size_t tectonic_steps;
+        bool simulate_atmosphere;
+    };
+
+    //! Worlds to check. Changing these invalidates the golden digests, so add new cases rather than editing old ones.
+    static const std::array<CheckCase, 6> CHECK_CASES = {{
+        {"default", "golden", 128U, 4U, 40.0F, 32U, 0U, false},
+        {"pangaea", "supercontinent", 192U, 1U, 45.0F, 48U, 0U, false},
+        {"archipelago", "islands", 128U, 7U, 20.0F, 16U, 0U, false},
+        {"large", "baseline", 256U, 4U, 40.0F, 64U, 0U, false},
+        {"drift", "tectonics", 128U, 4U, 40.0F, 32U, 64U, false},
+        {"monsoon", "trade winds", 192U, 3U, 40.0F, 32U, 0U, true}}};
+
+    static constexpr std::array<WorldPart, WorldDigest::NUM_PARTS> WORLD_PARTS = {
+        WorldPart::PLATES, WorldPart::REGIONS, WorldPart::TILES, WorldPart::GEOLOGY, WorldPart::BASINS,
+        WorldPart::RIVERS};
+
+    //! Digest of the world after each pass, in the order the passes ran.
+    using PassDigests_t = std::vector<std::pair<std::string, WorldDigest>>;
+
+    //! Recorded digest of one part of a world, after one pass.
+    struct GoldenDigest {
+        size_t count {0U};
+        uint64_t hash {0U};
+        std::vector<uint64_t> block_hashes;
+    };
+
+    //! Golden digests, keyed by MakeGoldenKey().
+    using GoldenDigests_t = std::unordered_map<std::string, GoldenDigest>;
+
+    static std::string MakeGoldenKey(const std::string& case_name, const std::string& pass_name, WorldPart part) {
+        return case_name + " " + pass_name + " " + WorldPartToString(part);
+    }
+
+    static std::unique_ptr<World> GenerateCase(const CheckCase& check_case, PassDigests_t& digests) {
+
+        WorldParams params;
+        params.SetName(check_case.name);
+        params.SetSeedAscii(check_case.seed);
+        params.SetDimension(check_case.dimension);
+        params.SetNumContinents(check_case.num_continents);
+        params.SetPercentLand(check_case.percent_land);
+        params.SetRegionSize(check_case.region_size);
+        params.SetTectonicSteps(check_case.tectonic_steps);
+        params.SetSimulateAtmosphere(check_case.simulate_atmosphere);
+
+        return WorldGenerator::Generate(params, [&digests](const char* pass_name, const World& world) {
+            digests.emplace_back(pass_name, WorldDigest(world));
+        });
+    }
+
+    //! Log the first element that differs between two digests. Returns whether any element differs.
+    static bool ReportDifference(const std::string& description, const std::string& pass_name,
+                                 const WorldDigest& expected, const WorldDigest& actual) {
+
+        for (WorldPart part : WORLD_PARTS) {
+            size_t index = expected.FindFirstDifference(actual, part);
+            if (index != WorldDigest::NO_DIFFERENCE) {
+                std::stringstream msg;
+                msg << description << " differ after the " << pass_name << " pass, first in "
+                    << WorldPartToString(part) << " element " << index;
+                Core::Logger::Error(msg.str());
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static bool CompareRuns(const std::string& description, const PassDigests_t& expected, const PassDigests_t& actual) {
+
+        if (expected.size() != actual.size()) {
+            Core::Logger::Error(description + " ran a different number of passes");
+            return false;
+        }
+
+        // only the first difference is interesting, since later passes inherit it.
+        for (size_t passIndex = 0U; passIndex < expected.size(); passIndex++) {
+            if (ReportDifference(description, expected[passIndex].first, expected[passIndex].second, actual[passIndex].second)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static GoldenDigests_t ReadGoldenDigests(const std::string& path) {
+
+        GoldenDigests_t golden;
+        std::ifstream file(path);
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || (line[0] == '#')) {
+                continue;
+            }
+
+            // <case> <pass> <part> <count> <hash> <block hashes...>
+            std::istringstream fields(line);
+            std::string caseName;
+            std::string passName;
+            std::string partName;
+            GoldenDigest digest;
+            fields >> caseName >> passName >> partName >> digest.count >> std::hex >> digest.hash;
+
+            uint64_t blockHash = 0U;
+            while (fields >> blockHash) {
+                digest.block_hashes.push_back(blockHash);
+            }
+
+            golden[caseName + " " + passName + " " + partName] = std::move(digest);
+        }
+
+        return golden;
+    }
+
+    static void WriteGoldenDigests(std::ostream& stream, const std::string& case_name, const PassDigests_t& digests) {
+
+        for (const auto& passDigest : digests) {
+            for (WorldPart part : WORLD_PARTS) {
+                stream << MakeGoldenKey(case_name, passDigest.first, part) << " "
+                       << std::dec << passDigest.second.GetCount(part) << " "
+                       << std::hex << std::setw(16) << std::setfill('0') << passDigest.second.GetHash(part);
+                for (uint64_t blockHash : passDigest.second.GetBlockHashes(part)) {
+                    stream << " " << std::setw(16) << blockHash;
+                }
+                stream << std::dec << "\n";
+            }
+        }
+    }
+
+    static bool CompareGolden(const GoldenDigests_t& golden, const std::string& case_name, const PassDigests_t& digests) {
+
+        for (const auto& passDigest : digests) {
+            for (WorldPart part : WORLD_PARTS) {
+
+                auto goldenItr = golden.find(MakeGoldenKey(case_name, passDigest.first, part));
+                if (goldenItr == golden.end()) {
+                    Core::Logger::Error(case_name + ": no golden digest for the " + passDigest.first +
+                                        " pass. Record them with worldCheck=record");
+                    return false;
+                }
+
+                const GoldenDigest& expected = goldenItr->second;
+                const WorldDigest& actual = passDigest.second;
+                if ((expected.count == actual.GetCount(part)) && (expected.hash == actual.GetHash(part))) {
+                    continue;
+                }
+
+                // narrow the difference down to the first block that differs.
+                std::vector<uint64_t> blockHashes = actual.GetBlockHashes(part);
+                size_t block = 0U;
+                while ((block < blockHashes.size()) && (block < expected.block_hashes.size()) &&
+                       (blockHashes[block] == expected.block_hashes[block])) {
+                    block++;
+                }
+
+                std::stringstream msg;
+                msg << case_name << ": differs from the golden digests after the " << passDigest.first << " pass, first in "
+                    << WorldPartToString(part) << " elements " << (block * WorldDigest::BLOCK_SIZE) << " to "
+                    << ((block + 1U) * WorldDigest::BLOCK_SIZE) - 1U << " (expected " << expected.count
+                    << " elements, found " << actual.GetCount(part) << ")";
+                Core::Logger::Error(msg.str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool RunGenerationCheck(const std::string& golden_path, bool record) {
+
+        GoldenDigests_t golden;
+        if (!record) {
+            golden = ReadGoldenDigests(golden_path);
+        }
+
+        std::stringstream recorded;
+        Core::ThreadPool serialPool(0U);
+        bool passed = true;
+
+        for (const CheckCase& checkCase : CHECK_CASES) {
+
+            const std::string caseName = checkCase.name;
+            Core::Logger::Info("Checking world generation for " + caseName);
+
+            PassDigests_t parallelDigests;
+            std::unique_ptr<World> p_world = GenerateCase(checkCase, parallelDigests);
+
+            PassDigests_t serialDigests;
+            {
+                Core::ThreadPool::ScopedInstance serial(serialPool);
+                GenerateCase(checkCase, serialDigests);
+            }
+            passed = CompareRuns(caseName + ": serial and multithreaded worlds", parallelDigests, serialDigests) && passed;
+
+            std::stringstream saveStream(std::ios::in | std::ios::out | std::ios::binary);
+            WriteWorld(saveStream, *p_world);
+            std::unique_ptr<World> p_loaded = ReadWorld(saveStream);
+            passed = !ReportDifference(caseName + ": saved and loaded worlds", parallelDigests.back().first,
+                                       parallelDigests.back().second, WorldDigest(*p_loaded)) && passed;
+
+            if (record) {
+                WriteGoldenDigests(recorded, caseName, parallelDigests);
+            } else {
+                passed = CompareGolden(golden, caseName, parallelDigests) && passed;
+            }
+        }
+
+        if (record) {
+            std::ofstream file(golden_path);
+            if (!file.is_open()) {
+                Core::Logger::Error("Failed to write golden digests to " + golden_path);
+                return false;
+            }
+
+            file << "# World generation digests, written by worldCheck=record.\n"
+                 << "# <case> <pass> <part> <count> <hash> <hash of each block of "
+                 << WorldDigest::BLOCK_SIZE << " elements...>\n"
+                 << recorded.str();
+            Core::Logger::Info("Recorded golden digests to " + golden_path);
+        }
+
+        if (passed) {
+            Core::Logger::Info("World generation check passed");
+        } else {
+            Core::Logger::Error("World generation check failed");
+        }
+
+        return passed;
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+namespace World {
+
+    //! @brief Check that world generation is deterministic, and still produces the worlds it did when recorded.
+    //!
+    //! Generates a fixed set of worlds, once with the shared thread pool and once with no worker threads, and hashes
+    //! the world after every pass with WorldDigest. Each world must match between the two runs, must survive a save and
+    //! load unchanged, and must match the digests in the golden file. Every failure is logged with the first pass, part
+    //! and element that differs.
+    //!
+    //! Golden digests depend on the floating point behavior of the compiler and platform, so record them with the
+    //! build that is being checked against. The digests in content/data/world_digests.txt are checked by the WorldTests
+    //! CTest target.
+    //!
+    //! @param[in] golden_path Path to the file of golden digests.
+    //! @param[in] record      Write the digests of this build to the golden file, rather than comparing against it.
+    //!
+    //! @returns Whether every check passed.
+    bool RunGenerationCheck(const std::string& golden_path, bool record);
+}
@@ -0,0 +1,143 @@
+#include "Geology.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace World {
+
+    std::string RockTypeToString(RockType rock) {
+        switch (rock) {
+            case RockType::SOIL:
+                return "Soil";
+            case RockType::SAND:
+                return "Sand";
+            case RockType::SANDSTONE:
+                return "Sandstone";
+            case RockType::SHALE:
+                return "Shale";
+            case RockType::LIMESTONE:
+                return "Limestone";
+            case RockType::SLATE:
+                return "Slate";
+            case RockType::MARBLE:
+                return "Marble";
+            case RockType::GRANITE:
+                return "Granite";
+            case RockType::BASALT:
+                return "Basalt";
+            case RockType::OBSIDIAN:
+                return "Obsidian";
+            default:
+                return {};
+        }
+    }
+
+    std::string ResourceTypeToString(ResourceType resource) {
+        switch (resource) {
+            case ResourceType::NONE:
+                return "None";
+            case ResourceType::COAL:
+                return "Coal";
+            case ResourceType::IRON:
+                return "Iron";
+            case ResourceType::COPPER:
+                return "Copper";
+            case ResourceType::TIN:
+                return "Tin";
+            case ResourceType::SILVER:
+                return "Silver";
+            case ResourceType::GOLD:
+                return "Gold";
+            case ResourceType::GEMS:
+                return "Gems";
+            case ResourceType::SALT:
+                return "Salt";
+            default:
+                return {};
+        }
+    }
+
+    Geology::Geology(const std::vector<std::vector<GeologyLayer>>& region_layers) {
+
+        m_offsets.reserve(region_layers.size() + 1U);
+        for (const std::vector<GeologyLayer>& layers : region_layers) {
+
+            const size_t first = m_layers.size();
+            for (const GeologyLayer& layer : layers) {
+
+                // a layer of the same rock and resource as the one above just makes that layer deeper.
+                if ((m_layers.size() > first) && (m_layers.back().rock == layer.rock) &&
+                    (m_layers.back().resource == layer.resource)) {
+                    m_layers.back().bottom_depth = layer.bottom_depth;
+                } else {
+                    m_layers.push_back(layer);
+                }
+            }
+
+            m_offsets.push_back(static_cast<uint32_t>(m_layers.size()));
+        }
+    }
+
+    Geology::Geology(std::vector<uint32_t>&& offsets, std::vector<GeologyLayer>&& layers)
+        : m_offsets(std::move(offsets))
+        , m_layers(std::move(layers)) {
+
+        if (m_offsets.empty() || (m_offsets.front() != 0U) || (m_offsets.back() != m_layers.size())) {
+            throw std::runtime_error("Invalid geology layer table");
+        }
+
+        for (size_t regionId = 0U; regionId + 1U < m_offsets.size(); regionId++) {
+            if (m_offsets[regionId] >= m_offsets[regionId + 1U]) {
+                throw std::runtime_error("Invalid geology layer table");
+            }
+        }
+    }
+
+    size_t Geology::GetNumRegions() const {
+        return m_offsets.size() - 1U;
+    }
+
+    size_t Geology::GetNumLayers(RegionId_t region_id) const {
+        return m_offsets.at(region_id + 1) - m_offsets.at(region_id);
+    }
+
+    const GeologyLayer& Geology::GetLayer(RegionId_t region_id, size_t index) const {
+        if (index >= GetNumLayers(region_id)) {
+            throw std::out_of_range("Geology layer index out of range");
+        }
+        return m_layers[m_offsets[region_id] + index];
+    }
+
+    const GeologyLayer& Geology::GetLayerAt(RegionId_t region_id, float depth) const {
+
+        auto first = m_layers.begin() + m_offsets.at(region_id);
+        auto last = m_layers.begin() + m_offsets.at(region_id + 1) - 1;
+
+        // the first layer whose bottom is below the depth. Anything deeper than the last layer is in the last layer.
+        auto layer = std::upper_bound(first, last, depth, [](float value, const GeologyLayer& element) {
+            return value < static_cast<float>(element.bottom_depth);
+        });
+        return *layer;
+    }
+
+    float Geology::FindResourceDepth(RegionId_t region_id, ResourceType resource) const {
+
+        float top = 0.0F;
+        for (uint32_t layer = m_offsets.at(region_id); layer < m_offsets.at(region_id + 1); layer++) {
+            if (m_layers[layer].resource == resource) {
+                return top;
+            }
+            top = static_cast<float>(m_layers[layer].bottom_depth);
+        }
+
+        return -1.0F;
+    }
+
+    const std::vector<uint32_t>& Geology::GetOffsets() const {
+        return m_offsets;
+    }
+
+    const std::vector<GeologyLayer>& Geology::GetLayers() const {
+        return m_layers;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Region.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace World {
+
+    //! Kind of rock that a geological layer is made of.
+    enum class RockType : uint8_t {
+        SOIL = 0,
+        SAND,
+        SANDSTONE, // Sedimentary rocks
+        SHALE,
+        LIMESTONE,
+        SLATE, // Metamorphic rocks
+        MARBLE,
+        GRANITE, // Igneous rocks
+        BASALT,
+        OBSIDIAN
+    };
+
+    static constexpr size_t ROCK_TYPE_COUNT = static_cast<size_t>(RockType::OBSIDIAN) + 1;
+
+    //! Resource that can be mined from a geological layer.
+    enum class ResourceType : uint8_t {
+        NONE = 0,
+        COAL,
+        IRON,
+        COPPER,
+        TIN,
+        SILVER,
+        GOLD,
+        GEMS,
+        SALT
+    };
+
+    static constexpr size_t RESOURCE_TYPE_COUNT = static_cast<size_t>(ResourceType::SALT) + 1;
+
+    std::string RockTypeToString(RockType rock);
+    std::string ResourceTypeToString(ResourceType resource);
+
+    //! A run of the same rock holding the same resource, from the bottom of the layer above down to its own bottom.
+    struct GeologyLayer {
+        uint16_t bottom_depth;  //!< Depth of the bottom of the layer below the surface, in meters.
+        RockType rock;          //!< Rock the layer is made of.
+        ResourceType resource;  //!< Resource found in the layer.
+
+        bool operator==(const GeologyLayer& other) const {
+            return (bottom_depth == other.bottom_depth) && (rock == other.rock) && (resource == other.resource);
+        }
+    };
+
+    //! Layers of rock under every region, from the surface down to MAX_DEPTH.
+    //!
+    //! The layers of all regions are kept in a single table, with the layers of each region stored one after another,
+    //! and adjacent layers of the same rock and resource merged into one run. Each layer takes four bytes, so the
+    //! geology of a world costs a few dozen bytes per region rather than per tile.
+    class Geology {
+
+        public:
+
+            //! Deepest layer generated, in meters. The last layer of each region reaches this depth, and extends below.
+            static constexpr uint16_t MAX_DEPTH = 4096U;
+
+            //! Create geology with no regions.
+            Geology() = default;
+
+            //! @brief Create geology from the layers of each region.
+            //!
+            //! @param[in] region_layers The layers of each region, indexed by region ID, from the surface down. Layers
+            //!                          must be ordered by depth, and each region needs at least one layer.
+            explicit Geology(const std::vector<std::vector<GeologyLayer>>& region_layers);
+
+            //! @brief Create geology from its layer table, as returned by GetOffsets() and GetLayers().
+            //!
+            //! Throws std::runtime_error if the table is malformed.
+            Geology(std::vector<uint32_t>&& offsets, std::vector<GeologyLayer>&& layers);
+
+            //! @brief Get the number of regions.
+            size_t GetNumRegions() const;
+
+            //! @brief Get the number of layers under a region.
+            size_t GetNumLayers(RegionId_t region_id) const;
+
+            //! @brief Get a layer under a region.
+            //!
+            //! @param[in] region_id The region.
+            //! @param[in] index     Index of the layer, counting down from the surface.
+            const GeologyLayer& GetLayer(RegionId_t region_id, size_t index) const;
+
+            //! @brief Find the layer at a depth under a region.
+            //!
+            //! @param[in] region_id The region.
+            //! @param[in] depth     Depth below the surface, in meters. Depths below MAX_DEPTH are in the last layer.
+            //!
+            //! @returns The layer.
+            const GeologyLayer& GetLayerAt(RegionId_t region_id, float depth) const;
+
+            //! @brief Find the shallowest layer under a region that holds a resource.
+            //!
+            //! @returns The depth of the top of the layer in meters, or a negative value if the region has none.
+            float FindResourceDepth(RegionId_t region_id, ResourceType resource) const;
+
+            //! @brief Get the index of the first layer of each region in GetLayers(), followed by the number of layers.
+            const std::vector<uint32_t>& GetOffsets() const;
+
+            //! @brief Get the layers of every region.
+            const std::vector<GeologyLayer>& GetLayers() const;
+
+        private:
+
+            //! Index of the first layer of each region, followed by the total number of layers.
+            std::vector<uint32_t> m_offsets {0U};
+
+            //! Layers of every region.
+            std::vector<GeologyLayer> m_layers;
+    };
+}
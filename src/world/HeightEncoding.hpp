@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace World {
+
+    //! 16 bit fixed point encoding of heights, used to store tile heights and water levels.
+    //!
+    //! A height is stored as round((height - offset) / scale). Heights inside the encoded range come back with an
+    //! error of at most half a step, see GetMaxError(). Heights outside of the range are clamped to it. The default
+    //! encoding has a step of 0.375 m, covers about -12.3 km to 12.3 km, and stores a height of zero exactly. Its
+    //! error is at most 0.1875 m.
+    //!
+    //! Worlds fit their encoding to their own range of heights as they are generated, with FromRange(), and store it
+    //! in their save. See World::FitHeightEncoding().
+    class HeightEncoding {
+
+        public:
+
+            static constexpr uint32_t MAX_VALUE = UINT16_MAX;
+
+            //! Exact in binary, so that every encoded value decodes to an exact float.
+            static constexpr float DEFAULT_SCALE = 0.375F;
+            static constexpr float DEFAULT_OFFSET = -DEFAULT_SCALE * static_cast<float>((MAX_VALUE + 1U) / 2U);
+
+            //! @brief Create the default encoding.
+            HeightEncoding()
+                : HeightEncoding(DEFAULT_OFFSET, DEFAULT_SCALE) {
+            }
+
+            //! @brief Create an encoding from an offset and scale, as stored in a world save.
+            //!
+            //! @param[in] offset Height of the encoded value 0, in meters.
+            //! @param[in] scale  Height of one step, in meters. Must be positive.
+            HeightEncoding(float offset, float scale)
+                : m_offset(offset)
+                , m_scale(scale)
+                , m_inverse_scale(1.0F / scale) {
+            }
+
+            //! @brief Create the encoding with the smallest step that covers a range of heights.
+            //!
+            //! The step is a power of two, and the offset a whole number of steps, so that every encoded value decodes
+            //! to an exact float, and a height of zero is stored exactly when it is inside the range.
+            //!
+            //! @param[in] min_height The lowest height, in meters.
+            //! @param[in] max_height The highest height, in meters. Must be greater than min_height.
+            static HeightEncoding FromRange(float min_height, float max_height) {
+
+                // one step is kept spare, as the offset is rounded down to a whole step.
+                int exponent = 0;
+                std::frexp((max_height - min_height) / static_cast<float>(MAX_VALUE - 1U), &exponent);
+                const float scale = std::ldexp(1.0F, exponent);
+                return {std::floor(min_height / scale) * scale, scale};
+            }
+
+            float GetOffset() const {
+                return m_offset;
+            }
+
+            float GetScale() const {
+                return m_scale;
+            }
+
+            //! @brief Get the largest difference between a height inside the range and its decoded value.
+            float GetMaxError() const {
+                return m_scale * 0.5F;
+            }
+
+            //! @brief Encode a height.
+            //!
+            //! @param[in] height The height, in meters.
+            //!
+            //! @returns The nearest encoded value.
+            uint16_t Encode(float height) const {
+                float value = std::round((height - m_offset) * m_inverse_scale);
+                return static_cast<uint16_t>(std::clamp(value, 0.0F, static_cast<float>(MAX_VALUE)));
+            }
+
+            //! @brief Decode a height.
+            //!
+            //! @param[in] value The encoded value.
+            //!
+            //! @returns The height, in meters.
+            float Decode(uint16_t value) const {
+                return m_offset + (static_cast<float>(value) * m_scale);
+            }
+
+            //! @brief Encode an array of heights. Written as a plain loop so that the compiler can vectorize it.
+            void Encode(const float* p_heights, uint16_t* p_values, size_t count) const {
+                for (size_t index = 0U; index < count; index++) {
+                    p_values[index] = Encode(p_heights[index]);
+                }
+            }
+
+            //! @brief Decode an array of heights. Written as a plain loop so that the compiler can vectorize it.
+            void Decode(const uint16_t* p_values, float* p_heights, size_t count) const {
+                for (size_t index = 0U; index < count; index++) {
+                    p_heights[index] = Decode(p_values[index]);
+                }
+            }
+
+        private:
+
+            //! Height of the encoded value 0, in meters.
+            float m_offset;
+
+            //! Height of one step, in meters.
+            float m_scale;
+
+            float m_inverse_scale;
+    };
+}
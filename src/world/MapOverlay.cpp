@@ -1,9 +1,12 @@
 #include "MapOverlay.hpp"
+#include "Basin.hpp"
 #include "Biome.hpp"
 #include "World.hpp"
 #include "Region.hpp"
 #include "Tile.hpp"
 #include "TectonicPlate.hpp"
+#include "WorldSimulation.hpp"
+#include "math/Hash.hpp"
 #include <algorithm>
 #include <cstdint>
 #include <glm/fwd.hpp>
@@ -13,7 +16,10 @@
 
 namespace World {
 
-    std::vector<uint8_t> MapOverlay::GetOverlay(World& world, OverlayType overlayType) {
+    //! Snow cover, in mm of water, above which the snow overlay is white.
+    static constexpr float SNOW_FOR_FULL_COVER = 50.0F;
+
+    std::vector<uint8_t> MapOverlay::GetOverlay(const World& world, OverlayType overlayType) {
         switch (overlayType) {
             case OverlayType::PLATE_TECTONICS:
                 return GetPlateTectonicsOverlay(world);
@@ -27,6 +33,8 @@ namespace World {
                 return GetMoistureOverlay(world);
             case OverlayType::BIOME_MAP:
                 return GetBiomeOverlay(world);
+            case OverlayType::BASIN_MAP:
+                return GetBasinOverlay(world);
             default:
                 // Return black overlay for unknown types
                 Extent_t size = world.GetSize();
@@ -34,14 +42,26 @@ namespace World {
         }
     }
 
-    std::vector<uint8_t> MapOverlay::GetPlateTectonicsOverlay(World& world) {
+    std::vector<uint8_t> MapOverlay::GetOverlay(
+        const World& world, const WorldSnapshot& snapshot, OverlayType overlayType) {
+        switch (overlayType) {
+            case OverlayType::WEATHER_MAP:
+                return GetTemperatureOverlay(world, snapshot.climate.temperatures);
+            case OverlayType::SNOW_MAP:
+                return GetSnowOverlay(world, snapshot.climate.snow_cover);
+            default:
+                return GetOverlay(world, overlayType);
+        }
+    }
+
+    std::vector<uint8_t> MapOverlay::GetPlateTectonicsOverlay(const World& world) {
         Extent_t size = world.GetSize();
         size_t num_pixels = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
 
         // RGBA buffer - 4 bytes per pixel
         std::vector<uint8_t> buffer(num_pixels * 4, 255);  // Initialize to white with alpha = 255
 
-        const std::vector<Tile>& tiles = world.GetTiles();
+        ConstTileView tiles = world.GetTiles();
         const std::vector<Region>& regions = world.GetRegions();
         const std::vector<TectonicPlate>& plates = world.GetPlates();
 
@@ -101,14 +121,14 @@ namespace World {
         return buffer;
     }
 
-    std::vector<uint8_t> MapOverlay::GetHeightMapOverlay(World& world) {
+    std::vector<uint8_t> MapOverlay::GetHeightMapOverlay(const World& world) {
         Extent_t size = world.GetSize();
         size_t num_pixels = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
 
         // RGBA buffer - 4 bytes per pixel
         std::vector<uint8_t> buffer(num_pixels * 4);
 
-        const std::vector<Tile>& tiles = world.GetTiles();
+        ConstTileView tiles = world.GetTiles();
 
         // Find min and max heights for normalization
         float min_height = std::numeric_limits<float>::max();
@@ -153,14 +173,14 @@ namespace World {
         return buffer;
     }
 
-    std::vector<uint8_t> MapOverlay::GetWaterMapOverlay(World& world) {
+    std::vector<uint8_t> MapOverlay::GetWaterMapOverlay(const World& world) {
         Extent_t size = world.GetSize();
         size_t num_pixels = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
 
         // RGBA buffer - 4 bytes per pixel
         std::vector<uint8_t> buffer(num_pixels * 4);
 
-        const std::vector<Tile>& tiles = world.GetTiles();
+        ConstTileView tiles = world.GetTiles();
 
         // Process each tile
         for (const auto& tile : tiles) {
@@ -195,7 +215,17 @@ namespace World {
         return buffer;
     }
 
-    std::vector<uint8_t> MapOverlay::GetHeatMapOverlay(World& world) {
+    std::vector<uint8_t> MapOverlay::GetHeatMapOverlay(const World& world) {
+
+        const std::vector<Region>& regions = world.GetRegions();
+        std::vector<float> temperatures(regions.size());
+        std::transform(regions.begin(), regions.end(), temperatures.begin(),
+            [](const Region& region) { return region.GetTemperature(); });
+
+        return GetTemperatureOverlay(world, temperatures);
+    }
+
+    std::vector<uint8_t> MapOverlay::GetTemperatureOverlay(const World& world, const std::vector<float>& temperatures) {
 
         Extent_t size = world.GetSize();
         size_t num_pixels = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
@@ -203,8 +233,8 @@ namespace World {
         // RGBA buffer - 4 bytes per pixel
         std::vector<uint8_t> buffer(num_pixels * 4);
 
-        const std::vector<Tile>& tiles = world.GetTiles();
-        const std::vector<Region>& regions = world.GetRegions();
+        ConstTileView tiles = world.GetTiles();
+        const size_t numRegions = world.GetRegions().size();
 
         glm::vec4 coldColor(0.0F, 0.0F, 1.0F, 1.0F);
         glm::vec4 zeroColor(1.0F, 0.0F, 1.0F, 1.0F);
@@ -213,22 +243,20 @@ namespace World {
         float minTemp = std::numeric_limits<float>::max();
         float maxTemp = std::numeric_limits<float>::min();
 
-        for (const Region& region : regions) {
+        for (size_t regionId = 0U; regionId < numRegions; regionId++) {
 
-            minTemp = std::min(region.GetTemperature(), minTemp);
-            maxTemp = std::max(region.GetTemperature(), maxTemp);
+            minTemp = std::min(temperatures.at(regionId), minTemp);
+            maxTemp = std::max(temperatures.at(regionId), maxTemp);
         }
 
-        for (const Tile& tile : tiles) {
+        for (ConstTile tile : tiles) {
 
             TileId_t tile_id = tile.GetTileId();
             size_t pixel_idx = static_cast<size_t>(tile_id) * 4;
 
-            const Region& region = regions.at(tile.GetRegionId());
-
             glm::vec4 color;
 
-            float temperature = region.GetTemperature();
+            float temperature = temperatures.at(tile.GetRegionId());
 
             if (temperature < 0.0F) {
                 // mix cold to zero
@@ -257,14 +285,14 @@ namespace World {
         return buffer;
     }
 
-    std::vector<uint8_t> MapOverlay::GetMoistureOverlay(World& world) {
+    std::vector<uint8_t> MapOverlay::GetMoistureOverlay(const World& world) {
         Extent_t size = world.GetSize();
         size_t num_pixels = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
 
         // RGBA buffer - 4 bytes per pixel
         std::vector<uint8_t> buffer(num_pixels * 4);
 
-        const std::vector<Tile>& tiles = world.GetTiles();
+        ConstTileView tiles = world.GetTiles();
         const std::vector<Region>& regions = world.GetRegions();
 
         glm::vec4 dryColor(1.0F, 0.0F, 0.0F, 1.0F);
@@ -279,7 +307,7 @@ namespace World {
             maxMoisture = std::max(region.GetTemperature(), maxMoisture);
         }
 
-        for (const Tile& tile : tiles) {
+        for (ConstTile tile : tiles) {
 
             TileId_t tile_id = tile.GetTileId();
             size_t pixel_idx = static_cast<size_t>(tile_id) * 4;
@@ -309,28 +337,27 @@ namespace World {
     }
 
 
-    std::vector<uint8_t> MapOverlay::GetBiomeOverlay(World& world) {
+    std::vector<uint8_t> MapOverlay::GetBiomeOverlay(const World& world) {
         Extent_t size = world.GetSize();
         size_t num_pixels = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
 
         // RGBA buffer - 4 bytes per pixel
         std::vector<uint8_t> buffer(num_pixels * 4);
 
-        const std::vector<Tile>& tiles = world.GetTiles();
-        const std::vector<Region>& regions = world.GetRegions();
+        ConstTileView tiles = world.GetTiles();
 
-        for (const Tile& tile : tiles) {
+        for (ConstTile tile : tiles) {
 
             TileId_t tile_id = tile.GetTileId();
             size_t pixel_idx = static_cast<size_t>(tile_id) * 4;
 
-            const Region& region = regions.at(tile.GetRegionId());
+            BiomeType biome = tile.GetBiome();
 
             glm::u8vec4 color;
 
             if (tile.GetIsRiver()) {
 
-                if (region.GetBiome() == BiomeType::ICE_SHEET) {
+                if (biome == BiomeType::ICE_SHEET) {
                     color = {189, 189, 189, 255};
                 }
                 else {
@@ -339,7 +366,7 @@ namespace World {
             }
             else {
 
-                switch (region.GetBiome()) {
+                switch (biome) {
 
                     case BiomeType::OCEAN:
                         color = glm::u8vec4(0U, 51U, 102U, 255U);
@@ -409,4 +436,67 @@ namespace World {
         return buffer;
     }
 
+    //! Pick a color for a basin, so that neighboring basins are likely to differ.
+    static glm::u8vec4 GetBasinColor(BasinId_t basin_id) {
+        uint64_t hash = Math::HashFNV1A64(&basin_id, sizeof(basin_id));
+        return {
+            static_cast<uint8_t>(96U + (hash & 0x7FU)),
+            static_cast<uint8_t>(96U + ((hash >> 8U) & 0x7FU)),
+            static_cast<uint8_t>(96U + ((hash >> 16U) & 0x7FU)),
+            UINT8_MAX};
+    }
+
+    std::vector<uint8_t> MapOverlay::GetBasinOverlay(const World& world) {
+        Extent_t size = world.GetSize();
+        size_t num_pixels = static_cast<size_t>(size.x) * static_cast<size_t>(size.y);
+
+        // RGBA buffer - 4 bytes per pixel
+        std::vector<uint8_t> buffer(num_pixels * 4);
+
+        ConstTileView tiles = world.GetTiles();
+
+        for (ConstTile tile : tiles) {
+
+            size_t pixel_idx = static_cast<size_t>(tile.GetTileId()) * 4;
+            BasinId_t basin_id = tile.GetBasinId();
+
+            glm::u8vec4 color(0U, 51U, 102U, 255U);  // Dark blue for ocean
+            if (basin_id != INVALID_BASIN_ID) {
+                const Basin& basin = world.GetBasin(basin_id);
+                if ((basin.lake != INVALID_BASIN_ID) && (tile.GetAbsoluteHeight() < basin.water_level)) {
+                    glm::u8vec4 lake = GetBasinColor(basin.lake);
+                    color = glm::u8vec4(lake.r / 4U, lake.g / 4U, 128U + (lake.b / 2U), 255U);
+                } else {
+                    color = GetBasinColor(basin_id);
+                }
+            }
+
+            buffer.at(pixel_idx + 0) = color.r;
+            buffer.at(pixel_idx + 1) = color.g;
+            buffer.at(pixel_idx + 2) = color.b;
+            buffer.at(pixel_idx + 3) = color.a;
+        }
+
+        return buffer;
+    }
+
+    std::vector<uint8_t> MapOverlay::GetSnowOverlay(const World& world, const std::vector<float>& snow_cover) {
+
+        std::vector<uint8_t> buffer = GetBiomeOverlay(world);
+
+        ConstTileView tiles = world.GetTiles();
+
+        for (ConstTile tile : tiles) {
+
+            size_t pixel_idx = static_cast<size_t>(tile.GetTileId()) * 4;
+            float cover = std::clamp(snow_cover.at(tile.GetRegionId()) / SNOW_FOR_FULL_COVER, 0.0F, 1.0F);
+
+            for (size_t channel = 0U; channel < 3U; channel++) {
+                float value = static_cast<float>(buffer.at(pixel_idx + channel));
+                buffer.at(pixel_idx + channel) = static_cast<uint8_t>(value + ((255.0F - value) * cover));
+            }
+        }
+
+        return buffer;
+    }
 }
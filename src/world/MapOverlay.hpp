@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 namespace World {
 
     class World;
+    struct WorldSnapshot;
 
     //! The type of overlay
     enum class OverlayType : uint8_t {
@@ -14,13 +16,24 @@ namespace World {
         HEAT_MAP = 3,
         MOISTURE_MAP = 4,
         BIOME_MAP = 5,
+        BASIN_MAP = 6,
+        WEATHER_MAP = 7,    //!< Temperature of the latest tick of a simulation.
+        SNOW_MAP = 8,       //!< Snow cover of the latest tick of a simulation, over the biomes.
     };
 
     class MapOverlay {
 
         public:
 
-            static std::vector<uint8_t> GetOverlay(World& world, OverlayType overlayType);
+            //! @brief Get an overlay of a world, as it was generated.
+            //!
+            //! Overlays of a simulation are black, as there is no snapshot to draw them from.
+            static std::vector<uint8_t> GetOverlay(const World& world, OverlayType overlayType);
+
+            //! @brief Get an overlay of a world while it is simulated, drawing anything that changes over time from a
+            //! snapshot of the simulation.
+            static std::vector<uint8_t> GetOverlay(
+                const World& world, const WorldSnapshot& snapshot, OverlayType overlayType);
 
         private:
 
@@ -32,11 +45,11 @@ namespace World {
             //! - white maps to pixels within regions that are not on plate boundaries
             //!
             //! Alpha channel is set to opaque.
-            static std::vector<uint8_t> GetPlateTectonicsOverlay(World& world);
+            static std::vector<uint8_t> GetPlateTectonicsOverlay(const World& world);
 
             //! Returns a greyscale buffer of pixels, where rgb channels are used to indicate height. Height is normalized
             //! between black and white, where black is lowest elevation, and white is highest elevation.
-            static std::vector<uint8_t> GetHeightMapOverlay(World& world);
+            static std::vector<uint8_t> GetHeightMapOverlay(const World& world);
 
             //! Returns a colored buffer of pixels representing water and land features:
             //! - Dark blue for ocean water
@@ -45,19 +58,35 @@ namespace World {
             //! - Green for land
             //!
             //! Alpha channel is set to opaque.
-            static std::vector<uint8_t> GetWaterMapOverlay(World& world);
+            static std::vector<uint8_t> GetWaterMapOverlay(const World& world);
 
             //! Returns a colored buffer of pixels where temperature values are interpolated between blue and red colors.
             //! Temperatures greater than 0 Celsius are red.
             //! Temperatures less than 0 Celsius are blue.
-            static std::vector<uint8_t> GetHeatMapOverlay(World& world);
+            static std::vector<uint8_t> GetHeatMapOverlay(const World& world);
+
+            //! Returns the heat map of a temperature for each region, indexed by region ID.
+            static std::vector<uint8_t> GetTemperatureOverlay(
+                const World& world, const std::vector<float>& temperatures);
 
             //! Returns a colored buffer of pixels where moisture values are represented in grayscale.
             //! Moisture of 0 is black.
             //! Moisture of 100 is white.
-            static std::vector<uint8_t> GetMoistureOverlay(World& world);
+            static std::vector<uint8_t> GetMoistureOverlay(const World& world);
 
             //! Returns a colored buffer of pixels where biome values are represented as colors
-            static std::vector<uint8_t> GetBiomeOverlay(World& world);
+            static std::vector<uint8_t> GetBiomeOverlay(const World& world);
+
+            //! Returns a colored buffer of pixels where each drainage basin is given its own color:
+            //! - Dark blue for ocean water
+            //! - Each basin is a pale color picked from a hash of its ID
+            //! - Tiles flooded by the lake of a basin are a darker blue, tinted with the color of the lake
+            //!
+            //! Alpha channel is set to opaque.
+            static std::vector<uint8_t> GetBasinOverlay(const World& world);
+
+            //! Returns the biome overlay, faded towards white by the snow cover of each region, indexed by region ID.
+            //! Regions with 50 mm of water or more in snow are white.
+            static std::vector<uint8_t> GetSnowOverlay(const World& world, const std::vector<float>& snow_cover);
     };
 };
\ No newline at end of file
@@ -0,0 +1,416 @@
+#include "PathFinder.hpp"
+#include "World.hpp"
+#include "WorldParams.hpp"
+#include "core/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+
+namespace World {
+
+    //! Extra cost for each tile of height climbed or descended.
+    static constexpr float SLOPE_COST = 2.0F;
+
+    static constexpr float DIAGONAL_DISTANCE = 1.41421356F;
+
+    //! Requests handled by each task when finding paths in a batch.
+    static constexpr size_t REQUESTS_PER_TASK = 8U;
+
+    //! Set of indices, which can be cleared in constant time by bumping a generation counter.
+    struct StampSet {
+        std::vector<uint32_t> stamps;
+        uint32_t generation {0U};
+
+        void Resize(size_t size) {
+            stamps.assign(size, 0U);
+            generation = 0U;
+        }
+
+        void Clear() {
+            generation++;
+            if (generation == 0U) {
+                // wrapped around, so old stamps could alias the new generation.
+                std::fill(stamps.begin(), stamps.end(), 0U);
+                generation = 1U;
+            }
+        }
+
+        bool Contains(size_t index) const {
+            return stamps[index] == generation;
+        }
+
+        void Insert(size_t index) {
+            stamps[index] = generation;
+        }
+    };
+
+    //! Open list entry, ordered by estimated total cost.
+    using HeapEntry_t = std::pair<float, uint32_t>;
+
+    struct PathFinder::SearchContext {
+        StampSet tile_seen;
+        StampSet tile_closed;
+        std::vector<float> tile_cost;
+        std::vector<TileId_t> tile_parent;
+
+        StampSet region_seen;
+        StampSet region_closed;
+        std::vector<float> region_cost;
+        std::vector<RegionId_t> region_parent;
+
+        //! Regions that the tile search may enter.
+        StampSet corridor;
+
+        //! Binary heap used as the open list.
+        std::vector<HeapEntry_t> heap;
+
+        SearchContext(size_t num_tiles, size_t num_regions) {
+            tile_seen.Resize(num_tiles);
+            tile_closed.Resize(num_tiles);
+            tile_cost.resize(num_tiles);
+            tile_parent.resize(num_tiles);
+            region_seen.Resize(num_regions);
+            region_closed.Resize(num_regions);
+            region_cost.resize(num_regions);
+            region_parent.resize(num_regions);
+            corridor.Resize(num_regions);
+        }
+
+        void Push(float priority, uint32_t index) {
+            heap.emplace_back(priority, index);
+            std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry_t>());
+        }
+
+        uint32_t Pop() {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry_t>());
+            uint32_t index = heap.back().second;
+            heap.pop_back();
+            return index;
+        }
+    };
+
+    PathFinder::PathFinder(const World& world, size_t cache_capacity)
+        : m_width(static_cast<int32_t>(world.GetSize().x))
+        , m_height(static_cast<int32_t>(world.GetSize().y))
+        , m_cache_capacity(cache_capacity) {
+
+        world.GetTileHeights(m_tile_heights);
+        for (float& height : m_tile_heights) {
+            height *= TILE_PER_METER_F32;
+        }
+
+        ConstTileView tiles = world.GetTiles();
+        m_tile_passable.reserve(tiles.size());
+        m_tile_regions.reserve(tiles.size());
+        for (ConstTile tile : tiles) {
+            m_tile_passable.push_back(tile.GetIsWater() ? 0U : 1U);
+            m_tile_regions.push_back(tile.GetRegionId());
+        }
+
+        const std::vector<Region>& regions = world.GetRegions();
+        for (const Region& region : regions) {
+            glm::vec2 centroid = region.GetCentroid() * TILE_PER_METER_F32;
+            m_region_x.push_back(centroid.x);
+            m_region_y.push_back(centroid.y);
+            m_region_heights.push_back(region.GetAbsoluteHeight() * TILE_PER_METER_F32);
+        }
+
+        Math::CsrGraph<float>::Builder regionGraph(regions.size());
+        for (size_t regionId = 0U; regionId < regions.size(); regionId++) {
+            for (RegionId_t neighborId : regions[regionId].GetNeighbors()) {
+                float distanceX = m_region_x[neighborId] - m_region_x[regionId];
+                float distanceY = m_region_y[neighborId] - m_region_y[regionId];
+                float cost = std::sqrt((distanceX * distanceX) + (distanceY * distanceY)) +
+                    (SLOPE_COST * std::abs(m_region_heights[neighborId] - m_region_heights[regionId]));
+                regionGraph.AddEdge(
+                    static_cast<Math::GraphNode_t>(regionId), static_cast<Math::GraphNode_t>(neighborId), cost);
+            }
+        }
+        m_region_graph = regionGraph.Build();
+
+        // a region can be crossed if any of its tiles can, since water regions may still hold a strip of land.
+        m_region_passable.assign(regions.size(), 0U);
+        for (size_t tileId = 0U; tileId < m_tile_passable.size(); tileId++) {
+            if ((m_tile_passable[tileId] != 0U) && (m_tile_regions[tileId] != INVALID_REGION_ID)) {
+                m_region_passable[m_tile_regions[tileId]] = 1U;
+            }
+        }
+    }
+
+    PathFinder::~PathFinder() = default;
+
+    Path PathFinder::FindPath(const PathRequest& request) const {
+
+        Path path;
+        const size_t numTiles = m_tile_passable.size();
+        if ((request.start >= numTiles) || (request.goal >= numTiles) ||
+            (m_tile_passable[request.start] == 0U) || (m_tile_passable[request.goal] == 0U)) {
+            return path;
+        }
+
+        RegionId_t startRegion = m_tile_regions[request.start];
+        RegionId_t goalRegion = m_tile_regions[request.goal];
+        if ((startRegion == INVALID_REGION_ID) || (goalRegion == INVALID_REGION_ID)) {
+            return path;
+        }
+
+        std::unique_ptr<SearchContext> p_context = AcquireContext();
+        SearchContext& context = *p_context;
+
+        std::shared_ptr<const std::vector<RegionId_t>> p_regionPath = GetRegionPath(context, startRegion, goalRegion);
+        if (!p_regionPath->empty()) {
+
+            context.corridor.Clear();
+            for (RegionId_t regionId : *p_regionPath) {
+                context.corridor.Insert(regionId);
+            }
+
+            // neighboring regions do not always share passable tiles along their border, so widen the corridor by one
+            // region, and finally search every tile, before giving up.
+            if (!SearchTiles(context, request.start, request.goal, path)) {
+                for (RegionId_t regionId : *p_regionPath) {
+                    for (Math::GraphNode_t neighborId : m_region_graph.GetNeighbors(regionId)) {
+                        context.corridor.Insert(neighborId);
+                    }
+                }
+
+                if (!SearchTiles(context, request.start, request.goal, path)) {
+                    for (size_t regionId = 0U; regionId < m_region_passable.size(); regionId++) {
+                        context.corridor.Insert(regionId);
+                    }
+
+                    SearchTiles(context, request.start, request.goal, path);
+                }
+            }
+        }
+
+        ReleaseContext(std::move(p_context));
+        return path;
+    }
+
+    std::vector<Path> PathFinder::FindPaths(const std::vector<PathRequest>& requests) const {
+
+        std::vector<Path> paths(requests.size());
+        Core::ThreadPool::GetInstance().ParallelFor(requests.size(), REQUESTS_PER_TASK, [&](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; index++) {
+                paths[index] = FindPath(requests[index]);
+            }
+        });
+
+        return paths;
+    }
+
+    std::vector<RegionId_t> PathFinder::FindRegionPath(RegionId_t start, RegionId_t goal) const {
+
+        const RegionId_t numRegions = static_cast<RegionId_t>(m_region_passable.size());
+        if ((start < 0) || (goal < 0) || (start >= numRegions) || (goal >= numRegions)) {
+            return {};
+        }
+
+        std::unique_ptr<SearchContext> p_context = AcquireContext();
+        std::vector<RegionId_t> regionPath = *GetRegionPath(*p_context, start, goal);
+        ReleaseContext(std::move(p_context));
+
+        return regionPath;
+    }
+
+    std::vector<RegionId_t> PathFinder::SearchRegions(SearchContext& context, RegionId_t start, RegionId_t goal) const {
+
+        auto heuristic = [this, goal](RegionId_t regionId) {
+            float distanceX = m_region_x[regionId] - m_region_x[goal];
+            float distanceY = m_region_y[regionId] - m_region_y[goal];
+            return std::sqrt((distanceX * distanceX) + (distanceY * distanceY));
+        };
+
+        context.region_seen.Clear();
+        context.region_closed.Clear();
+        context.heap.clear();
+
+        context.region_seen.Insert(start);
+        context.region_cost[start] = 0.0F;
+        context.region_parent[start] = INVALID_REGION_ID;
+        context.Push(heuristic(start), static_cast<uint32_t>(start));
+
+        while (!context.heap.empty()) {
+
+            RegionId_t current = static_cast<RegionId_t>(context.Pop());
+            if (context.region_closed.Contains(current)) {
+                continue;
+            }
+            context.region_closed.Insert(current);
+
+            if (current == goal) {
+                std::vector<RegionId_t> regionPath;
+                for (RegionId_t regionId = goal; regionId != INVALID_REGION_ID; regionId = context.region_parent[regionId]) {
+                    regionPath.push_back(regionId);
+                }
+                std::reverse(regionPath.begin(), regionPath.end());
+                return regionPath;
+            }
+
+            Math::GraphRange<const Math::GraphNode_t> neighbors = m_region_graph.GetNeighbors(current);
+            Math::GraphRange<const float> stepCosts = m_region_graph.GetWeights(current);
+            for (size_t edge = 0U; edge < neighbors.size(); edge++) {
+
+                RegionId_t neighborId = static_cast<RegionId_t>(neighbors[edge]);
+
+                // the goal is always enterable, since the goal tile itself is known to be land.
+                if (context.region_closed.Contains(neighborId) ||
+                    ((m_region_passable[neighborId] == 0U) && (neighborId != goal))) {
+                    continue;
+                }
+
+                float cost = context.region_cost[current] + stepCosts[edge];
+
+                if (!context.region_seen.Contains(neighborId) || (cost < context.region_cost[neighborId])) {
+                    context.region_seen.Insert(neighborId);
+                    context.region_cost[neighborId] = cost;
+                    context.region_parent[neighborId] = current;
+                    context.Push(cost + heuristic(neighborId), static_cast<uint32_t>(neighborId));
+                }
+            }
+        }
+
+        return {};
+    }
+
+    bool PathFinder::SearchTiles(SearchContext& context, TileId_t start, TileId_t goal, Path& out_path) const {
+
+        const int32_t goalX = static_cast<int32_t>(goal % static_cast<TileId_t>(m_width));
+        const int32_t goalY = static_cast<int32_t>(goal / static_cast<TileId_t>(m_width));
+
+        // octile distance, which never overestimates since every step costs at least its length.
+        auto heuristic = [goalX, goalY](int32_t x_coord, int32_t y_coord) {
+            float deltaX = static_cast<float>(std::abs(x_coord - goalX));
+            float deltaY = static_cast<float>(std::abs(y_coord - goalY));
+            return std::max(deltaX, deltaY) + ((DIAGONAL_DISTANCE - 1.0F) * std::min(deltaX, deltaY));
+        };
+
+        auto isOpen = [this, &context](int32_t x_coord, int32_t y_coord) {
+            if ((x_coord < 0) || (y_coord < 0) || (x_coord >= m_width) || (y_coord >= m_height)) {
+                return false;
+            }
+            TileId_t tileId = static_cast<TileId_t>((y_coord * m_width) + x_coord);
+            return (m_tile_passable[tileId] != 0U) && context.corridor.Contains(m_tile_regions[tileId]);
+        };
+
+        static const std::array<std::pair<int32_t, int32_t>, 8> OFFSETS = {{
+            {1, 0}, {-1, 0}, {0, 1}, {0, -1},
+            {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+        context.tile_seen.Clear();
+        context.tile_closed.Clear();
+        context.heap.clear();
+
+        context.tile_seen.Insert(start);
+        context.tile_cost[start] = 0.0F;
+        context.tile_parent[start] = INVALID_TILE_ID;
+        context.Push(heuristic(static_cast<int32_t>(start % m_width), static_cast<int32_t>(start / m_width)), start);
+
+        while (!context.heap.empty()) {
+
+            TileId_t current = context.Pop();
+            if (context.tile_closed.Contains(current)) {
+                continue;
+            }
+            context.tile_closed.Insert(current);
+
+            if (current == goal) {
+                out_path.cost = context.tile_cost[goal];
+                out_path.tiles.clear();
+                for (TileId_t tileId = goal; tileId != INVALID_TILE_ID; tileId = context.tile_parent[tileId]) {
+                    out_path.tiles.push_back(tileId);
+                }
+                std::reverse(out_path.tiles.begin(), out_path.tiles.end());
+                return true;
+            }
+
+            const int32_t currentX = static_cast<int32_t>(current % static_cast<TileId_t>(m_width));
+            const int32_t currentY = static_cast<int32_t>(current / static_cast<TileId_t>(m_width));
+
+            for (const auto& offset : OFFSETS) {
+
+                int32_t neighborX = currentX + offset.first;
+                int32_t neighborY = currentY + offset.second;
+                bool isDiagonal = (offset.first != 0) && (offset.second != 0);
+
+                // diagonal moves may not cut the corner of a blocked tile.
+                if (!isOpen(neighborX, neighborY) ||
+                    (isDiagonal && (!isOpen(neighborX, currentY) || !isOpen(currentX, neighborY)))) {
+                    continue;
+                }
+
+                TileId_t neighborId = static_cast<TileId_t>((neighborY * m_width) + neighborX);
+                if (context.tile_closed.Contains(neighborId)) {
+                    continue;
+                }
+
+                float cost = context.tile_cost[current] + GetStepCost(current, neighborId, isDiagonal ? DIAGONAL_DISTANCE : 1.0F);
+                if (!context.tile_seen.Contains(neighborId) || (cost < context.tile_cost[neighborId])) {
+                    context.tile_seen.Insert(neighborId);
+                    context.tile_cost[neighborId] = cost;
+                    context.tile_parent[neighborId] = current;
+                    context.Push(cost + heuristic(neighborX, neighborY), neighborId);
+                }
+            }
+        }
+
+        return false;
+    }
+
+    std::shared_ptr<const std::vector<RegionId_t>> PathFinder::GetRegionPath(SearchContext& context, RegionId_t start, RegionId_t goal) const {
+
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(start)) << 32U) | static_cast<uint32_t>(goal); // NOLINT
+
+        {
+            std::lock_guard<std::mutex> lock(m_cache_mutex);
+            auto cacheItr = m_cache.find(key);
+            if (cacheItr != m_cache.end()) {
+                m_cache_lru.splice(m_cache_lru.begin(), m_cache_lru, cacheItr->second.lru_position);
+                return cacheItr->second.p_path;
+            }
+        }
+
+        // search without holding the lock. Another thread may find the same path in the meantime, which is harmless.
+        std::shared_ptr<const std::vector<RegionId_t>> p_path =
+            std::make_shared<const std::vector<RegionId_t>>(SearchRegions(context, start, goal));
+
+        if (m_cache_capacity > 0U) {
+            std::lock_guard<std::mutex> lock(m_cache_mutex);
+            if (m_cache.count(key) == 0U) {
+                m_cache_lru.push_front(key);
+                m_cache.emplace(key, CacheEntry{p_path, m_cache_lru.begin()});
+
+                while (m_cache.size() > m_cache_capacity) {
+                    m_cache.erase(m_cache_lru.back());
+                    m_cache_lru.pop_back();
+                }
+            }
+        }
+
+        return p_path;
+    }
+
+    std::unique_ptr<PathFinder::SearchContext> PathFinder::AcquireContext() const {
+        {
+            std::lock_guard<std::mutex> lock(m_context_mutex);
+            if (!m_free_contexts.empty()) {
+                std::unique_ptr<SearchContext> p_context = std::move(m_free_contexts.back());
+                m_free_contexts.pop_back();
+                return p_context;
+            }
+        }
+
+        return std::make_unique<SearchContext>(m_tile_passable.size(), m_region_passable.size());
+    }
+
+    void PathFinder::ReleaseContext(std::unique_ptr<SearchContext>&& p_context) const {
+        std::lock_guard<std::mutex> lock(m_context_mutex);
+        m_free_contexts.push_back(std::move(p_context));
+    }
+
+    float PathFinder::GetStepCost(TileId_t from, TileId_t to, float distance) const {
+        return distance + (SLOPE_COST * std::abs(m_tile_heights[to] - m_tile_heights[from]));
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Region.hpp"
+#include "Tile.hpp"
+#include "math/CsrGraph.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace World {
+
+    class World;
+
+    //! A request for a path between two tiles.
+    struct PathRequest {
+        TileId_t start {INVALID_TILE_ID};
+        TileId_t goal {INVALID_TILE_ID};
+    };
+
+    //! A path between two tiles.
+    struct Path {
+        //! Tiles along the path, from start to goal inclusive. Empty if there is no path.
+        std::vector<TileId_t> tiles;
+
+        //! Total movement cost of the path.
+        float cost {0.0F};
+    };
+
+    //! Hierarchical path finder for movement over land.
+    //!
+    //! Paths are first planned with A* over the region adjacency graph, and then refined with A* over tiles, limited
+    //! to the corridor of regions chosen by the first search. Region paths are kept in a least recently used cache,
+    //! since many requests travel between the same regions.
+    //!
+    //! Water tiles and regions cannot be crossed. Moving uphill or downhill costs more than moving over flat ground.
+    //!
+    //! All methods are safe to call from several threads at once. The world must not be modified while the path finder
+    //! exists.
+    class PathFinder {
+
+        public:
+
+            static constexpr size_t DEFAULT_CACHE_CAPACITY = 4096U;
+
+            //! @brief Constructor
+            //!
+            //! @param[in] world          The world to find paths in. Must outlive the path finder.
+            //! @param[in] cache_capacity Maximum number of region paths kept in the cache.
+            explicit PathFinder(const World& world, size_t cache_capacity = DEFAULT_CACHE_CAPACITY);
+            PathFinder(const PathFinder& other) = delete;
+            PathFinder(PathFinder&& other) = delete;
+            PathFinder& operator=(const PathFinder& other) = delete;
+            PathFinder& operator=(PathFinder&& other) = delete;
+            ~PathFinder();
+
+            //! @brief Find a path between two tiles.
+            //!
+            //! @param[in] request The start and goal tiles.
+            //!
+            //! @returns The path. The path is empty if either tile is water, or no path exists.
+            Path FindPath(const PathRequest& request) const;
+
+            //! @brief Find paths for many requests, spread over the shared thread pool.
+            //!
+            //! @param[in] requests The requests.
+            //!
+            //! @returns A path for each request, in the same order as the requests.
+            std::vector<Path> FindPaths(const std::vector<PathRequest>& requests) const;
+
+            //! @brief Find the sequence of regions a path between two regions passes through.
+            //!
+            //! @param[in] start The region to start in.
+            //! @param[in] goal  The region to end in.
+            //!
+            //! @returns The regions from start to goal inclusive, or an empty vector if there is no path.
+            std::vector<RegionId_t> FindRegionPath(RegionId_t start, RegionId_t goal) const;
+
+        private:
+
+            //! Scratch memory for a single search. Reused between searches to avoid allocating.
+            struct SearchContext;
+
+            //! A region path in the cache, and its position in the LRU list.
+            struct CacheEntry {
+                std::shared_ptr<const std::vector<RegionId_t>> p_path;
+                std::list<uint64_t>::iterator lru_position;
+            };
+
+            //! Run A* over the region graph.
+            std::vector<RegionId_t> SearchRegions(SearchContext& context, RegionId_t start, RegionId_t goal) const;
+
+            //! Run A* over tiles, only visiting tiles in regions marked as part of the corridor.
+            bool SearchTiles(SearchContext& context, TileId_t start, TileId_t goal, Path& out_path) const;
+
+            //! Get a region path, from the cache if possible.
+            std::shared_ptr<const std::vector<RegionId_t>> GetRegionPath(SearchContext& context, RegionId_t start, RegionId_t goal) const;
+
+            //! Take a search context from the free list, or create one.
+            std::unique_ptr<SearchContext> AcquireContext() const;
+
+            //! Return a search context to the free list.
+            void ReleaseContext(std::unique_ptr<SearchContext>&& p_context) const;
+
+            //! Cost of moving between two neighboring tiles.
+            float GetStepCost(TileId_t from, TileId_t to, float distance) const;
+
+            //! Size of the world, in tiles.
+            int32_t m_width;
+            int32_t m_height;
+
+            //! Per tile data, copied from the world so that searches touch as little memory as possible.
+            std::vector<float> m_tile_heights;
+            std::vector<uint8_t> m_tile_passable;
+            std::vector<RegionId_t> m_tile_regions;
+
+            //! Per region data.
+            std::vector<float> m_region_x;
+            std::vector<float> m_region_y;
+            std::vector<float> m_region_heights;
+            std::vector<uint8_t> m_region_passable;
+
+            //! Region adjacency, weighted by the cost of moving between the centroids of neighboring regions.
+            Math::CsrGraph<float> m_region_graph;
+
+            //! Maximum number of region paths in the cache.
+            size_t m_cache_capacity;
+
+            //! Cached region paths, keyed by start and goal region.
+            mutable std::unordered_map<uint64_t, CacheEntry> m_cache;
+
+            //! Keys of cached paths, most recently used first.
+            mutable std::list<uint64_t> m_cache_lru;
+
+            //! Protects the cache.
+            mutable std::mutex m_cache_mutex;
+
+            //! Search contexts that are not in use.
+            mutable std::vector<std::unique_ptr<SearchContext>> m_free_contexts;
+
+            //! Protects the free list.
+            mutable std::mutex m_context_mutex;
+    };
+}
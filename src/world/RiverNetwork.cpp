@@ -0,0 +1,187 @@
+#include "RiverNetwork.hpp"
+#include "WorldParams.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace World {
+
+    RiverNetwork::RiverNetwork(uint32_t world_width, std::vector<RiverSegment>&& segments,
+                               std::vector<uint32_t>&& point_offsets, std::vector<TileId_t>&& points)
+        : m_world_width(world_width)
+        , m_segments(std::move(segments))
+        , m_point_offsets(std::move(point_offsets))
+        , m_points(std::move(points)) {
+
+        if ((m_point_offsets.size() != m_segments.size() + 1U) || (m_point_offsets.front() != 0U) ||
+            (m_point_offsets.back() != m_points.size())) {
+            throw std::runtime_error("Invalid river point table");
+        }
+
+        for (size_t segmentId = 0U; segmentId < m_segments.size(); segmentId++) {
+            RiverId_t downstream = m_segments[segmentId].downstream;
+            if ((m_point_offsets[segmentId] >= m_point_offsets[segmentId + 1U]) ||
+                ((downstream != INVALID_RIVER_ID) && (downstream >= m_segments.size()))) {
+                throw std::runtime_error("Invalid river segment");
+            }
+        }
+
+        // counting sort of the segments by the segment they flow into.
+        m_upstream_offsets.assign(m_segments.size() + 1U, 0U);
+        for (const RiverSegment& segment : m_segments) {
+            if (segment.downstream != INVALID_RIVER_ID) {
+                m_upstream_offsets[segment.downstream + 1U]++;
+            }
+        }
+
+        for (size_t segmentId = 0U; segmentId < m_segments.size(); segmentId++) {
+            m_upstream_offsets[segmentId + 1U] += m_upstream_offsets[segmentId];
+        }
+
+        std::vector<uint32_t> upstreamFill(m_upstream_offsets.begin(), m_upstream_offsets.end() - 1);
+        m_upstream.resize(m_upstream_offsets.back());
+        for (size_t segmentId = 0U; segmentId < m_segments.size(); segmentId++) {
+            if (m_segments[segmentId].downstream != INVALID_RIVER_ID) {
+                m_upstream[upstreamFill[m_segments[segmentId].downstream]++] = static_cast<RiverId_t>(segmentId);
+            }
+        }
+
+        std::vector<glm::vec2> positions;
+        positions.reserve(m_points.size());
+        for (size_t segmentId = 0U; segmentId < m_segments.size(); segmentId++) {
+            for (size_t index = 0U; index < GetNumPoints(static_cast<RiverId_t>(segmentId)); index++) {
+                positions.push_back(GetPointPosition(static_cast<RiverId_t>(segmentId), index));
+            }
+        }
+        m_point_grid = Math::PointGrid(positions);
+    }
+
+    size_t RiverNetwork::GetNumSegments() const {
+        return m_segments.size();
+    }
+
+    const RiverSegment& RiverNetwork::GetSegment(RiverId_t segment_id) const {
+        return m_segments.at(segment_id);
+    }
+
+    size_t RiverNetwork::GetNumPoints(RiverId_t segment_id) const {
+        return m_point_offsets.at(segment_id + 1U) - m_point_offsets.at(segment_id);
+    }
+
+    TileId_t RiverNetwork::GetPoint(RiverId_t segment_id, size_t index) const {
+        if (index >= GetNumPoints(segment_id)) {
+            throw std::out_of_range("River point index out of range");
+        }
+        return m_points[m_point_offsets[segment_id] + index];
+    }
+
+    glm::vec2 RiverNetwork::GetPointPosition(RiverId_t segment_id, size_t index) const {
+        TileId_t tileId = GetPoint(segment_id, index);
+        glm::vec2 coordinate(static_cast<float>(tileId % m_world_width), static_cast<float>(tileId / m_world_width));
+        return (coordinate + glm::vec2(0.5F)) * TILE_SIZE_METERS_F32;
+    }
+
+    size_t RiverNetwork::GetNumUpstream(RiverId_t segment_id) const {
+        return m_upstream_offsets.at(segment_id + 1U) - m_upstream_offsets.at(segment_id);
+    }
+
+    RiverId_t RiverNetwork::GetUpstream(RiverId_t segment_id, size_t index) const {
+        if (index >= GetNumUpstream(segment_id)) {
+            throw std::out_of_range("River upstream index out of range");
+        }
+        return m_upstream[m_upstream_offsets[segment_id] + index];
+    }
+
+    std::vector<RiverId_t> RiverNetwork::WalkDownstream(RiverId_t segment_id) const {
+
+        std::vector<RiverId_t> segments;
+        for (RiverId_t segment = segment_id; segment != INVALID_RIVER_ID; segment = GetSegment(segment).downstream) {
+            segments.push_back(segment);
+        }
+        return segments;
+    }
+
+    std::vector<RiverId_t> RiverNetwork::WalkUpstream(RiverId_t segment_id) const {
+
+        std::vector<RiverId_t> segments;
+        std::vector<RiverId_t> stack = {segment_id};
+        while (!stack.empty()) {
+
+            RiverId_t segment = stack.back();
+            stack.pop_back();
+            segments.push_back(segment);
+
+            // pushed in reverse, so that the first upstream segment is visited first.
+            for (size_t index = GetNumUpstream(segment); index > 0U; index--) {
+                stack.push_back(GetUpstream(segment, index - 1U));
+            }
+        }
+        return segments;
+    }
+
+    RiverLocation RiverNetwork::FindNearest(glm::vec2 position) const {
+
+        int32_t pointIndex = m_point_grid.FindNearest(position);
+        if (pointIndex < 0) {
+            return {};
+        }
+
+        // the segment whose run of points holds the point.
+        auto offset = std::upper_bound(m_point_offsets.begin(), m_point_offsets.end(), static_cast<uint32_t>(pointIndex));
+        RiverLocation location;
+        location.segment = static_cast<RiverId_t>(offset - m_point_offsets.begin() - 1);
+        location.point = static_cast<uint32_t>(pointIndex) - m_point_offsets[location.segment];
+        location.distance = glm::distance(position, GetPointPosition(location.segment, location.point));
+        return location;
+    }
+
+    std::vector<glm::vec2> RiverNetwork::BuildTriangleStrip(uint8_t min_order, float min_spacing, float width_scale) const {
+
+        std::vector<glm::vec2> strip;
+        std::vector<glm::vec2> line;
+        for (size_t segmentId = 0U; segmentId < m_segments.size(); segmentId++) {
+
+            const RiverSegment& segment = m_segments[segmentId];
+            const size_t numPoints = GetNumPoints(static_cast<RiverId_t>(segmentId));
+            if ((segment.order < min_order) || (numPoints < 2U)) {
+                continue;
+            }
+
+            // keep points at least the minimum spacing apart, and always the last one, so that the river reaches the
+            // segment downstream. The point before the last one is dropped instead, if it is too close.
+            line.clear();
+            line.push_back(GetPointPosition(static_cast<RiverId_t>(segmentId), 0U));
+            for (size_t index = 1U; index < numPoints; index++) {
+                glm::vec2 point = GetPointPosition(static_cast<RiverId_t>(segmentId), index);
+                if (index + 1U == numPoints) {
+                    if ((line.size() > 1U) && (glm::distance(line.back(), point) < min_spacing)) {
+                        line.back() = point;
+                    } else {
+                        line.push_back(point);
+                    }
+                } else if (glm::distance(line.back(), point) >= min_spacing) {
+                    line.push_back(point);
+                }
+            }
+
+            const float halfWidth = 0.5F * segment.width * width_scale;
+            for (size_t index = 0U; index < line.size(); index++) {
+
+                glm::vec2 tangent = line[std::min(index + 1U, line.size() - 1U)] - line[(index > 0U) ? index - 1U : 0U];
+                glm::vec2 normal = glm::normalize(glm::vec2(-tangent.y, tangent.x)) * halfWidth;
+
+                // repeat the first vertex of each segment after the first, to join them with degenerate triangles.
+                if ((index == 0U) && !strip.empty()) {
+                    strip.push_back(strip.back());
+                    strip.push_back(line[index] + normal);
+                }
+                strip.push_back(line[index] + normal);
+                strip.push_back(line[index] - normal);
+            }
+        }
+
+        return strip;
+    }
+}
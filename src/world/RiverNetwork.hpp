@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Tile.hpp"
+#include "math/PointGrid.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
+#include <vector>
+
+namespace World {
+
+    using RiverId_t = uint32_t;
+    static constexpr RiverId_t INVALID_RIVER_ID = UINT32_MAX;
+
+    //! A reach of river between two confluences, or between a source or mouth and a confluence.
+    struct RiverSegment {
+        RiverId_t downstream {INVALID_RIVER_ID};    //!< Segment this one flows into, or invalid at a mouth.
+        float flow {0.0F};                          //!< Land area drained at the end of the segment, in km^2.
+        float width {0.0F};                         //!< Width of the river at the end of the segment, in meters.
+        uint8_t order {1U};                         //!< Strahler order, starting from one at the sources.
+    };
+
+    //! A point on a river, as found by RiverNetwork::FindNearest().
+    struct RiverLocation {
+        RiverId_t segment {INVALID_RIVER_ID};   //!< The segment, or INVALID_RIVER_ID if the world has no rivers.
+        uint32_t point {0U};                    //!< Index of the point in the segment.
+        float distance {0.0F};                  //!< Distance from the query position to the point, in meters.
+    };
+
+    //! Rivers of a world, as a graph of segments that each follow a line of tiles downstream.
+    //!
+    //! The tiles of all segments are kept in a single table, with the tiles of each segment stored one after another,
+    //! from upstream to downstream. The last tile of a segment is the first tile of the segment downstream of it, or
+    //! the ocean tile it flows into, so the lines of a river join up. Each tile takes four bytes, so rivers cost a few
+    //! bytes per river tile rather than per tile of the world.
+    class RiverNetwork {
+
+        public:
+
+            //! Create a network with no rivers.
+            RiverNetwork() = default;
+
+            //! @brief Create a network from its segments.
+            //!
+            //! @param[in] world_width   Width of the world, in tiles, to convert tile IDs to positions.
+            //! @param[in] segments      The segments. Downstream segments must be valid segment IDs.
+            //! @param[in] point_offsets Index of the first tile of each segment in points, followed by the number of
+            //!                          points. Every segment needs at least one point.
+            //! @param[in] points        Tiles of every segment, from upstream to downstream.
+            //!
+            //! Throws std::runtime_error if the segments are malformed.
+            RiverNetwork(uint32_t world_width, std::vector<RiverSegment>&& segments,
+                         std::vector<uint32_t>&& point_offsets, std::vector<TileId_t>&& points);
+
+            //! @brief Get the number of segments.
+            size_t GetNumSegments() const;
+
+            //! @brief Get a segment by ID.
+            const RiverSegment& GetSegment(RiverId_t segment_id) const;
+
+            //! @brief Get the number of tiles along a segment.
+            size_t GetNumPoints(RiverId_t segment_id) const;
+
+            //! @brief Get a tile along a segment, counting from upstream.
+            TileId_t GetPoint(RiverId_t segment_id, size_t index) const;
+
+            //! @brief Get the position of the center of a tile along a segment, in meters.
+            glm::vec2 GetPointPosition(RiverId_t segment_id, size_t index) const;
+
+            //! @brief Get the number of segments that flow into a segment.
+            size_t GetNumUpstream(RiverId_t segment_id) const;
+
+            //! @brief Get a segment that flows into a segment.
+            RiverId_t GetUpstream(RiverId_t segment_id, size_t index) const;
+
+            //! @brief Follow a river down from a segment to its mouth.
+            //!
+            //! @returns The segment, followed by every segment downstream of it.
+            std::vector<RiverId_t> WalkDownstream(RiverId_t segment_id) const;
+
+            //! @brief Find every segment that flows into a segment, directly or through other segments.
+            //!
+            //! @returns The segment, followed by every segment upstream of it, depth first.
+            std::vector<RiverId_t> WalkUpstream(RiverId_t segment_id) const;
+
+            //! @brief Find the point on a river closest to a position.
+            //!
+            //! @param[in] position Position in the world, in meters.
+            RiverLocation FindNearest(glm::vec2 position) const;
+
+            //! @brief Build a triangle strip covering the rivers, for rendering.
+            //!
+            //! Rivers are joined into a single strip by degenerate triangles. Each segment is as wide as the river at
+            //! its end. The level of detail is lowered by leaving out small rivers, and points closer together than
+            //! a minimum spacing.
+            //!
+            //! @param[in] min_order   Lowest Strahler order of the segments to include.
+            //! @param[in] min_spacing Minimum distance between the points of a segment, in meters. The first and last
+            //!                        point of each segment are always included.
+            //! @param[in] width_scale Scale applied to the width of the rivers, so that they are visible on a map.
+            //!
+            //! @returns Vertex positions of the strip, in meters.
+            std::vector<glm::vec2> BuildTriangleStrip(uint8_t min_order, float min_spacing, float width_scale) const;
+
+        private:
+
+            //! Width of the world, in tiles.
+            uint32_t m_world_width {0U};
+
+            //! Every segment.
+            std::vector<RiverSegment> m_segments;
+
+            //! Index of the first tile of each segment, followed by the total number of tiles.
+            std::vector<uint32_t> m_point_offsets {0U};
+
+            //! Tiles of every segment.
+            std::vector<TileId_t> m_points;
+
+            //! Index of the first upstream segment of each segment, followed by the total number of upstream segments.
+            std::vector<uint32_t> m_upstream_offsets {0U};
+
+            //! Segments upstream of each segment.
+            std::vector<RiverId_t> m_upstream;
+
+            //! Grid over the position of every point, indexed the same as m_points.
+            Math::PointGrid m_point_grid;
+    };
+}
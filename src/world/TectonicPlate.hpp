@@ -67,7 +67,7 @@ namespace World {
             glm::vec2 m_velocity {0.0F, 0.0F};
 
             //! The height of the plate.
-            float m_height;
+            float m_height {0.0F};
 
             //! Whether the plate is continental or oceanic. If true the plate is continental, if false the plate is
             //! oceanic.
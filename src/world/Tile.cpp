@@ -1,78 +1,117 @@
 #include "Tile.hpp"
+#include "TileColumns.hpp"
 #include "World.hpp"
 #include <glm/geometric.hpp>
 
 namespace World {
 
-    Tile::Tile(World& world, TileId_t tile_id)
-        : m_p_world(&world), m_tile_id(tile_id), m_region_id(INVALID_REGION_ID) {
-        // Calculate the center position of this tile
-        Coordinate_t coordinate = world.TileIdToCoordinate(tile_id);
-        m_center = world.CoordinateToPosition(coordinate);
+    ConstTile::ConstTile(const World& world, TileId_t tile_id)
+        : m_p_world(&world), m_tile_id(tile_id) {
     }
 
-    void Tile::SetRegionId(RegionId_t region_id) {
-        m_region_id = region_id;
+    RegionId_t ConstTile::GetRegionId() const {
+        return m_p_world->GetTileColumns().GetRegionIds()[m_tile_id];
     }
 
-    RegionId_t Tile::GetRegionId() const {
-        return m_region_id;
+    TileId_t ConstTile::GetTileId() const {
+        return m_tile_id;
     }
 
-    TileId_t Tile::GetTileId() const {
-        return m_tile_id;
+    glm::vec2 ConstTile::GetCenter() const {
+        return m_p_world->CoordinateToPosition(m_p_world->TileIdToCoordinate(m_tile_id));
     }
 
-    glm::vec2 Tile::GetCenter() const {
-        return m_center;
+    bool ConstTile::GetIsEdgeTile() const {
+        return GetFlag(TILE_FLAG_EDGE);
     }
 
-    void Tile::SetIsEdgeTile(bool is_edge) {
-        m_is_edge = is_edge;
+    float ConstTile::GetAbsoluteHeight() const {
+        return m_p_world->GetHeightEncoding().Decode(GetEncodedHeight());
     }
 
-    bool Tile::GetIsEdgeTile() const {
-        return m_is_edge;
+    uint16_t ConstTile::GetEncodedHeight() const {
+        return m_p_world->GetTileColumns().GetHeights()[m_tile_id];
     }
 
-    void Tile::SetAbsoluteHeight(float height) {
-        m_height = height;
+    bool ConstTile::GetIsWater() const {
+        return GetFlag(TILE_FLAG_WATER);
     }
 
-    float Tile::GetAbsoluteHeight() const {
-        return m_height;
+    bool ConstTile::GetIsRiver() const {
+        return GetFlag(TILE_FLAG_RIVER);
     }
 
-    void Tile::SetIsWater(bool is_water) {
-        m_is_water = is_water;
+    bool ConstTile::GetIsLake() const {
+        return GetFlag(TILE_FLAG_LAKE);
     }
 
-    bool Tile::GetIsWater() const {
-        return m_is_water;
+    float ConstTile::GetWaterLevel() const {
+        return m_p_world->GetHeightEncoding().Decode(GetEncodedWaterLevel());
     }
 
-    void Tile::SetIsRiver(bool is_river) {
-        m_is_river = is_river;
+    uint16_t ConstTile::GetEncodedWaterLevel() const {
+        return m_p_world->GetTileColumns().GetWaterLevels()[m_tile_id];
     }
 
-    bool Tile::GetIsRiver() const {
-        return m_is_river;
+    BiomeType ConstTile::GetBiome() const {
+        return m_p_world->GetTileColumns().GetBiomes()[m_tile_id];
     }
 
-    void Tile::SetIsLake(bool is_lake) {
-        m_is_lake = is_lake;
+    BasinId_t ConstTile::GetBasinId() const {
+        return m_p_world->GetTileColumns().GetBasinIds()[m_tile_id];
+    }
+
+    bool ConstTile::GetFlag(uint8_t flag) const {
+        return (m_p_world->GetTileColumns().GetFlags()[m_tile_id] & flag) != 0U;
+    }
+
+    Tile::Tile(World& world, TileId_t tile_id)
+        : ConstTile(world, tile_id), m_p_mutable_world(&world) {
+    }
+
+    void Tile::SetRegionId(RegionId_t region_id) {
+        m_p_mutable_world->GetTileColumns().GetRegionIds()[GetTileId()] = region_id;
+    }
+
+    void Tile::SetIsEdgeTile(bool is_edge) {
+        SetFlag(TILE_FLAG_EDGE, is_edge);
+    }
+
+    void Tile::SetAbsoluteHeight(float height) {
+        SetEncodedHeight(m_p_mutable_world->GetHeightEncoding().Encode(height));
+    }
+
+    void Tile::SetEncodedHeight(uint16_t height) {
+        m_p_mutable_world->GetTileColumns().GetHeights()[GetTileId()] = height;
+    }
+
+    void Tile::SetIsWater(bool is_water) {
+        SetFlag(TILE_FLAG_WATER, is_water);
     }
 
-    bool Tile::GetIsLake() const {
-        return m_is_lake;
+    void Tile::SetIsRiver(bool is_river) {
+        SetFlag(TILE_FLAG_RIVER, is_river);
+    }
+
+    void Tile::SetIsLake(bool is_lake) {
+        SetFlag(TILE_FLAG_LAKE, is_lake);
     }
 
     void Tile::SetWaterLevel(float water_level) {
-        m_water_level = water_level;
+        SetEncodedWaterLevel(m_p_mutable_world->GetHeightEncoding().Encode(water_level));
+    }
+
+    void Tile::SetEncodedWaterLevel(uint16_t water_level) {
+        m_p_mutable_world->GetTileColumns().GetWaterLevels()[GetTileId()] = water_level;
+    }
+
+    void Tile::SetBiome(BiomeType biome) {
+        m_p_mutable_world->GetTileColumns().GetBiomes()[GetTileId()] = biome;
     }
 
-    float Tile::GetWaterLevel() const {
-        return m_water_level;
+    void Tile::SetFlag(uint8_t flag, bool value) {
+        uint8_t& flags = m_p_mutable_world->GetTileColumns().GetFlags()[GetTileId()];
+        flags = value ? static_cast<uint8_t>(flags | flag) : static_cast<uint8_t>(flags & ~flag);
     }
 
 }
@@ -1,20 +1,28 @@
 #pragma once
 
+#include "Biome.hpp"
 #include "Region.hpp"
+#include <cstddef>
+#include <cstdint>
 
 namespace World {
 
     using TileId_t = uint32_t;
     static constexpr TileId_t INVALID_TILE_ID = UINT32_MAX;
+    using BasinId_t = uint32_t;
+    static constexpr BasinId_t INVALID_BASIN_ID = UINT32_MAX;
     class World;
 
     // 2D Grid Used to represent a location in the world.
-    class Tile {
+    //
+    // Tiles are handles to the tile columns of their world, so they are cheap to copy, and a change made through one
+    // handle is seen by every other handle to the same tile. A ConstTile only reads the tile, and is what a const world
+    // hands out.
+    class ConstTile {
 
         public:
-            Tile(World& world, TileId_t tile_id);
+            ConstTile(const World& world, TileId_t tile_id);
 
-            void SetRegionId(RegionId_t region_id);
             RegionId_t GetRegionId() const;
 
             TileId_t GetTileId() const;
@@ -22,39 +30,141 @@ namespace World {
             glm::vec2 GetCenter() const;
 
             // Determine if the tile is on a the edge of a region.
-            void SetIsEdgeTile(bool is_edge);
             bool GetIsEdgeTile() const;
 
-            // Set the absolute height of the tile
-            void SetAbsoluteHeight(float height);
+            // Absolute height of the tile, decoded with the height encoding of the world.
             float GetAbsoluteHeight() const;
 
+            // Access the encoded height directly, for bulk copies and saving.
+            uint16_t GetEncodedHeight() const;
+
             // Water properties
-            void SetIsWater(bool is_water);
             bool GetIsWater() const;
-
-            void SetIsRiver(bool is_river);
             bool GetIsRiver() const;
-
-            void SetIsLake(bool is_lake);
             bool GetIsLake() const;
-
-            void SetWaterLevel(float water_level);
             float GetWaterLevel() const;
+            uint16_t GetEncodedWaterLevel() const;
+
+            // Biome of the tile. Near region borders this may differ from the biome of the region that owns it.
+            BiomeType GetBiome() const;
+
+            // Drainage basin the tile belongs to, see World::GetBasin(). INVALID_BASIN_ID for ocean tiles.
+            BasinId_t GetBasinId() const;
 
         private:
 
-            World* m_p_world {nullptr};
+            bool GetFlag(uint8_t flag) const;
+
+            const World* m_p_world {nullptr};
             TileId_t m_tile_id {INVALID_TILE_ID};
-            RegionId_t m_region_id {INVALID_REGION_ID};
-            glm::vec2 m_center {0.0F, 0.0F};
-            float m_height {0.0F};
-            bool m_is_edge {false};
+    };
 
-            // Water properties
-            bool m_is_water {false};
-            bool m_is_river {false};
-            bool m_is_lake {false};
-            float m_water_level {0.0F};
+    // A tile of a mutable world, which can be changed as well as read.
+    class Tile : public ConstTile {
+
+        public:
+            Tile(World& world, TileId_t tile_id);
+
+            void SetRegionId(RegionId_t region_id);
+
+            void SetIsEdgeTile(bool is_edge);
+
+            // Set the absolute height of the tile. Stored with the height encoding of the world, so the height read
+            // back may differ by up to HeightEncoding::GetMaxError().
+            void SetAbsoluteHeight(float height);
+
+            void SetEncodedHeight(uint16_t height);
+
+            void SetIsWater(bool is_water);
+            void SetIsRiver(bool is_river);
+            void SetIsLake(bool is_lake);
+            void SetWaterLevel(float water_level);
+            void SetEncodedWaterLevel(uint16_t water_level);
+
+            void SetBiome(BiomeType biome);
+
+        private:
+
+            // Set or clear one of the TileFlag bits.
+            void SetFlag(uint8_t flag, bool value);
+
+            World* m_p_mutable_world {nullptr};
+    };
+
+    //! Every tile of a world, for use in range based for loops. Tiles are handed out by value.
+    //!
+    //! @tparam Tile_t  Tile, or ConstTile for a range over a const world.
+    //! @tparam World_t World, or const World for a range over a const world.
+    template<typename Tile_t, typename World_t>
+    class BasicTileView {
+
+        public:
+
+            class Iterator {
+
+                public:
+
+                    Iterator(World_t* p_world, TileId_t tile_id)
+                        : m_p_world(p_world), m_tile_id(tile_id) {
+                    }
+
+                    Tile_t operator*() const {
+                        return Tile_t(*m_p_world, m_tile_id);
+                    }
+
+                    Iterator& operator++() {
+                        m_tile_id++;
+                        return *this;
+                    }
+
+                    bool operator==(const Iterator& other) const {
+                        return m_tile_id == other.m_tile_id;
+                    }
+
+                    bool operator!=(const Iterator& other) const {
+                        return m_tile_id != other.m_tile_id;
+                    }
+
+                private:
+
+                    World_t* m_p_world;
+                    TileId_t m_tile_id;
+            };
+
+            BasicTileView(World_t* p_world, size_t size)
+                : m_p_world(p_world), m_size(size) {
+            }
+
+            //! A view of mutable tiles may be used where a view of const tiles is expected.
+            BasicTileView(const BasicTileView<Tile, World>& other) // NOLINT implicit on purpose
+                : m_p_world(other.m_p_world), m_size(other.m_size) {
+            }
+
+            Iterator begin() const {
+                return {m_p_world, 0U};
+            }
+
+            Iterator end() const {
+                return {m_p_world, static_cast<TileId_t>(m_size)};
+            }
+
+            size_t size() const {
+                return m_size;
+            }
+
+            Tile_t operator[](TileId_t tile_id) const {
+                return Tile_t(*m_p_world, tile_id);
+            }
+
+        private:
+
+            template<typename OtherTile_t, typename OtherWorld_t>
+            friend class BasicTileView;
+
+            World_t* m_p_world;
+            size_t m_size;
     };
-}
\ No newline at end of file
+
+    using TileView = BasicTileView<Tile, World>;
+    using ConstTileView = BasicTileView<ConstTile, const World>;
+}
@@ -0,0 +1,33 @@
+#include "TileBlocks.hpp"
+#include "core/ThreadPool.hpp"
+#include <algorithm>
+
+namespace World {
+
+    void ForEachTileBlock(glm::uvec2 extent, uint32_t block_size, uint32_t halo,
+                          const std::function<void(const TileBlock& block)>& kernel) {
+
+        block_size = std::max(block_size, 1U);
+        const uint32_t numBlocksX = (extent.x + block_size - 1U) / block_size;
+        const uint32_t numBlocksY = (extent.y + block_size - 1U) / block_size;
+
+        Core::ThreadPool::GetInstance().ParallelFor(
+            static_cast<size_t>(numBlocksX) * numBlocksY, numBlocksX, [&](size_t begin, size_t end) {
+
+            for (size_t blockIndex = begin; blockIndex < end; blockIndex++) {
+
+                TileBlock block;
+                block.min.x = static_cast<uint32_t>(blockIndex % numBlocksX) * block_size;
+                block.min.y = static_cast<uint32_t>(blockIndex / numBlocksX) * block_size;
+                block.max.x = std::min(block.min.x + block_size, extent.x);
+                block.max.y = std::min(block.min.y + block_size, extent.y);
+                block.halo_min.x = block.min.x - std::min(block.min.x, halo);
+                block.halo_min.y = block.min.y - std::min(block.min.y, halo);
+                block.halo_max.x = std::min(block.max.x + halo, extent.x);
+                block.halo_max.y = std::min(block.max.y + halo, extent.y);
+
+                kernel(block);
+            }
+        });
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <glm/ext/vector_uint2.hpp>
+
+namespace World {
+
+    //! A rectangle of tiles processed as a unit, together with a border of halo tiles around it.
+    //!
+    //! A kernel writes only the tiles of its own block, and may read tiles of the halo, which belong to neighboring
+    //! blocks. All bounds are clamped to the world.
+    struct TileBlock {
+        glm::uvec2 min;         //!< First tile of the block.
+        glm::uvec2 max;         //!< One past the last tile of the block.
+        glm::uvec2 halo_min;    //!< First tile of the block and its halo.
+        glm::uvec2 halo_max;    //!< One past the last tile of the block and its halo.
+    };
+
+    //! Edge length of the blocks used by the world generation passes, in tiles. A block of 16 bit values is then
+    //! 128 KB, which keeps the working set of a block small even for out of core worlds.
+    static constexpr uint32_t DEFAULT_TILE_BLOCK_SIZE = 256U;
+
+    //! @brief Split a grid of tiles into square blocks, and run a kernel for each block on the shared thread pool.
+    //!
+    //! Blocks are handed out a row of blocks at a time, so that the blocks in flight are close together, and the pages
+    //! of an out of core world that they touch are shared. Blocks may run in any order, so a kernel must not depend on
+    //! the results of other blocks, other than through its halo when they are known not to change.
+    //!
+    //! @param[in] extent     Size of the grid, in tiles.
+    //! @param[in] block_size Edge length of each block, in tiles.
+    //! @param[in] halo       Width of the halo around each block, in tiles.
+    //! @param[in] kernel     Function to run for each block.
+    void ForEachTileBlock(glm::uvec2 extent, uint32_t block_size, uint32_t halo,
+                          const std::function<void(const TileBlock& block)>& kernel);
+}
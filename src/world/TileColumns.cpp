@@ -0,0 +1,95 @@
+#include "TileColumns.hpp"
+#include <algorithm>
+
+namespace World {
+
+    TileColumns::TileColumns(size_t num_tiles, bool is_out_of_core, uint16_t height, const std::string& directory)
+        : m_size(num_tiles) {
+
+        // columns are laid out one after another, widest first, so that every column is aligned.
+        const size_t regionBytes = num_tiles * sizeof(RegionId_t);
+        const size_t basinBytes = num_tiles * sizeof(BasinId_t);
+        const size_t heightBytes = num_tiles * sizeof(uint16_t);
+        const size_t totalBytes =
+            regionBytes + basinBytes + (2U * heightBytes) + (num_tiles * (1U + sizeof(BiomeType)));
+
+        uint8_t* p_storage = nullptr;
+        if (is_out_of_core && (totalBytes > 0U)) {
+            m_mapped_file = Core::MappedFile::CreateTemporary(totalBytes, directory);
+            p_storage = m_mapped_file.GetData();
+        } else {
+            m_memory.resize(totalBytes);
+            p_storage = m_memory.data();
+        }
+
+        m_p_region_ids = reinterpret_cast<RegionId_t*>(p_storage);
+        m_p_basin_ids = reinterpret_cast<BasinId_t*>(p_storage + regionBytes); // NOLINT
+        uint8_t* p_narrow = p_storage + regionBytes + basinBytes; // NOLINT
+        m_p_heights = reinterpret_cast<uint16_t*>(p_narrow);
+        m_p_water_levels = reinterpret_cast<uint16_t*>(p_narrow + heightBytes); // NOLINT
+        m_p_flags = p_narrow + (2U * heightBytes); // NOLINT
+        m_p_biomes = reinterpret_cast<BiomeType*>(m_p_flags + num_tiles); // NOLINT
+
+        // both kinds of storage start out as zero, which is already right for the flags, and makes every tile ocean.
+        std::fill(m_p_region_ids, m_p_region_ids + num_tiles, INVALID_REGION_ID); // NOLINT
+        std::fill(m_p_basin_ids, m_p_basin_ids + num_tiles, INVALID_BASIN_ID); // NOLINT
+        std::fill(m_p_heights, m_p_heights + num_tiles, height); // NOLINT
+        std::fill(m_p_water_levels, m_p_water_levels + num_tiles, height); // NOLINT
+    }
+
+    size_t TileColumns::GetSize() const {
+        return m_size;
+    }
+
+    bool TileColumns::GetIsOutOfCore() const {
+        return m_mapped_file.GetData() != nullptr;
+    }
+
+    RegionId_t* TileColumns::GetRegionIds() {
+        return m_p_region_ids;
+    }
+
+    const RegionId_t* TileColumns::GetRegionIds() const {
+        return m_p_region_ids;
+    }
+
+    uint16_t* TileColumns::GetHeights() {
+        return m_p_heights;
+    }
+
+    const uint16_t* TileColumns::GetHeights() const {
+        return m_p_heights;
+    }
+
+    uint16_t* TileColumns::GetWaterLevels() {
+        return m_p_water_levels;
+    }
+
+    const uint16_t* TileColumns::GetWaterLevels() const {
+        return m_p_water_levels;
+    }
+
+    uint8_t* TileColumns::GetFlags() {
+        return m_p_flags;
+    }
+
+    const uint8_t* TileColumns::GetFlags() const {
+        return m_p_flags;
+    }
+
+    BiomeType* TileColumns::GetBiomes() {
+        return m_p_biomes;
+    }
+
+    const BiomeType* TileColumns::GetBiomes() const {
+        return m_p_biomes;
+    }
+
+    BasinId_t* TileColumns::GetBasinIds() {
+        return m_p_basin_ids;
+    }
+
+    const BasinId_t* TileColumns::GetBasinIds() const {
+        return m_p_basin_ids;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Biome.hpp"
+#include "Region.hpp"
+#include "Tile.hpp"
+#include "core/MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace World {
+
+    //! Bits of the flags column.
+    enum TileFlag : uint8_t {
+        TILE_FLAG_EDGE = 1U << 0U,   //!< The tile borders a tile of another region.
+        TILE_FLAG_WATER = 1U << 1U,  //!< The tile is covered by water.
+        TILE_FLAG_RIVER = 1U << 2U,  //!< The tile holds a river.
+        TILE_FLAG_LAKE = 1U << 3U    //!< The tile is part of a lake.
+    };
+
+    //! Storage for the data of every tile in a world, with one array per field, indexed by tile ID.
+    //!
+    //! Heights and water levels use the 16 bit height encoding of the world, so a tile takes 14 bytes. The arrays can
+    //! either be held in memory, or in a memory mapped temporary file for worlds that are too large for memory. The
+    //! same pointers are used in both cases, so code working on the columns does not need to know which is used.
+    class TileColumns {
+
+        public:
+
+            //! @brief Allocate the columns.
+            //!
+            //! @param[in] num_tiles      The number of tiles.
+            //! @param[in] is_out_of_core Keep the columns in a memory mapped file, rather than in memory.
+            //! @param[in] height         Encoded value to set every height and water level to.
+            //! @param[in] directory      Directory to create the memory mapped file in, see
+            //!                           Core::MappedFile::CreateTemporary().
+            TileColumns(size_t num_tiles, bool is_out_of_core, uint16_t height, const std::string& directory = "");
+            TileColumns(const TileColumns& other) = delete;
+            TileColumns(TileColumns&& other) = delete;
+            TileColumns& operator=(const TileColumns& other) = delete;
+            TileColumns& operator=(TileColumns&& other) = delete;
+            ~TileColumns() = default;
+
+            //! Get the number of tiles.
+            size_t GetSize() const;
+
+            //! Whether the columns are held in a memory mapped file.
+            bool GetIsOutOfCore() const;
+
+            //! Region that owns each tile.
+            RegionId_t* GetRegionIds();
+            const RegionId_t* GetRegionIds() const;
+
+            //! Encoded height of each tile.
+            uint16_t* GetHeights();
+            const uint16_t* GetHeights() const;
+
+            //! Encoded water level of each tile.
+            uint16_t* GetWaterLevels();
+            const uint16_t* GetWaterLevels() const;
+
+            //! TileFlag bits of each tile.
+            uint8_t* GetFlags();
+            const uint8_t* GetFlags() const;
+
+            //! BiomeType of each tile.
+            BiomeType* GetBiomes();
+            const BiomeType* GetBiomes() const;
+
+            //! Drainage basin of each tile, or INVALID_BASIN_ID for ocean tiles.
+            BasinId_t* GetBasinIds();
+            const BasinId_t* GetBasinIds() const;
+
+        private:
+
+            //! Number of tiles.
+            size_t m_size;
+
+            //! Backing storage when held in memory.
+            std::vector<uint8_t> m_memory;
+
+            //! Backing storage when out of core.
+            Core::MappedFile m_mapped_file;
+
+            //! Columns, each pointing into the backing storage.
+            RegionId_t* m_p_region_ids {nullptr};
+            uint16_t* m_p_heights {nullptr};
+            uint16_t* m_p_water_levels {nullptr};
+            uint8_t* m_p_flags {nullptr};
+            BiomeType* m_p_biomes {nullptr};
+            BasinId_t* m_p_basin_ids {nullptr};
+    };
+}
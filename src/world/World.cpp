@@ -1,22 +1,25 @@
 #include "World.hpp"
 #include "Region.hpp"
 #include "Tile.hpp"
+#include "TileBlocks.hpp"
 #include "WorldParams.hpp"
+#include "math/PointGrid.hpp"
+#include "math/Stencil.hpp"
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <glm/geometric.hpp>
-#include <limits>
+#include <stdexcept>
 
 namespace World {
 
     World::World(const WorldParams& params)
-        : m_params(params) {
-
-        Extent_t extent = params.GetWorldExtent();
-        // Initialize tiles
-        size_t total_tiles = static_cast<size_t>(extent.x) * static_cast<size_t>(extent.y);
-        for (size_t i = 0; i < total_tiles; ++i) {
-            m_tiles.emplace_back(*this, static_cast<TileId_t>(i));
-        }
+        : m_params(params)
+        , m_tile_columns(
+            static_cast<size_t>(params.GetWorldExtent().x) * static_cast<size_t>(params.GetWorldExtent().y),
+            params.GetIsOutOfCore(),
+            m_height_encoding.Encode(0.0F),
+            params.GetOutOfCoreDirectory())
+        , m_ocean_level(0.0F) {
     }
 
     const WorldParams& World::GetParameters() const {
@@ -57,55 +60,36 @@ namespace World {
 
         if (updateTiles) {
             // Assign each tile to the nearest region centroid using Voronoi-like assignment
-            for (size_t tile_idx = 0; tile_idx < m_tiles.size(); ++tile_idx) {
-                Coordinate_t tile_coord = TileIdToCoordinate(static_cast<TileId_t>(tile_idx));
-                glm::vec2 tile_pos = CoordinateToPosition(tile_coord);
-
-                // Find the closest region to this tile
-                RegionId_t closest_region = INVALID_REGION_ID;
-                float closest_distance = std::numeric_limits<float>::max();
-
-                for (size_t region_idx = 0; region_idx < m_regions.size(); ++region_idx) {
-                    glm::vec2 region_centroid = m_regions[region_idx].GetCentroid();
-                    float distance = glm::distance(tile_pos, region_centroid);
-
-                    if (distance < closest_distance) {
-                        closest_distance = distance;
-                        closest_region = static_cast<RegionId_t>(region_idx);
-                    }
-                }
-
-                // Assign the tile to the closest region
-                m_tiles[tile_idx].SetRegionId(closest_region);
+            std::vector<glm::vec2> centroids;
+            centroids.reserve(m_regions.size());
+            for (const Region& region : m_regions) {
+                centroids.push_back(region.GetCentroid());
             }
 
-            // Determine if the tile is on a region boundary.
-            for (size_t tile_idx = 0; tile_idx < m_tiles.size(); tile_idx++) {
-
-                Tile& tileA = m_tiles.at(tile_idx);
-                Coordinate_t coordinate = TileIdToCoordinate(tile_idx);
-
-                // check eastern and southern neighbors
-                if (coordinate.x + 1 < m_params.GetWorldExtent().x) {
-                    TileId_t tileB_idx = CoordinateToTileId({coordinate.x + 1, coordinate.y});
-                    Tile& tileB = m_tiles.at(tileB_idx);
-
-                    if (tileA.GetRegionId() != tileB.GetRegionId()) {
-                        tileA.SetIsEdgeTile(true);
-                        tileB.SetIsEdgeTile(true);
+            Math::PointGrid centroidGrid(centroids);
+            const Extent_t extent = m_params.GetWorldExtent();
+            RegionId_t* p_regionIds = m_tile_columns.GetRegionIds();
+            uint8_t* p_flags = m_tile_columns.GetFlags();
+
+            ForEachTileBlock(extent, DEFAULT_TILE_BLOCK_SIZE, 0U, [&](const TileBlock& block) {
+                for (uint32_t y = block.min.y; y < block.max.y; y++) {
+                    for (uint32_t x = block.min.x; x < block.max.x; x++) {
+                        // Assign the tile to the closest region
+                        glm::vec2 tile_pos = CoordinateToPosition({x, y});
+                        p_regionIds[CoordinateToTileId({x, y})] = static_cast<RegionId_t>(centroidGrid.FindNearest(tile_pos));
                     }
                 }
-
-                if (coordinate.y + 1 < m_params.GetWorldExtent().y) {
-                    TileId_t tileB_idx = CoordinateToTileId({coordinate.x, coordinate.y + 1});
-                    Tile& tileB = m_tiles.at(tileB_idx);
-
-                    if (tileA.GetRegionId() != tileB.GetRegionId()) {
-                        tileA.SetIsEdgeTile(true);
-                        tileB.SetIsEdgeTile(true);
+            });
+
+            // Determine if the tile is on a region boundary. Each tile only marks itself, and tiles beyond the edge of the
+            // world are clamped, so they never differ from the tile itself.
+            Math::ApplyStencil4(p_regionIds, extent, Math::StencilEdge::CLAMP,
+                [&](size_t tileId, RegionId_t regionId, const std::array<RegionId_t, 4>& neighbors) {
+                    if ((neighbors[0] != regionId) || (neighbors[1] != regionId) ||
+                        (neighbors[2] != regionId) || (neighbors[3] != regionId)) {
+                        p_flags[tileId] |= TILE_FLAG_EDGE;
                     }
-                }
-            }
+                });
         }
     }
 
@@ -117,12 +101,18 @@ namespace World {
         return m_params.GetWorldExtent();
     }
 
-    Tile& World::GetTile(TileId_t tile_id) {
-        return m_tiles.at(tile_id);
+    Tile World::GetTile(TileId_t tile_id) {
+        if (tile_id >= m_tile_columns.GetSize()) {
+            throw std::out_of_range("Tile ID out of range");
+        }
+        return {*this, tile_id};
     }
 
-    const Tile& World::GetTile(TileId_t tile_id) const {
-        return m_tiles.at(tile_id);
+    ConstTile World::GetTile(TileId_t tile_id) const {
+        if (tile_id >= m_tile_columns.GetSize()) {
+            throw std::out_of_range("Tile ID out of range");
+        }
+        return {*this, tile_id};
     }
 
     Region& World::GetRegion(RegionId_t region_id) {
@@ -141,12 +131,20 @@ namespace World {
         return m_plates.at(plate_id);
     }
 
-    const std::vector<Tile>& World::GetTiles() const {
-        return m_tiles;
+    ConstTileView World::GetTiles() const {
+        return {this, m_tile_columns.GetSize()};
+    }
+
+    TileView World::GetTiles() {
+        return {this, m_tile_columns.GetSize()};
+    }
+
+    const TileColumns& World::GetTileColumns() const {
+        return m_tile_columns;
     }
 
-    std::vector<Tile>& World::GetTiles() {
-        return m_tiles;
+    TileColumns& World::GetTileColumns() {
+        return m_tile_columns;
     }
 
     const std::vector<Region>& World::GetRegions() const {
@@ -165,8 +163,85 @@ namespace World {
         return m_plates;
     }
 
+    void World::SetGeology(Geology&& geology) {
+        m_geology = std::move(geology);
+    }
+
+    const Geology& World::GetGeology() const {
+        return m_geology;
+    }
+
+    const GeologyLayer& World::GetGeologyAt(TileId_t tile_id, float depth) const {
+        if (tile_id >= m_tile_columns.GetSize()) {
+            throw std::out_of_range("Tile ID out of range");
+        }
+        return m_geology.GetLayerAt(m_tile_columns.GetRegionIds()[tile_id], depth);
+    }
+
+    void World::SetBasins(std::vector<Basin>&& basins) {
+        m_basins = std::move(basins);
+    }
+
+    const std::vector<Basin>& World::GetBasins() const {
+        return m_basins;
+    }
+
+    const Basin& World::GetBasin(BasinId_t basin_id) const {
+        return m_basins.at(basin_id);
+    }
+
+    void World::SetRivers(RiverNetwork&& rivers) {
+        m_rivers = std::move(rivers);
+    }
+
+    const RiverNetwork& World::GetRivers() const {
+        return m_rivers;
+    }
+
     float World::GetOceanLevel() const {
         return m_ocean_level;
     }
 
+    const HeightEncoding& World::GetHeightEncoding() const {
+        return m_height_encoding;
+    }
+
+    void World::SetHeightEncoding(const HeightEncoding& encoding) {
+        uint16_t* p_heights = m_tile_columns.GetHeights();
+        uint16_t* p_waterLevels = m_tile_columns.GetWaterLevels();
+        for (size_t tileId = 0U; tileId < m_tile_columns.GetSize(); tileId++) {
+            p_heights[tileId] = encoding.Encode(m_height_encoding.Decode(p_heights[tileId]));
+            p_waterLevels[tileId] = encoding.Encode(m_height_encoding.Decode(p_waterLevels[tileId]));
+        }
+        m_height_encoding = encoding;
+    }
+
+    void World::GetTileHeights(std::vector<float>& heights) const {
+        heights.resize(m_tile_columns.GetSize());
+        m_height_encoding.Decode(m_tile_columns.GetHeights(), heights.data(), heights.size());
+    }
+
+    void World::FitHeightEncoding(float min_height, float max_height) {
+        min_height = std::min(min_height, m_ocean_level);
+        max_height = std::max({max_height, m_ocean_level, min_height + MIN_HEIGHT_RANGE});
+        SetHeightEncoding(HeightEncoding::FromRange(min_height, max_height));
+    }
+
+    void World::SetTileHeights(const std::vector<float>& heights) {
+
+        float minHeight = m_ocean_level;
+        float maxHeight = m_ocean_level;
+        for (float height : heights) {
+            minHeight = std::min(minHeight, height);
+            maxHeight = std::max(maxHeight, height);
+        }
+        for (const Region& region : m_regions) {
+            minHeight = std::min(minHeight, region.GetAbsoluteHeight());
+            maxHeight = std::max(maxHeight, region.GetAbsoluteHeight());
+        }
+
+        FitHeightEncoding(minHeight, maxHeight);
+        m_height_encoding.Encode(heights.data(), m_tile_columns.GetHeights(), m_tile_columns.GetSize());
+    }
+
 }
@@ -5,9 +5,14 @@
 #include <glm/vec2.hpp>
 #include <vector>
 
+#include "Basin.hpp"
+#include "Geology.hpp"
+#include "HeightEncoding.hpp"
 #include "Region.hpp"
+#include "RiverNetwork.hpp"
 #include "TectonicPlate.hpp"
 #include "Tile.hpp"
+#include "TileColumns.hpp"
 #include "WorldParams.hpp"
 
 namespace World {
@@ -19,6 +24,10 @@ namespace World {
 
         public:
 
+            //! Smallest range of heights that the height encoding is fit to, in meters, so that a flat world still has
+            //! room for water levels and later changes of height.
+            static constexpr float MIN_HEIGHT_RANGE = 256.0F;
+
             World(const WorldParams& params);
 
             //! @brief Get Parameters
@@ -55,8 +64,8 @@ namespace World {
             Extent_t GetSize() const;
 
             //! Get a tile by ID
-            Tile& GetTile(TileId_t tile_id);
-            const Tile& GetTile(TileId_t tile_id) const;
+            Tile GetTile(TileId_t tile_id);
+            ConstTile GetTile(TileId_t tile_id) const;
 
             //! Get a region by ID
             Region& GetRegion(RegionId_t region_id);
@@ -67,8 +76,12 @@ namespace World {
             const TectonicPlate& GetPlate(PlateId_t plate_id) const;
 
             //! Get all tiles
-            const std::vector<Tile>& GetTiles() const;
-            std::vector<Tile>& GetTiles();
+            ConstTileView GetTiles() const;
+            TileView GetTiles();
+
+            //! Get the storage of all tiles, for passes that work on whole columns of tile data at once.
+            const TileColumns& GetTileColumns() const;
+            TileColumns& GetTileColumns();
 
             //! Get all regions
             const std::vector<Region>& GetRegions() const;
@@ -81,13 +94,77 @@ namespace World {
             //! Get the ocean level
             float GetOceanLevel() const;
 
+            //! Set the geological layers under every region
+            void SetGeology(Geology&& geology);
+
+            //! Get the geological layers under every region
+            const Geology& GetGeology() const;
+
+            //! @brief Find the geological layer at a depth under a tile.
+            //!
+            //! @param[in] tile_id The tile.
+            //! @param[in] depth   Depth below the surface of the tile, in meters.
+            //!
+            //! @returns The layer, which tells the rock and resource found at that depth.
+            const GeologyLayer& GetGeologyAt(TileId_t tile_id, float depth) const;
+
+            //! Set the drainage basins, which the basin ID of each tile indexes
+            void SetBasins(std::vector<Basin>&& basins);
+
+            //! Get all drainage basins
+            const std::vector<Basin>& GetBasins() const;
+
+            //! Get a drainage basin by ID
+            const Basin& GetBasin(BasinId_t basin_id) const;
+
+            //! Set the river network
+            void SetRivers(RiverNetwork&& rivers);
+
+            //! Get the river network
+            const RiverNetwork& GetRivers() const;
+
+            //! @brief Get the encoding used to store tile heights and water levels.
+            const HeightEncoding& GetHeightEncoding() const;
+
+            //! @brief Change the encoding used to store tile heights and water levels.
+            //!
+            //! Heights already stored in the tiles are converted to the new encoding.
+            //!
+            //! @param[in] encoding The new encoding.
+            void SetHeightEncoding(const HeightEncoding& encoding);
+
+            //! @brief Decode the height of every tile.
+            //!
+            //! @param[out] heights Set to the height of each tile in meters, indexed by tile ID.
+            void GetTileHeights(std::vector<float>& heights) const;
+
+            //! @brief Fit the height encoding to a range of heights, so that they are stored with the smallest step.
+            //!
+            //! The range is widened to include the ocean level, and to at least MIN_HEIGHT_RANGE. Heights already stored
+            //! in the tiles are converted to the new encoding, and clamped to it.
+            //!
+            //! @param[in] min_height The lowest height to be stored, in meters.
+            //! @param[in] max_height The highest height to be stored, in meters.
+            void FitHeightEncoding(float min_height, float max_height);
+
+            //! @brief Encode and set the height of every tile.
+            //!
+            //! The height encoding is first fit to the range of the heights, and of the regions that water levels are
+            //! taken from.
+            //!
+            //! @param[in] heights The height of each tile in meters, indexed by tile ID.
+            void SetTileHeights(const std::vector<float>& heights);
+
         private:
 
             //! World Parameters
             WorldParams m_params;
 
-            //! Set of all tiles in the world
-            std::vector<Tile> m_tiles;
+            //! Encoding of tile heights and water levels.
+            HeightEncoding m_height_encoding;
+
+            //! Data of all tiles in the world
+            TileColumns m_tile_columns;
 
             //! Set of all regions in the world
             std::vector<Region> m_regions;
@@ -95,6 +172,15 @@ namespace World {
             //! Set of all tectonic plates in the world.
             std::vector<TectonicPlate> m_plates;
 
+            //! Geological layers under each region.
+            Geology m_geology;
+
+            //! Drainage basins of the land, see Passes::LabelBasins().
+            std::vector<Basin> m_basins;
+
+            //! Rivers, see Passes::BuildRiverNetwork().
+            RiverNetwork m_rivers;
+
             //! Overall ocean level of the world.
             float m_ocean_level;
     };
@@ -0,0 +1,217 @@
+#include "WorldDigest.hpp"
+#include "World.hpp"
+#include "math/Hash.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace World {
+
+    //! Accumulates the fields of a single element into a hash.
+    class ElementHasher {
+
+        public:
+
+            template<typename T>
+            ElementHasher& Add(const T& value) {
+                m_hash = Math::HashFNV1A64(&value, sizeof(T), m_hash);
+                return *this;
+            }
+
+            ElementHasher& Add(glm::vec2 value) {
+                return Add(value.x).Add(value.y);
+            }
+
+            uint64_t GetHash() const {
+                return m_hash;
+            }
+
+        private:
+
+            uint64_t m_hash {Math::FNV1A64_OFFSET_BASIS};
+    };
+
+    static uint64_t HashPlate(const TectonicPlate& plate) {
+        ElementHasher hasher;
+        hasher.Add(plate.GetVelocity())
+            .Add(plate.GetIsContinental())
+            .Add(plate.GetAbsoluteHeight())
+            .Add(plate.GetCentroid());
+
+        // boundaries are kept in a hash map, so sort them to make the hash independent of its iteration order.
+        std::vector<std::pair<PlateId_t, PlateBoundaryType>> boundaries(
+            plate.GetBoundaries().begin(), plate.GetBoundaries().end());
+        std::sort(boundaries.begin(), boundaries.end());
+        for (const auto& boundary : boundaries) {
+            hasher.Add(boundary.first).Add(static_cast<uint8_t>(boundary.second));
+        }
+
+        return hasher.GetHash();
+    }
+
+    static uint64_t HashRegion(const Region& region) {
+        ElementHasher hasher;
+        hasher.Add(region.GetPlateId()).Add(region.GetCentroid());
+        for (RegionId_t neighbor : region.GetNeighbors()) {
+            hasher.Add(neighbor);
+        }
+
+        hasher.Add(region.GetIsBoundary())
+            .Add(region.GetHasSubduction())
+            .Add(region.GetAbsoluteHeight())
+            .Add(region.GetIsOcean())
+            .Add(region.GetIsWater())
+            .Add(region.GetIsLake())
+            .Add(region.GetIsMountain())
+            .Add(region.GetWaterLevel())
+            .Add(region.GetFlowAccumulation())
+            .Add(region.GetFlowDirection())
+            .Add(region.GetHasRiver())
+            .Add(region.GetTemperature())
+            .Add(region.GetTemperatureVariance())
+            .Add(region.GetMoisture())
+            .Add(static_cast<uint8_t>(region.GetBiome()));
+
+        return hasher.GetHash();
+    }
+
+    static uint64_t HashTile(const ConstTile& tile) {
+        ElementHasher hasher;
+        hasher.Add(tile.GetRegionId())
+            .Add(tile.GetIsEdgeTile())
+            .Add(tile.GetEncodedHeight())
+            .Add(tile.GetIsWater())
+            .Add(tile.GetIsRiver())
+            .Add(tile.GetIsLake())
+            .Add(tile.GetEncodedWaterLevel())
+            .Add(static_cast<uint8_t>(tile.GetBiome()))
+            .Add(tile.GetBasinId());
+
+        return hasher.GetHash();
+    }
+
+    static uint64_t HashGeologyColumn(const Geology& geology, RegionId_t region_id) {
+        ElementHasher hasher;
+        for (size_t layer = 0U; layer < geology.GetNumLayers(region_id); layer++) {
+            const GeologyLayer& geologyLayer = geology.GetLayer(region_id, layer);
+            hasher.Add(geologyLayer.bottom_depth)
+                .Add(static_cast<uint8_t>(geologyLayer.rock))
+                .Add(static_cast<uint8_t>(geologyLayer.resource));
+        }
+
+        return hasher.GetHash();
+    }
+
+    static uint64_t HashBasin(const Basin& basin) {
+        ElementHasher hasher;
+        hasher.Add(basin.pit)
+            .Add(basin.spill)
+            .Add(basin.spill_basin)
+            .Add(basin.outlet)
+            .Add(basin.lake)
+            .Add(basin.spill_height)
+            .Add(basin.water_level)
+            .Add(basin.volume)
+            .Add(basin.drains_to_ocean);
+
+        return hasher.GetHash();
+    }
+
+    static uint64_t HashRiverSegment(const RiverNetwork& rivers, RiverId_t segment_id) {
+        const RiverSegment& segment = rivers.GetSegment(segment_id);
+        ElementHasher hasher;
+        hasher.Add(segment.downstream).Add(segment.flow).Add(segment.width).Add(segment.order);
+        for (size_t point = 0U; point < rivers.GetNumPoints(segment_id); point++) {
+            hasher.Add(rivers.GetPoint(segment_id, point));
+        }
+
+        return hasher.GetHash();
+    }
+
+    const char* WorldPartToString(WorldPart part) {
+        switch (part) {
+            case WorldPart::PLATES:
+                return "plates";
+            case WorldPart::REGIONS:
+                return "regions";
+            case WorldPart::TILES:
+                return "tiles";
+            case WorldPart::GEOLOGY:
+                return "geology";
+            case WorldPart::BASINS:
+                return "basins";
+            case WorldPart::RIVERS:
+                return "rivers";
+            default:
+                return "unknown";
+        }
+    }
+
+    WorldDigest::WorldDigest(const World& world) {
+
+        std::vector<uint64_t>& plateHashes = m_element_hashes[static_cast<size_t>(WorldPart::PLATES)];
+        for (const TectonicPlate& plate : world.GetPlates()) {
+            plateHashes.push_back(HashPlate(plate));
+        }
+
+        std::vector<uint64_t>& regionHashes = m_element_hashes[static_cast<size_t>(WorldPart::REGIONS)];
+        for (const Region& region : world.GetRegions()) {
+            regionHashes.push_back(HashRegion(region));
+        }
+
+        std::vector<uint64_t>& tileHashes = m_element_hashes[static_cast<size_t>(WorldPart::TILES)];
+        tileHashes.reserve(world.GetTiles().size());
+        for (ConstTile tile : world.GetTiles()) {
+            tileHashes.push_back(HashTile(tile));
+        }
+
+        const Geology& geology = world.GetGeology();
+        std::vector<uint64_t>& geologyHashes = m_element_hashes[static_cast<size_t>(WorldPart::GEOLOGY)];
+        for (size_t regionId = 0U; regionId < geology.GetNumRegions(); regionId++) {
+            geologyHashes.push_back(HashGeologyColumn(geology, static_cast<RegionId_t>(regionId)));
+        }
+
+        std::vector<uint64_t>& basinHashes = m_element_hashes[static_cast<size_t>(WorldPart::BASINS)];
+        for (const Basin& basin : world.GetBasins()) {
+            basinHashes.push_back(HashBasin(basin));
+        }
+
+        const RiverNetwork& rivers = world.GetRivers();
+        std::vector<uint64_t>& riverHashes = m_element_hashes[static_cast<size_t>(WorldPart::RIVERS)];
+        for (size_t segmentId = 0U; segmentId < rivers.GetNumSegments(); segmentId++) {
+            riverHashes.push_back(HashRiverSegment(rivers, static_cast<RiverId_t>(segmentId)));
+        }
+    }
+
+    size_t WorldDigest::GetCount(WorldPart part) const {
+        return m_element_hashes[static_cast<size_t>(part)].size();
+    }
+
+    uint64_t WorldDigest::GetHash(WorldPart part) const {
+        const std::vector<uint64_t>& hashes = m_element_hashes[static_cast<size_t>(part)];
+        return Math::HashFNV1A64(hashes.data(), hashes.size() * sizeof(uint64_t));
+    }
+
+    std::vector<uint64_t> WorldDigest::GetBlockHashes(WorldPart part) const {
+        const std::vector<uint64_t>& hashes = m_element_hashes[static_cast<size_t>(part)];
+
+        std::vector<uint64_t> blockHashes;
+        for (size_t begin = 0U; begin < hashes.size(); begin += BLOCK_SIZE) {
+            size_t count = std::min(BLOCK_SIZE, hashes.size() - begin);
+            blockHashes.push_back(Math::HashFNV1A64(&hashes[begin], count * sizeof(uint64_t)));
+        }
+
+        return blockHashes;
+    }
+
+    size_t WorldDigest::FindFirstDifference(const WorldDigest& other, WorldPart part) const {
+        const std::vector<uint64_t>& hashes = m_element_hashes[static_cast<size_t>(part)];
+        const std::vector<uint64_t>& otherHashes = other.m_element_hashes[static_cast<size_t>(part)];
+
+        auto mismatch = std::mismatch(hashes.begin(), hashes.end(), otherHashes.begin(), otherHashes.end());
+        if ((mismatch.first == hashes.end()) && (mismatch.second == otherHashes.end())) {
+            return NO_DIFFERENCE;
+        }
+
+        return static_cast<size_t>(mismatch.first - hashes.begin());
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World {
+
+    class World;
+
+    //! Parts of a world that are hashed separately by a WorldDigest.
+    enum class WorldPart : uint8_t {
+        PLATES = 0,
+        REGIONS,
+        TILES,
+        GEOLOGY,
+        BASINS,
+        RIVERS,
+        NUM_PARTS
+    };
+
+    //! @brief Get the name of a part, as used in digest files.
+    const char* WorldPartToString(WorldPart part);
+
+    //! Stable hashes of the contents of a world, used to check that generation and saving give the same world across
+    //! runs, thread counts and code changes.
+    //!
+    //! Every plate, region, tile, geological column, drainage basin and river segment is hashed on its own, from the fields that are
+    //! written to a save, or derived again as it is loaded. Floats are hashed
+    //! by their bits, so that any change to a result is caught, no matter how small.
+    class WorldDigest {
+
+        public:
+
+            static constexpr size_t NUM_PARTS = static_cast<size_t>(WorldPart::NUM_PARTS);
+
+            //! Number of elements covered by each hash returned from GetBlockHashes().
+            static constexpr size_t BLOCK_SIZE = 4096U;
+
+            //! Returned by FindFirstDifference() when the parts are identical.
+            static constexpr size_t NO_DIFFERENCE = SIZE_MAX;
+
+            //! @brief Hash the contents of a world.
+            explicit WorldDigest(const World& world);
+
+            //! @brief Get the number of elements in a part.
+            size_t GetCount(WorldPart part) const;
+
+            //! @brief Get a single hash of every element in a part.
+            uint64_t GetHash(WorldPart part) const;
+
+            //! @brief Get a hash for each consecutive block of BLOCK_SIZE elements in a part.
+            //!
+            //! Comparing block hashes narrows down where two digests differ, when only the block hashes of one of them
+            //! were recorded.
+            std::vector<uint64_t> GetBlockHashes(WorldPart part) const;
+
+            //! @brief Find the first element of a part that differs between two digests.
+            //!
+            //! @param[in] other The digest to compare with.
+            //! @param[in] part  The part to compare.
+            //!
+            //! @returns The index of the first element that differs. If one part is a prefix of the other, the length of
+            //!          the shorter one. NO_DIFFERENCE if the parts are identical.
+            size_t FindFirstDifference(const WorldDigest& other, WorldPart part) const;
+
+        private:
+
+            //! Hash of each element, for each part.
+            std::array<std::vector<uint64_t>, NUM_PARTS> m_element_hashes;
+    };
+}
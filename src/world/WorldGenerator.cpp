@@ -9,18 +9,32 @@
 #include "World.hpp"
 #include "WorldParams.hpp"
 #include "passes/Passes.hpp"
+#include <array>
+#include <utility>
 
 namespace World {
 
 
-std::unique_ptr<World> WorldGenerator::Generate(const WorldParams& params) {
+std::unique_ptr<World> WorldGenerator::Generate(const WorldParams& params, const PassObserver_t& observer) {
+
+    using Pass_t = void (*)(World&, const WorldParams&);
+    static constexpr std::array<std::pair<const char*, Pass_t>, 7> PASSES = {{
+        {"Tectonics", &Passes::RunTectonicsPass},
+        {"Elevation", &Passes::RunElevationPass},
+        {"TectonicSimulation", &Passes::RunTectonicSimulationPass},
+        {"Erosion", &Passes::RunErosionPass},
+        {"Hydrology", &Passes::RunHydrologyPass},
+        {"Climate", &Passes::RunClimatePass},
+        {"Minerals", &Passes::RunMineralPass}}};
 
     std::unique_ptr<World> p_world = std::make_unique<World>(params);
 
-    Passes::RunTectonicsPass(*p_world, params);
-    Passes::RunElevationPass(*p_world, params);
-    Passes::RunHydrologyPass(*p_world, params);
-    Passes::RunClimatePass(*p_world, params);
+    for (const auto& pass : PASSES) {
+        pass.second(*p_world, params);
+        if (observer) {
+            observer(pass.first, *p_world);
+        }
+    }
 
     return p_world;
 }
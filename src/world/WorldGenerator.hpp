@@ -2,6 +2,7 @@
 
 #include "World.hpp"
 #include "WorldParams.hpp"
+#include <functional>
 #include <glm/vec2.hpp>
 #include <memory>
 
@@ -13,6 +14,13 @@ namespace World {
 
         public:
 
-            static std::unique_ptr<World> Generate(const WorldParams& params);
+            //! Called after each pass, with the name of the pass and the world as it left it.
+            using PassObserver_t = std::function<void(const char* pass_name, const World& world)>;
+
+            //! @brief Generate a world.
+            //!
+            //! @param[in] params   Parameters of the world.
+            //! @param[in] observer Optional function to call after each pass.
+            static std::unique_ptr<World> Generate(const WorldParams& params, const PassObserver_t& observer = nullptr);
     };
 }
\ No newline at end of file
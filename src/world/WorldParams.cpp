@@ -63,6 +63,46 @@ namespace World {
         return m_region_size;
     }
 
+    void WorldParams::SetErosionIterations(size_t iterations) {
+        m_erosion_iterations = iterations;
+    }
+
+    size_t WorldParams::GetErosionIterations() const {
+        return m_erosion_iterations;
+    }
+
+    void WorldParams::SetTectonicSteps(size_t steps) {
+        m_tectonic_steps = steps;
+    }
+
+    size_t WorldParams::GetTectonicSteps() const {
+        return m_tectonic_steps;
+    }
+
+    void WorldParams::SetSimulateAtmosphere(bool simulate_atmosphere) {
+        m_simulate_atmosphere = simulate_atmosphere;
+    }
+
+    bool WorldParams::GetIsAtmosphereSimulated() const {
+        return m_simulate_atmosphere;
+    }
+
+    void WorldParams::SetOutOfCore(bool out_of_core) {
+        m_out_of_core = out_of_core;
+    }
+
+    bool WorldParams::GetIsOutOfCore() const {
+        return m_out_of_core || (m_dimmension >= OUT_OF_CORE_MIN_DIMENSION);
+    }
+
+    void WorldParams::SetOutOfCoreDirectory(const std::string& directory) {
+        m_out_of_core_directory = directory;
+    }
+
+    const std::string& WorldParams::GetOutOfCoreDirectory() const {
+        return m_out_of_core_directory;
+    }
+
     int32_t WorldParams::CalculateNumPlates() const {
 
         float numPlates = static_cast<float>(m_num_continents);
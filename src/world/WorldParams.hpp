@@ -12,11 +12,29 @@ namespace World {
 
     static constexpr float TILE_PER_METER_F32 = 1.0F / TILE_SIZE_METERS_F32;
 
+    //! Streams of the counter based random number generator used during world generation. Each use of random numbers
+    //! gets its own stream, so that adding or reordering draws in one pass does not change the results of another.
+    static constexpr uint32_t RNG_STREAM_PLATE_SEEDS = 1U;
+    static constexpr uint32_t RNG_STREAM_REGION_SEEDS = 2U;
+    static constexpr uint32_t RNG_STREAM_PLATE_VELOCITY = 3U;
+    static constexpr uint32_t RNG_STREAM_CONTINENTS = 4U;
+    static constexpr uint32_t RNG_STREAM_EROSION_DROPLETS = 5U;
+    static constexpr uint32_t RNG_STREAM_GEOLOGY = 6U;
+    static constexpr uint32_t RNG_STREAM_WEATHER = 7U;
+
     //! Parameters used for world generation.
     class WorldParams {
 
         public:
 
+            static constexpr size_t DEFAULT_EROSION_ITERATIONS = 2U;
+            static constexpr size_t DEFAULT_TECTONIC_STEPS = 0U;
+
+            //! Worlds at least this wide keep their tiles in a memory mapped file rather than in memory. A world of
+            //! 4096x4096 tiles needs 144 MB of tile data. Generating it peaks at about 660 MB resident, and a world of
+            //! 8192x8192 tiles at about 2.6 GB, as the passes that are not blocked still hold whole world buffers.
+            static constexpr size_t OUT_OF_CORE_MIN_DIMENSION = 4096U;
+
             //! Set the name of the world.
             void SetName(const std::string& name);
 
@@ -59,6 +77,45 @@ namespace World {
             //! Get the region size
             size_t GetRegionSize() const;
 
+            //! Set the number of erosion iterations. Each iteration simulates one droplet of rain per tile, followed by
+            //! thermal relaxation of steep slopes. Zero disables erosion.
+            void SetErosionIterations(size_t iterations);
+
+            //! Get the number of erosion iterations
+            size_t GetErosionIterations() const;
+
+            //! Set the number of steps of the tectonic simulation. Each step moves the plates, and uplifts, subducts
+            //! or rifts the crust where they meet. Zero disables the simulation, leaving elevation as assigned from
+            //! the plate boundaries. Plates move at most one tile per step, so worlds too large to drift the whole
+            //! distance in this many steps take more.
+            void SetTectonicSteps(size_t steps);
+
+            //! Get the number of steps of the tectonic simulation.
+            size_t GetTectonicSteps() const;
+
+            //! Simulate winds and ocean currents on a coarse grid over the world, to move moisture and heat from the
+            //! ocean over land. Gives rain shadows behind mountains and wet coasts, rather than moisture that only
+            //! depends on the distance to water.
+            void SetSimulateAtmosphere(bool simulate_atmosphere);
+
+            //! Determine if the climate is simulated by the atmosphere.
+            bool GetIsAtmosphereSimulated() const;
+
+            //! Force the tiles of the world to be kept in a memory mapped file, even for small worlds.
+            void SetOutOfCore(bool out_of_core);
+
+            //! Determine if the tiles of the world are kept in a memory mapped file.
+            bool GetIsOutOfCore() const;
+
+            //! @brief Set the directory the memory mapped file of an out of core world is created in.
+            //!
+            //! The game passes the user save directory. When empty, the temporary directory of the system is used,
+            //! which is often held in memory, so that the world takes as much memory as it would in core.
+            void SetOutOfCoreDirectory(const std::string& directory);
+
+            //! Get the directory the memory mapped file of an out of core world is created in.
+            const std::string& GetOutOfCoreDirectory() const;
+
             //! Calculate the number of tectonic plates
             int32_t CalculateNumPlates() const;
 
@@ -88,5 +145,20 @@ namespace World {
             //! The size of each region used for biome/feature assignment.
             size_t m_region_size;
 
+            //! The number of erosion iterations run after elevation is assigned.
+            size_t m_erosion_iterations {DEFAULT_EROSION_ITERATIONS};
+
+            //! The number of steps of the tectonic simulation run after elevation is assigned.
+            size_t m_tectonic_steps {DEFAULT_TECTONIC_STEPS};
+
+            //! Whether the climate pass simulates the atmosphere.
+            bool m_simulate_atmosphere {false};
+
+            //! Whether out of core storage was requested, regardless of the world dimension. Not saved.
+            bool m_out_of_core {false};
+
+            //! Directory for the memory mapped file of out of core worlds. Not saved.
+            std::string m_out_of_core_directory;
+
     };
 }
\ No newline at end of file
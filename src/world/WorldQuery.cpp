@@ -0,0 +1,360 @@
+#include "WorldQuery.hpp"
+#include "World.hpp"
+#include "WorldParams.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace World {
+
+    //! Maximum number of regions in a leaf of the bounding volume hierarchy.
+    static constexpr int32_t MAX_REGIONS_PER_LEAF = 4;
+
+    //! Convert a position in meters to tile center space, where the center of tile (x, y) is at (x, y).
+    static glm::vec2 ToTileCenterSpace(glm::vec2 position) {
+        return (position * TILE_PER_METER_F32) - glm::vec2(0.5F);
+    }
+
+    WorldQuery::WorldQuery(const World& world)
+        : m_p_world(&world)
+        , m_extent(glm::ivec2(world.GetSize())) {
+
+        ConstTileView tiles = world.GetTiles();
+        const size_t numRegions = world.GetRegions().size();
+
+        m_region_raster.resize(tiles.size());
+        m_region_bounds.assign(numRegions, TileRange{m_extent, glm::ivec2(-1)});
+
+        for (size_t tileId = 0U; tileId < tiles.size(); tileId++) {
+
+            RegionId_t regionId = tiles[tileId].GetRegionId();
+            m_region_raster[tileId] = regionId;
+            if ((regionId < 0) || (static_cast<size_t>(regionId) >= numRegions)) {
+                continue;
+            }
+
+            glm::ivec2 coordinate(world.TileIdToCoordinate(static_cast<TileId_t>(tileId)));
+            TileRange& bounds = m_region_bounds[regionId];
+            bounds.min = glm::ivec2(std::min(bounds.min.x, coordinate.x), std::min(bounds.min.y, coordinate.y));
+            bounds.max = glm::ivec2(std::max(bounds.max.x, coordinate.x), std::max(bounds.max.y, coordinate.y));
+        }
+
+        // regions without any tiles can never be found by a query.
+        for (size_t regionId = 0U; regionId < numRegions; regionId++) {
+            if (m_region_bounds[regionId].min.x <= m_region_bounds[regionId].max.x) {
+                m_bvh_regions.push_back(static_cast<RegionId_t>(regionId));
+            }
+        }
+
+        if (!m_bvh_regions.empty()) {
+            m_bvh_nodes.reserve(2U * m_bvh_regions.size());
+            BuildBvh(0, static_cast<int32_t>(m_bvh_regions.size()));
+        }
+    }
+
+    TileId_t WorldQuery::GetTileAt(glm::vec2 position) const {
+
+        glm::vec2 tilePosition = position * TILE_PER_METER_F32;
+        if ((tilePosition.x < 0.0F) || (tilePosition.y < 0.0F) ||
+            (tilePosition.x >= static_cast<float>(m_extent.x)) || (tilePosition.y >= static_cast<float>(m_extent.y))) {
+            return INVALID_TILE_ID;
+        }
+
+        return (static_cast<TileId_t>(tilePosition.y) * static_cast<TileId_t>(m_extent.x)) + static_cast<TileId_t>(tilePosition.x);
+    }
+
+    RegionId_t WorldQuery::GetRegionAt(glm::vec2 position) const {
+
+        TileId_t tileId = GetTileAt(position);
+        return (tileId == INVALID_TILE_ID) ? INVALID_REGION_ID : m_region_raster[tileId];
+    }
+
+    std::vector<TileId_t> WorldQuery::FindTilesInRadius(glm::vec2 center, float radius) const {
+
+        glm::vec2 centerTile = ToTileCenterSpace(center);
+        float radiusTile = radius * TILE_PER_METER_F32;
+        float radiusSquare = radiusTile * radiusTile;
+
+        TileRange range = GetCircleRange(centerTile, radiusTile);
+
+        std::vector<TileId_t> found;
+        for (int32_t yCoord = range.min.y; yCoord <= range.max.y; yCoord++) {
+            float distanceY = static_cast<float>(yCoord) - centerTile.y;
+            for (int32_t xCoord = range.min.x; xCoord <= range.max.x; xCoord++) {
+                float distanceX = static_cast<float>(xCoord) - centerTile.x;
+                if ((distanceX * distanceX) + (distanceY * distanceY) <= radiusSquare) {
+                    found.push_back(static_cast<TileId_t>((yCoord * m_extent.x) + xCoord));
+                }
+            }
+        }
+
+        return found;
+    }
+
+    std::vector<TileId_t> WorldQuery::FindTilesInRect(const Math::Box& rect) const {
+
+        TileRange range = GetRectRange(rect);
+
+        std::vector<TileId_t> found;
+        for (int32_t yCoord = range.min.y; yCoord <= range.max.y; yCoord++) {
+            for (int32_t xCoord = range.min.x; xCoord <= range.max.x; xCoord++) {
+                found.push_back(static_cast<TileId_t>((yCoord * m_extent.x) + xCoord));
+            }
+        }
+
+        return found;
+    }
+
+    std::vector<RegionId_t> WorldQuery::FindRegionsInRadius(glm::vec2 center, float radius) const {
+
+        glm::vec2 centerTile = ToTileCenterSpace(center);
+        float radiusTile = radius * TILE_PER_METER_F32;
+        float radiusSquare = radiusTile * radiusTile;
+
+        TileRange range = GetCircleRange(centerTile, radiusTile);
+
+        auto inCircle = [centerTile, radiusSquare](float x_coord, float y_coord) {
+            float distanceX = x_coord - centerTile.x;
+            float distanceY = y_coord - centerTile.y;
+            return (distanceX * distanceX) + (distanceY * distanceY) <= radiusSquare;
+        };
+
+        // distance from the circle to the closest tile center in the bounds.
+        auto boundsTest = [&inCircle, centerTile](const TileRange& bounds) {
+            return inCircle(
+                std::clamp(centerTile.x, static_cast<float>(bounds.min.x), static_cast<float>(bounds.max.x)),
+                std::clamp(centerTile.y, static_cast<float>(bounds.min.y), static_cast<float>(bounds.max.y)));
+        };
+
+        auto tileTest = [&inCircle](int32_t x_coord, int32_t y_coord) {
+            return inCircle(static_cast<float>(x_coord), static_cast<float>(y_coord));
+        };
+
+        return FindRegions(range, boundsTest, tileTest);
+    }
+
+    std::vector<RegionId_t> WorldQuery::FindRegionsInRect(const Math::Box& rect) const {
+
+        TileRange range = GetRectRange(rect);
+
+        // every tile in the range is inside of the rectangle, so overlapping the range is enough.
+        auto boundsTest = [](const TileRange& /*bounds*/) { return true; };
+        auto tileTest = [](int32_t /*x_coord*/, int32_t /*y_coord*/) { return true; };
+
+        return FindRegions(range, boundsTest, tileTest);
+    }
+
+    TileId_t WorldQuery::FindNearest(Feature feature, glm::vec2 position) const {
+
+        size_t featureIndex = static_cast<size_t>(feature);
+        std::call_once(m_nearest_built.at(featureIndex), [this, feature]() { BuildNearestMap(feature); });
+
+        glm::vec2 tilePosition = position * TILE_PER_METER_F32;
+        glm::ivec2 coordinate(
+            std::clamp(static_cast<int32_t>(std::floor(tilePosition.x)), 0, m_extent.x - 1),
+            std::clamp(static_cast<int32_t>(std::floor(tilePosition.y)), 0, m_extent.y - 1));
+
+        const std::vector<TileId_t>& nearest = m_nearest_maps.at(featureIndex);
+        return nearest.at((static_cast<size_t>(coordinate.y) * m_extent.x) + coordinate.x);
+    }
+
+    int32_t WorldQuery::BuildBvh(int32_t begin, int32_t end) {
+
+        int32_t nodeIndex = static_cast<int32_t>(m_bvh_nodes.size());
+        m_bvh_nodes.emplace_back();
+
+        TileRange bounds{m_extent, glm::ivec2(-1)};
+        for (int32_t index = begin; index < end; index++) {
+            const TileRange& regionBounds = m_region_bounds[m_bvh_regions[index]];
+            bounds.min = glm::ivec2(std::min(bounds.min.x, regionBounds.min.x), std::min(bounds.min.y, regionBounds.min.y));
+            bounds.max = glm::ivec2(std::max(bounds.max.x, regionBounds.max.x), std::max(bounds.max.y, regionBounds.max.y));
+        }
+        m_bvh_nodes[nodeIndex].bounds = bounds;
+
+        if (end - begin <= MAX_REGIONS_PER_LEAF) {
+            m_bvh_nodes[nodeIndex].first = begin;
+            m_bvh_nodes[nodeIndex].count = end - begin;
+            return nodeIndex;
+        }
+
+        // split at the median of the region centers, along the longest axis.
+        bool splitX = (bounds.max.x - bounds.min.x) >= (bounds.max.y - bounds.min.y);
+        int32_t middle = begin + ((end - begin) / 2);
+        auto centerOf = [this, splitX](RegionId_t regionId) {
+            const TileRange& regionBounds = m_region_bounds[regionId];
+            return splitX ? (regionBounds.min.x + regionBounds.max.x) : (regionBounds.min.y + regionBounds.max.y);
+        };
+
+        std::nth_element(
+            m_bvh_regions.begin() + begin,
+            m_bvh_regions.begin() + middle,
+            m_bvh_regions.begin() + end,
+            [&centerOf](RegionId_t lhs, RegionId_t rhs) {
+                int32_t lhsCenter = centerOf(lhs);
+                int32_t rhsCenter = centerOf(rhs);
+                return (lhsCenter < rhsCenter) || ((lhsCenter == rhsCenter) && (lhs < rhs));
+            });
+
+        BuildBvh(begin, middle);
+        int32_t rightIndex = BuildBvh(middle, end);
+        m_bvh_nodes[nodeIndex].first = rightIndex;
+        return nodeIndex;
+    }
+
+    template<typename BoundsTest_t, typename TileTest_t>
+    std::vector<RegionId_t> WorldQuery::FindRegions(const TileRange& range, BoundsTest_t bounds_test, TileTest_t tile_test) const {
+
+        std::vector<RegionId_t> found;
+        if (m_bvh_nodes.empty() || (range.min.x > range.max.x) || (range.min.y > range.max.y)) {
+            return found;
+        }
+
+        auto overlaps = [&range](const TileRange& bounds) {
+            return (bounds.min.x <= range.max.x) && (bounds.max.x >= range.min.x) &&
+                   (bounds.min.y <= range.max.y) && (bounds.max.y >= range.min.y);
+        };
+
+        std::vector<int32_t> stack;
+        stack.push_back(0);
+
+        while (!stack.empty()) {
+
+            const BvhNode& node = m_bvh_nodes[stack.back()];
+            int32_t nodeIndex = stack.back();
+            stack.pop_back();
+
+            if (!overlaps(node.bounds) || !bounds_test(node.bounds)) {
+                continue;
+            }
+
+            if (node.count == 0) {
+                stack.push_back(node.first);
+                stack.push_back(nodeIndex + 1);
+                continue;
+            }
+
+            for (int32_t index = node.first; index < node.first + node.count; index++) {
+
+                RegionId_t regionId = m_bvh_regions[index];
+                const TileRange& bounds = m_region_bounds[regionId];
+                if (!overlaps(bounds) || !bounds_test(bounds)) {
+                    continue;
+                }
+
+                // bounding boxes of regions overlap, so confirm that a tile of the region is actually in the shape.
+                bool isFound = false;
+                for (int32_t yCoord = std::max(bounds.min.y, range.min.y); !isFound && (yCoord <= std::min(bounds.max.y, range.max.y)); yCoord++) {
+                    for (int32_t xCoord = std::max(bounds.min.x, range.min.x); xCoord <= std::min(bounds.max.x, range.max.x); xCoord++) {
+                        if ((m_region_raster[(static_cast<size_t>(yCoord) * m_extent.x) + xCoord] == regionId) && tile_test(xCoord, yCoord)) {
+                            isFound = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (isFound) {
+                    found.push_back(regionId);
+                }
+            }
+        }
+
+        return found;
+    }
+
+    WorldQuery::TileRange WorldQuery::GetCircleRange(glm::vec2 center_tile, float radius_tile) const {
+        return ClampToWorld({
+            glm::ivec2(static_cast<int32_t>(std::ceil(center_tile.x - radius_tile)), static_cast<int32_t>(std::ceil(center_tile.y - radius_tile))),
+            glm::ivec2(static_cast<int32_t>(std::floor(center_tile.x + radius_tile)), static_cast<int32_t>(std::floor(center_tile.y + radius_tile)))});
+    }
+
+    WorldQuery::TileRange WorldQuery::GetRectRange(const Math::Box& rect) const {
+
+        // the rectangle includes its top left edges, but not its bottom right edges.
+        glm::vec2 topLeft = ToTileCenterSpace(rect.GetTopLeft());
+        glm::vec2 bottomRight = ToTileCenterSpace(rect.GetBottomRight());
+
+        return ClampToWorld({
+            glm::ivec2(static_cast<int32_t>(std::ceil(topLeft.x)), static_cast<int32_t>(std::ceil(topLeft.y))),
+            glm::ivec2(static_cast<int32_t>(std::ceil(bottomRight.x)) - 1, static_cast<int32_t>(std::ceil(bottomRight.y)) - 1)});
+    }
+
+    WorldQuery::TileRange WorldQuery::ClampToWorld(TileRange range) const {
+        range.min = glm::ivec2(std::max(range.min.x, 0), std::max(range.min.y, 0));
+        range.max = glm::ivec2(std::min(range.max.x, m_extent.x - 1), std::min(range.max.y, m_extent.y - 1));
+        return range;
+    }
+
+    void WorldQuery::BuildNearestMap(Feature feature) const {
+
+        const size_t numTiles = m_region_raster.size();
+        std::vector<TileId_t>& nearest = m_nearest_maps.at(static_cast<size_t>(feature));
+        nearest.assign(numTiles, INVALID_TILE_ID);
+
+        // multi-source breadth first search, starting from every tile with the feature.
+        std::vector<TileId_t> frontier;
+        for (TileId_t tileId = 0U; tileId < numTiles; tileId++) {
+            if (HasFeature(feature, tileId)) {
+                nearest[tileId] = tileId;
+                frontier.push_back(tileId);
+            }
+        }
+
+        for (size_t head = 0U; head < frontier.size(); head++) {
+
+            TileId_t tileId = frontier[head];
+            int32_t xCoord = static_cast<int32_t>(tileId % static_cast<TileId_t>(m_extent.x));
+            int32_t yCoord = static_cast<int32_t>(tileId / static_cast<TileId_t>(m_extent.x));
+
+            const std::array<glm::ivec2, 4> neighbors = {
+                glm::ivec2(xCoord, yCoord - 1),
+                glm::ivec2(xCoord - 1, yCoord),
+                glm::ivec2(xCoord + 1, yCoord),
+                glm::ivec2(xCoord, yCoord + 1)};
+
+            for (const glm::ivec2& neighbor : neighbors) {
+                if ((neighbor.x < 0) || (neighbor.y < 0) || (neighbor.x >= m_extent.x) || (neighbor.y >= m_extent.y)) {
+                    continue;
+                }
+
+                TileId_t neighborId = static_cast<TileId_t>((neighbor.y * m_extent.x) + neighbor.x);
+                if (nearest[neighborId] == INVALID_TILE_ID) {
+                    nearest[neighborId] = nearest[tileId];
+                    frontier.push_back(neighborId);
+                }
+            }
+        }
+    }
+
+    bool WorldQuery::HasFeature(Feature feature, TileId_t tile_id) const {
+
+        const World& world = *m_p_world;
+        ConstTile tile = world.GetTile(tile_id);
+
+        switch (feature) {
+            case Feature::RIVER:
+                return tile.GetIsRiver();
+
+            case Feature::WATER:
+                return tile.GetIsWater() || tile.GetIsRiver();
+
+            case Feature::COAST: {
+                if (tile.GetIsWater()) {
+                    return false;
+                }
+
+                Coordinate_t coordinate = world.TileIdToCoordinate(tile_id);
+                auto isOcean = [&world](Coordinate_t neighbor) {
+                    ConstTile neighborTile = world.GetTile(world.CoordinateToTileId(neighbor));
+                    return neighborTile.GetIsWater() && !neighborTile.GetIsLake();
+                };
+
+                return ((coordinate.x > 0U) && isOcean({coordinate.x - 1U, coordinate.y})) ||
+                       ((coordinate.y > 0U) && isOcean({coordinate.x, coordinate.y - 1U})) ||
+                       ((coordinate.x + 1U < static_cast<uint32_t>(m_extent.x)) && isOcean({coordinate.x + 1U, coordinate.y})) ||
+                       ((coordinate.y + 1U < static_cast<uint32_t>(m_extent.y)) && isOcean({coordinate.x, coordinate.y + 1U}));
+            }
+
+            default:
+                return false;
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Region.hpp"
+#include "Tile.hpp"
+#include "math/Shapes.hpp"
+#include <array>
+#include <cstdint>
+#include <glm/ext/vector_int2.hpp>
+#include <glm/vec2.hpp>
+#include <mutex>
+#include <vector>
+
+namespace World {
+
+    class World;
+
+    //! Spatial queries over the tiles and regions of a world, for use by AI, spawning and rendering.
+    //!
+    //! Point lookups use a raster of the region that owns each tile. Region enumeration walks a bounding volume
+    //! hierarchy over the bounding box of each region. Nearest feature queries use a map of the nearest feature tile
+    //! for every tile, which is built the first time each feature is queried.
+    //!
+    //! Build the query after the world has been generated or loaded. Queries do not see later changes to the world.
+    //! All queries are const, and safe to call from several threads at once.
+    class WorldQuery {
+
+        public:
+
+            //! Features that can be searched for with FindNearest().
+            enum class Feature : uint8_t {
+                RIVER = 0,  //!< Tiles with a river.
+                COAST,      //!< Land tiles next to the ocean.
+                WATER,      //!< Ocean, lake or river tiles.
+                NUM_FEATURES
+            };
+
+            //! @brief Build the query structures.
+            //!
+            //! @param[in] world The world to query. Must outlive the query.
+            explicit WorldQuery(const World& world);
+            WorldQuery(const WorldQuery& other) = delete;
+            WorldQuery(WorldQuery&& other) = delete;
+            WorldQuery& operator=(const WorldQuery& other) = delete;
+            WorldQuery& operator=(WorldQuery&& other) = delete;
+            ~WorldQuery() = default;
+
+            //! @brief Get the tile under a position.
+            //!
+            //! @param[in] position Position in the world, in meters.
+            //!
+            //! @returns The tile, or INVALID_TILE_ID if the position is outside of the world.
+            TileId_t GetTileAt(glm::vec2 position) const;
+
+            //! @brief Get the region under a position.
+            //!
+            //! @param[in] position Position in the world, in meters.
+            //!
+            //! @returns The region, or INVALID_REGION_ID if the position is outside of the world.
+            RegionId_t GetRegionAt(glm::vec2 position) const;
+
+            //! @brief Find the tiles whose centers are within a radius of a position.
+            //!
+            //! @param[in] center Center of the circle, in meters.
+            //! @param[in] radius Radius of the circle, in meters.
+            //!
+            //! @returns The tiles, ordered by tile ID.
+            std::vector<TileId_t> FindTilesInRadius(glm::vec2 center, float radius) const;
+
+            //! @brief Find the tiles whose centers are within a rectangle.
+            //!
+            //! @param[in] rect The rectangle, in meters. Includes the top and left edges, but not the bottom and right.
+            //!
+            //! @returns The tiles, ordered by tile ID.
+            std::vector<TileId_t> FindTilesInRect(const Math::Box& rect) const;
+
+            //! @brief Find the regions that own at least one tile whose center is within a radius of a position.
+            //!
+            //! @param[in] center Center of the circle, in meters.
+            //! @param[in] radius Radius of the circle, in meters.
+            //!
+            //! @returns The regions, in no particular order.
+            std::vector<RegionId_t> FindRegionsInRadius(glm::vec2 center, float radius) const;
+
+            //! @brief Find the regions that own at least one tile whose center is within a rectangle.
+            //!
+            //! @param[in] rect The rectangle, in meters. Includes the top and left edges, but not the bottom and right.
+            //!
+            //! @returns The regions, in no particular order.
+            std::vector<RegionId_t> FindRegionsInRect(const Math::Box& rect) const;
+
+            //! @brief Find the closest tile with a feature.
+            //!
+            //! Distance is measured in steps between tiles that share an edge, which matches how far something has to
+            //! walk across the map.
+            //!
+            //! @param[in] feature  The feature to look for.
+            //! @param[in] position Position in the world, in meters. Clamped to the world.
+            //!
+            //! @returns The closest tile with the feature, or INVALID_TILE_ID if the world has none.
+            TileId_t FindNearest(Feature feature, glm::vec2 position) const;
+
+        private:
+
+            //! Inclusive range of tile coordinates. Empty if min is greater than max on either axis.
+            struct TileRange {
+                glm::ivec2 min;
+                glm::ivec2 max;
+            };
+
+            //! Node of the region bounding volume hierarchy.
+            //!
+            //! Nodes are stored depth first, so the left child of an interior node immediately follows it.
+            struct BvhNode {
+                TileRange bounds;       //!< Bounds of every region below the node.
+                int32_t first {0};      //!< Leaf: first index into m_bvh_regions. Interior: index of the right child.
+                int32_t count {0};      //!< Leaf: number of regions. Zero for interior nodes.
+            };
+
+            //! Build the subtree over m_bvh_regions[begin, end), and return the index of its root.
+            int32_t BuildBvh(int32_t begin, int32_t end);
+
+            //! Shared implementation of the region queries. The shape is tested against tile coordinates.
+            template<typename BoundsTest_t, typename TileTest_t>
+            std::vector<RegionId_t> FindRegions(const TileRange& range, BoundsTest_t bounds_test, TileTest_t tile_test) const;
+
+            //! Get the range of tiles whose centers could be within a circle, given in tile center space.
+            TileRange GetCircleRange(glm::vec2 center_tile, float radius_tile) const;
+
+            //! Get the range of tiles whose centers are within a rectangle, given in meters.
+            TileRange GetRectRange(const Math::Box& rect) const;
+
+            //! Clamp a range of tiles to the world.
+            TileRange ClampToWorld(TileRange range) const;
+
+            //! Build the map from each tile to the nearest tile with a feature.
+            void BuildNearestMap(Feature feature) const;
+
+            //! Whether a tile has a feature.
+            bool HasFeature(Feature feature, TileId_t tile_id) const;
+
+            //! The world being queried.
+            const World* m_p_world;
+
+            //! Size of the world, in tiles.
+            glm::ivec2 m_extent;
+
+            //! Region that owns each tile, indexed by tile ID.
+            std::vector<RegionId_t> m_region_raster;
+
+            //! Tile bounds of each region, indexed by region ID.
+            std::vector<TileRange> m_region_bounds;
+
+            //! Nodes of the bounding volume hierarchy. The root is the first node.
+            std::vector<BvhNode> m_bvh_nodes;
+
+            //! Region IDs, ordered so that each leaf refers to a contiguous run.
+            std::vector<RegionId_t> m_bvh_regions;
+
+            static constexpr size_t NUM_FEATURES = static_cast<size_t>(Feature::NUM_FEATURES);
+
+            //! For each feature, the nearest tile with the feature for every tile. Built on first use.
+            mutable std::array<std::vector<TileId_t>, NUM_FEATURES> m_nearest_maps;
+
+            //! Guards building of each nearest map.
+            mutable std::array<std::once_flag, NUM_FEATURES> m_nearest_built;
+    };
+}
@@ -10,32 +10,40 @@
 #include "Biome.hpp"
 #include "core/Filesystem.hpp"
 #include "world/TectonicPlate.hpp"
+#include "passes/Passes.hpp"
+#include <algorithm>
 #include <cstring>
 
 namespace World {
 
-static constexpr uint8_t WORLD_FILE_VERSION = 1;
+//! Version 2 stores tile heights and water levels with the 16 bit height encoding, rather than as floats. Version 3
+//! adds the geological layers of each region. Version 4 adds the biome of each tile, as one byte after its water
+//! level, since near region borders it may differ from the biome of its region. Older saves assign it on load.
+static constexpr uint8_t WORLD_FILE_VERSION = 4;
+static constexpr uint8_t WORLD_FILE_VERSION_NO_TILE_BIOMES = 3;
+static constexpr uint8_t WORLD_FILE_VERSION_NO_GEOLOGY = 2;
+static constexpr uint8_t WORLD_FILE_VERSION_FLOAT_HEIGHTS = 1;
 
 // Binary serialization helpers
 template<typename T>
-static void WriteBinary(std::ofstream& stream, const T& value) {
+static void WriteBinary(std::ostream& stream, const T& value) {
     stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
 }
 
 template<typename T>
-static T ReadBinary(std::ifstream& stream) {
+static T ReadBinary(std::istream& stream) {
     T value;
     stream.read(reinterpret_cast<char*>(&value), sizeof(T));
     return value;
 }
 
-static void WriteString(std::ofstream& stream, const std::string& str) {
+static void WriteString(std::ostream& stream, const std::string& str) {
     uint32_t length = str.length();
     WriteBinary(stream, length);
     stream.write(str.c_str(), length);
 }
 
-static std::string ReadString(std::ifstream& stream) {
+static std::string ReadString(std::istream& stream) {
     uint32_t length = ReadBinary<uint32_t>(stream);
     std::string str(length, '\0');
     stream.read(&str[0], length);
@@ -55,7 +63,7 @@ static std::string CreateWorldDirectory(const std::string& worldName) {
 }
 
 // Binary serialization functions
-static void WriteParamsToBinary(std::ofstream& stream, const WorldParams& params) {
+static void WriteParamsToBinary(std::ostream& stream, const WorldParams& params) {
     WriteString(stream, params.GetName());
     WriteString(stream, params.GetSeedAscii());
     WriteBinary(stream, params.GetDimension());
@@ -64,7 +72,7 @@ static void WriteParamsToBinary(std::ofstream& stream, const WorldParams& params
     WriteBinary(stream, params.GetRegionSize());
 }
 
-static WorldParams ReadParamsFromBinary(std::ifstream& stream) {
+static WorldParams ReadParamsFromBinary(std::istream& stream) {
     WorldParams params;
     params.SetName(ReadString(stream));
     params.SetSeedAscii(ReadString(stream));
@@ -75,7 +83,7 @@ static WorldParams ReadParamsFromBinary(std::ifstream& stream) {
     return params;
 }
 
-static void WritePlateToBinary(std::ofstream& stream, const TectonicPlate& plate) {
+static void WritePlateToBinary(std::ostream& stream, const TectonicPlate& plate) {
     WriteBinary(stream, plate.GetVelocity().x);
     WriteBinary(stream, plate.GetVelocity().y);
     WriteBinary(stream, plate.GetIsContinental());
@@ -91,7 +99,7 @@ static void WritePlateToBinary(std::ofstream& stream, const TectonicPlate& plate
     }
 }
 
-static TectonicPlate ReadPlateFromBinary(std::ifstream& stream, World& world) {
+static TectonicPlate ReadPlateFromBinary(std::istream& stream, World& world) {
     float velX = ReadBinary<float>(stream);
     float velY = ReadBinary<float>(stream);
     bool isContinental = ReadBinary<bool>(stream);
@@ -114,7 +122,7 @@ static TectonicPlate ReadPlateFromBinary(std::ifstream& stream, World& world) {
     return plate;
 }
 
-static void WriteRegionToBinary(std::ofstream& stream, const Region& region) {
+static void WriteRegionToBinary(std::ostream& stream, const Region& region) {
     WriteBinary(stream, region.GetPlateId());
     WriteBinary(stream, region.GetCentroid().x);
     WriteBinary(stream, region.GetCentroid().y);
@@ -142,7 +150,7 @@ static void WriteRegionToBinary(std::ofstream& stream, const Region& region) {
     WriteString(stream, BiomeTypeToString(region.GetBiome()));
 }
 
-static Region ReadRegionFromBinary(std::ifstream& stream, World& world) {
+static Region ReadRegionFromBinary(std::istream& stream, World& world) {
     PlateId_t plateId = ReadBinary<PlateId_t>(stream);
     float centroidX = ReadBinary<float>(stream);
     float centroidY = ReadBinary<float>(stream);
@@ -173,113 +181,251 @@ static Region ReadRegionFromBinary(std::ifstream& stream, World& world) {
     return region;
 }
 
-static void WriteTileToBinary(std::ofstream& stream, const Tile& tile) {
+static void WriteHeightEncodingToBinary(std::ostream& stream, const HeightEncoding& encoding) {
+    WriteBinary(stream, encoding.GetOffset());
+    WriteBinary(stream, encoding.GetScale());
+}
+
+static HeightEncoding ReadHeightEncodingFromBinary(std::istream& stream) {
+    float offset = ReadBinary<float>(stream);
+    float scale = ReadBinary<float>(stream);
+    if (!(scale > 0.0F)) {
+        throw std::runtime_error("Invalid height encoding in world save file");
+    }
+    return {offset, scale};
+}
+
+static void WriteTileToBinary(std::ostream& stream, const ConstTile& tile) {
     WriteBinary(stream, tile.GetRegionId());
     WriteBinary(stream, tile.GetIsEdgeTile());
-    WriteBinary(stream, tile.GetAbsoluteHeight());
+    WriteBinary(stream, tile.GetEncodedHeight());
     WriteBinary(stream, tile.GetIsWater());
     WriteBinary(stream, tile.GetIsRiver());
     WriteBinary(stream, tile.GetIsLake());
-    WriteBinary(stream, tile.GetWaterLevel());
+    WriteBinary(stream, tile.GetEncodedWaterLevel());
+    WriteBinary(stream, static_cast<uint8_t>(tile.GetBiome()));
 }
 
-static void ReadTileFromBinary(std::ifstream& stream, World& world, TileId_t tileId) {
-    Tile& tile = world.GetTile(tileId);
+//! Read the tiles of a version 1 save, whose heights and water levels are floats. They are encoded once they have all
+//! been read, with an encoding fit to their range.
+static void ReadFloatTilesFromBinary(std::istream& stream, World& world, uint32_t tileCount) {
+    std::vector<float> heights(tileCount);
+    std::vector<float> waterLevels(tileCount);
+    for (uint32_t tileId = 0; tileId < tileCount; ++tileId) {
+        Tile tile = world.GetTile(tileId);
+        tile.SetRegionId(ReadBinary<RegionId_t>(stream));
+        tile.SetIsEdgeTile(ReadBinary<bool>(stream));
+        heights[tileId] = ReadBinary<float>(stream);
+        tile.SetIsWater(ReadBinary<bool>(stream));
+        tile.SetIsRiver(ReadBinary<bool>(stream));
+        tile.SetIsLake(ReadBinary<bool>(stream));
+        waterLevels[tileId] = ReadBinary<float>(stream);
+    }
+
+    if (tileCount > 0U) {
+        auto [minHeight, maxHeight] = std::minmax_element(heights.begin(), heights.end());
+        auto [minWaterLevel, maxWaterLevel] = std::minmax_element(waterLevels.begin(), waterLevels.end());
+        world.FitHeightEncoding(std::min(*minHeight, *minWaterLevel), std::max(*maxHeight, *maxWaterLevel));
+    }
+
+    for (uint32_t tileId = 0; tileId < tileCount; ++tileId) {
+        Tile tile = world.GetTile(tileId);
+        tile.SetAbsoluteHeight(heights[tileId]);
+        tile.SetWaterLevel(waterLevels[tileId]);
+    }
+}
+
+static void ReadTileFromBinary(std::istream& stream, World& world, TileId_t tileId, uint8_t version) {
+    Tile tile = world.GetTile(tileId);
     tile.SetRegionId(ReadBinary<RegionId_t>(stream));
     tile.SetIsEdgeTile(ReadBinary<bool>(stream));
-    tile.SetAbsoluteHeight(ReadBinary<float>(stream));
+    tile.SetEncodedHeight(ReadBinary<uint16_t>(stream));
     tile.SetIsWater(ReadBinary<bool>(stream));
     tile.SetIsRiver(ReadBinary<bool>(stream));
     tile.SetIsLake(ReadBinary<bool>(stream));
-    tile.SetWaterLevel(ReadBinary<float>(stream));
+    tile.SetEncodedWaterLevel(ReadBinary<uint16_t>(stream));
+    if (version == WORLD_FILE_VERSION) {
+        uint8_t biome = ReadBinary<uint8_t>(stream);
+        if (biome >= BIOME_TYPE_COUNT) {
+            throw std::runtime_error("Invalid tile biome in world save file");
+        }
+        tile.SetBiome(static_cast<BiomeType>(biome));
+    }
 }
 
-void SaveWorldToFile(const World& world) {
+static void WriteGeologyToBinary(std::ostream& stream, const Geology& geology) {
+    uint32_t offsetCount = geology.GetOffsets().size();
+    WriteBinary(stream, offsetCount);
+    for (uint32_t offset : geology.GetOffsets()) {
+        WriteBinary(stream, offset);
+    }
 
-    const std::string worldName = world.GetParameters().GetName();
-    std::string worldDir = CreateWorldDirectory(worldName);
+    uint32_t layerCount = geology.GetLayers().size();
+    WriteBinary(stream, layerCount);
+    for (const GeologyLayer& layer : geology.GetLayers()) {
+        WriteBinary(stream, layer.bottom_depth);
+        WriteBinary(stream, static_cast<uint8_t>(layer.rock));
+        WriteBinary(stream, static_cast<uint8_t>(layer.resource));
+    }
+}
 
-    std::ofstream filestream(worldDir + "/world.bin", std::ios::binary);
+static Geology ReadGeologyFromBinary(std::istream& stream) {
+    uint32_t offsetCount = ReadBinary<uint32_t>(stream);
+    std::vector<uint32_t> offsets;
+    offsets.reserve(offsetCount);
+    for (uint32_t i = 0; i < offsetCount; ++i) {
+        offsets.push_back(ReadBinary<uint32_t>(stream));
+    }
+
+    uint32_t layerCount = ReadBinary<uint32_t>(stream);
+    std::vector<GeologyLayer> layers;
+    layers.reserve(layerCount);
+    for (uint32_t i = 0; i < layerCount; ++i) {
+        GeologyLayer layer {};
+        layer.bottom_depth = ReadBinary<uint16_t>(stream);
+        uint8_t rock = ReadBinary<uint8_t>(stream);
+        uint8_t resource = ReadBinary<uint8_t>(stream);
+        if ((rock >= ROCK_TYPE_COUNT) || (resource >= RESOURCE_TYPE_COUNT)) {
+            throw std::runtime_error("Invalid geology layer in world save file");
+        }
+        layer.rock = static_cast<RockType>(rock);
+        layer.resource = static_cast<ResourceType>(resource);
+        layers.push_back(layer);
+    }
+
+    return {std::move(offsets), std::move(layers)};
+}
+
+void WriteWorld(std::ostream& stream, const World& world) {
 
     // Write magic number and version for validation
-    filestream.write("WSAV", 4);
+    stream.write("WSAV", 4);
     uint8_t version = WORLD_FILE_VERSION;
-    WriteBinary(filestream, version);
+    WriteBinary(stream, version);
 
     // save parameters
-    WriteParamsToBinary(filestream, world.GetParameters());
+    WriteParamsToBinary(stream, world.GetParameters());
+    WriteHeightEncodingToBinary(stream, world.GetHeightEncoding());
 
     // save plates
     uint32_t plateCount = world.GetPlates().size();
-    WriteBinary(filestream, plateCount);
+    WriteBinary(stream, plateCount);
     for (const TectonicPlate& plate : world.GetPlates()) {
-        WritePlateToBinary(filestream, plate);
+        WritePlateToBinary(stream, plate);
     }
 
     // save regions
     uint32_t regionCount = world.GetRegions().size();
-    WriteBinary(filestream, regionCount);
+    WriteBinary(stream, regionCount);
     for (const Region& region : world.GetRegions()) {
-        WriteRegionToBinary(filestream, region);
+        WriteRegionToBinary(stream, region);
     }
 
     // save tiles
     uint32_t tileCount = world.GetTiles().size();
-    WriteBinary(filestream, tileCount);
-    for (const Tile& tile : world.GetTiles()) {
-        WriteTileToBinary(filestream, tile);
+    WriteBinary(stream, tileCount);
+    for (ConstTile tile : world.GetTiles()) {
+        WriteTileToBinary(stream, tile);
     }
+
+    // save geology
+    WriteGeologyToBinary(stream, world.GetGeology());
 }
 
-std::unique_ptr<World> LoadWorldFromFile(const std::string& world_name) {
-
-    std::string worldDir = GetWorldsDirectory() + world_name;
-    std::ifstream filestream(worldDir + "/world.bin", std::ios::binary);
-    if (!filestream.is_open()) {
-        throw std::runtime_error("Failed to open world file: " + worldDir + "/world.bin");
-    }
+std::unique_ptr<World> ReadWorld(std::istream& stream, const std::string& out_of_core_directory) {
 
     // Verify magic number and version
     char magic[4];
-    filestream.read(magic, 4);
+    stream.read(magic, 4);
     if (std::strncmp(magic, "WSAV", 4) != 0) {
         throw std::runtime_error("Invalid world save file format");
     }
-    uint8_t version = ReadBinary<uint8_t>(filestream);
-    if (version != WORLD_FILE_VERSION) {
+    uint8_t version = ReadBinary<uint8_t>(stream);
+    if ((version != WORLD_FILE_VERSION) && (version != WORLD_FILE_VERSION_NO_TILE_BIOMES) &&
+        (version != WORLD_FILE_VERSION_NO_GEOLOGY) && (version != WORLD_FILE_VERSION_FLOAT_HEIGHTS)) {
         throw std::runtime_error("Unsupported world save version");
     }
 
-    // Load parameters
-    std::unique_ptr<World> world = std::make_unique<World>(ReadParamsFromBinary(filestream));
+    // Load parameters, and the height encoding that tile heights and water levels were saved with. Version 1 saves
+    // have none, and are fit to the range of their tiles as they are read.
+    WorldParams params = ReadParamsFromBinary(stream);
+    params.SetOutOfCoreDirectory(out_of_core_directory);
+    std::unique_ptr<World> world = std::make_unique<World>(params);
+    if (version != WORLD_FILE_VERSION_FLOAT_HEIGHTS) {
+        world->SetHeightEncoding(ReadHeightEncodingFromBinary(stream));
+    }
 
     // Load plates
-    uint32_t plateCount = ReadBinary<uint32_t>(filestream);
+    uint32_t plateCount = ReadBinary<uint32_t>(stream);
     std::vector<TectonicPlate> plates;
     plates.reserve(plateCount);
     for (uint32_t i = 0; i < plateCount; ++i) {
-        plates.push_back(ReadPlateFromBinary(filestream, *world));
+        plates.push_back(ReadPlateFromBinary(stream, *world));
     }
     world->SetPlates(std::move(plates));
 
     // Load Regions
-    uint32_t regionCount = ReadBinary<uint32_t>(filestream);
+    uint32_t regionCount = ReadBinary<uint32_t>(stream);
     std::vector<Region> regions;
     regions.reserve(regionCount);
     for (uint32_t i = 0; i < regionCount; ++i) {
-        regions.push_back(ReadRegionFromBinary(filestream, *world));
+        regions.push_back(ReadRegionFromBinary(stream, *world));
     }
     world->SetRegions(std::move(regions), false);
 
     // Load Tiles
-    uint32_t tileCount = ReadBinary<uint32_t>(filestream);
-    for (uint32_t tileId = 0; tileId < tileCount; ++tileId) {
-        ReadTileFromBinary(filestream, *world, tileId);
+    uint32_t tileCount = ReadBinary<uint32_t>(stream);
+    if (version == WORLD_FILE_VERSION_FLOAT_HEIGHTS) {
+        ReadFloatTilesFromBinary(stream, *world, tileCount);
+    } else {
+        for (uint32_t tileId = 0; tileId < tileCount; ++tileId) {
+            ReadTileFromBinary(stream, *world, tileId, version);
+        }
     }
 
+    // Load geology. Older saves have none, but it only depends on the plates and regions, so it is generated again.
+    if ((version == WORLD_FILE_VERSION) || (version == WORLD_FILE_VERSION_NO_TILE_BIOMES)) {
+        Geology geology = ReadGeologyFromBinary(stream);
+        if (geology.GetNumRegions() != world->GetRegions().size()) {
+            throw std::runtime_error("World save file has geology for a different number of regions");
+        }
+        world->SetGeology(std::move(geology));
+    } else {
+        Passes::RunMineralPass(*world, world->GetParameters());
+    }
+
+    // Older saves only have the biomes of regions, which the biomes of tiles are assigned from.
+    if (version != WORLD_FILE_VERSION) {
+        Passes::AssignTileBiomes(*world, world->GetParameters());
+    }
+
+    // Basins and rivers are not saved, since they only depend on the tiles, and are quick to build again.
+    Passes::LabelBasins(*world);
+    Passes::BuildRiverNetwork(*world);
+
     return world;
 }
 
+void SaveWorldToFile(const World& world) {
+
+    const std::string worldName = world.GetParameters().GetName();
+    std::string worldDir = CreateWorldDirectory(worldName);
+
+    std::ofstream filestream(worldDir + "/world.bin", std::ios::binary);
+    WriteWorld(filestream, world);
+}
+
+std::unique_ptr<World> LoadWorldFromFile(const std::string& world_name) {
+
+    std::string worldDir = GetWorldsDirectory() + world_name;
+    std::ifstream filestream(worldDir + "/world.bin", std::ios::binary);
+    if (!filestream.is_open()) {
+        throw std::runtime_error("Failed to open world file: " + worldDir + "/world.bin");
+    }
+
+    return ReadWorld(filestream, Core::Engine::GetInstance().GetUserSaveDir());
+}
+
 
 std::vector<std::string> GetSavedWorlds() {
     std::vector<std::string> worlds;
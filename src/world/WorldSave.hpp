@@ -1,13 +1,25 @@
 #pragma once
 
-#include <string>
+#include <istream>
 #include <memory>
+#include <ostream>
+#include <string>
 #include <vector>
 
 namespace World {
 
     class World;
 
+    //! @brief Write a world in the save file format.
+    void WriteWorld(std::ostream& stream, const World& world);
+
+    //! @brief Read a world in the save file format. Throws if the stream does not hold a supported save.
+    //!
+    //! @param[in] stream                The stream to read from.
+    //! @param[in] out_of_core_directory Directory for the tiles of large worlds, see
+    //!                                  WorldParams::SetOutOfCoreDirectory().
+    std::unique_ptr<World> ReadWorld(std::istream& stream, const std::string& out_of_core_directory = "");
+
     void SaveWorldToFile(const World& world);
     std::unique_ptr<World> LoadWorldFromFile(const std::string& world_name);
 
@@ -0,0 +1,98 @@
+#include "WorldSimulation.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace World {
+
+    //! Check that there is a world to simulate, before anything is built from it.
+    static const World& RequireWorld(const std::unique_ptr<World>& p_world) {
+        if (p_world == nullptr) {
+            throw std::invalid_argument("No world to simulate");
+        }
+        return *p_world;
+    }
+
+    //! Create the snapshot of the first tick of a climate.
+    static WorldSnapshot MakeFirstSnapshot(const ClimateSimulation& climate) {
+        WorldSnapshot snapshot;
+        snapshot.climate = *climate.GetState();
+        return snapshot;
+    }
+
+    WorldSimulation::WorldSimulation(std::unique_ptr<World>&& p_world)
+        : m_p_world(std::move(p_world))
+        , m_climate(RequireWorld(m_p_world))
+        , m_snapshot(MakeFirstSnapshot(m_climate)) {
+    }
+
+    WorldSimulation::~WorldSimulation() {
+        Stop();
+    }
+
+    const World& WorldSimulation::GetWorld() const {
+        return *m_p_world;
+    }
+
+    void WorldSimulation::Start(float ticks_per_second) {
+
+        Stop();
+
+        m_stop = false;
+        m_thread = std::thread([this, ticks_per_second]() { Run(ticks_per_second); });
+    }
+
+    void WorldSimulation::Stop() {
+
+        if (!m_thread.joinable()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_stop_requested.notify_all();
+        m_thread.join();
+    }
+
+    bool WorldSimulation::GetIsRunning() const {
+        return m_thread.joinable();
+    }
+
+    void WorldSimulation::Step() {
+
+        m_climate.Step();
+
+        // the back buffer is written in place, so the arrays of the snapshot keep their memory from tick to tick.
+        Core::DoubleBuffer<ClimateState>::ReadHandle climate = m_climate.GetState();
+        m_snapshot.Publish([&climate](const WorldSnapshot& previous, WorldSnapshot& next) {
+            next.version = previous.version + 1U;
+            next.climate = *climate;
+        });
+    }
+
+    Core::DoubleBuffer<WorldSnapshot>::ReadHandle WorldSimulation::GetSnapshot() const {
+        return m_snapshot.Read();
+    }
+
+    void WorldSimulation::Run(float ticks_per_second) {
+
+        using Clock_t = std::chrono::steady_clock;
+        const Clock_t::duration period = std::chrono::duration_cast<Clock_t::duration>(
+            std::chrono::duration<double>(1.0 / static_cast<double>(ticks_per_second)));
+
+        Clock_t::time_point nextTick = Clock_t::now() + period;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop_requested.wait_until(lock, nextTick, [this]() { return m_stop; })) {
+
+            lock.unlock();
+            Step();
+            lock.lock();
+
+            nextTick = std::max(nextTick + period, Clock_t::now());
+        }
+    }
+}
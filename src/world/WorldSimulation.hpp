@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ClimateSimulation.hpp"
+#include "core/DoubleBuffer.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace World {
+
+    class World;
+
+    //! Everything about a world that changes while it is simulated, as published by one tick of a WorldSimulation.
+    //! A snapshot is never changed once published.
+    struct WorldSnapshot {
+        uint64_t version {0U};  //!< Number of snapshots published before this one. Changes whenever the snapshot does.
+        ClimateState climate;   //!< Seasons and weather of the regions.
+    };
+
+    //! Host of a world while it is being played, which advances everything that changes over time at a fixed tick rate
+    //! on a thread of its own.
+    //!
+    //! The simulation owns the world. The world itself is not changed once the simulation has it, so it can be read
+    //! from any thread through GetWorld(). Everything that does change is copied into a snapshot at the end of each
+    //! tick, and published to a double buffer, so the renderer, the UI and map overlays can read the latest snapshot
+    //! with GetSnapshot() without locking, and without waiting for a tick to finish, however long it takes.
+    class WorldSimulation {
+
+        public:
+
+            //! @brief Take ownership of a world, and publish the snapshot of its first tick.
+            //!
+            //! @param[in] p_world The world to simulate. Must not be null.
+            //!
+            //! @throws std::invalid_argument if there is no world.
+            explicit WorldSimulation(std::unique_ptr<World>&& p_world);
+            WorldSimulation(const WorldSimulation& other) = delete;
+            WorldSimulation(WorldSimulation&& other) = delete;
+            WorldSimulation& operator=(const WorldSimulation& other) = delete;
+            WorldSimulation& operator=(WorldSimulation&& other) = delete;
+
+            //! Stops the simulation thread, if it is running.
+            ~WorldSimulation();
+
+            //! Get the world being simulated.
+            const World& GetWorld() const;
+
+            //! @brief Start advancing the simulation on its own thread.
+            //!
+            //! If the thread falls behind, for example while the process is suspended, it skips the missed ticks rather
+            //! than trying to catch up.
+            //!
+            //! @param[in] ticks_per_second Rate to run ticks at. Must be positive.
+            void Start(float ticks_per_second);
+
+            //! @brief Stop the simulation thread, after the tick it is running. Does nothing if it is not running.
+            void Stop();
+
+            //! Determine if the simulation thread is running.
+            bool GetIsRunning() const;
+
+            //! @brief Advance the simulation by one tick on the calling thread, and publish its snapshot.
+            //!
+            //! Must not be called while the simulation thread is running.
+            void Step();
+
+            //! @brief Get the snapshot published by the latest tick. Lock free, and safe to call from any thread.
+            //!
+            //! The snapshot is held until the handle is destroyed, which holds up the tick after next, so the handle
+            //! should not be kept for longer than a frame.
+            Core::DoubleBuffer<WorldSnapshot>::ReadHandle GetSnapshot() const;
+
+        private:
+
+            //! Main loop of the simulation thread.
+            void Run(float ticks_per_second);
+
+            //! The world.
+            std::unique_ptr<World> m_p_world;
+
+            //! Seasons and weather of the world. Advanced by the simulation thread, so that every part of a snapshot is
+            //! from the same tick.
+            ClimateSimulation m_climate;
+
+            //! The snapshot published by the latest tick.
+            Core::DoubleBuffer<WorldSnapshot> m_snapshot;
+
+            //! The simulation thread.
+            std::thread m_thread;
+
+            //! Protects the flag that stops the thread.
+            std::mutex m_mutex;
+
+            //! Signalled to wake the thread up early when it should stop.
+            std::condition_variable m_stop_requested;
+
+            //! Whether the thread should stop.
+            bool m_stop {false};
+    };
+}
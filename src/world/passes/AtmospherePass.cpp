@@ -0,0 +1,450 @@
+#include "Passes.hpp"
+#include "Climate.hpp"
+
+#include "core/ThreadPool.hpp"
+#include "math/Simd.hpp"
+#include "math/Stencil.hpp"
+#include "world/Region.hpp"
+#include "world/TileColumns.hpp"
+#include "world/World.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <glm/common.hpp>
+#include <glm/ext/scalar_constants.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+#include <vector>
+
+namespace World::Passes {
+
+//! Number of cells across the longer side of the grid the atmosphere is simulated on. Each cell covers a square of
+//! tiles, so the cost of the simulation does not grow with the size of the world.
+static constexpr uint32_t GRID_CELLS = 128U;
+
+//! Number of steps simulated. The count is fixed, so the climate does not depend on how quickly the simulation
+//! settles, and rain is only measured after the first steps, once moisture has spread from the ocean.
+static constexpr int32_t NUM_STEPS = 192;
+static constexpr int32_t NUM_SPIN_UP_STEPS = 64;
+
+//! Rows of the grid processed by each task.
+static constexpr size_t ROWS_PER_TASK = 8U;
+
+//! Fastest prevailing wind, in cells per step. The component of the wind towards or away from the poles is a fraction
+//! of the component along the latitude.
+static constexpr float WIND_SPEED = 1.0F;
+static constexpr float MERIDIONAL_WIND = 0.25F;
+
+//! Speed of the ocean currents, relative to the wind that drives them. Currents flow at 45 degrees to the wind,
+//! turned to the right in the northern half of the world, and to the left in the southern half.
+static constexpr float CURRENT_SPEED = 0.2F;
+
+//! Fraction of the difference from the average of its four neighbors that each cell loses per step.
+static constexpr float DIFFUSION = 0.1F;
+
+//! Moisture the air can hold is ((T + CAPACITY_OFFSET) * CAPACITY_SCALE)^2 at temperature T, roughly doubling every
+//! ten degrees over the range of temperatures in the world.
+static constexpr float CAPACITY_OFFSET = 40.0F;
+static constexpr float CAPACITY_SCALE = 1.0F / 50.0F;
+
+//! Fraction of the moisture the air could still take up that evaporates per step, over water and over land.
+static constexpr float OCEAN_EVAPORATION = 0.2F;
+static constexpr float LAND_EVAPORATION = 0.01F;
+
+//! Fraction of the moisture above what the air can hold that falls as rain per step.
+static constexpr float CONDENSATION = 0.5F;
+
+//! Fraction of the moisture in the air that falls as rain per step, everywhere, and for each meter the wind rises
+//! over the land in a step.
+static constexpr float BASE_RAIN = 0.05F;
+static constexpr float OROGRAPHIC_RAIN = 1.0F / 1000.0F;
+
+//! Fraction of the difference from the temperature of the surface that the air takes on per step, and that the
+//! ocean takes on from the latitude.
+static constexpr float AIR_RELAXATION = 0.1F;
+static constexpr float SEA_RELAXATION = 0.02F;
+
+//! Rain per step that gives land a moisture of 50. Moisture approaches 100 as the rain increases.
+static constexpr float RAIN_FOR_HALF_MOISTURE = 0.012F;
+
+//! Fields carried by the wind and by the ocean currents.
+enum AtmosphereField : size_t {
+    FIELD_HUMIDITY,     //!< Moisture held by the air.
+    FIELD_AIR,          //!< Temperature of the air, at ocean level.
+    FIELD_SEA,          //!< Temperature of the ocean surface.
+    NUM_FIELDS
+};
+
+//! The grid the atmosphere is simulated on. The winds and currents only depend on the latitude, so they are the same
+//! along each row of the grid.
+struct AtmosphereGrid {
+    glm::uvec2 extent {0U};                 //!< Size of the grid, in cells.
+    float cell_size {1.0F};                 //!< Edge length of each cell, in tiles.
+    std::vector<float> water;               //!< Fraction of the tiles of each cell covered by water.
+    std::vector<float> evaporation;         //!< Fraction of the missing moisture that evaporates in each cell per step.
+    std::vector<float> lapse;               //!< Temperature lost to the height of each cell above ocean level.
+    std::vector<float> rain_rate;           //!< Fraction of the moisture that falls as rain in each cell per step.
+    std::vector<glm::vec2> winds;           //!< Wind along each row, in cells per step.
+    std::vector<glm::vec2> currents;        //!< Ocean current along each row, in cells per step.
+    std::vector<float> temperatures;        //!< Temperature at ocean level along each row, from the latitude.
+};
+
+//! Constants of the update of each cell, splatted to the width of the values the update runs on.
+template<typename Vec_t>
+struct CellConstants {
+    Vec_t zero;
+    Vec_t capacity_offset;
+    Vec_t capacity_scale;
+    Vec_t condensation;
+    Vec_t air_relaxation;
+    Vec_t sea_relaxation;
+    Vec_t one;
+    Vec_t temperature;
+};
+
+template<typename Vec_t, typename Splat_t>
+static CellConstants<Vec_t> MakeCellConstants(float temperature, const Splat_t& splat) {
+    return {splat(0.0F), splat(CAPACITY_OFFSET), splat(CAPACITY_SCALE), splat(CONDENSATION), splat(AIR_RELAXATION),
+            splat(SEA_RELAXATION), splat(1.0F), splat(temperature)};
+}
+
+// scalar versions of the Math::Simd operations, with the same operand order, so that the update of a cell gives the
+// same result whether it runs on four cells at once or on one.
+static float Max(float lhs, float rhs) {
+    return (lhs > rhs) ? lhs : rhs;
+}
+
+static float Min(float lhs, float rhs) {
+    return (lhs < rhs) ? lhs : rhs;
+}
+
+//! @brief Exchange heat and moisture between the air and the surface of cells, and rain out the excess moisture.
+//!
+//! Runs on single cells as floats, and on four cells at once as Math::Simd::Float4.
+template<typename Vec_t>
+static void UpdateCells(const CellConstants<Vec_t>& constants, Vec_t water, Vec_t evaporation, Vec_t lapse,
+                        Vec_t rain_rate, Vec_t& humidity, Vec_t& air, Vec_t& sea, Vec_t& rainfall) {
+
+    // the ocean is warmed or cooled towards the temperature of its latitude. Under land, it follows the land.
+    const Vec_t land = constants.one - water;
+    sea = (water * (sea + (constants.sea_relaxation * (constants.temperature - sea)))) + (land * constants.temperature);
+
+    // the air takes on the temperature of the surface under it.
+    const Vec_t surface = (water * sea) + (land * constants.temperature);
+    air = air + (constants.air_relaxation * (surface - air));
+
+    // water evaporates until the air holds as much as it can, which is less over high, and so colder, land.
+    const Vec_t scaled = Max(air - lapse + constants.capacity_offset, constants.zero) * constants.capacity_scale;
+    const Vec_t capacity = scaled * scaled;
+    humidity = humidity + (evaporation * Max(capacity - humidity, constants.zero));
+
+    const Vec_t rain =
+        Min(humidity, (humidity * rain_rate) + (constants.condensation * Max(humidity - capacity, constants.zero)));
+    humidity = humidity - rain;
+    rainfall = rainfall + rain;
+}
+
+//! @brief Trace each cell of a row back along the velocity, and take the value of the field where it came from.
+//!
+//! The velocity is the same along the row, so every cell is traced back by the same offset, and blends the same
+//! fractions of the four cells around the point it came from. Cells beyond the edge of the grid are clamped to it.
+static void AdvectRow(const float* p_field, glm::uvec2 extent, uint32_t y_coord, glm::vec2 velocity, float* p_out) {
+
+    const float sourceX = -velocity.x;
+    const float sourceY = static_cast<float>(y_coord) - velocity.y;
+    const float floorX = std::floor(sourceX);
+    const float floorY = std::floor(sourceY);
+    const float fracX = sourceX - floorX;
+    const float fracY = sourceY - floorY;
+
+    const int64_t width = extent.x;
+    const int64_t shift = static_cast<int64_t>(floorX);
+    const int64_t lastRow = static_cast<int64_t>(extent.y) - 1;
+    const float* p_row0 = p_field + (std::clamp(static_cast<int64_t>(floorY), int64_t {0}, lastRow) * width);
+    const float* p_row1 = p_field + (std::clamp(static_cast<int64_t>(floorY) + 1, int64_t {0}, lastRow) * width);
+
+    const float weight00 = (1.0F - fracX) * (1.0F - fracY);
+    const float weight10 = fracX * (1.0F - fracY);
+    const float weight01 = (1.0F - fracX) * fracY;
+    const float weight11 = fracX * fracY;
+
+    auto blendCell = [&](int64_t x_coord) {
+        const int64_t source0 = std::clamp(x_coord + shift, int64_t {0}, width - 1);
+        const int64_t source1 = std::clamp(x_coord + shift + 1, int64_t {0}, width - 1);
+        p_out[x_coord] = ((weight00 * p_row0[source0]) + (weight10 * p_row0[source1])) +
+                         ((weight01 * p_row1[source0]) + (weight11 * p_row1[source1]));
+    };
+
+    // cells whose sources are all inside the grid are blended four at a time.
+    using namespace Math::Simd;
+    const int64_t begin = std::clamp(-shift, int64_t {0}, width);
+    const int64_t end = std::clamp(width - 1 - shift, begin, width);
+
+    int64_t xCoord = 0;
+    for (; xCoord < begin; xCoord++) {
+        blendCell(xCoord);
+    }
+
+    const Float4 vecWeight00 = Splat(weight00);
+    const Float4 vecWeight10 = Splat(weight10);
+    const Float4 vecWeight01 = Splat(weight01);
+    const Float4 vecWeight11 = Splat(weight11);
+    for (; xCoord + static_cast<int64_t>(FLOAT4_WIDTH) <= end; xCoord += static_cast<int64_t>(FLOAT4_WIDTH)) {
+        const int64_t source = xCoord + shift;
+        Store(p_out + xCoord,
+              ((vecWeight00 * Load(p_row0 + source)) + (vecWeight10 * Load(p_row0 + source + 1))) +
+              ((vecWeight01 * Load(p_row1 + source)) + (vecWeight11 * Load(p_row1 + source + 1))));
+    }
+
+    for (; xCoord < width; xCoord++) {
+        blendCell(xCoord);
+    }
+}
+
+//! @brief Update the cells of a row, after the fields have been carried into it.
+static void UpdateRow(const AtmosphereGrid& grid, uint32_t y_coord, std::array<std::vector<float>, NUM_FIELDS>& fields,
+                      std::vector<float>& rainfall) {
+
+    const size_t first = static_cast<size_t>(y_coord) * grid.extent.x;
+    const ptrdiff_t width = static_cast<ptrdiff_t>(grid.extent.x);
+    const float* p_water = grid.water.data() + first;
+    const float* p_evaporation = grid.evaporation.data() + first;
+    const float* p_lapse = grid.lapse.data() + first;
+    const float* p_rainRate = grid.rain_rate.data() + first;
+    float* p_humidity = fields[FIELD_HUMIDITY].data() + first;
+    float* p_air = fields[FIELD_AIR].data() + first;
+    float* p_sea = fields[FIELD_SEA].data() + first;
+    float* p_rainfall = rainfall.data() + first;
+
+    using namespace Math::Simd;
+    const CellConstants<Float4> vecConstants = MakeCellConstants<Float4>(grid.temperatures[y_coord], Splat);
+
+    ptrdiff_t xCoord = 0;
+    for (; xCoord + static_cast<ptrdiff_t>(FLOAT4_WIDTH) <= width; xCoord += static_cast<ptrdiff_t>(FLOAT4_WIDTH)) {
+        Float4 humidity = Load(p_humidity + xCoord);
+        Float4 air = Load(p_air + xCoord);
+        Float4 sea = Load(p_sea + xCoord);
+        Float4 rain = Load(p_rainfall + xCoord);
+        UpdateCells(vecConstants, Load(p_water + xCoord), Load(p_evaporation + xCoord), Load(p_lapse + xCoord),
+                    Load(p_rainRate + xCoord), humidity, air, sea, rain);
+        Store(p_humidity + xCoord, humidity);
+        Store(p_air + xCoord, air);
+        Store(p_sea + xCoord, sea);
+        Store(p_rainfall + xCoord, rain);
+    }
+
+    const CellConstants<float> constants =
+        MakeCellConstants<float>(grid.temperatures[y_coord], [](float value) { return value; });
+    for (; xCoord < width; xCoord++) {
+        UpdateCells(constants, p_water[xCoord], p_evaporation[xCoord], p_lapse[xCoord], p_rainRate[xCoord],
+                    p_humidity[xCoord], p_air[xCoord], p_sea[xCoord], p_rainfall[xCoord]);
+    }
+}
+
+//! Spread a row of a field to its four neighbors.
+static void DiffuseRow(const Math::StencilRow<float>& row, float* p_out) {
+
+    using namespace Math::Simd;
+    const Float4 diffusion = Splat(DIFFUSION);
+    const Float4 four = Splat(4.0F);
+
+    const ptrdiff_t width = static_cast<ptrdiff_t>(row.width);
+    const float* p_row = row.p_center;
+
+    ptrdiff_t xCoord = 0;
+    for (; xCoord + static_cast<ptrdiff_t>(FLOAT4_WIDTH) <= width; xCoord += static_cast<ptrdiff_t>(FLOAT4_WIDTH)) {
+        Float4 center = Load(p_row + xCoord);
+        Float4 sum = (Load(row.p_north + xCoord) + Load(row.p_south + xCoord)) +
+                     (Load(p_row + xCoord - 1) + Load(p_row + xCoord + 1));
+        Store(p_out + xCoord, center + (diffusion * (sum - (four * center))));
+    }
+
+    for (; xCoord < width; xCoord++) {
+        float center = p_row[xCoord];
+        float sum = (row.p_north[xCoord] + row.p_south[xCoord]) + (p_row[xCoord - 1] + p_row[xCoord + 1]);
+        p_out[xCoord] = center + (DIFFUSION * (sum - (4.0F * center)));
+    }
+}
+
+//! @brief Build the grid from the tiles of the world.
+static AtmosphereGrid BuildAtmosphereGrid(const World& world) {
+
+    const Extent_t worldSize = world.GetSize();
+    const uint32_t cellSize = std::max((std::max(worldSize.x, worldSize.y) + GRID_CELLS - 1U) / GRID_CELLS, 1U);
+
+    AtmosphereGrid grid;
+    grid.extent = (worldSize + glm::uvec2(cellSize - 1U)) / cellSize;
+    grid.cell_size = static_cast<float>(cellSize);
+
+    const size_t numCells = static_cast<size_t>(grid.extent.x) * grid.extent.y;
+    grid.water.resize(numCells);
+    grid.evaporation.resize(numCells);
+    grid.lapse.resize(numCells);
+    grid.rain_rate.resize(numCells);
+    std::vector<float> heights(numCells);
+
+    // a. water and the average height above ocean level of the tiles of each cell.
+    const TileColumns& columns = world.GetTileColumns();
+    const uint16_t* p_heights = columns.GetHeights();
+    const uint8_t* p_flags = columns.GetFlags();
+    const HeightEncoding& encoding = world.GetHeightEncoding();
+    const float oceanLevel = world.GetOceanLevel();
+
+    Core::ThreadPool::GetInstance().ParallelFor(grid.extent.y, ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t cellY = begin; cellY < end; cellY++) {
+            const uint32_t minY = static_cast<uint32_t>(cellY) * cellSize;
+            const uint32_t maxY = std::min(minY + cellSize, worldSize.y);
+            for (uint32_t cellX = 0U; cellX < grid.extent.x; cellX++) {
+
+                const uint32_t minX = cellX * cellSize;
+                const uint32_t maxX = std::min(minX + cellSize, worldSize.x);
+                float numWater = 0.0F;
+                float heightSum = 0.0F;
+                for (uint32_t yCoord = minY; yCoord < maxY; yCoord++) {
+                    const TileId_t rowStart = world.CoordinateToTileId({0U, yCoord});
+                    for (uint32_t xCoord = minX; xCoord < maxX; xCoord++) {
+                        const TileId_t tileId = rowStart + xCoord;
+                        numWater += ((p_flags[tileId] & TILE_FLAG_WATER) != 0U) ? 1.0F : 0.0F;
+                        heightSum += std::max(encoding.Decode(p_heights[tileId]) - oceanLevel, 0.0F);
+                    }
+                }
+
+                const size_t cellId = (cellY * grid.extent.x) + cellX;
+                const float numTiles = static_cast<float>((maxX - minX) * (maxY - minY));
+                grid.water[cellId] = numWater / numTiles;
+                grid.evaporation[cellId] = LAND_EVAPORATION + ((OCEAN_EVAPORATION - LAND_EVAPORATION) * grid.water[cellId]);
+                heights[cellId] = heightSum / numTiles;
+                grid.lapse[cellId] = heights[cellId] * LAPSE_RATE;
+            }
+        }
+    });
+
+    // b. prevailing winds for each band of latitude: trade winds blow towards the equator and west, westerlies
+    //    towards the poles and east, and polar easterlies towards the equator and west again.
+    grid.winds.resize(grid.extent.y);
+    grid.currents.resize(grid.extent.y);
+    grid.temperatures.resize(grid.extent.y);
+    for (uint32_t cellY = 0U; cellY < grid.extent.y; cellY++) {
+
+        const float latOffset = ((((static_cast<float>(cellY) + 0.5F) * grid.cell_size) /
+                                  static_cast<float>(worldSize.y)) - 0.5F) * 2.0F;
+        const float latitude = std::min(std::abs(latOffset), 1.0F);
+        const float band = std::sin(3.0F * glm::pi<float>() * latitude);
+        const float towardsPole = (latOffset < 0.0F) ? -1.0F : 1.0F;
+        const glm::vec2 wind(-WIND_SPEED * band, -towardsPole * MERIDIONAL_WIND * WIND_SPEED * band);
+
+        // y grows to the south, so turning (x, y) to (-y, x) turns it to the right of north.
+        const glm::vec2 turned = (latOffset < 0.0F) ? glm::vec2(-wind.y, wind.x) : glm::vec2(wind.y, -wind.x);
+
+        grid.winds[cellY] = wind;
+        grid.currents[cellY] = CURRENT_SPEED * (wind + turned);
+        grid.temperatures[cellY] = CalculateSeaLevelTemperature(latitude);
+    }
+
+    // c. rain is forced out of the air where the wind blows up a slope.
+    Core::ThreadPool::GetInstance().ParallelFor(grid.extent.y, ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t cellY = begin; cellY < end; cellY++) {
+            const size_t north = (cellY > 0U) ? cellY - 1U : cellY;
+            const size_t south = std::min<size_t>(cellY + 1U, grid.extent.y - 1U);
+            const float scaleY = 1.0F / static_cast<float>(std::max<size_t>(south - north, 1U));
+            for (size_t cellX = 0U; cellX < grid.extent.x; cellX++) {
+
+                const size_t west = (cellX > 0U) ? cellX - 1U : cellX;
+                const size_t east = std::min<size_t>(cellX + 1U, grid.extent.x - 1U);
+                const float scaleX = 1.0F / static_cast<float>(std::max<size_t>(east - west, 1U));
+                const size_t rowStart = cellY * grid.extent.x;
+                const glm::vec2 slope(
+                    (heights[rowStart + east] - heights[rowStart + west]) * scaleX,
+                    (heights[(south * grid.extent.x) + cellX] - heights[(north * grid.extent.x) + cellX]) * scaleY);
+
+                const float rise = std::max(glm::dot(grid.winds[cellY], slope), 0.0F);
+                grid.rain_rate[rowStart + cellX] = std::min(BASE_RAIN + (OROGRAPHIC_RAIN * rise), 1.0F);
+            }
+        }
+    });
+
+    return grid;
+}
+
+//! @brief Sample a field of the grid at a position, in cells, blending the four nearest cells.
+static float SampleField(const std::vector<float>& field, glm::uvec2 extent, glm::vec2 position) {
+
+    const glm::vec2 clamped = glm::clamp(position, glm::vec2(0.0F), glm::vec2(extent - glm::uvec2(1U)));
+    const glm::uvec2 cell0 = glm::uvec2(clamped);
+    const glm::uvec2 cell1 = glm::min(cell0 + glm::uvec2(1U), extent - glm::uvec2(1U));
+    const glm::vec2 frac = clamped - glm::vec2(cell0);
+
+    auto at = [&](uint32_t x_coord, uint32_t y_coord) { return field[(static_cast<size_t>(y_coord) * extent.x) + x_coord]; };
+    const float north = glm::mix(at(cell0.x, cell0.y), at(cell1.x, cell0.y), frac.x);
+    const float south = glm::mix(at(cell0.x, cell1.y), at(cell1.x, cell1.y), frac.x);
+    return glm::mix(north, south, frac.y);
+}
+
+void SimulateAtmosphere(World& world) {
+
+    // a. find the water, height and winds of each cell of the grid.
+    const AtmosphereGrid grid = BuildAtmosphereGrid(world);
+    const size_t numCells = grid.water.size();
+
+    // b. start with dry air, at the temperature of its latitude.
+    std::array<std::vector<float>, NUM_FIELDS> fields;
+    std::array<std::vector<float>, NUM_FIELDS> advected;
+    for (size_t field = 0U; field < NUM_FIELDS; field++) {
+        fields[field].assign(numCells, 0.0F);
+        advected[field].resize(numCells);
+    }
+    for (uint32_t cellY = 0U; cellY < grid.extent.y; cellY++) {
+        const size_t rowStart = static_cast<size_t>(cellY) * grid.extent.x;
+        std::fill_n(fields[FIELD_AIR].begin() + static_cast<ptrdiff_t>(rowStart), grid.extent.x, grid.temperatures[cellY]);
+        std::fill_n(fields[FIELD_SEA].begin() + static_cast<ptrdiff_t>(rowStart), grid.extent.x, grid.temperatures[cellY]);
+    }
+
+    // c. each step carries the fields along the winds and currents, exchanges heat and moisture with the surface,
+    //    and then spreads them out. Rows are independent in each stage, so they are updated in parallel.
+    std::vector<float> rainfall(numCells, 0.0F);
+    Core::ThreadPool& pool = Core::ThreadPool::GetInstance();
+    for (int32_t step = 0; step < NUM_STEPS; step++) {
+
+        if (step == NUM_SPIN_UP_STEPS) {
+            std::fill(rainfall.begin(), rainfall.end(), 0.0F);
+        }
+
+        pool.ParallelFor(grid.extent.y, ROWS_PER_TASK, [&](size_t begin, size_t end) {
+            for (size_t cellY = begin; cellY < end; cellY++) {
+                const uint32_t yCoord = static_cast<uint32_t>(cellY);
+                const size_t rowStart = cellY * grid.extent.x;
+                for (size_t field = 0U; field < NUM_FIELDS; field++) {
+                    const glm::vec2 velocity = (field == FIELD_SEA) ? grid.currents[cellY] : grid.winds[cellY];
+                    AdvectRow(fields[field].data(), grid.extent, yCoord, velocity, advected[field].data() + rowStart);
+                }
+                UpdateRow(grid, yCoord, advected, rainfall);
+            }
+        });
+
+        for (size_t field = 0U; field < NUM_FIELDS; field++) {
+            float* p_out = fields[field].data();
+            Math::ForEachStencilRow(advected[field].data(), grid.extent, Math::StencilEdge::CLAMP,
+                [&](const Math::StencilRow<float>& row) {
+                    DiffuseRow(row, p_out + row.first_index);
+                });
+        }
+    }
+
+    // d. set the climate of each region from the cell under its centroid. Water regions stay fully wet.
+    const float rainScale = 1.0F / static_cast<float>(NUM_STEPS - NUM_SPIN_UP_STEPS);
+    for (Region& region : world.GetRegions()) {
+
+        const glm::vec2 position = ((region.GetCentroid() * TILE_PER_METER_F32) / grid.cell_size) - glm::vec2(0.5F);
+        const float air = SampleField(fields[FIELD_AIR], grid.extent, position);
+        region.SetTemperature(air + CalculateElevationModifier(region, world.GetOceanLevel()));
+
+        if (!IsWaterRegion(region)) {
+            const float rain = SampleField(rainfall, grid.extent, position) * rainScale;
+            region.SetMoisture(100.0F * rain / (rain + RAIN_FOR_HALF_MOISTURE));
+        }
+    }
+}
+
+} // namespace World::Passes
@@ -0,0 +1,329 @@
+#include "Passes.hpp"
+#include "Drainage.hpp"
+
+#include "core/ThreadPool.hpp"
+#include "math/Stencil.hpp"
+#include "world/Basin.hpp"
+#include "world/TileColumns.hpp"
+#include "world/World.hpp"
+#include "world/WorldParams.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace World::Passes {
+
+//! Tiles processed by each task, for passes that visit every tile on its own.
+static constexpr size_t TILES_PER_TASK = 16384U;
+
+//! Lowest pair of adjacent tiles shared by two basins.
+struct BasinEdge {
+    BasinId_t first;    //!< The basin with the lower ID.
+    BasinId_t second;   //!< The basin with the higher ID.
+    uint16_t height;    //!< Encoded height that water must rise to, to cross from one basin to the other.
+    TileId_t tile;      //!< The higher tile of the pair, which the water crosses.
+    TileId_t first_tile;    //!< The tile of the pair in the first basin.
+    TileId_t second_tile;   //!< The tile of the pair in the second basin.
+
+    bool operator<(const BasinEdge& other) const {
+        return std::tie(first, second, height, tile) < std::tie(other.first, other.second, other.height, other.tile);
+    }
+};
+
+//! @brief Replace the receiver of every tile with the tile at the end of its drainage path.
+//!
+//! Each round replaces the receiver of every tile with the receiver of its receiver, which halves the remaining length
+//! of every path, so paths of any length resolve in a logarithmic number of rounds. Rounds read one buffer and write
+//! the other, so tiles can be processed in parallel, in any order.
+static void ResolveDrainageRoots(std::vector<TileId_t>& receivers) {
+
+    std::vector<TileId_t> next(receivers.size());
+    std::atomic<bool> isChanged {true};
+    while (isChanged.load()) {
+
+        isChanged.store(false);
+        Core::ThreadPool::GetInstance().ParallelFor(receivers.size(), TILES_PER_TASK, [&](size_t begin, size_t end) {
+            bool isTaskChanged = false;
+            for (size_t tileId = begin; tileId < end; tileId++) {
+                const TileId_t receiver = receivers[tileId];
+                next[tileId] = receivers[receiver];
+                isTaskChanged = isTaskChanged || (next[tileId] != receiver);
+            }
+            if (isTaskChanged) {
+                isChanged.store(true, std::memory_order_relaxed);
+            }
+        });
+
+        receivers.swap(next);
+    }
+}
+
+//! @brief Find the lowest edge between every pair of adjacent basins, sorted by height.
+static std::vector<BasinEdge> FindBasinEdges(
+    const BasinId_t* p_basin_ids, const std::vector<uint16_t>& surface, glm::uvec2 extent) {
+
+    // each row of each block collects its own edges, so that they can be gathered in the same order on every run.
+    const size_t blocksX = (extent.x + Math::STENCIL_BLOCK_WIDTH - 1U) / Math::STENCIL_BLOCK_WIDTH;
+    std::vector<std::vector<BasinEdge>> rowEdges(blocksX * extent.y);
+
+    Math::ForEachStencilRow(p_basin_ids, extent, Math::StencilEdge::CLAMP, [&](const Math::StencilRow<BasinId_t>& row) {
+
+        std::vector<BasinEdge>& edges = rowEdges[(row.first.y * blocksX) + (row.first.x / Math::STENCIL_BLOCK_WIDTH)];
+        auto addEdge = [&](size_t tileId, BasinId_t basin, size_t otherId, BasinId_t other) {
+            if ((basin == other) || (basin == INVALID_BASIN_ID) || (other == INVALID_BASIN_ID)) {
+                return;
+            }
+            const TileId_t higher = static_cast<TileId_t>((surface[otherId] > surface[tileId]) ? otherId : tileId);
+            if (basin < other) {
+                edges.push_back({basin, other, surface[higher], higher, static_cast<TileId_t>(tileId),
+                                 static_cast<TileId_t>(otherId)});
+            } else {
+                edges.push_back({other, basin, surface[higher], higher, static_cast<TileId_t>(otherId),
+                                 static_cast<TileId_t>(tileId)});
+            }
+        };
+
+        // only the neighbors to the east and south are checked, so every pair of tiles is seen once. Beyond the edge
+        // of the world, clamping repeats the tile itself, which is in the same basin.
+        for (ptrdiff_t xCoord = 0; xCoord < static_cast<ptrdiff_t>(row.width); xCoord++) {
+            const size_t tileId = row.first_index + static_cast<size_t>(xCoord);
+            addEdge(tileId, row.p_center[xCoord], tileId + 1U, row.p_center[xCoord + 1]);
+            addEdge(tileId, row.p_center[xCoord], tileId + extent.x, row.p_south[xCoord]);
+        }
+    });
+
+    std::vector<BasinEdge> edges;
+    for (std::vector<BasinEdge>& blockEdges : rowEdges) {
+        edges.insert(edges.end(), blockEdges.begin(), blockEdges.end());
+        std::vector<BasinEdge>().swap(blockEdges);
+    }
+
+    // keep only the lowest edge of each pair of basins.
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end(), [](const BasinEdge& lhs, const BasinEdge& rhs) {
+        return (lhs.first == rhs.first) && (lhs.second == rhs.second);
+    }), edges.end());
+
+    std::sort(edges.begin(), edges.end(), [](const BasinEdge& lhs, const BasinEdge& rhs) {
+        return std::tie(lhs.height, lhs.tile, lhs.first, lhs.second) <
+               std::tie(rhs.height, rhs.tile, rhs.first, rhs.second);
+    });
+    return edges;
+}
+
+//! Groups of basins that are flooded together, which are merged as the water in them rises.
+class BasinForest {
+
+    public:
+
+        //! @brief Start with every basin in a group of its own.
+        //!
+        //! @param[in] pit_heights     Encoded height of the pit of each basin.
+        //! @param[in] drains_to_ocean Whether each basin drains to the ocean.
+        BasinForest(const std::vector<uint16_t>& pit_heights, const std::vector<bool>& drains_to_ocean)
+            : m_parents(pit_heights.size())
+            , m_sizes(pit_heights.size(), 1U)
+            , m_next(pit_heights.size(), INVALID_BASIN_ID)
+            , m_tails(pit_heights.size())
+            , m_lowest(pit_heights.size())
+            , m_is_drained(drains_to_ocean)
+            , m_pit_heights(pit_heights)
+            , m_fill_heights(pit_heights)
+            , m_lakes(pit_heights.size(), INVALID_BASIN_ID)
+            , m_outlets(pit_heights.size(), INVALID_TILE_ID) {
+
+            std::iota(m_parents.begin(), m_parents.end(), 0U);
+            std::iota(m_tails.begin(), m_tails.end(), 0U);
+            std::iota(m_lowest.begin(), m_lowest.end(), 0U);
+        }
+
+        //! @brief Let the water rise over the edge between two basins.
+        //!
+        //! A group that cannot drain fills up to the height of the edge, and drains through it if the group on the
+        //! other side already drains. Otherwise the two groups join, and fill up as one lake from then on.
+        void Flood(const BasinEdge& edge) {
+
+            BasinId_t first = Find(edge.first);
+            BasinId_t second = Find(edge.second);
+            if ((first == second) || (m_is_drained[first] && m_is_drained[second])) {
+                return;
+            }
+
+            if (m_is_drained[first]) {
+                Drain(second, edge.height, edge.first_tile);
+                return;
+            }
+            if (m_is_drained[second]) {
+                Drain(first, edge.height, edge.second_tile);
+                return;
+            }
+
+            if (m_sizes[first] < m_sizes[second]) {
+                std::swap(first, second);
+            }
+            m_parents[second] = first;
+            m_sizes[first] += m_sizes[second];
+            m_next[m_tails[first]] = second;
+            m_tails[first] = m_tails[second];
+            if (IsLower(m_lowest[second], m_lowest[first])) {
+                m_lowest[first] = m_lowest[second];
+            }
+        }
+
+        //! Encoded height that each basin fills up to. Basins that never drain keep the height of their pit.
+        const std::vector<uint16_t>& GetFillHeights() const {
+            return m_fill_heights;
+        }
+
+        //! Tile that each basin drains to once it fills up, or INVALID_TILE_ID if it never drains.
+        const std::vector<TileId_t>& GetOutlets() const {
+            return m_outlets;
+        }
+
+        //! Basin holding the lowest pit of the lake that floods each basin, or INVALID_BASIN_ID if it stays dry.
+        std::vector<BasinId_t> GetLakes() const {
+            std::vector<BasinId_t> lakes(m_lakes);
+            for (BasinId_t basin = 0U; basin < lakes.size(); basin++) {
+                if (m_fill_heights[basin] <= m_pit_heights[basin]) {
+                    lakes[basin] = INVALID_BASIN_ID;
+                }
+            }
+            return lakes;
+        }
+
+    private:
+
+        BasinId_t Find(BasinId_t basin) {
+            while (m_parents[basin] != basin) {
+                m_parents[basin] = m_parents[m_parents[basin]];
+                basin = m_parents[basin];
+            }
+            return basin;
+        }
+
+        bool IsLower(BasinId_t lhs, BasinId_t rhs) const {
+            return std::tie(m_pit_heights[lhs], lhs) < std::tie(m_pit_heights[rhs], rhs);
+        }
+
+        //! Fill every basin of a group up to a height, at which it starts to drain into a tile of another group.
+        void Drain(BasinId_t root, uint16_t height, TileId_t outlet) {
+            for (BasinId_t basin = root; basin != INVALID_BASIN_ID; basin = m_next[basin]) {
+                m_fill_heights[basin] = std::max(height, m_pit_heights[basin]);
+                m_lakes[basin] = m_lowest[root];
+                m_outlets[basin] = outlet;
+            }
+            m_is_drained[root] = true;
+        }
+
+        std::vector<BasinId_t> m_parents;
+        std::vector<uint32_t> m_sizes;
+
+        //! Members of each group, as a linked list from the root through m_next, ending at m_tails[root].
+        std::vector<BasinId_t> m_next;
+        std::vector<BasinId_t> m_tails;
+
+        //! Member of each group with the lowest pit.
+        std::vector<BasinId_t> m_lowest;
+
+        std::vector<bool> m_is_drained;
+        std::vector<uint16_t> m_pit_heights;
+        std::vector<uint16_t> m_fill_heights;
+        std::vector<BasinId_t> m_lakes;
+        std::vector<TileId_t> m_outlets;
+};
+
+void LabelBasins(World& world) {
+
+    TileColumns& columns = world.GetTileColumns();
+    const HeightEncoding& encoding = world.GetHeightEncoding();
+    const Extent_t extent = world.GetSize();
+    const size_t numTiles = columns.GetSize();
+    const uint8_t* p_flags = columns.GetFlags();
+    BasinId_t* p_basin_ids = columns.GetBasinIds();
+
+    // a. follow the steepest slope down from every tile, to the pit or ocean tile it drains to.
+    const std::vector<uint16_t> surface = GetDrainageSurface(world);
+    std::vector<TileId_t> roots = FindDrainageReceivers(surface, extent);
+    ResolveDrainageRoots(roots);
+
+    // b. number the basins in the order their first tile is found. Ocean tiles belong to no basin.
+    std::vector<Basin> basins;
+    std::vector<BasinId_t> rootBasins(numTiles, INVALID_BASIN_ID);
+    for (size_t tileId = 0U; tileId < numTiles; tileId++) {
+
+        if (IsOceanTile(p_flags[tileId])) {
+            p_basin_ids[tileId] = INVALID_BASIN_ID;
+            continue;
+        }
+
+        const TileId_t root = roots[tileId];
+        if (rootBasins[root] == INVALID_BASIN_ID) {
+            rootBasins[root] = static_cast<BasinId_t>(basins.size());
+            Basin& basin = basins.emplace_back();
+            basin.pit = root;
+            basin.drains_to_ocean = IsOceanTile(p_flags[root]);
+        }
+        p_basin_ids[tileId] = rootBasins[root];
+    }
+    std::vector<BasinId_t>().swap(rootBasins);
+    std::vector<TileId_t>().swap(roots);
+
+    // c. the spill point of each basin is the lowest edge it shares with another basin.
+    std::vector<BasinEdge> edges = FindBasinEdges(p_basin_ids, surface, extent);
+    for (const BasinEdge& edge : edges) {
+        for (BasinId_t basinId : {edge.first, edge.second}) {
+            Basin& basin = basins[basinId];
+            if (basin.spill == INVALID_TILE_ID) {
+                basin.spill = edge.tile;
+                basin.spill_basin = (basinId == edge.first) ? edge.second : edge.first;
+                basin.spill_height = encoding.Decode(edge.height);
+            }
+        }
+    }
+
+    // d. raise the water over the edges from the lowest up, merging basins that flood into one another, until every
+    //    lake spills into a basin that drains to the ocean.
+    std::vector<uint16_t> pitHeights(basins.size());
+    std::vector<bool> drainsToOcean(basins.size());
+    for (size_t basinId = 0U; basinId < basins.size(); basinId++) {
+        pitHeights[basinId] = surface[basins[basinId].pit];
+        drainsToOcean[basinId] = basins[basinId].drains_to_ocean;
+    }
+
+    BasinForest forest(pitHeights, drainsToOcean);
+    for (const BasinEdge& edge : edges) {
+        forest.Flood(edge);
+    }
+
+    const std::vector<uint16_t>& fillHeights = forest.GetFillHeights();
+    const std::vector<BasinId_t> lakes = forest.GetLakes();
+    for (size_t basinId = 0U; basinId < basins.size(); basinId++) {
+        Basin& basin = basins[basinId];
+        basin.lake = lakes[basinId];
+        basin.outlet = forest.GetOutlets()[basinId];
+        basin.water_level = encoding.Decode(
+            basin.drains_to_ocean ? columns.GetWaterLevels()[basin.pit] : fillHeights[basinId]);
+    }
+
+    // e. sum the depth of water over each tile of a lake.
+    std::vector<double> volumes(basins.size(), 0.0);
+    for (size_t tileId = 0U; tileId < numTiles; tileId++) {
+        const BasinId_t basinId = p_basin_ids[tileId];
+        if ((basinId != INVALID_BASIN_ID) && (surface[tileId] < fillHeights[basinId])) {
+            volumes[basinId] += basins[basinId].water_level - encoding.Decode(surface[tileId]);
+        }
+    }
+    for (size_t basinId = 0U; basinId < basins.size(); basinId++) {
+        basins[basinId].volume = static_cast<float>(volumes[basinId] * TILE_SIZE_METERS_F32 * TILE_SIZE_METERS_F32);
+    }
+
+    world.SetBasins(std::move(basins));
+}
+
+} // namespace World::Passes
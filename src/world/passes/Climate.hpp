@@ -0,0 +1,21 @@
+#pragma once
+
+#include "world/Region.hpp"
+
+//! Climate of the world before the atmosphere moves heat and moisture around, shared by the climate passes.
+namespace World::Passes {
+
+    //! Temperature lost per meter of height above ocean level.
+    static constexpr float LAPSE_RATE = 6.5F / 1000.0F;
+
+    //! @brief Get the temperature at ocean level, from the latitude alone.
+    //!
+    //! @param[in] latitude Distance from the equator, from zero at the equator to one at either pole.
+    float CalculateSeaLevelTemperature(float latitude);
+
+    //! @brief Get the temperature change of a region due to its height above ocean level.
+    float CalculateElevationModifier(const Region& region, float ocean_level);
+
+    //! @brief Whether a region is covered by the ocean or a lake.
+    bool IsWaterRegion(const Region& region);
+}
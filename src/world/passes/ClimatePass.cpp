@@ -1,9 +1,17 @@
 #include "Passes.hpp"
+#include "Climate.hpp"
+#include "math/PerlinNoise.hpp"
+#include "math/Simd.hpp"
 #include "world/Region.hpp"
+#include "world/TileBlocks.hpp"
 #include "world/World.hpp"
 #include <vector>
+#include <glm/common.hpp>
 #include <glm/geometric.hpp>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
 
 namespace World::Passes {
 
@@ -12,8 +20,31 @@ static constexpr float TEMP_POLES = -30.0F;
 
 static constexpr float MAX_VARIANCE = 20.0F;
 
+//! Noise used to jitter the borders between tile biomes. The wavelength and amplitude are in region spacings.
+static constexpr uint32_t WARP_SEED_SALT = 0x85EBCA6BU;
+static constexpr float WARP_WAVELENGTH = 4.0F;
+static constexpr float WARP_AMPLITUDE = 1.0F;
+static constexpr int WARP_OCTAVES = 2;
+static constexpr float WARP_Y_OFFSET = 43.97F;
+
+//! How far from the border between regions their climates are blended, as a difference between the squared distances
+//! to their centroids, in region spacings. Further in, a region keeps its own climate.
+static constexpr float BLEND_WIDTH = 0.25F;
+
+float CalculateSeaLevelTemperature(float latitude) {
+    return ((TEMP_EQUATER - TEMP_POLES) * (1.0F - latitude)) + TEMP_POLES;
+}
+
+//! Temperature decreases with elevation (~6.5°C per 1000m) above ocean level
+float CalculateElevationModifier(const Region& region, float ocean_level) {
+    if (region.GetAbsoluteHeight() > ocean_level) {
+        return -(region.GetAbsoluteHeight() - ocean_level) * LAPSE_RATE;
+    }
+    return 0.0F;
+}
+
 //! Calculate temperature for a region based on latitude and elevation
-std::pair<float, float> CalculateTemperature(Coordinate_t coordinate, Extent_t world_size, Region& region, float ocean_level) {
+std::pair<float, float> CalculateTemperature(Coordinate_t coordinate, Extent_t world_size, const Region& region, float ocean_level) {
     // Base temperature: ~25°C at equator, decreases toward poles
     // Normalize latitude (y) to 0-1 range, where 0 is north pole and 1 is south pole
     float latitude = static_cast<float>(coordinate.y) / static_cast<float>(world_size.y);
@@ -22,18 +53,15 @@ std::pair<float, float> CalculateTemperature(Coordinate_t coordinate, Extent_t w
     float lat_offset = (latitude - 0.5F) * 2.0F;
 
     // Base temperature decreases with latitude (cosine wave: ~25°C at equator, ~-10°C at poles)
-    float base_temp = ((TEMP_EQUATER - TEMP_POLES) * (1.0F - std::abs(lat_offset))) + TEMP_POLES;
+    float base_temp = CalculateSeaLevelTemperature(std::abs(lat_offset));
 
     float variance = MAX_VARIANCE * std::abs(lat_offset);
 
-    // Temperature decreases with elevation (~6.5°C per 1000m) above ocean level
-    float elevation_temp_modifier = 0.0F;
-    if (region.GetAbsoluteHeight() > ocean_level) {
-
-        elevation_temp_modifier = -((region.GetAbsoluteHeight() - ocean_level)/ 1000.0F) * 6.5F;
-    }
+    return {base_temp + CalculateElevationModifier(region, ocean_level), variance};
+}
 
-    return {base_temp + elevation_temp_modifier, variance};
+bool IsWaterRegion(const Region& region) {
+    return region.GetIsOcean() || region.GetIsLake();
 }
 
 //! Calculate moisture for a region based on proximity to water
@@ -45,7 +73,7 @@ float CalculateMoisture(const Region& region, const std::vector<Region>& all_reg
     // Once we know moisture capacity, we can give regions with higher temperature more moisture. Additionally, we'll have
     // to do a round of thermal dynamics to simulate effect of moisture on temperature.
     // Base moisture for water regions
-    if (region.GetIsOcean() || region.GetIsLake()) {
+    if (IsWaterRegion(region)) {
         return 100.0F;
     }
 
@@ -125,81 +153,183 @@ void RunClimatePass(World& world, const WorldParams& params) {
         region.SetMoisture(moisture);
     }
 
-    // 1.c. Use Whitacker diagram to assign biomes to regions based on temperature and moisture.
-    for (Region& region : regions) {
+    // 1.c. Optionally move heat and moisture around with the winds, for rain shadows and wet coasts.
+    if (params.GetIsAtmosphereSimulated()) {
+        SimulateAtmosphere(world);
+    }
 
-        float temperature = region.GetTemperature();
-        float moisture = region.GetMoisture();
+    // 1.d. Use Whitacker diagram to assign biomes to regions based on temperature and moisture.
+    for (Region& region : regions) {
+        region.SetBiome(ClassifyBiome({
+            region.GetTemperature(),
+            region.GetTemperatureVariance(),
+            region.GetMoisture(),
+            region.GetIsOcean(),
+            region.GetIsLake(),
+            region.GetIsMountain(),
+            region.GetHasRiver()}));
+    }
 
-        // Use the biome dictionary to find the most specific type of biome that fits the region.
-        if (region.GetIsOcean()) {
+    // 1.e. Assign biomes to tiles, so that the borders between biomes follow the climate rather than the regions.
+    AssignTileBiomes(world, params);
+}
 
-            // Assign one of the ocean biomes.
-            if (temperature < -20.0F) {
-                region.SetBiome(BiomeType::SEA_ICE);
-            }
-            else {
-                region.SetBiome(BiomeType::OCEAN);
+void AssignTileBiomes(World& world, const WorldParams& params) {
+
+    const std::vector<Region>& regions = world.GetRegions();
+    const Extent_t worldSize = world.GetSize();
+
+    // distances are measured in tiles, relative to the typical spacing between region centroids.
+    const float regionSpacing = std::sqrt(static_cast<float>(std::max<size_t>(params.GetRegionSize(), 1U)));
+    const float invSpacingSquared = 1.0F / (regionSpacing * regionSpacing);
+    const float warpAmplitude = 2.0F * WARP_AMPLITUDE * regionSpacing;
+    const float warpScale = 1.0F / (WARP_WAVELENGTH * regionSpacing);
+    const Math::PerlinNoise noise(params.GetSeed() ^ WARP_SEED_SALT);
+
+    // the elevation and moisture of each region are blended with its neighbors. Land is only blended with land, so
+    // that coasts do not take on the moisture of the ocean, and water is not blended at all. The fields used by the
+    // kernel are copied out of the regions, to keep them close together. The temperature of a region that differs
+    // from its latitude and elevation, as simulated by the atmosphere, is blended along with the elevation.
+    std::vector<glm::vec2> centroids(regions.size());
+    std::vector<float> temperatureModifiers(regions.size());
+    std::vector<float> moistures(regions.size());
+    std::vector<uint8_t> isWaterRegion(regions.size());
+    std::vector<uint32_t> blendOffsets;
+    std::vector<RegionId_t> blendRegions;
+    blendOffsets.reserve(regions.size() + 1U);
+    blendOffsets.push_back(0U);
+    for (size_t regionId = 0U; regionId < regions.size(); regionId++) {
+        const Region& region = regions[regionId];
+        centroids[regionId] = region.GetCentroid() * TILE_PER_METER_F32;
+        const float latitudeTemperature =
+            CalculateTemperature(world.PositionToCoordinate(region.GetCentroid()), worldSize, region, world.GetOceanLevel()).first;
+        temperatureModifiers[regionId] = CalculateElevationModifier(region, world.GetOceanLevel()) +
+                                         (region.GetTemperature() - latitudeTemperature);
+        moistures[regionId] = region.GetMoisture();
+        isWaterRegion[regionId] = IsWaterRegion(region) ? 1U : 0U;
+        blendRegions.push_back(static_cast<RegionId_t>(regionId));
+        if (!IsWaterRegion(region)) {
+            for (RegionId_t neighborId : region.GetNeighbors()) {
+                if ((neighborId != INVALID_REGION_ID) && !IsWaterRegion(regions[neighborId])) {
+                    blendRegions.push_back(neighborId);
+                }
             }
         }
-        else if (region.GetIsLake()) {
+        blendOffsets.push_back(static_cast<uint32_t>(blendRegions.size()));
+    }
 
-            if (temperature < -20.0F) {
-                region.SetBiome(BiomeType::FROZEN_LAKE);
-            }
-            else {
-                region.SetBiome(BiomeType::LAKE);
-            }
+    TileColumns& columns = world.GetTileColumns();
+    const RegionId_t* p_regionIds = columns.GetRegionIds();
+    const uint8_t* p_flags = columns.GetFlags();
+    BiomeType* p_biomes = columns.GetBiomes();
+
+    // each row of a block is processed in stages over arrays of the row, so that the arithmetic of each stage runs
+    // over contiguous values. The noise of stage a and the blending of stage c look up tables for each tile, and stay
+    // scalar. The arithmetic around them runs on four tiles at once, over whole Float4s; the lanes past the end of a
+    // narrow block are computed and ignored.
+    static_assert((DEFAULT_TILE_BLOCK_SIZE % Math::Simd::FLOAT4_WIDTH) == 0U);
+    using namespace Math::Simd;
+    const Float4 vecWarpAmplitude = Splat(warpAmplitude);
+    const Float4 vecMaxX = Splat(static_cast<float>(worldSize.x) - 1.0F);
+    const Float4 vecMaxY = Splat(static_cast<float>(worldSize.y) - 1.0F);
+    const Float4 vecHeight = Splat(static_cast<float>(worldSize.y));
+
+    ForEachTileBlock(worldSize, DEFAULT_TILE_BLOCK_SIZE, 0U, [&](const TileBlock& block) {
+
+        std::array<float, DEFAULT_TILE_BLOCK_SIZE> positionsX {};
+        std::array<float, DEFAULT_TILE_BLOCK_SIZE> warpsX {};
+        std::array<float, DEFAULT_TILE_BLOCK_SIZE> warpsY {};
+        std::array<float, DEFAULT_TILE_BLOCK_SIZE> samplesX {};
+        std::array<float, DEFAULT_TILE_BLOCK_SIZE> samplesY {};
+        std::array<float, DEFAULT_TILE_BLOCK_SIZE> temperatures {};
+        std::array<float, DEFAULT_TILE_BLOCK_SIZE> variances {};
+        const size_t width = block.max.x - block.min.x;
+        const size_t vecWidth = ((width + FLOAT4_WIDTH - 1U) / FLOAT4_WIDTH) * FLOAT4_WIDTH;
+
+        for (size_t index = 0U; index < width; index++) {
+            positionsX[index] = static_cast<float>(block.min.x + index) + 0.5F;
         }
-        else {
 
-            // Cold Biomes
-            if (temperature < -20.0F) {
-                region.SetBiome(BiomeType::ICE_SHEET);
-            }
-            else if ((temperature < 0.0F) && ((moisture < 50.0F) || (region.GetIsMountain()))) {
-                region.SetBiome(BiomeType::TUNDRA);
+        for (uint32_t y = block.min.y; y < block.max.y; y++) {
+
+            const TileId_t rowStart = world.CoordinateToTileId({block.min.x, y});
+            const float positionY = static_cast<float>(y) + 0.5F;
+
+            // a. jitter where the climate of each tile is sampled, so that biome borders are not straight lines.
+            for (size_t index = 0U; index < width; index++) {
+                glm::vec2 warpPosition = glm::vec2(positionsX[index], positionY) * warpScale;
+                warpsX[index] = noise.Fbm(warpPosition, WARP_OCTAVES);
+                warpsY[index] = noise.Fbm(warpPosition + glm::vec2(WARP_Y_OFFSET), WARP_OCTAVES);
             }
-            else if ((temperature < 10.0F) && ((moisture < 80.0F) || region.GetHasRiver())) {
-                region.SetBiome(BiomeType::BOREAL_FOREST);
+
+            const Float4 vecPositionY = Splat(positionY);
+            for (size_t index = 0U; index < vecWidth; index += FLOAT4_WIDTH) {
+                const Float4 offsetX = vecWarpAmplitude * (Load(&warpsX[index]) - Splat(0.5F));
+                const Float4 offsetY = vecWarpAmplitude * (Load(&warpsY[index]) - Splat(0.5F));
+                Store(&samplesX[index], Min(Max(Load(&positionsX[index]) + offsetX, Splat(0.0F)), vecMaxX));
+                Store(&samplesY[index], Min(Max(vecPositionY + offsetY, Splat(0.0F)), vecMaxY));
             }
-            else if (temperature < 10.0F) {
-                region.SetBiome(BiomeType::COLD_BOG);
+
+            // b. temperature at ocean level, and its variance, from the latitude of each sample, as
+            //    CalculateSeaLevelTemperature() computes it.
+            for (size_t index = 0U; index < vecWidth; index += FLOAT4_WIDTH) {
+                const Float4 latOffset = Abs(((Load(&samplesY[index]) / vecHeight) - Splat(0.5F)) * Splat(2.0F));
+                Store(&temperatures[index],
+                      (Splat(TEMP_EQUATER - TEMP_POLES) * (Splat(1.0F) - latOffset)) + Splat(TEMP_POLES));
+                Store(&variances[index], Splat(MAX_VARIANCE) * latOffset);
             }
-            else if (temperature > 27.5F) {
 
-                if (moisture < 50.0F) {
-                    region.SetBiome(BiomeType::EXTREME_DESERT);
-                }
-                if (moisture < 60.0F) {
-                    region.SetBiome(BiomeType::DESERT);
-                }
-                else {
-                    region.SetBiome(BiomeType::ARID_SHRUBLAND);
+            // c. temperature and moisture blended between the regions around each sample, and then the biome. The water
+            //    of the tile itself decides whether it is ocean or lake.
+            for (size_t index = 0U; index < width; index++) {
+
+                const TileId_t tileId = rowStart + static_cast<TileId_t>(index);
+                const glm::vec2 sample(samplesX[index], samplesY[index]);
+                const uint8_t flags = p_flags[tileId];
+                const bool isWater = (flags & TILE_FLAG_WATER) != 0U;
+
+                // sample the region under the jittered position, unless that takes a tile across a coast.
+                RegionId_t sampleId = p_regionIds[world.CoordinateToTileId(Coordinate_t(sample))];
+                if ((isWaterRegion[sampleId] != 0U) != isWater) {
+                    sampleId = p_regionIds[tileId];
                 }
-            }
-            else {
-
-                bool is_swamp = ((moisture >= 80.0F) && !region.GetHasRiver());
-
-                // Seperate out by variability in temperature
-                if (region.GetTemperatureVariance() < 4.0F) {
-                    if (is_swamp) {
-                        region.SetBiome(BiomeType::TROPICAL_SWAMP);
-                    }
-                    else {
-                        region.SetBiome(BiomeType::TROPICAL_RAINFOREST);
-                    }
+
+                // regions are weighted by how much further their centroid is than the nearest one.
+                const uint32_t firstBlend = blendOffsets[sampleId];
+                const uint32_t lastBlend = blendOffsets[sampleId + 1U];
+                auto distanceTo = [&](RegionId_t regionId) {
+                    const glm::vec2 offset = centroids[regionId] - sample;
+                    return glm::dot(offset, offset) * invSpacingSquared;
+                };
+
+                float nearest = std::numeric_limits<float>::max();
+                for (uint32_t blend = firstBlend; blend < lastBlend; blend++) {
+                    nearest = std::min(nearest, distanceTo(blendRegions[blend]));
                 }
-                else if (is_swamp) {
-                    region.SetBiome(BiomeType::TEMPERATE_SWAMP);
-                } else {
-                    region.SetBiome(BiomeType::TEMPERATE_FOREST);
+
+                float weightSum = 0.0F;
+                float temperatureSum = 0.0F;
+                float moistureSum = 0.0F;
+                for (uint32_t blend = firstBlend; blend < lastBlend; blend++) {
+                    const RegionId_t blendId = blendRegions[blend];
+                    const float weight = std::max(1.0F - ((distanceTo(blendId) - nearest) / BLEND_WIDTH), 0.0F);
+                    weightSum += weight;
+                    temperatureSum += weight * temperatureModifiers[blendId];
+                    moistureSum += weight * moistures[blendId];
                 }
-            }
 
+                const Region& region = regions[p_regionIds[tileId]];
+                p_biomes[tileId] = ClassifyBiome({
+                    temperatures[index] + (temperatureSum / weightSum),
+                    variances[index],
+                    moistureSum / weightSum,
+                    isWater && ((flags & TILE_FLAG_LAKE) == 0U),
+                    (flags & TILE_FLAG_LAKE) != 0U,
+                    region.GetIsMountain(),
+                    region.GetHasRiver()});
+            }
         }
-    }
+    });
 }
 
-}
\ No newline at end of file
+} // namespace World::Passes
@@ -0,0 +1,153 @@
+#include "Drainage.hpp"
+
+#include "core/ThreadPool.hpp"
+#include "math/Stencil.hpp"
+#include "world/TileColumns.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace World::Passes {
+
+//! Tiles processed by each task, for passes that visit every tile on its own.
+static constexpr size_t TILES_PER_TASK = 16384U;
+
+//! Offsets to the eight neighbors of a tile, in the order that Math::ApplyStencil8 passes them.
+static constexpr std::array<int32_t, 8> NEIGHBOR_X = {-1, 0, 1, -1, 1, -1, 0, 1};
+static constexpr std::array<int32_t, 8> NEIGHBOR_Y = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+//! Distance to each of the eight neighbors, in tiles.
+static constexpr float DIAGONAL = 1.41421356F;
+static constexpr std::array<float, 8> NEIGHBOR_DISTANCE = {
+    DIAGONAL, 1.0F, DIAGONAL, 1.0F, 1.0F, DIAGONAL, 1.0F, DIAGONAL};
+
+bool IsOceanTile(uint8_t flags) {
+    return ((flags & TILE_FLAG_WATER) != 0U) && ((flags & TILE_FLAG_LAKE) == 0U);
+}
+
+std::vector<uint16_t> GetDrainageSurface(const World& world) {
+
+    const TileColumns& columns = world.GetTileColumns();
+    const uint16_t* p_heights = columns.GetHeights();
+    const uint8_t* p_flags = columns.GetFlags();
+
+    std::vector<uint16_t> surface(columns.GetSize());
+    Core::ThreadPool::GetInstance().ParallelFor(surface.size(), TILES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t tileId = begin; tileId < end; tileId++) {
+            surface[tileId] = IsOceanTile(p_flags[tileId]) ? 0U : std::max<uint16_t>(p_heights[tileId], 1U);
+        }
+    });
+
+    return surface;
+}
+
+//! @brief Drain the tiles of flats, which have no lower neighbor, across the flat to where it drains.
+//!
+//! Tiles of a flat next to a tile of the same height that drains lower are given it as their receiver, then the rest
+//! of the flat is walked breadth first from them, so that each tile drains to a neighbor one step closer to an outlet.
+//! Flats with no outlet are left draining to themselves, as pits.
+static void RouteFlats(const std::vector<uint16_t>& surface, Extent_t extent, std::vector<TileId_t>& receivers) {
+
+    const int64_t width = extent.x;
+    const int64_t height = extent.y;
+    auto forEachNeighbor = [&](TileId_t tileId, auto&& func) {
+        const int64_t x = static_cast<int64_t>(tileId) % width;
+        const int64_t y = static_cast<int64_t>(tileId) / width;
+        for (size_t neighbor = 0U; neighbor < NEIGHBOR_X.size(); neighbor++) {
+            const int64_t neighborX = x + NEIGHBOR_X[neighbor];
+            const int64_t neighborY = y + NEIGHBOR_Y[neighbor];
+            if ((neighborX >= 0) && (neighborX < width) && (neighborY >= 0) && (neighborY < height)) {
+                if (func(static_cast<TileId_t>((neighborY * width) + neighborX))) {
+                    return;
+                }
+            }
+        }
+    };
+
+    // a. tiles of flats next to an outlet. Receivers are only set once every tile has been looked at, so that tiles
+    //    of the flat are not taken for outlets.
+    std::vector<TileId_t> queue;
+    std::vector<TileId_t> outlets;
+    for (size_t index = 0U; index < receivers.size(); index++) {
+        const TileId_t tileId = static_cast<TileId_t>(index);
+        if (receivers[tileId] != tileId) {
+            continue;
+        }
+
+        forEachNeighbor(tileId, [&](TileId_t neighborId) {
+            if ((surface[neighborId] == surface[tileId]) && (receivers[neighborId] != neighborId)) {
+                queue.push_back(tileId);
+                outlets.push_back(neighborId);
+                return true;
+            }
+            return false;
+        });
+    }
+
+    for (size_t index = 0U; index < queue.size(); index++) {
+        receivers[queue[index]] = outlets[index];
+    }
+
+    // b. the rest of each flat, breadth first from its outlets.
+    for (size_t head = 0U; head < queue.size(); head++) {
+        const TileId_t tileId = queue[head];
+        forEachNeighbor(tileId, [&](TileId_t neighborId) {
+            if ((receivers[neighborId] == neighborId) && (surface[neighborId] == surface[tileId])) {
+                receivers[neighborId] = tileId;
+                queue.push_back(neighborId);
+            }
+            return false;
+        });
+    }
+}
+
+std::vector<TileId_t> FindDrainageReceivers(const std::vector<uint16_t>& surface, Extent_t extent) {
+
+    std::vector<TileId_t> receivers(surface.size());
+    Math::ForEachStencilRow(surface.data(), extent, Math::StencilEdge::CLAMP, [&](const Math::StencilRow<uint16_t>& row) {
+
+        // cells padded in by clamping repeat a real neighbor, so those beyond the edge of the world are skipped, to
+        // keep the receiver from being set to a tile that is not a neighbor at all.
+        const std::array<const uint16_t*, 3> p_rows = {row.p_north, row.p_center, row.p_south};
+        const bool hasNorth = row.first.y > 0U;
+        const bool hasSouth = (row.first.y + 1U) < extent.y;
+
+        for (ptrdiff_t xCoord = 0; xCoord < static_cast<ptrdiff_t>(row.width); xCoord++) {
+
+            const uint32_t worldX = row.first.x + static_cast<uint32_t>(xCoord);
+            const bool hasWest = worldX > 0U;
+            const bool hasEast = (worldX + 1U) < extent.x;
+            const uint16_t center = row.p_center[xCoord];
+            const TileId_t tileId = static_cast<TileId_t>(row.first_index + static_cast<size_t>(xCoord));
+
+            float steepest = 0.0F;
+            TileId_t receiver = tileId;
+            for (size_t neighbor = 0U; neighbor < NEIGHBOR_X.size(); neighbor++) {
+
+                const int32_t offsetX = NEIGHBOR_X[neighbor];
+                const int32_t offsetY = NEIGHBOR_Y[neighbor];
+                if (((offsetX < 0) && !hasWest) || ((offsetX > 0) && !hasEast) || ((offsetY < 0) && !hasNorth) ||
+                    ((offsetY > 0) && !hasSouth)) {
+                    continue;
+                }
+
+                const uint16_t height = p_rows[static_cast<size_t>(offsetY + 1)][xCoord + offsetX];
+                const float slope =
+                    (static_cast<float>(center) - static_cast<float>(height)) / NEIGHBOR_DISTANCE[neighbor];
+                if (slope > steepest) {
+                    steepest = slope;
+                    receiver = static_cast<TileId_t>(static_cast<int64_t>(tileId) + offsetX +
+                                                     (static_cast<int64_t>(offsetY) * extent.x));
+                }
+            }
+
+            receivers[tileId] = receiver;
+        }
+    });
+
+    RouteFlats(surface, extent, receivers);
+    return receivers;
+}
+
+} // namespace World::Passes
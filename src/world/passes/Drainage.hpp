@@ -0,0 +1,31 @@
+#pragma once
+
+#include "world/Tile.hpp"
+#include "world/World.hpp"
+#include <cstdint>
+#include <vector>
+
+//! Steepest descent drainage over the tiles of a world, shared by the passes that follow water downhill.
+namespace World::Passes {
+
+    //! @brief Whether a tile is part of the ocean, from its TileFlag bits. Lakes are not.
+    bool IsOceanTile(uint8_t flags);
+
+    //! @brief Get the surface that water drains over.
+    //!
+    //! @returns The encoded height of each land tile, at least one, and zero for ocean tiles, so that land next to the
+    //!          ocean always drains into it.
+    std::vector<uint16_t> GetDrainageSurface(const World& world);
+
+    //! @brief Find the tile each tile drains to, which is its neighbor down the steepest slope.
+    //!
+    //! Tiles of a flat, with no lower neighbor, drain to a neighbor of the same height on the shortest path across the
+    //! flat to a tile that drains lower. Tiles with no such path, at the bottom of a pit or in the ocean, drain to
+    //! themselves.
+    //!
+    //! @param[in] surface Surface returned by GetDrainageSurface().
+    //! @param[in] extent  Size of the world, in tiles.
+    //!
+    //! @returns The tile each tile drains to, indexed by tile ID.
+    std::vector<TileId_t> FindDrainageReceivers(const std::vector<uint16_t>& surface, Extent_t extent);
+}
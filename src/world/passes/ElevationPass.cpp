@@ -3,6 +3,8 @@
 #include "math/PerlinNoise.hpp"
 #include "world/Region.hpp"
 #include "world/TectonicPlate.hpp"
+#include "world/TileBlocks.hpp"
+#include "world/TileColumns.hpp"
 #include "math/Voronoi.hpp"
 #include "world/World.hpp"
 #include "world/WorldParams.hpp"
@@ -53,7 +55,6 @@ void RunElevationPass(World& world, const WorldParams& params) {
 
     std::vector<TectonicPlate>& plates = world.GetPlates();
     std::vector<Region>& regions = world.GetRegions();
-    std::vector<Tile>& tiles = world.GetTiles();
     Extent_t worldExtent = world.GetSize();
 
     Math::PerlinNoise perlin(params.GetSeed());
@@ -142,19 +143,38 @@ void RunElevationPass(World& world, const WorldParams& params) {
 
     //    d. Finally, use higher octave perlin noise to assign heights to each individual tile based on proximity to centroid
     //       or edge of region. Tiles closer to edge should blend with height of closest neighboring region.
-    for (Tile& tile : tiles) {
+    // Tiles are written a block at a time, so that only a few blocks of an out of core world are touched at once.
+    // the noise is within [0, 1], so tiles are between zero and the height of their region. Fit the height encoding to
+    // the range of the regions before the tiles are encoded.
+    std::vector<float> regionHeights(regions.size());
+    float minHeight = 0.0F;
+    float maxHeight = 0.0F;
+    for (size_t regionId = 0U; regionId < regions.size(); regionId++) {
+        regionHeights[regionId] = regions[regionId].GetAbsoluteHeight();
+        minHeight = std::min(minHeight, regionHeights[regionId]);
+        maxHeight = std::max(maxHeight, regionHeights[regionId]);
+    }
+    world.FitHeightEncoding(minHeight, maxHeight);
 
-        Region& region = regions.at(tile.GetRegionId());
+    const HeightEncoding& encoding = world.GetHeightEncoding();
+    TileColumns& columns = world.GetTileColumns();
+    const RegionId_t* p_regionIds = columns.GetRegionIds();
+    uint16_t* p_heights = columns.GetHeights();
 
-        // normalize coordinate to world size
-        Coordinate_t coordinate = world.TileIdToCoordinate(tile.GetTileId());
-        glm::vec2 normalizedPos(
-            static_cast<float>(coordinate.x) / static_cast<float>(worldExtent.x),
-            static_cast<float>(coordinate.y) / static_cast<float>(worldExtent.y));
+    ForEachTileBlock(worldExtent, DEFAULT_TILE_BLOCK_SIZE, 0U, [&](const TileBlock& block) {
+        for (uint32_t y = block.min.y; y < block.max.y; y++) {
+            for (uint32_t x = block.min.x; x < block.max.x; x++) {
 
+                // normalize coordinate to world size
+                TileId_t tileId = world.CoordinateToTileId({x, y});
+                glm::vec2 normalizedPos(
+                    static_cast<float>(x) / static_cast<float>(worldExtent.x),
+                    static_cast<float>(y) / static_cast<float>(worldExtent.y));
 
-        tile.SetAbsoluteHeight(region.GetAbsoluteHeight() * perlin.Fbm(normalizedPos));
-    }
+                p_heights[tileId] = encoding.Encode(regionHeights.at(p_regionIds[tileId]) * perlin.Fbm(normalizedPos));
+            }
+        }
+    });
 }
 
 } // namespace World::Passes
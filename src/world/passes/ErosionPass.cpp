@@ -0,0 +1,313 @@
+#include "Passes.hpp"
+
+#include "core/ThreadPool.hpp"
+#include "math/Random.hpp"
+#include "math/Simd.hpp"
+#include "math/Stencil.hpp"
+#include "world/Tile.hpp"
+#include "world/World.hpp"
+#include "world/WorldParams.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World::Passes {
+
+// Droplets are simulated in blocks of BLOCK_SIZE x BLOCK_SIZE tiles. Blocks are colored like a checkerboard with four
+// colors, and all blocks of one color are processed in parallel. Blocks of the same color are separated by a full block,
+// so as long as a droplet cannot reach more than half a block outside of its own block, no two droplets running at the
+// same time touch the same tile. Droplets within a block run in a fixed order, so the result does not depend on the
+// number of threads.
+static constexpr int32_t BLOCK_SIZE = 64;
+static constexpr int32_t NUM_BLOCK_COLORS = 4;
+
+//! Tiles around the droplet position that are modified by erosion and deposition.
+static constexpr int32_t BRUSH_RADIUS = 1;
+
+//! Maximum number of steps in the lifetime of a droplet. Each step moves the droplet one tile.
+static constexpr int32_t MAX_DROPLET_STEPS = 30;
+static_assert(2 * (MAX_DROPLET_STEPS + BRUSH_RADIUS) <= BLOCK_SIZE, "droplets from neighboring blocks could overlap");
+
+//! How much of the previous direction is kept when a droplet changes direction.
+static constexpr float INERTIA = 0.05F;
+
+//! Multiplier for how much sediment a droplet can carry.
+static constexpr float SEDIMENT_CAPACITY_FACTOR = 4.0F;
+
+//! Prevents carry capacity from reaching zero on flat terrain.
+static constexpr float MIN_SEDIMENT_CAPACITY = 0.01F;
+
+//! Fraction of the excess sediment deposited each step.
+static constexpr float DEPOSIT_SPEED = 0.3F;
+
+//! Fraction of the free capacity eroded each step.
+static constexpr float ERODE_SPEED = 0.3F;
+
+//! Fraction of water that evaporates each step.
+static constexpr float EVAPORATE_SPEED = 0.02F;
+
+static constexpr float GRAVITY = 4.0F;
+
+//! Largest stable height difference between neighboring tiles, in tiles. About 30 degrees.
+static constexpr float TALUS_THRESHOLD = 0.6F;
+
+//! Fraction of the height difference over the talus threshold that is moved to each neighbor per sweep. Must be at most
+//! 1/8 for four neighbors, or material can oscillate between tiles.
+static constexpr float TALUS_RATE = 0.125F;
+
+//! Thermal relaxation sweeps after each round of droplets.
+static constexpr int32_t THERMAL_SWEEPS_PER_ITERATION = 4;
+
+//! Height field that erosion is run on. Heights are stored in tiles, rather than meters, so that slopes are unitless.
+struct HeightField {
+    std::vector<float> heights;
+    int32_t width;
+    int32_t height;
+
+    float& At(int32_t x_coord, int32_t y_coord) {
+        return heights[(static_cast<size_t>(y_coord) * width) + x_coord];
+    }
+
+    //! Bilinearly interpolated height and gradient at a position.
+    void Sample(float x_pos, float y_pos, float& out_height, float& out_grad_x, float& out_grad_y) {
+
+        int32_t xCoord = static_cast<int32_t>(x_pos);
+        int32_t yCoord = static_cast<int32_t>(y_pos);
+        float xOffset = x_pos - static_cast<float>(xCoord);
+        float yOffset = y_pos - static_cast<float>(yCoord);
+
+        float heightNW = At(xCoord, yCoord);
+        float heightNE = At(xCoord + 1, yCoord);
+        float heightSW = At(xCoord, yCoord + 1);
+        float heightSE = At(xCoord + 1, yCoord + 1);
+
+        out_grad_x = ((heightNE - heightNW) * (1.0F - yOffset)) + ((heightSE - heightSW) * yOffset);
+        out_grad_y = ((heightSW - heightNW) * (1.0F - xOffset)) + ((heightSE - heightNE) * xOffset);
+        out_height =
+            (heightNW * (1.0F - xOffset) * (1.0F - yOffset)) +
+            (heightNE * xOffset * (1.0F - yOffset)) +
+            (heightSW * (1.0F - xOffset) * yOffset) +
+            (heightSE * xOffset * yOffset);
+    }
+
+    //! Add an amount to the tiles around a position, weighted by bilinear interpolation. Negative amounts erode.
+    void Splat(int32_t x_coord, int32_t y_coord, float x_offset, float y_offset, float amount) {
+        At(x_coord, y_coord) += amount * (1.0F - x_offset) * (1.0F - y_offset);
+        At(x_coord + 1, y_coord) += amount * x_offset * (1.0F - y_offset);
+        At(x_coord, y_coord + 1) += amount * (1.0F - x_offset) * y_offset;
+        At(x_coord + 1, y_coord + 1) += amount * x_offset * y_offset;
+    }
+};
+
+//! Simulate a single droplet of water, that erodes the terrain as it flows downhill, and deposits sediment as it slows.
+static void SimulateDroplet(HeightField& field, float x_pos, float y_pos) {
+
+    float dirX = 0.0F;
+    float dirY = 0.0F;
+    float speed = 1.0F;
+    float water = 1.0F;
+    float sediment = 0.0F;
+
+    const float maxX = static_cast<float>(field.width - 1);
+    const float maxY = static_cast<float>(field.height - 1);
+
+    for (int32_t step = 0; step < MAX_DROPLET_STEPS; step++) {
+
+        int32_t xCoord = static_cast<int32_t>(x_pos);
+        int32_t yCoord = static_cast<int32_t>(y_pos);
+        float xOffset = x_pos - static_cast<float>(xCoord);
+        float yOffset = y_pos - static_cast<float>(yCoord);
+
+        float height = 0.0F;
+        float gradX = 0.0F;
+        float gradY = 0.0F;
+        field.Sample(x_pos, y_pos, height, gradX, gradY);
+
+        dirX = (dirX * INERTIA) - (gradX * (1.0F - INERTIA));
+        dirY = (dirY * INERTIA) - (gradY * (1.0F - INERTIA));
+
+        float length = std::sqrt((dirX * dirX) + (dirY * dirY));
+        if (length <= 0.0F) {
+            // stuck on perfectly flat terrain.
+            break;
+        }
+
+        dirX /= length;
+        dirY /= length;
+        x_pos += dirX;
+        y_pos += dirY;
+
+        if ((x_pos < 0.0F) || (y_pos < 0.0F) || (x_pos >= maxX) || (y_pos >= maxY)) {
+            // flowed off of the map, so the sediment is lost.
+            return;
+        }
+
+        float newHeight = 0.0F;
+        float unusedX = 0.0F;
+        float unusedY = 0.0F;
+        field.Sample(x_pos, y_pos, newHeight, unusedX, unusedY);
+        float deltaHeight = newHeight - height;
+
+        float capacity = std::max(-deltaHeight * speed * water * SEDIMENT_CAPACITY_FACTOR, MIN_SEDIMENT_CAPACITY);
+
+        if ((sediment > capacity) || (deltaHeight > 0.0F)) {
+
+            // moving uphill fills the pit behind the droplet, otherwise drop a fraction of the excess.
+            float deposit = (deltaHeight > 0.0F) ? std::min(deltaHeight, sediment) : (sediment - capacity) * DEPOSIT_SPEED;
+            sediment -= deposit;
+            field.Splat(xCoord, yCoord, xOffset, yOffset, deposit);
+        }
+        else {
+
+            // never erode deeper than the height difference, or the droplet digs a hole it cannot leave.
+            float erode = std::min((capacity - sediment) * ERODE_SPEED, -deltaHeight);
+            sediment += erode;
+            field.Splat(xCoord, yCoord, xOffset, yOffset, -erode);
+        }
+
+        speed = std::sqrt(std::max((speed * speed) - (deltaHeight * GRAVITY), 0.0F));
+        water *= (1.0F - EVAPORATE_SPEED);
+    }
+
+    // the droplet evaporated, so drop whatever it was still carrying.
+    int32_t xCoord = static_cast<int32_t>(x_pos);
+    int32_t yCoord = static_cast<int32_t>(y_pos);
+    field.Splat(xCoord, yCoord, x_pos - static_cast<float>(xCoord), y_pos - static_cast<float>(yCoord), sediment);
+}
+
+//! Height moved into a tile from one neighbor. Positive when material slides in from the neighbor.
+static float TalusTransfer(float height, float neighbor) {
+    float slideIn = std::max(neighbor - height - TALUS_THRESHOLD, 0.0F);
+    float slideOut = std::max(height - neighbor - TALUS_THRESHOLD, 0.0F);
+    return slideIn - slideOut;
+}
+
+//! Thermal relaxation of a single row. Gathers the material that slides in from, or out to, the four neighbors.
+//! Tiles outside of the map are clamped to the edge, so they are the same height as the tile, and nothing slides over
+//! the edge.
+static void RelaxRow(const Math::StencilRow<float>& row, float* p_out) {
+
+    // using the same operations in the same order as TalusTransfer, so the vector and scalar paths give equal results.
+    using namespace Math::Simd;
+    const Float4 threshold = Splat(TALUS_THRESHOLD);
+    const Float4 rate = Splat(TALUS_RATE);
+    const Float4 zero = Splat(0.0F);
+
+    auto transfer = [&](Float4 height, Float4 neighbor) {
+        Float4 slideIn = Max(neighbor - height - threshold, zero);
+        Float4 slideOut = Max(height - neighbor - threshold, zero);
+        return slideIn - slideOut;
+    };
+
+    const ptrdiff_t width = static_cast<ptrdiff_t>(row.width);
+    const float* p_row = row.p_center;
+
+    ptrdiff_t xCoord = 0;
+    for (; xCoord + static_cast<ptrdiff_t>(FLOAT4_WIDTH) <= width; xCoord += static_cast<ptrdiff_t>(FLOAT4_WIDTH)) {
+        Float4 height = Load(p_row + xCoord);
+        Float4 sum = transfer(height, Load(p_row + xCoord - 1)) + transfer(height, Load(p_row + xCoord + 1)) +
+                     transfer(height, Load(row.p_north + xCoord)) + transfer(height, Load(row.p_south + xCoord));
+        Store(p_out + xCoord, height + (rate * sum));
+    }
+
+    for (; xCoord < width; xCoord++) {
+        float height = p_row[xCoord];
+        float sum = TalusTransfer(height, p_row[xCoord - 1]) + TalusTransfer(height, p_row[xCoord + 1]) +
+                    TalusTransfer(height, row.p_north[xCoord]) + TalusTransfer(height, row.p_south[xCoord]);
+        p_out[xCoord] = height + (TALUS_RATE * sum);
+    }
+}
+
+//! Relax slopes steeper than the talus angle. Double buffered, so every tile can be updated in parallel.
+static void RunThermalErosion(HeightField& field, std::vector<float>& scratch) {
+
+    const glm::uvec2 extent(static_cast<uint32_t>(field.width), static_cast<uint32_t>(field.height));
+    scratch.resize(field.heights.size());
+
+    for (int32_t sweep = 0; sweep < THERMAL_SWEEPS_PER_ITERATION; sweep++) {
+
+        float* p_out = scratch.data();
+        Math::ForEachStencilRow(field.heights.data(), extent, Math::StencilEdge::CLAMP,
+            [&](const Math::StencilRow<float>& row) {
+                RelaxRow(row, p_out + row.first_index);
+            });
+
+        field.heights.swap(scratch);
+    }
+}
+
+//! Run one round of droplets, one droplet for each tile in the map.
+static void RunHydraulicErosion(HeightField& field, const Math::RandomStream& rng, int32_t iteration, Core::ThreadPool& pool) {
+
+    // droplets sample the tile to their south east, so they cannot start in the last row or column. Leaving that row
+    // and column out of the blocks keeps the last block from being empty when the size is one more than a multiple of
+    // the block size.
+    const int32_t blocksX = (field.width - 1 + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const int32_t blocksY = (field.height - 1 + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const uint64_t numBlocks = static_cast<uint64_t>(blocksX) * static_cast<uint64_t>(blocksY);
+    const uint64_t dropletsPerBlock = static_cast<uint64_t>(BLOCK_SIZE) * static_cast<uint64_t>(BLOCK_SIZE);
+
+    for (int32_t color = 0; color < NUM_BLOCK_COLORS; color++) {
+
+        // gather the blocks of this color.
+        std::vector<int32_t> blocks;
+        for (int32_t blockY = color / 2; blockY < blocksY; blockY += 2) {
+            for (int32_t blockX = color % 2; blockX < blocksX; blockX += 2) {
+                blocks.push_back((blockY * blocksX) + blockX);
+            }
+        }
+
+        pool.ParallelFor(blocks.size(), 1U, [&](size_t begin, size_t end) {
+            for (size_t blockIndex = begin; blockIndex < end; blockIndex++) {
+
+                int32_t block = blocks[blockIndex];
+                float originX = static_cast<float>((block % blocksX) * BLOCK_SIZE);
+                float originY = static_cast<float>((block / blocksX) * BLOCK_SIZE);
+                float sizeX = std::min(static_cast<float>(BLOCK_SIZE), static_cast<float>(field.width - 1) - originX);
+                float sizeY = std::min(static_cast<float>(BLOCK_SIZE), static_cast<float>(field.height - 1) - originY);
+
+                uint64_t firstDroplet = ((static_cast<uint64_t>(iteration) * numBlocks) + static_cast<uint64_t>(block)) * dropletsPerBlock;
+                for (uint64_t droplet = 0U; droplet < dropletsPerBlock; droplet++) {
+                    uint64_t index = (firstDroplet + droplet) * 2U;
+                    SimulateDroplet(field, originX + rng.Range(index, 0.0F, sizeX), originY + rng.Range(index + 1U, 0.0F, sizeY));
+                }
+            }
+        });
+    }
+}
+
+void RunErosionPass(World& world, const WorldParams& params) {
+
+    const int32_t iterations = static_cast<int32_t>(params.GetErosionIterations());
+    Extent_t extent = world.GetSize();
+
+    if ((iterations <= 0) || (extent.x < 2U) || (extent.y < 2U)) {
+        return;
+    }
+
+    HeightField field;
+    field.width = static_cast<int32_t>(extent.x);
+    field.height = static_cast<int32_t>(extent.y);
+    world.GetTileHeights(field.heights);
+    for (float& height : field.heights) {
+        height *= TILE_PER_METER_F32;
+    }
+
+    Core::ThreadPool& pool = Core::ThreadPool::GetInstance();
+    Math::RandomStream rng(params.GetSeed(), RNG_STREAM_EROSION_DROPLETS);
+    std::vector<float> scratch;
+
+    for (int32_t iteration = 0; iteration < iterations; iteration++) {
+        RunHydraulicErosion(field, rng, iteration, pool);
+        RunThermalErosion(field, scratch);
+    }
+
+    for (float& height : field.heights) {
+        height = std::max(height * TILE_SIZE_METERS_F32, 0.0F);
+    }
+    world.SetTileHeights(field.heights);
+}
+
+} // namespace World::Passes
@@ -1,16 +1,13 @@
 #include "Passes.hpp"
 
 #include "world/Tile.hpp"
+#include "world/TileBlocks.hpp"
+#include "world/TileColumns.hpp"
 #include "world/Region.hpp"
 #include "world/World.hpp"
 #include <algorithm>
 #include <glm/geometric.hpp>
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
 #include <limits>
-#include <queue>
-#include <set>
-#include <unordered_set>
 #include <iostream>
 
 namespace World::Passes {
@@ -254,237 +251,43 @@ void IdentifyRiverRegions(std::vector<Region>& regions) {
     }
 }
 
-//! A* node for pathfinding
-struct PathNode {
-    Coordinate_t coord;
-    float g_cost;  // Cost from start
-    float h_cost;  // Heuristic cost to goal
-    float f_cost;  // Total cost (g + h)
-    Coordinate_t parent;
-    bool operator>(const PathNode& other) const {
-        return f_cost > other.f_cost;
-    }
-};
-
-//! Trace river path using A* algorithm that prefers downhill paths
-//! Returns set of tile IDs that form the path, or empty set if no path found
-std::set<TileId_t> TraceRiverPathAStar(World& world, Coordinate_t start_coord, Coordinate_t end_coord) {
-    int32_t iterations = 100U;
-    std::set<TileId_t> result_path;
-    auto& tiles = world.GetTiles();
-    const Extent_t world_size = world.GetSize();
-
-    // A* pathfinding
-    std::priority_queue<PathNode, std::vector<PathNode>, std::greater<PathNode>> frontier; // the set of nodes to explor next.
-    std::unordered_set<Coordinate_t> visited; // set of nodes that have already been visited. These cannot be added back to frontier.
-    std::unordered_map<Coordinate_t, Coordinate_t> came_from; // Used to trace the cheapest path from end point to start point.
-
-    PathNode start_node{start_coord, 0.0F, 0.0F, 0.0F, start_coord};
-    start_node.h_cost = glm::distance(glm::vec2(start_coord.x, start_coord.y), glm::vec2(end_coord.x, end_coord.y));
-    start_node.f_cost = start_node.h_cost;
-    frontier.push(start_node);
-
-    const std::vector<glm::ivec2> neighbors_offsets = {
-        {1, 0}, {-1, 0}, {0, 1}, {0, -1},      // Cardinal directions
-        {1, 1}, {1, -1}, {-1, 1}, {-1, -1}     // Diagonal directions
-    };
-
-    while (!frontier.empty() && (iterations >= 0)) {
-        PathNode current = frontier.top();
-        frontier.pop();
-
-        if (current.coord.x == end_coord.x && current.coord.y == end_coord.y) {
-            // Found the goal, reconstruct path
-            Coordinate_t path_coord = end_coord;
-            while (path_coord.x != start_coord.x || path_coord.y != start_coord.y) {
-                TileId_t tile_id = world.CoordinateToTileId(path_coord);
-                result_path.insert(tile_id);
-                auto it = came_from.find({path_coord.x, path_coord.y});
-                if (it != came_from.end()) {
-                    path_coord = it->second;
-                } else {
-                    result_path.clear();
-                    break;
-                }
-            }
-
-            // Done, so let's return.
-            break;
-        }
-
-        visited.insert({current.coord.x, current.coord.y});
-
-        // Check all neighbors
-        for (const auto& offset : neighbors_offsets) {
-            Coordinate_t neighbor_coord{
-                static_cast<int>(current.coord.x) + static_cast<int>(offset.x),
-                static_cast<int>(current.coord.y) + static_cast<int>(offset.y)
-            };
-
-            // Check bounds
-            if (neighbor_coord.x >= world_size.x || neighbor_coord.y >= world_size.y) {
-                continue;
-            }
-
-            // Check if in closed set
-            if (visited.count({neighbor_coord.x, neighbor_coord.y}) > 0U) {
-                continue;
-            }
-
-            TileId_t current_tile_id = world.CoordinateToTileId(current.coord);
-            TileId_t neighbor_tile_id = world.CoordinateToTileId(neighbor_coord);
-
-            const Tile& current_tile = tiles[current_tile_id];
-            const Tile& neighbor_tile = tiles[neighbor_tile_id];
-
-            // Movement cost: diagonal moves cost more, and going downhill costs less
-            float move_cost = (offset.x != 0 && offset.y != 0) ? 1.414F : 1.0F;  // Diagonal = sqrt(2)
-
-            float height_diff = current_tile.GetAbsoluteHeight() - neighbor_tile.GetAbsoluteHeight();
-            // Reward going downhill (reduce cost), penalize going uphill (increase cost)
-            move_cost += height_diff * -0.1F;  // Negative because we want to reward downhill
-
-            float g_cost = current.g_cost + move_cost;
-            float h_cost = glm::distance(glm::vec2(neighbor_coord.x, neighbor_coord.y), glm::vec2(end_coord.x, end_coord.y));
-            float f_cost = g_cost + h_cost;
-
-            PathNode neighbor_node{neighbor_coord, g_cost, h_cost, f_cost, current.coord};
-            frontier.push(neighbor_node);
-            came_from[{neighbor_coord.x, neighbor_coord.y}] = current.coord;
-        }
-
-        iterations--;
-    }
-
-    return result_path;  // Empty set if no path found
-}
-
-//! Trace river path using Bresenham's line algorithm as fallback
-//! Returns set of tile IDs that form the path
-std::set<TileId_t> TraceRiverPathBresenham(World& world, Coordinate_t start_coord, Coordinate_t end_coord) {
-    std::set<TileId_t> result_path;
-    const Extent_t world_size = world.GetSize();
-
-    int x0 = start_coord.x;
-    int y0 = start_coord.y;
-    int x1 = end_coord.x;
-    int y1 = end_coord.y;
-
-    int dx = std::abs(static_cast<int>(x1) - static_cast<int>(x0));
-    int dy = std::abs(static_cast<int>(y1) - static_cast<int>(y0));
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dx - dy;
-
-    while (true) {
-        if (x0 >= 0 && x0 < static_cast<int>(world_size.x) && y0 >= 0 && y0 < static_cast<int>(world_size.y)) {
-            TileId_t tile_id = world.CoordinateToTileId({x0, y0});
-            result_path.insert(tile_id);
-        }
-
-        if (x0 == static_cast<int>(x1) && y0 == static_cast<int>(y1)) {
-            break;
-        }
-
-        int e2 = 2 * err;
-        if (e2 > -static_cast<int>(dy)) {
-            err -= dy;
-            x0 += sx;
-        }
-        if (e2 < static_cast<int>(dx)) {
-            err += dx;
-            y0 += sy;
-        }
-    }
-
-    return result_path;
-}
-
-//! Trace river path between two positions, preferring A* pathfinding with Bresenham fallback
-void TraceTileLineRiver(World& world, glm::vec2 start_pos, glm::vec2 end_pos) {
-    auto& tiles = world.GetTiles();
-    const Extent_t world_size = world.GetSize();
-
-    // Convert world positions to tile coordinates
-    Coordinate_t start_coord(
-        start_pos.x / TILE_SIZE_METERS_S32,
-        start_pos.y / TILE_SIZE_METERS_S32
-    );
-    Coordinate_t end_coord(
-        end_pos.x / TILE_SIZE_METERS_S32,
-        end_pos.y / TILE_SIZE_METERS_S32
-    );
-
-    // Clamp to world bounds
-    start_coord.x = glm::clamp(start_coord.x, 0U, world_size.x - 1U);
-    start_coord.y = glm::clamp(start_coord.y, 0U, world_size.y - 1);
-    end_coord.x = glm::clamp(end_coord.x, 0U, world_size.x - 1);
-    end_coord.y = glm::clamp(end_coord.y, 0U, world_size.y - 1);
-
-    // Try A* pathfinding first
-    std::set<TileId_t> river_path = TraceRiverPathAStar(world, start_coord, end_coord);
-
-    // Fallback to Bresenham if A* didn't find a path
-    if (river_path.empty()) {
-        river_path = TraceRiverPathBresenham(world, start_coord, end_coord);
-    }
-
-    // Mark all tiles in the path as rivers
-    for (TileId_t tile_id : river_path) {
-        Tile& tile = tiles[tile_id];
-        if (!tile.GetIsWater()) {
-            tile.SetIsRiver(true);
-        }
-    }
-}
-
 //! Map region-level water features to individual tiles
 void MapRegionWaterFeaturesToTiles(World& world) {
-    auto& tiles = world.GetTiles();
     const auto& regions = world.GetRegions();
+    const HeightEncoding& encoding = world.GetHeightEncoding();
+    TileColumns& columns = world.GetTileColumns();
+    const RegionId_t* p_regionIds = columns.GetRegionIds();
+    uint16_t* p_waterLevels = columns.GetWaterLevels();
+    uint8_t* p_flags = columns.GetFlags();
+
+    // Map oceans and lakes to all tiles in those regions, a block of tiles at a time. Rivers are traced over the
+    // tiles later, by BuildRiverNetwork.
+    ForEachTileBlock(world.GetSize(), DEFAULT_TILE_BLOCK_SIZE, 0U, [&](const TileBlock& block) {
+        for (uint32_t y = block.min.y; y < block.max.y; y++) {
+            for (uint32_t x = block.min.x; x < block.max.x; x++) {
+
+                TileId_t tile_id = world.CoordinateToTileId({x, y});
+                RegionId_t region_id = p_regionIds[tile_id];
+
+                if (region_id == INVALID_REGION_ID) {
+                    continue;
+                }
 
-    // First pass: map oceans and lakes to all tiles in those regions
-    for (auto& tile : tiles) {
-        RegionId_t region_id = tile.GetRegionId();
-
-        if (region_id == INVALID_REGION_ID) {
-            continue;
-        }
-
-        const Region& region = regions[region_id];
-
-        // Map region water properties to tile
-        if (region.GetIsOcean()) {
-            tile.SetIsWater(true);
-            tile.SetWaterLevel(region.GetWaterLevel());
-        }
-
-        if (region.GetIsLake()) {
-            tile.SetIsLake(true);
-            tile.SetIsWater(true);
-            tile.SetWaterLevel(region.GetWaterLevel());
-        }
-    }
-
-    // Second pass: trace river lines along flow directions
-    for (size_t region_idx = 0; region_idx < regions.size(); ++region_idx) {
-        const Region& region = regions[region_idx];
+                const Region& region = regions[region_id];
 
-        if (!region.GetHasRiver()) {
-            continue;
-        }
+                // Map region water properties to tile
+                if (region.GetIsOcean()) {
+                    p_flags[tile_id] |= TILE_FLAG_WATER;
+                    p_waterLevels[tile_id] = encoding.Encode(region.GetWaterLevel());
+                }
 
-        RegionId_t flow_target = region.GetFlowDirection();
-        if (flow_target == INVALID_REGION_ID) {
-            continue;
+                if (region.GetIsLake()) {
+                    p_flags[tile_id] |= (TILE_FLAG_LAKE | TILE_FLAG_WATER);
+                    p_waterLevels[tile_id] = encoding.Encode(region.GetWaterLevel());
+                }
+            }
         }
-
-        // Trace a line of river tiles from this region's centroid to the target region's centroid
-        glm::vec2 start_pos = region.GetCentroid();
-        glm::vec2 end_pos = regions[flow_target].GetCentroid();
-
-        TraceTileLineRiver(world, start_pos, end_pos);
-    }
+    });
 }
 
 void RunHydrologyPass(World& world, const WorldParams& params) {
@@ -514,6 +317,12 @@ void RunHydrologyPass(World& world, const WorldParams& params) {
 
     // Step 1g: Map region-level features to tiles
     MapRegionWaterFeaturesToTiles(world);
+
+    // Step 1h: Label drainage basins, now that the ocean tiles are known
+    LabelBasins(world);
+
+    // Step 1i: Build the river network, flowing through the lakes of the basins
+    BuildRiverNetwork(world);
 }
 
 }  // namespace World::Passes
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "Passes.hpp"
+
+#include "core/ThreadPool.hpp"
+#include "math/Random.hpp"
+#include "world/Geology.hpp"
+#include "world/Region.hpp"
+#include "world/TectonicPlate.hpp"
+#include "world/World.hpp"
+#include "world/WorldParams.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World::Passes {
+
+//! Random numbers drawn for each region are taken from their own range of the geology stream, so that regions can be
+//! generated in any order.
+static constexpr uint64_t DRAWS_PER_REGION = 64U;
+
+//! Regions processed by each task.
+static constexpr size_t REGIONS_PER_TASK = 64U;
+
+//! Moisture above which lowland sediment forms coal, and below which it forms salt.
+static constexpr float COAL_MOISTURE = 60.0F;
+static constexpr float SALT_MOISTURE = 20.0F;
+
+//! Builds the layers under a single region, from the surface down.
+class ColumnBuilder {
+
+    public:
+
+        ColumnBuilder(const Math::RandomStream& rng, RegionId_t region_id, std::vector<GeologyLayer>& layers)
+            : m_rng(rng)
+            , m_first_draw(static_cast<uint64_t>(region_id) * DRAWS_PER_REGION)
+            , m_layers(layers) {
+        }
+
+        //! Draw a random number in [min, max). Draws past the range of the region repeat the last one.
+        float Range(float min, float max) {
+            uint64_t draw = std::min(m_draw, DRAWS_PER_REGION - 1U);
+            m_draw++;
+            return m_rng.Range(m_first_draw + draw, min, max);
+        }
+
+        //! Draw true with a probability.
+        bool Chance(float probability) {
+            return Range(0.0F, 1.0F) < probability;
+        }
+
+        //! Add a layer below the previous one. Layers thinner than a meter, or below MAX_DEPTH, are dropped.
+        void Add(float thickness, RockType rock, ResourceType resource = ResourceType::NONE) {
+            m_depth = std::min(m_depth + std::max(thickness, 0.0F), static_cast<float>(Geology::MAX_DEPTH));
+            uint16_t bottom = static_cast<uint16_t>(std::round(m_depth));
+            uint16_t top = m_layers.empty() ? 0U : m_layers.back().bottom_depth;
+            if (bottom > top) {
+                m_layers.push_back({bottom, rock, resource});
+            }
+        }
+
+        //! Add a layer of rock, which may hold a thin seam of a resource somewhere in the middle of it.
+        void AddWithSeam(float thickness, RockType rock, ResourceType resource, float probability) {
+            if ((resource == ResourceType::NONE) || !Chance(probability)) {
+                Add(thickness, rock);
+                return;
+            }
+
+            float seam = Range(2.0F, 20.0F);
+            float above = Range(0.0F, std::max(thickness - seam, 0.0F));
+            Add(above, rock);
+            Add(seam, rock, resource);
+            Add(thickness - seam - above, rock);
+        }
+
+        //! Fill the rest of the column down to MAX_DEPTH.
+        void Fill(RockType rock, ResourceType resource = ResourceType::NONE) {
+            Add(static_cast<float>(Geology::MAX_DEPTH), rock, resource);
+        }
+
+    private:
+
+        const Math::RandomStream& m_rng;
+        uint64_t m_first_draw;
+        uint64_t m_draw {0U};
+        float m_depth {0.0F};
+        std::vector<GeologyLayer>& m_layers;
+};
+
+//! Ore found in the metamorphic rock of mountain ranges.
+static ResourceType ChooseMountainOre(ColumnBuilder& column) {
+    static constexpr std::array<ResourceType, 5> ORES = {
+        ResourceType::IRON, ResourceType::COPPER, ResourceType::SILVER, ResourceType::GOLD, ResourceType::GEMS};
+    return ORES[static_cast<size_t>(column.Range(0.0F, static_cast<float>(ORES.size()))) % ORES.size()];
+}
+
+//! Lay down sedimentary rock, as found on lowlands and ocean floors.
+static void AddSediment(ColumnBuilder& column, const Region& region, float max_thickness) {
+
+    const bool isWet = region.GetMoisture() >= COAL_MOISTURE;
+    const bool isDry = region.GetMoisture() <= SALT_MOISTURE;
+
+    int32_t numLayers = static_cast<int32_t>(column.Range(2.0F, 5.0F));
+    for (int32_t layer = 0; layer < numLayers; layer++) {
+
+        float thickness = column.Range(0.1F, 0.4F) * max_thickness;
+        switch (static_cast<int32_t>(column.Range(0.0F, 3.0F))) {
+            case 0:
+                column.AddWithSeam(thickness, RockType::SANDSTONE, ResourceType::IRON, 0.15F);
+                break;
+            case 1:
+                column.AddWithSeam(thickness, RockType::SHALE, isWet ? ResourceType::COAL : ResourceType::NONE, 0.5F);
+                break;
+            default:
+                column.AddWithSeam(thickness, RockType::LIMESTONE, isDry ? ResourceType::SALT : ResourceType::NONE, 0.5F);
+                break;
+        }
+    }
+}
+
+//! Generate the layers under a single region.
+static void GenerateColumn(const World& world, const Region& region, ColumnBuilder& column) {
+
+    const bool isContinental = world.GetPlate(region.GetPlateId()).GetIsContinental();
+    const PlateBoundaryType boundaryType = region.GetPlateBoundaryType().first;
+
+    // a. surface cover.
+    if (region.GetIsOcean() || region.GetIsLake()) {
+        column.Add(column.Range(5.0F, 50.0F), RockType::SAND);
+    } else if (region.GetIsMountain()) {
+        column.Add(column.Range(0.0F, 1.0F), RockType::SOIL);
+    } else {
+        column.Add(1.0F + (column.Range(0.0F, 4.0F) * region.GetMoisture() / 100.0F), RockType::SOIL);
+    }
+
+    // b. sediment collects where the land is low, and is worn off of mountains.
+    if (!region.GetIsMountain()) {
+        AddSediment(column, region, region.GetIsOcean() ? 200.0F : 600.0F);
+    }
+
+    // c. rock formed at plate boundaries.
+    switch (boundaryType) {
+        case PlateBoundaryType::CONVERGENT:
+            if (region.GetHasSubduction()) {
+                // volcanic arc above the subducting plate.
+                column.AddWithSeam(column.Range(100.0F, 400.0F), RockType::OBSIDIAN, ResourceType::GOLD, 0.2F);
+                column.AddWithSeam(column.Range(200.0F, 800.0F), RockType::BASALT, ResourceType::COPPER, 0.6F);
+            } else {
+                // folded mountain range. Draws are kept out of argument lists, which are evaluated in no fixed order.
+                float slateThickness = column.Range(200.0F, 600.0F);
+                ResourceType slateOre = ChooseMountainOre(column);
+                column.AddWithSeam(slateThickness, RockType::SLATE, slateOre, 0.5F);
+
+                float marbleThickness = column.Range(200.0F, 800.0F);
+                ResourceType marbleOre = ChooseMountainOre(column);
+                column.AddWithSeam(marbleThickness, RockType::MARBLE, marbleOre, 0.5F);
+            }
+            break;
+
+        case PlateBoundaryType::DIVERGENT:
+            column.AddWithSeam(column.Range(300.0F, 1200.0F), RockType::BASALT, ResourceType::IRON, 0.5F);
+            break;
+
+        case PlateBoundaryType::TRANSFORM:
+            column.AddWithSeam(column.Range(200.0F, 800.0F), RockType::GRANITE, ResourceType::TIN, 0.4F);
+            column.AddWithSeam(column.Range(100.0F, 400.0F), RockType::GRANITE, ResourceType::COPPER, 0.3F);
+            break;
+
+        case PlateBoundaryType::NONE:
+            if (region.GetIsMountain()) {
+                float slateThickness = column.Range(200.0F, 600.0F);
+                ResourceType slateOre = ChooseMountainOre(column);
+                column.AddWithSeam(slateThickness, RockType::SLATE, slateOre, 0.3F);
+            }
+            break;
+    }
+
+    // d. basement rock.
+    if (isContinental) {
+        column.AddWithSeam(column.Range(500.0F, 1500.0F), RockType::GRANITE, ResourceType::SILVER, 0.1F);
+        column.Fill(RockType::GRANITE);
+    } else {
+        column.AddWithSeam(column.Range(500.0F, 1500.0F), RockType::BASALT, ResourceType::IRON, 0.1F);
+        column.Fill(RockType::BASALT);
+    }
+}
+
+void RunMineralPass(World& world, const WorldParams& params) {
+
+    const std::vector<Region>& regions = world.GetRegions();
+    const Math::RandomStream rng(params.GetSeed(), RNG_STREAM_GEOLOGY);
+
+    std::vector<std::vector<GeologyLayer>> regionLayers(regions.size());
+    Core::ThreadPool::GetInstance().ParallelFor(regions.size(), REGIONS_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t regionId = begin; regionId < end; regionId++) {
+            ColumnBuilder column(rng, static_cast<RegionId_t>(regionId), regionLayers[regionId]);
+            GenerateColumn(world, regions[regionId], column);
+        }
+    });
+
+    world.SetGeology(Geology(regionLayers));
+}
+
+} // namespace World::Passes
@@ -25,7 +25,22 @@ namespace World::Passes {
     //       or edge of region. Tiles closer to edge should blend with height of closest neighboring region.
     void RunElevationPass(World& world, const WorldParams& params);
 
-    // 3. Generate hydrology (oceans, rivers, and lakes)
+    // 3. Optionally simulate plate tectonics over a number of time steps, starting from the assigned elevation.
+    //    a. Move the crust of each plate one step along the plate velocity.
+    //    b. Where plates collide, fold continental crust into the crust it runs into, and subduct oceanic crust.
+    //    c. Where plates rift apart, fill the gap with new oceanic crust.
+    //    d. Spread thick crust across its plate, and wear down crust that rises high above the mantle.
+    //    e. Set tile heights from the crust thickness (isostasy), and region heights from their tiles.
+    void RunTectonicSimulationPass(World& world, const WorldParams& params);
+
+    // 4. Erode the terrain, to carve valleys into the elevation produced by noise.
+    //    a. Simulate droplets of rain that erode material as they flow downhill, and deposit it as they slow down.
+    //       Droplets run in blocks, so that blocks far enough apart can be eroded in parallel, deterministically.
+    //    b. Relax slopes steeper than the talus angle, by sliding material down to lower neighbors.
+    //    c. Repeat for the number of iterations given by the world parameters.
+    void RunErosionPass(World& world, const WorldParams& params);
+
+    // 5. Generate hydrology (oceans, rivers, and lakes)
     //    a. Determine ocean level based on world parameters and elevation distribution
     //    b. Mark all tiles below ocean level as water
     //    c. For each tile above ocean level, calculate flow direction to the lowest adjacent neighbor
@@ -33,15 +48,49 @@ namespace World::Passes {
     //    e. Identify and mark lakes at local minima (terrain depressions that collect water)
     //    f. Identify and mark rivers as tiles with sufficient accumulated water flow
     //    g. Set water level for each water tile (ocean level or lake level)
+    //    h. Label the drainage basin of every tile (LabelBasins).
+    //    i. Build the river network (BuildRiverNetwork).
     void RunHydrologyPass(World& world, const WorldParams& params);
 
-    // 4. Generate climate (temperature, moisture)
+    //    Label the drainage basin of every land tile, by following the steepest slope down from each tile to the pit or
+    //    ocean tile it drains to. Basins are then flooded from their lowest rim up, merging nested basins into a
+    //    single lake, to find the spill point, water level and volume of every lake. Only depends on tile heights and
+    //    water flags, so it is also used to label the basins of worlds as they are loaded.
+    void LabelBasins(World& world);
+
+    //    Build the river network from the area drained through each tile, following the steepest slope down, and
+    //    through lakes from the pit of each basin to its outlet. Tiles that drain enough land hold a river, which is
+    //    split into segments at each confluence, ordered by the Strahler number of each segment. Sets the river flag
+    //    of the tiles, and needs the basins from LabelBasins.
+    void BuildRiverNetwork(World& world);
+
+    // 6. Generate climate (temperature, moisture)
     //    a. Assign temperatures based on proximity to poles and elevation.
     //    b. Assign moisture based on proximity to water.
+    //    c. Optionally replace both with the climate simulated by the atmosphere (SimulateAtmosphere).
+    //    d. Use a Whittaker diagram to assign a biome to each region from its temperature and moisture.
+    //    e. Assign a biome to each tile (AssignTileBiomes).
     void RunClimatePass(World& world, const WorldParams& params);
 
-    // 5. Generate geological layers for each region, which determine availability of various resources
-    void MineralPass(World& world, const WorldParams& params);
+    //    Simulate the atmosphere on a coarse grid over the world, for a fixed number of steps. Prevailing winds for
+    //    each band of latitude carry moisture evaporated from the water, and heat from ocean currents, over the land.
+    //    Rain falls where the air is forced up mountains or cools below the moisture it holds, leaving rain shadows
+    //    behind them. Sets the temperature of each region, and the moisture of each land region from the rain that
+    //    falls on it.
+    void SimulateAtmosphere(World& world);
+
+    //    Assign a biome to each tile from its own temperature, and moisture blended between nearby regions. The climate
+    //    of each tile is sampled at a position jittered by noise, so that biomes do not follow region borders. Used on
+    //    its own to fill in the tile biomes of worlds saved before they were stored.
+    void AssignTileBiomes(World& world, const WorldParams& params);
+
+    // 7. Generate geological layers for each region, which determine availability of various resources
+    //    a. Cover land with soil, thinner on mountains and thicker where it is wet.
+    //    b. Lay down sediment on lowlands and ocean floors. Coal forms in wet lowlands, salt in dry ones.
+    //    c. Add metamorphic rock and ore veins where plates converge, volcanic rock where they subduct or rift, and
+    //       faulted rock where they slide past each other.
+    //    d. Fill the rest of the column with granite under continents, or basalt under oceans.
+    void RunMineralPass(World& world, const WorldParams& params);
 
 
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "Passes.hpp"
+#include "Drainage.hpp"
+
+#include "core/ThreadPool.hpp"
+#include "world/Basin.hpp"
+#include "world/RiverNetwork.hpp"
+#include "world/TileColumns.hpp"
+#include "world/World.hpp"
+#include "world/WorldParams.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace World::Passes {
+
+//! Tiles processed by each task, for passes that visit every tile on its own.
+static constexpr size_t TILES_PER_TASK = 16384U;
+
+//! Number of tiles that must drain through a tile for it to hold a river.
+static constexpr uint32_t RIVER_MIN_AREA = 128U;
+
+//! Area of a tile, in km^2.
+static constexpr float TILE_AREA_KM2 = TILE_SIZE_METERS_F32 * TILE_SIZE_METERS_F32 * 1.0E-6F;
+
+//! Width of a river, in meters, for each square root of the area it drains in km^2. Rivers widen with the square root
+//! of their flow, and flow grows with the area drained.
+static constexpr float RIVER_WIDTH_PER_SQRT_KM2 = 2.0F;
+
+//! @brief Count the tiles that drain through each tile, including itself.
+//!
+//! Tiles are visited from the sources down, each once all of the tiles that drain into it have been.
+static std::vector<uint32_t> AccumulateDrainageArea(const std::vector<TileId_t>& receivers) {
+
+    std::vector<uint32_t> numDonors(receivers.size(), 0U);
+    for (size_t tileId = 0U; tileId < receivers.size(); tileId++) {
+        if (receivers[tileId] != tileId) {
+            numDonors[receivers[tileId]]++;
+        }
+    }
+
+    std::vector<TileId_t> ready;
+    for (size_t tileId = 0U; tileId < receivers.size(); tileId++) {
+        if (numDonors[tileId] == 0U) {
+            ready.push_back(static_cast<TileId_t>(tileId));
+        }
+    }
+
+    std::vector<uint32_t> areas(receivers.size(), 1U);
+    while (!ready.empty()) {
+
+        TileId_t tileId = ready.back();
+        ready.pop_back();
+
+        TileId_t receiver = receivers[tileId];
+        if (receiver != tileId) {
+            areas[receiver] += areas[tileId];
+            if (--numDonors[receiver] == 0U) {
+                ready.push_back(receiver);
+            }
+        }
+    }
+
+    return areas;
+}
+
+//! @brief Set the Strahler order of every segment.
+//!
+//! Segments at a source have order one. Below a confluence, the order is the highest order flowing in, plus one if
+//! more than one segment flowing in has it.
+static void AssignStrahlerOrders(std::vector<RiverSegment>& segments) {
+
+    std::vector<uint32_t> numUpstream(segments.size(), 0U);
+    for (const RiverSegment& segment : segments) {
+        if (segment.downstream != INVALID_RIVER_ID) {
+            numUpstream[segment.downstream]++;
+        }
+    }
+
+    std::vector<uint8_t> maxOrders(segments.size(), 0U);
+    std::vector<uint8_t> numMaxOrders(segments.size(), 0U);
+    std::vector<RiverId_t> ready;
+    for (size_t segmentId = 0U; segmentId < segments.size(); segmentId++) {
+        if (numUpstream[segmentId] == 0U) {
+            ready.push_back(static_cast<RiverId_t>(segmentId));
+        }
+    }
+
+    while (!ready.empty()) {
+
+        RiverId_t segmentId = ready.back();
+        ready.pop_back();
+
+        RiverSegment& segment = segments[segmentId];
+        segment.order = (maxOrders[segmentId] == 0U) ? 1U
+                      : static_cast<uint8_t>(maxOrders[segmentId] + ((numMaxOrders[segmentId] > 1U) ? 1U : 0U));
+
+        if (segment.downstream == INVALID_RIVER_ID) {
+            continue;
+        }
+
+        RiverId_t downstream = segment.downstream;
+        if (segment.order > maxOrders[downstream]) {
+            maxOrders[downstream] = segment.order;
+            numMaxOrders[downstream] = 1U;
+        } else if (segment.order == maxOrders[downstream]) {
+            numMaxOrders[downstream]++;
+        }
+
+        if (--numUpstream[downstream] == 0U) {
+            ready.push_back(downstream);
+        }
+    }
+}
+
+void BuildRiverNetwork(World& world) {
+
+    TileColumns& columns = world.GetTileColumns();
+    const Extent_t extent = world.GetSize();
+    const size_t numTiles = columns.GetSize();
+    uint8_t* p_flags = columns.GetFlags();
+
+    // a. water flows down the steepest slope, and out of the pit of a basin through the outlet of its lake.
+    std::vector<TileId_t> receivers = FindDrainageReceivers(GetDrainageSurface(world), extent);
+    for (const Basin& basin : world.GetBasins()) {
+        if (basin.outlet != INVALID_TILE_ID) {
+            receivers[basin.pit] = basin.outlet;
+        }
+    }
+
+    // b. rivers are the land tiles that enough of the land drains through.
+    const std::vector<uint32_t> areas = AccumulateDrainageArea(receivers);
+    auto isRiver = [&](TileId_t tileId) {
+        return (areas[tileId] >= RIVER_MIN_AREA) && !IsOceanTile(p_flags[tileId]);
+    };
+
+    std::vector<uint32_t> numRiverDonors(numTiles, 0U);
+    for (TileId_t tileId = 0U; tileId < numTiles; tileId++) {
+        const TileId_t receiver = receivers[tileId];
+        if ((receiver != tileId) && isRiver(tileId) && isRiver(receiver)) {
+            numRiverDonors[receiver]++;
+        }
+    }
+
+    // c. a segment starts at each source and confluence, and follows the river down to the next confluence, or to
+    //    the ocean.
+    std::vector<RiverSegment> segments;
+    std::vector<uint32_t> pointOffsets = {0U};
+    std::vector<TileId_t> points;
+    std::vector<TileId_t> segmentEnds;
+    std::vector<RiverId_t> headSegments(numTiles, INVALID_RIVER_ID);
+
+    for (TileId_t head = 0U; head < numTiles; head++) {
+
+        if (!isRiver(head) || (numRiverDonors[head] == 1U)) {
+            continue;
+        }
+
+        headSegments[head] = static_cast<RiverId_t>(segments.size());
+        points.push_back(head);
+
+        TileId_t last = head;
+        TileId_t tileId = head;
+        while (receivers[tileId] != tileId) {
+
+            tileId = receivers[tileId];
+            points.push_back(tileId);
+            if (!isRiver(tileId) || (numRiverDonors[tileId] != 1U)) {
+                break;
+            }
+            last = tileId;
+        }
+
+        const float flow = static_cast<float>(areas[last]) * TILE_AREA_KM2;
+        RiverSegment& segment = segments.emplace_back();
+        segment.flow = flow;
+        segment.width = RIVER_WIDTH_PER_SQRT_KM2 * std::sqrt(flow);
+        pointOffsets.push_back(static_cast<uint32_t>(points.size()));
+        segmentEnds.push_back(tileId);
+    }
+
+    for (size_t segmentId = 0U; segmentId < segments.size(); segmentId++) {
+        const TileId_t end = segmentEnds[segmentId];
+        segments[segmentId].downstream = (end == points[pointOffsets[segmentId]]) ? INVALID_RIVER_ID : headSegments[end];
+    }
+    AssignStrahlerOrders(segments);
+
+    // d. river tiles are flagged for the code that works a tile at a time. Water tiles already show the water.
+    Core::ThreadPool::GetInstance().ParallelFor(numTiles, TILES_PER_TASK, [&](size_t begin, size_t end) {
+        for (size_t tileId = begin; tileId < end; tileId++) {
+            const bool isRiverTile =
+                isRiver(static_cast<TileId_t>(tileId)) && ((p_flags[tileId] & TILE_FLAG_WATER) == 0U);
+            p_flags[tileId] = isRiverTile ? static_cast<uint8_t>(p_flags[tileId] | TILE_FLAG_RIVER)
+                                          : static_cast<uint8_t>(p_flags[tileId] & ~TILE_FLAG_RIVER);
+        }
+    });
+
+    world.SetRivers(RiverNetwork(extent.x, std::move(segments), std::move(pointOffsets), std::move(points)));
+}
+
+} // namespace World::Passes
@@ -0,0 +1,340 @@
+#include "Passes.hpp"
+
+#include "world/Region.hpp"
+#include "world/TectonicPlate.hpp"
+#include "world/TileBlocks.hpp"
+#include "world/TileColumns.hpp"
+#include "world/World.hpp"
+#include "world/WorldParams.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <glm/common.hpp>
+#include <vector>
+
+namespace World::Passes {
+
+// The crust is simulated on a grid with one cell per tile. Every kernel gathers from the previous state of the grid
+// into a second copy, so each cell is written by exactly one block, and the result does not depend on the number of
+// threads or the order blocks run in.
+
+//! Edge length of the blocks the kernels run on. Smaller than the default, so that even small worlds are split over
+//! every thread.
+static constexpr uint32_t SIMULATION_BLOCK_SIZE = 64U;
+
+//! Distance that plates travel over the whole simulation, as a fraction of the world dimension. More steps simulate
+//! the same drift at a finer time step.
+static constexpr float TOTAL_DRIFT = 0.25F;
+
+//! Airy isostasy. Crust floats on the mantle, so only the fraction (1 - crust density / mantle density) of its
+//! thickness rises above the surface of the mantle.
+static constexpr float CRUST_DENSITY = 2800.0F;
+static constexpr float MANTLE_DENSITY = 3300.0F;
+static constexpr float FREEBOARD = 1.0F - (CRUST_DENSITY / MANTLE_DENSITY);
+
+//! Elevation of the surface of the mantle, in meters. Places the heights from the elevation pass on crust a few tens
+//! of kilometers thick.
+static constexpr float MANTLE_ELEVATION = -4000.0F;
+
+//! Thickness of the oceanic crust formed where plates rift apart, in meters. Floats at about the height of the oceanic
+//! plates from the elevation pass.
+static constexpr float RIFT_THICKNESS = 33000.0F;
+
+//! Fraction of the thickness of colliding continental crust that is folded into the crust it runs into.
+static constexpr float COLLISION_ACCRETION = 0.15F;
+
+//! Fraction of the thickness of subducted oceanic crust that is added to the overriding crust, as volcanic arcs.
+static constexpr float SUBDUCTION_ACCRETION = 0.02F;
+
+//! Fraction of the difference in thickness to each neighbor on the same plate that flows to it, for each cell the
+//! plates drift. Must be at most 1/4 for four neighbors, or the crust oscillates.
+static constexpr float CRUST_FLOW_RATE = 0.1F;
+
+//! Elevation above which crust is worn down, in meters, and the fraction of the excess removed for each cell the
+//! plates drift.
+static constexpr float DENUDATION_ELEVATION = 2000.0F;
+static constexpr float DENUDATION_RATE = 0.02F;
+
+//! Elevation, in meters, that the highest tile of a region must reach for the region to be considered mountainous.
+//! Ranges pushed up by collisions are narrow, so the average height of a region says little.
+static constexpr float MOUNTAIN_ELEVATION = 3000.0F;
+
+//! State of the crust for every cell of the grid.
+struct CrustGrid {
+    std::vector<PlateId_t> plate_ids;
+    std::vector<float> thickness;
+    std::vector<uint8_t> is_continental;
+
+    void Resize(size_t size) {
+        plate_ids.resize(size);
+        thickness.resize(size);
+        is_continental.resize(size);
+    }
+
+    void Swap(CrustGrid& other) {
+        plate_ids.swap(other.plate_ids);
+        thickness.swap(other.thickness);
+        is_continental.swap(other.is_continental);
+    }
+};
+
+//! Movement of a plate during a single step, as the index of the offset in the 3x3 neighborhood of a cell, row by
+//! row. MOVE_NONE is the center, so the plate stays in place.
+using MoveCode_t = uint8_t;
+static constexpr MoveCode_t MOVE_NONE = 4U;
+static constexpr int32_t NUM_MOVES = 9;
+
+static float ThicknessToElevation(float thickness) {
+    return MANTLE_ELEVATION + (thickness * FREEBOARD);
+}
+
+static float ElevationToThickness(float elevation) {
+    return std::max((elevation - MANTLE_ELEVATION) / FREEBOARD, 0.0F);
+}
+
+//! Initialize the crust from the heights assigned by the elevation pass, with each cell on the plate of its region.
+static void InitializeCrust(const World& world, CrustGrid& crust) {
+
+    const std::vector<Region>& regions = world.GetRegions();
+    const std::vector<TectonicPlate>& plates = world.GetPlates();
+    const RegionId_t* p_regionIds = world.GetTileColumns().GetRegionIds();
+
+    std::vector<float> heights;
+    world.GetTileHeights(heights);
+    crust.Resize(heights.size());
+
+    for (size_t cell = 0U; cell < heights.size(); cell++) {
+        PlateId_t plateId = regions.at(p_regionIds[cell]).GetPlateId();
+        crust.plate_ids[cell] = plateId;
+        crust.thickness[cell] = ElevationToThickness(heights[cell]);
+        crust.is_continental[cell] = plates.at(plateId).GetIsContinental() ? 1U : 0U;
+    }
+}
+
+//! Calculate the movement of each plate during a step. Plates move in a straight line, and are snapped to whole cells,
+//! so that crust moves rigidly with its plate.
+static void CalculatePlateMoves(const std::vector<TectonicPlate>& plates, float speed, size_t step,
+                                std::vector<MoveCode_t>& moves) {
+
+    moves.resize(plates.size());
+    for (size_t plateId = 0U; plateId < plates.size(); plateId++) {
+        glm::vec2 velocity = plates[plateId].GetVelocity() * speed;
+        glm::vec2 move = glm::floor(velocity * static_cast<float>(step + 1U)) - glm::floor(velocity * static_cast<float>(step));
+        moves[plateId] = static_cast<MoveCode_t>(MOVE_NONE + static_cast<int32_t>(move.x) + (3 * static_cast<int32_t>(move.y)));
+    }
+}
+
+//! Determine whether crust arriving at a cell stays on the surface, when other crust arrives at the same cell.
+//! Continental crust is too buoyant to subduct, otherwise the thicker crust overrides. Ties go to the lower plate, so
+//! the result does not depend on the order arrivals are found.
+static bool Overrides(const CrustGrid& crust, size_t cell, size_t other) {
+    if (crust.is_continental[cell] != crust.is_continental[other]) {
+        return crust.is_continental[cell] > crust.is_continental[other];
+    }
+    if (crust.thickness[cell] != crust.thickness[other]) {
+        return crust.thickness[cell] > crust.thickness[other];
+    }
+    return crust.plate_ids[cell] < crust.plate_ids[other];
+}
+
+//! Move the crust of every plate, then resolve cells that no crust, or crust from several plates, arrived at.
+static void AdvectCrust(Extent_t extent, const std::vector<MoveCode_t>& moves, const CrustGrid& crust,
+                        std::vector<MoveCode_t>& cell_moves, CrustGrid& out) {
+
+    // look up the move of every cell once, so the gather below reads neighboring bytes rather than plates.
+    ForEachTileBlock(extent, SIMULATION_BLOCK_SIZE, 0U, [&](const TileBlock& block) {
+        const PlateId_t* p_plateIds = crust.plate_ids.data();
+        const MoveCode_t* p_moves = moves.data();
+        MoveCode_t* p_cellMoves = cell_moves.data();
+
+        for (uint32_t y = block.min.y; y < block.max.y; y++) {
+            for (uint32_t x = block.min.x; x < block.max.x; x++) {
+                const size_t cell = (static_cast<size_t>(y) * extent.x) + x;
+                p_cellMoves[cell] = p_moves[p_plateIds[cell]];
+            }
+        }
+    });
+
+    // crust can only arrive from the cell itself or its eight neighbors, since plates move at most one cell. Crust
+    // arrives if its move is the offset from its cell to this one.
+    const int64_t width = static_cast<int64_t>(extent.x);
+    const std::array<int64_t, NUM_MOVES> moveOffsets = {
+        -width - 1, -width, -width + 1,
+        -1, 0, 1,
+        width - 1, width, width + 1};
+
+    ForEachTileBlock(extent, SIMULATION_BLOCK_SIZE, 1U, [&](const TileBlock& block) {
+        // byte stores may alias anything, so keep the arrays in locals rather than reading them through the grids.
+        const PlateId_t* p_plateIds = crust.plate_ids.data();
+        const float* p_thickness = crust.thickness.data();
+        const uint8_t* p_isContinental = crust.is_continental.data();
+        const MoveCode_t* p_cellMoves = cell_moves.data();
+        PlateId_t* p_outPlateIds = out.plate_ids.data();
+        float* p_outThickness = out.thickness.data();
+        uint8_t* p_outIsContinental = out.is_continental.data();
+
+        for (uint32_t y = block.min.y; y < block.max.y; y++) {
+            for (uint32_t x = block.min.x; x < block.max.x; x++) {
+
+                const size_t cell = (static_cast<size_t>(y) * extent.x) + x;
+                const bool isInterior = (x > 0U) && (y > 0U) && (x + 1U < extent.x) && (y + 1U < extent.y);
+                size_t survivor = SIZE_MAX;
+                float accreted = 0.0F;
+
+                for (int32_t move = 0; move < NUM_MOVES; move++) {
+
+                    if (!isInterior) {
+                        int32_t sourceX = static_cast<int32_t>(x) + 1 - (move % 3);
+                        int32_t sourceY = static_cast<int32_t>(y) + 1 - (move / 3);
+                        if ((sourceX < static_cast<int32_t>(block.halo_min.x)) || (sourceX >= static_cast<int32_t>(block.halo_max.x)) ||
+                            (sourceY < static_cast<int32_t>(block.halo_min.y)) || (sourceY >= static_cast<int32_t>(block.halo_max.y))) {
+                            continue;
+                        }
+                    }
+
+                    const size_t source = static_cast<size_t>(static_cast<int64_t>(cell) - moveOffsets[move]);
+                    if (p_cellMoves[source] != move) {
+                        continue;
+                    }
+
+                    if (survivor == SIZE_MAX) {
+                        survivor = source;
+                        continue;
+                    }
+
+                    // collision. The crust that is overridden is either folded into the survivor, or subducted.
+                    size_t consumed = source;
+                    if (Overrides(crust, source, survivor)) {
+                        std::swap(survivor, consumed);
+                    }
+                    accreted += p_thickness[consumed] *
+                        (p_isContinental[consumed] != 0U ? COLLISION_ACCRETION : SUBDUCTION_ACCRETION);
+                }
+
+                if (survivor == SIZE_MAX) {
+                    // plates rifted apart, and new oceanic crust wells up behind the plate that left.
+                    p_outPlateIds[cell] = p_plateIds[cell];
+                    p_outThickness[cell] = RIFT_THICKNESS;
+                    p_outIsContinental[cell] = 0U;
+                } else {
+                    p_outPlateIds[cell] = p_plateIds[survivor];
+                    p_outThickness[cell] = p_thickness[survivor] + accreted;
+                    p_outIsContinental[cell] = p_isContinental[survivor];
+                }
+            }
+        }
+    });
+}
+
+//! Spread thick crust to neighbors on the same plate, and wear down crust that rises high above the mantle. Only the
+//! thickness changes, so only the thickness is double buffered.
+static void RelaxCrust(Extent_t extent, float speed, const CrustGrid& crust, std::vector<float>& out_thickness) {
+
+    // rates are scaled by the drift of each step, so the result barely depends on the number of steps.
+    const float flowRate = CRUST_FLOW_RATE * speed;
+    const float denudationRate = DENUDATION_RATE * speed;
+
+    ForEachTileBlock(extent, SIMULATION_BLOCK_SIZE, 1U, [&](const TileBlock& block) {
+        const PlateId_t* p_plateIds = crust.plate_ids.data();
+        const float* p_thickness = crust.thickness.data();
+        float* p_outThickness = out_thickness.data();
+
+        for (uint32_t y = block.min.y; y < block.max.y; y++) {
+            for (uint32_t x = block.min.x; x < block.max.x; x++) {
+
+                const size_t cell = (static_cast<size_t>(y) * extent.x) + x;
+                const PlateId_t plateId = p_plateIds[cell];
+                const float thickness = p_thickness[cell];
+
+                auto flowFrom = [&](size_t neighbor) {
+                    return (p_plateIds[neighbor] == plateId) ? p_thickness[neighbor] - thickness : 0.0F;
+                };
+
+                float flow = 0.0F;
+                flow += (x > block.halo_min.x) ? flowFrom(cell - 1U) : 0.0F;
+                flow += (x + 1U < block.halo_max.x) ? flowFrom(cell + 1U) : 0.0F;
+                flow += (y > block.halo_min.y) ? flowFrom(cell - extent.x) : 0.0F;
+                flow += (y + 1U < block.halo_max.y) ? flowFrom(cell + extent.x) : 0.0F;
+
+                float relaxed = thickness + (flowRate * flow);
+                float excess = ThicknessToElevation(relaxed) - DENUDATION_ELEVATION;
+                if (excess > 0.0F) {
+                    relaxed -= (excess * denudationRate) / FREEBOARD;
+                }
+
+                p_outThickness[cell] = relaxed;
+            }
+        }
+    });
+}
+
+//! Set tile heights from the simulated crust, and region heights to the average height of their tiles.
+static void ApplyCrust(World& world, const CrustGrid& crust) {
+
+    std::vector<float> heights(crust.thickness.size());
+    for (size_t cell = 0U; cell < heights.size(); cell++) {
+        heights[cell] = ThicknessToElevation(crust.thickness[cell]);
+    }
+    world.SetTileHeights(heights);
+
+    std::vector<Region>& regions = world.GetRegions();
+    std::vector<double> heightSums(regions.size(), 0.0);
+    std::vector<float> maxHeights(regions.size(), MANTLE_ELEVATION);
+    std::vector<size_t> tileCounts(regions.size(), 0U);
+    const RegionId_t* p_regionIds = world.GetTileColumns().GetRegionIds();
+    for (size_t cell = 0U; cell < heights.size(); cell++) {
+        RegionId_t regionId = p_regionIds[cell];
+        heightSums[regionId] += heights[cell];
+        maxHeights[regionId] = std::max(maxHeights[regionId], heights[cell]);
+        tileCounts[regionId]++;
+    }
+
+    for (size_t regionId = 0U; regionId < regions.size(); regionId++) {
+        if (tileCounts[regionId] == 0U) {
+            continue;
+        }
+
+        regions[regionId].SetAbsoluteHeight(static_cast<float>(heightSums[regionId] / static_cast<double>(tileCounts[regionId])));
+        regions[regionId].SetIsMountain(maxHeights[regionId] >= MOUNTAIN_ELEVATION);
+    }
+}
+
+void RunTectonicSimulationPass(World& world, const WorldParams& params) {
+
+    const Extent_t extent = world.GetSize();
+    if ((params.GetTectonicSteps() == 0U) || (extent.x == 0U) || (extent.y == 0U)) {
+        return;
+    }
+
+    const std::vector<TectonicPlate>& plates = world.GetPlates();
+
+    // plates move at most one cell per step, so that crust only needs to be gathered from neighboring cells. Large
+    // worlds take more steps than asked for where needed, so that plates still drift the whole distance.
+    const float drift = TOTAL_DRIFT * static_cast<float>(params.GetDimension());
+    const size_t steps = std::max(params.GetTectonicSteps(), static_cast<size_t>(std::ceil(drift)));
+    const float speed = std::min(drift / static_cast<float>(steps), 1.0F);
+
+    CrustGrid crust;
+    CrustGrid scratch;
+    InitializeCrust(world, crust);
+    scratch.Resize(crust.thickness.size());
+
+    std::vector<MoveCode_t> moves;
+    std::vector<MoveCode_t> cellMoves(crust.thickness.size());
+    for (size_t step = 0U; step < steps; step++) {
+
+        CalculatePlateMoves(plates, speed, step, moves);
+
+        AdvectCrust(extent, moves, crust, cellMoves, scratch);
+        crust.Swap(scratch);
+
+        RelaxCrust(extent, speed, crust, scratch.thickness);
+        crust.thickness.swap(scratch.thickness);
+    }
+
+    ApplyCrust(world, crust);
+}
+
+} // namespace World::Passes
@@ -1,5 +1,6 @@
 #include "Passes.hpp"
 
+#include "math/Random.hpp"
 #include "math/Voronoi.hpp"
 #include "world/TectonicPlate.hpp"
 #include <cstddef>
@@ -8,7 +9,6 @@
 #include <glm/ext/scalar_constants.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/polar_coordinates.hpp>
-#include <random>
 
 namespace World::Passes {
 
@@ -28,17 +28,18 @@ void RunTectonicsPass(World& world, const WorldParams& params) {
         numPlates,
         canvasSize,
         params.GetDimension(),
-        params.GetSeed());
+        params.GetSeed(),
+        RNG_STREAM_PLATE_SEEDS);
     Math::VoronoiGraph regionsGraph = Math::VoronoiGenerator::Generate(
         numRegions,
         canvasSize,
         params.GetDimension(),
-        params.GetSeed());
-    std::mt19937 rng;
-    rng.seed(params.GetSeed());
+        params.GetSeed(),
+        RNG_STREAM_REGION_SEEDS);
 
     // plate movement distribution
-    std::uniform_real_distribution<float> uniform_dist_angle(0.0F, 2.0F * glm::pi<float>());
+    Math::RandomStream plateVelocityRng(params.GetSeed(), RNG_STREAM_PLATE_VELOCITY);
+    Math::RandomStream continentRng(params.GetSeed(), RNG_STREAM_CONTINENTS);
     std::vector<PlateId_t> chooseFrom;
     chooseFrom.reserve(plates.size());
 
@@ -47,7 +48,7 @@ void RunTectonicsPass(World& world, const WorldParams& params) {
 
         TectonicPlate plate(world, platesGraph.m_centroids.at(plateId));
 
-        float angle = uniform_dist_angle(rng);
+        float angle = plateVelocityRng.Range(plateId, 0.0F, 2.0F * glm::pi<float>());
         glm::vec2 velocity = glm::euclidean(glm::vec2(1.0F, angle));
 
         velocity = glm::normalize(velocity);
@@ -61,9 +62,7 @@ void RunTectonicsPass(World& world, const WorldParams& params) {
     size_t numContinents = 0U;
     while ((numContinents < params.GetNumContinents()) && !chooseFrom.empty()) {
 
-        std::uniform_int_distribution<size_t> uniform_dist_choice(0U, chooseFrom.size() -1);
-
-        int32_t chooseFromIndex = static_cast<int32_t>(uniform_dist_choice(rng));
+        int32_t chooseFromIndex = static_cast<int32_t>(continentRng.Below(numContinents, static_cast<uint32_t>(chooseFrom.size())));
         PlateId_t plateId = chooseFrom.at(chooseFromIndex);
         chooseFrom.erase(chooseFrom.begin() + chooseFromIndex);
 
@@ -74,10 +73,10 @@ void RunTectonicsPass(World& world, const WorldParams& params) {
     // Determine boundary types
     for (int32_t plateId =  0; plateId < numPlates; plateId++) {
 
-        std::vector<PlateId_t> neighbors = platesGraph.m_adjacency.at(plateId);
-
         TectonicPlate& plateA = plates.at(plateId);
-        for (PlateId_t neighborId : neighbors) {
+        for (Math::GraphNode_t neighbor : platesGraph.m_adjacency.GetNeighbors(plateId)) {
+
+            PlateId_t neighborId = static_cast<PlateId_t>(neighbor);
 
             // Determine boundar type
             if (!plateA.HasBoundary(neighborId)) {
@@ -94,7 +93,8 @@ void RunTectonicsPass(World& world, const WorldParams& params) {
     // Create regions
     for (int32_t regionId = 0; regionId < numRegions; regionId++) {
 
-        std::vector<RegionId_t> neighbors = regionsGraph.m_adjacency.at(regionId);
+        Math::GraphRange<const Math::GraphNode_t> adjacent = regionsGraph.m_adjacency.GetNeighbors(regionId);
+        std::vector<RegionId_t> neighbors(adjacent.begin(), adjacent.end());
         Region region(world, regionsGraph.m_centroids.at(regionId),  std::move(neighbors));
 
         // determine plate membership of region
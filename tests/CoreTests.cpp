@@ -0,0 +1,180 @@
+#include "Test.hpp"
+#include "core/NameGenerator.hpp"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t SEED = 7U;
+    constexpr size_t NUM_NAMES = 256U;
+    constexpr size_t MAX_CHARACTERS = 16U;
+
+    const std::vector<std::string> TRAINING_NAMES = {
+        "Aldmere", "Brightwater", "Caldera", "Dunmoor", "Eastwatch", "Fallowmere", "Greystone", "Highmoor",
+        "Ironwood", "Kingsbridge", "Lowmere", "Marshwood", "Northwatch", "Oakridge", "Redwater", "Stonebridge"};
+
+    //! Directory holding the names file and its cache, emptied before every case.
+    std::filesystem::path GetTestDirectory() {
+        return std::filesystem::temp_directory_path() / "SimulationGameNames";
+    }
+
+    std::filesystem::path GetNamesPath() {
+        return GetTestDirectory() / "names.json";
+    }
+
+    std::filesystem::path GetCachePath() {
+        return GetTestDirectory() / "names.Test.cache";
+    }
+
+    void WriteFile(const std::filesystem::path& path, const std::string& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    std::string ReadFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    //! Write a names file with a single list of names, under the key "Test".
+    void WriteNames(const std::vector<std::string>& names) {
+        std::string json = "{\"Test\": [";
+        for (size_t index = 0U; index < names.size(); index++) {
+            json += ((index == 0U) ? "\"" : ", \"") + names[index] + "\"";
+        }
+        WriteFile(GetNamesPath(), json + "]}");
+    }
+
+    void ResetTestDirectory(const std::vector<std::string>& names) {
+        std::filesystem::remove_all(GetTestDirectory());
+        std::filesystem::create_directories(GetTestDirectory());
+        WriteNames(names);
+    }
+
+    std::vector<std::string> GenerateNames(Core::NameGenerator& generator) {
+        const Core::NameBatch batch = generator.Generate(NUM_NAMES, MAX_CHARACTERS);
+        std::vector<std::string> names;
+        for (size_t index = 0U; index < batch.GetCount(); index++) {
+            names.emplace_back(batch.GetName(index));
+        }
+        return names;
+    }
+
+    //! Load the names file, and generate names with a fixed seed.
+    std::vector<std::string> LoadAndGenerate() {
+        Core::NameGenerator generator = Core::NameGenerator::Load(GetNamesPath().string(), "Test", SEED);
+        return GenerateNames(generator);
+    }
+
+    //! Mark the cache as written long ago, so that a later write to it can be seen.
+    std::filesystem::file_time_type AgeCache() {
+        const std::filesystem::file_time_type time = std::filesystem::last_write_time(GetCachePath()) -
+                                                     std::chrono::hours(1);
+        std::filesystem::last_write_time(GetCachePath(), time);
+        return time;
+    }
+}
+
+static void TestSameSeedGivesSameNames() {
+
+    Core::NameGenerator first(2, SEED);
+    Core::NameGenerator second(2, SEED);
+    Core::NameGenerator other(2, SEED + 1U);
+    first.Train(TRAINING_NAMES);
+    second.Train(TRAINING_NAMES);
+    other.Train(TRAINING_NAMES);
+
+    const std::vector<std::string> names = GenerateNames(first);
+    TEST_CHECK(names.size() == NUM_NAMES);
+    TEST_CHECK(names == GenerateNames(second));
+    TEST_CHECK(names != GenerateNames(other));
+
+    // names only continue with characters that followed the same characters in training.
+    bool namesFitTraining = true;
+    for (const std::string& name : names) {
+        namesFitTraining = namesFitTraining && (name.size() <= MAX_CHARACTERS) && !name.empty() &&
+                           (name.front() >= 'A') && (name.front() <= 'S');
+    }
+    TEST_CHECK(namesFitTraining);
+
+    // training again replaces the model, rather than adding to it.
+    first.Train({"Zz"});
+    TEST_CHECK(first.Generate(MAX_CHARACTERS) == "Zz");
+}
+
+static void TestCacheReadsBackTheTrainedModel() {
+
+    ResetTestDirectory(TRAINING_NAMES);
+
+    // the first load trains, and writes the cache.
+    const std::vector<std::string> trainedNames = LoadAndGenerate();
+    TEST_CHECK(std::filesystem::exists(GetCachePath()));
+    const std::string cache = ReadFile(GetCachePath());
+
+    // the second load reads the cache, without writing it again, and generates the same names from the same seed.
+    const std::filesystem::file_time_type cacheTime = AgeCache();
+    TEST_CHECK(LoadAndGenerate() == trainedNames);
+    TEST_CHECK(std::filesystem::last_write_time(GetCachePath()) == cacheTime);
+    TEST_CHECK(ReadFile(GetCachePath()) == cache);
+}
+
+static void TestDamagedCacheFallsBackToTraining() {
+
+    ResetTestDirectory(TRAINING_NAMES);
+    const std::vector<std::string> trainedNames = LoadAndGenerate();
+    const std::string cache = ReadFile(GetCachePath());
+
+    // a cache cut short, one with an index out of range, and one of another version, are each trained again and
+    // written over with the trained model.
+    std::string badIndex = cache;
+    badIndex.replace(badIndex.size() - sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), '\xFF');
+    std::string badVersion = cache;
+    badVersion[sizeof(uint32_t)]++;
+
+    for (const std::string& damaged : {cache.substr(0U, cache.size() / 2U), badIndex, badVersion}) {
+        WriteFile(GetCachePath(), damaged);
+        const std::filesystem::file_time_type damagedTime = AgeCache();
+        TEST_CHECK(LoadAndGenerate() == trainedNames);
+        TEST_CHECK(std::filesystem::last_write_time(GetCachePath()) != damagedTime);
+        TEST_CHECK(ReadFile(GetCachePath()) == cache);
+    }
+}
+
+static void TestStaleCacheFallsBackToTraining() {
+
+    ResetTestDirectory(TRAINING_NAMES);
+    LoadAndGenerate();
+    const std::string staleCache = ReadFile(GetCachePath());
+
+    // changing the names makes the cache stale, so the new names are trained on.
+    const std::vector<std::string> newNames = {"Quill", "Quarry", "Quay", "Quince"};
+    WriteNames(newNames);
+    const std::vector<std::string> names = LoadAndGenerate();
+    TEST_CHECK(ReadFile(GetCachePath()) != staleCache);
+
+    bool namesAreNew = true;
+    for (const std::string& name : names) {
+        namesAreNew = namesAreNew && (name.rfind("Qu", 0U) == 0U);
+    }
+    TEST_CHECK(namesAreNew);
+
+    // the rewritten cache holds the model of the new names.
+    TEST_CHECK(LoadAndGenerate() == names);
+
+    std::filesystem::remove_all(GetTestDirectory());
+}
+
+int main() {
+
+    return Test::Run({
+        {"name generators with the same seed generate the same names", TestSameSeedGivesSameNames},
+        {"name generator cache reads back the trained model", TestCacheReadsBackTheTrainedModel},
+        {"damaged name generator cache falls back to training", TestDamagedCacheFallsBackToTraining},
+        {"stale name generator cache falls back to training", TestStaleCacheFallsBackToTraining},
+    });
+}
@@ -0,0 +1,369 @@
+#include "Test.hpp"
+#include "core/ThreadPool.hpp"
+#include "ecs/ArchetypeStorage.hpp"
+#include "ecs/ECS.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    struct Position {
+        float x {0.0F};
+        float y {0.0F};
+    };
+
+    struct Velocity {
+        float x {0.0F};
+        float y {0.0F};
+    };
+
+    //! Not trivially copyable, so it is moved and destroyed through its constructors.
+    struct Name {
+        std::string value;
+    };
+
+    //! Counts how many instances are alive, to catch components that are leaked or destroyed twice.
+    struct Counted {
+        static inline int s_num_alive {0};
+
+        int value {0};
+
+        Counted() {
+            s_num_alive++;
+        }
+
+        Counted(Counted&& other) noexcept
+            : value(other.value) {
+            s_num_alive++;
+        }
+
+        Counted(const Counted& other) = delete;
+        Counted& operator=(const Counted& other) = delete;
+        Counted& operator=(Counted&& other) = delete;
+
+        ~Counted() {
+            s_num_alive--;
+        }
+    };
+
+    //! Order that systems finished in, within a frame.
+    std::atomic<int> s_next_finish {0};
+
+    //! Number of systems updating at once, and the most seen at once.
+    std::atomic<int> s_num_running {0};
+    std::atomic<int> s_max_running {0};
+
+    //! System that records when and where it ran. Each Index is a different system type.
+    template<int Index>
+    class RecordingSystem : public ECS::System {
+
+        public:
+
+            void Update() override {
+
+                int running = ++s_num_running;
+                int maxRunning = s_max_running.load();
+                while ((running > maxRunning) && !s_max_running.compare_exchange_weak(maxRunning, running)) {
+                }
+
+                thread = std::this_thread::get_id();
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                finish = s_next_finish++;
+                s_num_running--;
+
+                if (fail) {
+                    throw std::runtime_error("system failed");
+                }
+            }
+
+            std::thread::id thread;
+            int finish {-1};
+            bool fail {false};
+    };
+
+    template<int Index>
+    RecordingSystem<Index>& AddRecordingSystem(ECS::Registry& registry) {
+        registry.RegisterSystem(std::make_unique<RecordingSystem<Index>>());
+        return registry.GetSystem<RecordingSystem<Index>>();
+    }
+
+    ECS::ArchetypeStorage MakeStorage() {
+        ECS::ArchetypeStorage storage;
+        storage.RegisterComponent<Position>();
+        storage.RegisterComponent<Velocity>();
+        storage.RegisterComponent<Name>();
+        storage.RegisterComponent<Counted>();
+        return storage;
+    }
+}
+
+static void TestMoveBetweenArchetypes() {
+
+    ECS::ArchetypeStorage storage = MakeStorage();
+
+    storage.Add<Position>(1U, {1.0F, 2.0F});
+    storage.Add<Name>(1U, {"first"});
+    storage.Add<Position>(2U, {3.0F, 4.0F});
+    TEST_CHECK(storage.GetSize() == 2U);
+
+    // adding a component moves the entity, and the one left behind takes its row.
+    storage.Add<Velocity>(1U, {5.0F, 6.0F});
+    TEST_CHECK(storage.Has<Velocity>(1U));
+    TEST_CHECK(storage.Get<Position>(1U).y == 2.0F);
+    TEST_CHECK(storage.Get<Name>(1U).value == "first");
+    TEST_CHECK(storage.Get<Velocity>(1U).x == 5.0F);
+    TEST_CHECK(storage.Get<Position>(2U).x == 3.0F);
+
+    // removing one moves it back, keeping the components both archetypes have.
+    storage.Remove<Position>(1U);
+    TEST_CHECK(!storage.Has<Position>(1U));
+    TEST_CHECK(storage.Get<Name>(1U).value == "first");
+    TEST_CHECK(storage.Get<Velocity>(1U).y == 6.0F);
+    TEST_CHECK(storage.GetSignature(1U) ==
+               (storage.GetComponentSignature<Name>() | storage.GetComponentSignature<Velocity>()));
+
+    // an entity left without components is erased.
+    storage.Remove<Position>(2U);
+    TEST_CHECK(!storage.Contains(2U));
+    TEST_CHECK(storage.GetSize() == 1U);
+
+    bool threw = false;
+    try {
+        storage.Add<Name>(1U, {"again"});
+    }
+    catch (const ECS::Exception&) {
+        threw = true;
+    }
+    TEST_CHECK(threw);
+}
+
+static void TestChunkIteration() {
+
+    ECS::ArchetypeStorage storage = MakeStorage();
+
+    // enough entities to fill several chunks, split between two archetypes.
+    const ECS::EntityID_t numEntities = 3000U;
+    for (ECS::EntityID_t entity = 0U; entity < numEntities; entity++) {
+        storage.Add<Position>(entity, {static_cast<float>(entity), 0.0F});
+        storage.Add<Velocity>(entity, {1.0F, 0.0F});
+        if ((entity % 3U) == 0U) {
+            storage.Add<Name>(entity, {std::to_string(entity)});
+        }
+    }
+
+    // erase some entities, so that rows are filled from the end of their archetype.
+    for (ECS::EntityID_t entity = 0U; entity < numEntities; entity += 7U) {
+        storage.Erase(entity);
+    }
+
+    size_t numChunks = 0U;
+    std::set<ECS::EntityID_t> visited;
+    storage.ForEachChunk<Position, const Velocity>([&](ECS::ArchetypeChunk<Position, const Velocity>& chunk) {
+
+        TEST_CHECK(chunk.GetSize() > 0U);
+        const ECS::EntityID_t* p_entities = chunk.GetEntities();
+        Position* p_positions = chunk.GetColumn<Position>();
+        const Velocity* p_velocities = chunk.GetColumn<const Velocity>();
+        for (size_t row = 0U; row < chunk.GetSize(); row++) {
+            TEST_CHECK(p_positions[row].x == static_cast<float>(p_entities[row]));
+            p_positions[row].x += p_velocities[row].x;
+            TEST_CHECK(visited.insert(p_entities[row]).second);
+        }
+        numChunks++;
+    });
+
+    const size_t numErased = (numEntities + 6U) / 7U;
+    TEST_CHECK(visited.size() == numEntities - numErased);
+    TEST_CHECK(numChunks > 2U);
+    TEST_CHECK(storage.Get<Position>(1U).x == 2.0F);
+
+    size_t numUnnamed = 0U;
+    storage.ForEach<const Position>(
+        ECS::Exclude<Name>(), [&](ECS::EntityID_t entity, const Position& position) {
+            TEST_CHECK((entity % 3U) != 0U);
+            TEST_CHECK(position.x == static_cast<float>(entity) + 1.0F);
+            numUnnamed++;
+        });
+
+    size_t expectedUnnamed = 0U;
+    for (ECS::EntityID_t entity = 0U; entity < numEntities; entity++) {
+        if (((entity % 3U) != 0U) && ((entity % 7U) != 0U)) {
+            expectedUnnamed++;
+        }
+    }
+    TEST_CHECK(numUnnamed == expectedUnnamed);
+}
+
+static void TestComponentLifetimes() {
+
+    {
+        ECS::ArchetypeStorage storage = MakeStorage();
+        for (ECS::EntityID_t entity = 0U; entity < 100U; entity++) {
+            storage.Emplace<Counted>(entity).value = static_cast<int>(entity);
+            if ((entity % 2U) == 0U) {
+                storage.Add<Position>(entity, {});
+            }
+        }
+        TEST_CHECK(Counted::s_num_alive == 100);
+
+        storage.Remove<Counted>(10U);
+        storage.Erase(11U);
+        TEST_CHECK(Counted::s_num_alive == 98);
+        TEST_CHECK(storage.Get<Counted>(12U).value == 12);
+
+        // assigning over a storage destroys the components it held.
+        ECS::ArchetypeStorage other = MakeStorage();
+        other.Emplace<Counted>(0U);
+        TEST_CHECK(Counted::s_num_alive == 99);
+        storage = std::move(other);
+        TEST_CHECK(Counted::s_num_alive == 1);
+        TEST_CHECK(storage.GetSize() == 1U);
+    }
+
+    TEST_CHECK(Counted::s_num_alive == 0);
+}
+
+static void TestRegistryErasesDestroyedEntities() {
+
+    ECS::Registry registry;
+    ECS::ArchetypeStorage& storage = registry.GetArchetypeStorage();
+    storage.RegisterComponent<Position>();
+
+    ECS::EntityID_t kept = registry.CreateEntity();
+    ECS::EntityID_t destroyed = registry.CreateEntity();
+    storage.Add<Position>(kept, {});
+    storage.Add<Position>(destroyed, {});
+
+    registry.DestroyEntity(destroyed);
+    TEST_CHECK(!storage.Contains(destroyed));
+    TEST_CHECK(storage.Contains(kept));
+    TEST_CHECK(&registry.GetArchetypeStorage() == &storage);
+}
+
+static void TestParallelSchedule() {
+
+    Core::ThreadPool pool(4U);
+    Core::ThreadPool::ScopedInstance scopedPool(pool);
+
+    ECS::Registry registry;
+    registry.RegisterComponent<Position>();
+    registry.RegisterComponent<Velocity>();
+    registry.RegisterComponent<Name>();
+    const ECS::Signature_t position = registry.GetComponentSignature<Position>();
+    const ECS::Signature_t velocity = registry.GetComponentSignature<Velocity>();
+    const ECS::Signature_t name = registry.GetComponentSignature<Name>();
+
+    // 0 writes positions, which 1 reads. 2 writes velocities, which 3 reads on the main thread along with names. 4
+    // writes names, and depends on 0.
+    auto& writePositions = AddRecordingSystem<0>(registry);
+    auto& readPositions = AddRecordingSystem<1>(registry);
+    auto& writeVelocities = AddRecordingSystem<2>(registry);
+    auto& readOnMain = AddRecordingSystem<3>(registry);
+    auto& writeNames = AddRecordingSystem<4>(registry);
+    registry.SetSystemAccess<RecordingSystem<0>>({}, position, ECS::SystemAffinity::ANY_THREAD);
+    registry.SetSystemAccess<RecordingSystem<1>>(position, {}, ECS::SystemAffinity::ANY_THREAD);
+    registry.SetSystemAccess<RecordingSystem<2>>({}, velocity, ECS::SystemAffinity::ANY_THREAD);
+    registry.SetSystemAccess<RecordingSystem<3>>(velocity | name, {}, ECS::SystemAffinity::MAIN_THREAD);
+    registry.SetSystemAccess<RecordingSystem<4>>({}, name, ECS::SystemAffinity::ANY_THREAD);
+    registry.SetSystemDependency<RecordingSystem<4>, RecordingSystem<0>>();
+
+    // threads are not guaranteed to pick up work in any one frame, so look for parallelism over several.
+    uint32_t maxLanes = 0U;
+    s_max_running = 0;
+    for (int frame = 0; frame < 20; frame++) {
+
+        s_next_finish = 0;
+        registry.Update();
+
+        TEST_CHECK(writePositions.finish < readPositions.finish);
+        TEST_CHECK(writeVelocities.finish < readOnMain.finish);
+        TEST_CHECK(writePositions.finish < writeNames.finish);
+        TEST_CHECK((readOnMain.finish < writeNames.finish) || (writeNames.finish < readOnMain.finish));
+        TEST_CHECK(readOnMain.thread == std::this_thread::get_id());
+
+        const ECS::ScheduleTrace& trace = registry.GetScheduleTrace();
+        TEST_CHECK(trace.systems.size() == 5U);
+        for (const ECS::SystemTrace& system : trace.systems) {
+            TEST_CHECK((system.thread == std::this_thread::get_id()) == (system.lane == 0U));
+        }
+        maxLanes = std::max(maxLanes, trace.num_lanes);
+    }
+
+    TEST_CHECK(maxLanes > 1U);
+    TEST_CHECK(s_max_running.load() > 1);
+}
+
+static void TestUndeclaredSystemsRunAlone() {
+
+    Core::ThreadPool pool(4U);
+    Core::ThreadPool::ScopedInstance scopedPool(pool);
+
+    ECS::Registry registry;
+    auto& first = AddRecordingSystem<0>(registry);
+    auto& second = AddRecordingSystem<1>(registry);
+    registry.SetSystemAccess<RecordingSystem<0>>({}, {}, ECS::SystemAffinity::ANY_THREAD);
+
+    s_next_finish = 0;
+    s_max_running = 0;
+    registry.Update();
+
+    TEST_CHECK(s_max_running.load() == 1);
+    TEST_CHECK(first.finish == 0);
+    TEST_CHECK(second.thread == std::this_thread::get_id());
+}
+
+static void TestErrorsAreRethrownAfterEverySystemRuns() {
+
+    Core::ThreadPool pool(4U);
+    Core::ThreadPool::ScopedInstance scopedPool(pool);
+
+    ECS::Registry registry;
+    auto& failing = AddRecordingSystem<0>(registry);
+    auto& other = AddRecordingSystem<1>(registry);
+    auto& dependent = AddRecordingSystem<2>(registry);
+    registry.SetSystemAccess<RecordingSystem<0>>({}, {}, ECS::SystemAffinity::ANY_THREAD);
+    registry.SetSystemAccess<RecordingSystem<1>>({}, {}, ECS::SystemAffinity::ANY_THREAD);
+    registry.SetSystemAccess<RecordingSystem<2>>({}, {}, ECS::SystemAffinity::MAIN_THREAD);
+    registry.SetSystemDependency<RecordingSystem<2>, RecordingSystem<0>>();
+    failing.fail = true;
+
+    for (int frame = 0; frame < 2; frame++) {
+
+        s_next_finish = 0;
+        other.finish = -1;
+        dependent.finish = -1;
+
+        bool threw = false;
+        try {
+            registry.Update();
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+
+        TEST_CHECK(threw);
+        TEST_CHECK(other.finish >= 0);
+        TEST_CHECK(dependent.finish >= 0);
+    }
+}
+
+int main() {
+
+    return Test::Run({
+        {"archetype storage moves entities between archetypes", TestMoveBetweenArchetypes},
+        {"archetype storage iterates every entity in chunks", TestChunkIteration},
+        {"archetype storage destroys components once", TestComponentLifetimes},
+        {"registry erases destroyed entities from archetype storage", TestRegistryErasesDestroyedEntities},
+        {"parallel schedule orders conflicting systems", TestParallelSchedule},
+        {"systems without declared access run alone", TestUndeclaredSystemsRunAlone},
+        {"system errors are rethrown after every system runs", TestErrorsAreRethrownAfterEverySystemRuns},
+    });
+}
@@ -0,0 +1,157 @@
+#include "Test.hpp"
+#include "core/ThreadPool.hpp"
+#include "math/CsrGraph.hpp"
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace {
+
+    using Graph_t = Math::CsrGraph<float>;
+
+    constexpr Math::GraphNode_t UNREACHED = Math::INVALID_GRAPH_NODE;
+    constexpr float UNREACHED_DISTANCE = std::numeric_limits<float>::max();
+
+    //! @brief Build a small undirected graph with three components: nodes 0 to 4, which have two routes between 0 and
+    //!        4, the pair 5 and 6, and node 7 on its own.
+    Graph_t MakeFixedGraph() {
+        Graph_t::Builder builder(8U);
+        builder.AddUndirectedEdge(0U, 1U, 1.0F);
+        builder.AddUndirectedEdge(0U, 2U, 4.0F);
+        builder.AddUndirectedEdge(1U, 2U, 2.0F);
+        builder.AddUndirectedEdge(2U, 3U, 1.0F);
+        builder.AddUndirectedEdge(3U, 4U, 5.0F);
+        builder.AddUndirectedEdge(1U, 4U, 7.0F);
+        builder.AddUndirectedEdge(5U, 6U, 1.0F);
+        return builder.Build();
+    }
+
+    //! @brief Build a grid graph whose rows are joined left to right, and whose columns are joined top to bottom.
+    //!
+    //! Starting from the whole left column, every level of a search is a column as tall as the grid, so tall grids
+    //! split each level over several blocks of the parallel search.
+    Graph_t MakeGridGraph(size_t width, size_t height) {
+        Graph_t::Builder builder(width * height);
+        for (size_t y = 0U; y < height; y++) {
+            for (size_t x = 0U; x < width; x++) {
+                const auto node = static_cast<Math::GraphNode_t>((y * width) + x);
+                if ((x + 1U) < width) {
+                    builder.AddUndirectedEdge(node, node + 1U);
+                }
+                if ((y + 1U) < height) {
+                    builder.AddUndirectedEdge(node, node + static_cast<Math::GraphNode_t>(width));
+                }
+            }
+        }
+        return builder.Build();
+    }
+}
+
+static void TestBuilderGroupsEdgesByNode() {
+
+    const Graph_t graph = MakeFixedGraph();
+    TEST_CHECK(graph.GetNumNodes() == 8U);
+    TEST_CHECK(graph.GetNumEdges() == 14U);
+    TEST_CHECK(graph.GetDegree(1U) == 3U);
+    TEST_CHECK(graph.GetDegree(7U) == 0U);
+
+    // edges leaving a node keep the order they were added in.
+    const std::vector<Math::GraphNode_t> neighbors(graph.GetNeighbors(1U).begin(), graph.GetNeighbors(1U).end());
+    const std::vector<float> weights(graph.GetWeights(1U).begin(), graph.GetWeights(1U).end());
+    TEST_CHECK(neighbors == std::vector<Math::GraphNode_t>({0U, 2U, 4U}));
+    TEST_CHECK(weights == std::vector<float>({1.0F, 2.0F, 7.0F}));
+}
+
+static void TestBreadthFirstSearchLevels() {
+
+    const Graph_t graph = MakeFixedGraph();
+
+    const std::vector<Math::GraphNode_t> levels = Math::BreadthFirstSearch(graph, {0U});
+    TEST_CHECK(levels == std::vector<Math::GraphNode_t>({0U, 1U, 1U, 2U, 2U, UNREACHED, UNREACHED, UNREACHED}));
+
+    // with several sources, each node takes its level from the nearest.
+    const std::vector<Math::GraphNode_t> multiLevels = Math::BreadthFirstSearch(graph, {4U, 5U});
+    TEST_CHECK(multiLevels == std::vector<Math::GraphNode_t>({2U, 1U, 2U, 1U, 0U, 0U, 1U, UNREACHED}));
+}
+
+static void TestParallelBreadthFirstSearch() {
+
+    constexpr size_t WIDTH = 24U;
+    constexpr size_t HEIGHT = 3U * Math::GRAPH_BFS_GRAIN + 7U;
+    const Graph_t graph = MakeGridGraph(WIDTH, HEIGHT);
+
+    std::vector<Math::GraphNode_t> sources;
+    for (size_t y = 0U; y < HEIGHT; y++) {
+        sources.push_back(static_cast<Math::GraphNode_t>(y * WIDTH));
+    }
+
+    std::vector<Math::GraphNode_t> parallelLevels;
+    {
+        Core::ThreadPool pool(4U);
+        Core::ThreadPool::ScopedInstance scopedPool(pool);
+        parallelLevels = Math::BreadthFirstSearch(graph, sources);
+    }
+
+    std::vector<Math::GraphNode_t> serialLevels;
+    {
+        Core::ThreadPool pool(0U);
+        Core::ThreadPool::ScopedInstance scopedPool(pool);
+        serialLevels = Math::BreadthFirstSearch(graph, sources);
+    }
+
+    // every node is as many levels from the left column as its distance along its row.
+    bool levelsMatchColumns = true;
+    for (size_t node = 0U; node < graph.GetNumNodes(); node++) {
+        levelsMatchColumns = levelsMatchColumns && (parallelLevels[node] == (node % WIDTH));
+    }
+    TEST_CHECK(levelsMatchColumns);
+    TEST_CHECK(parallelLevels == serialLevels);
+}
+
+static void TestConnectedComponentLabels() {
+
+    const Graph_t graph = MakeFixedGraph();
+
+    std::vector<Math::GraphNode_t> components;
+    TEST_CHECK(Math::FindConnectedComponents(graph, components) == 3U);
+    TEST_CHECK(components == std::vector<Math::GraphNode_t>({0U, 0U, 0U, 0U, 0U, 1U, 1U, 2U}));
+
+    // the direction of edges is ignored, and components are numbered by their lowest node.
+    Graph_t::Builder builder(5U);
+    builder.AddEdge(4U, 1U);
+    builder.AddEdge(3U, 2U);
+    builder.AddEdge(2U, 0U);
+    const Graph_t directed = builder.Build();
+    TEST_CHECK(Math::FindConnectedComponents(directed, components) == 2U);
+    TEST_CHECK(components == std::vector<Math::GraphNode_t>({0U, 1U, 0U, 0U, 1U}));
+}
+
+static void TestDijkstraDistances() {
+
+    const Graph_t graph = MakeFixedGraph();
+
+    const Math::ShortestPaths<float> paths = Math::Dijkstra(graph, {0U});
+    TEST_CHECK(paths.distances == std::vector<float>({0.0F, 1.0F, 3.0F, 4.0F, 8.0F, UNREACHED_DISTANCE,
+                                                      UNREACHED_DISTANCE, UNREACHED_DISTANCE}));
+    TEST_CHECK(paths.GetPath(3U) == std::vector<Math::GraphNode_t>({0U, 1U, 2U, 3U}));
+    TEST_CHECK(paths.GetPath(4U) == std::vector<Math::GraphNode_t>({0U, 1U, 4U}));
+    TEST_CHECK(paths.GetPath(6U).empty());
+    TEST_CHECK(paths.parents[0U] == UNREACHED);
+
+    // with several sources, each node is reached from the nearest.
+    const Math::ShortestPaths<float> multiPaths = Math::Dijkstra(graph, {0U, 4U, 6U});
+    TEST_CHECK(multiPaths.distances == std::vector<float>({0.0F, 1.0F, 3.0F, 4.0F, 0.0F, 1.0F, 0.0F,
+                                                           UNREACHED_DISTANCE}));
+    TEST_CHECK(multiPaths.GetPath(5U) == std::vector<Math::GraphNode_t>({6U, 5U}));
+}
+
+int main() {
+
+    return Test::Run({
+        {"graph builder groups edges by the node they leave from", TestBuilderGroupsEdgesByNode},
+        {"breadth first search finds the level of every node", TestBreadthFirstSearchLevels},
+        {"parallel breadth first search matches a serial search", TestParallelBreadthFirstSearch},
+        {"connected components are labelled by their lowest node", TestConnectedComponentLabels},
+        {"dijkstra finds the shortest distance to every node", TestDijkstraDistances},
+    });
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/Logger.hpp"
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+//! Minimal test harness. Each test executable is a list of cases run by Test::Run() from main(), and registered with
+//! CTest in tests/CMakeLists.txt.
+namespace Test {
+
+    //! A named test case.
+    struct Case {
+        const char* name;
+        std::function<void()> run;
+    };
+
+    //! Thrown by a failed check, to end the case it failed in.
+    class Failure : public std::exception {
+
+        public:
+
+            explicit Failure(const std::string& msg)
+                : m_msg(msg) {
+            }
+
+            const char* what() const noexcept override {
+                return m_msg.c_str();
+            }
+
+        private:
+
+            std::string m_msg;
+    };
+
+    //! @brief Fail the current case if a condition does not hold. Use TEST_CHECK() to report where it failed.
+    inline void Check(bool condition, const std::string& message) {
+        if (!condition) {
+            throw Failure(message);
+        }
+    }
+
+    //! @brief Run every case, logging each one that fails or throws.
+    //!
+    //! @returns The exit code of the test executable, which is non-zero if any case failed.
+    inline int Run(const std::vector<Case>& cases) {
+
+        size_t numFailed = 0U;
+        for (const Case& testCase : cases) {
+            try {
+                testCase.run();
+                Core::Logger::Info(std::string("PASSED ") + testCase.name);
+            }
+            catch (const std::exception& error) {
+                Core::Logger::Error(std::string("FAILED ") + testCase.name + ": " + error.what());
+                numFailed++;
+            }
+        }
+
+        Core::Logger::Info(
+            std::to_string(cases.size() - numFailed) + " of " + std::to_string(cases.size()) + " cases passed");
+        return (numFailed == 0U) ? 0 : 1;
+    }
+}
+
+#define TEST_CHECK(condition) \
+    Test::Check((condition), std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": " + #condition)
@@ -0,0 +1,595 @@
+#include "Test.hpp"
+#include "core/ThreadPool.hpp"
+#include "world/ChunkGenerator.hpp"
+#include "world/ChunkStreamer.hpp"
+#include "world/GenerationCheck.hpp"
+#include "world/PathFinder.hpp"
+#include "world/World.hpp"
+#include "world/WorldDigest.hpp"
+#include "world/WorldGenerator.hpp"
+#include "world/WorldParams.hpp"
+#include "world/WorldQuery.hpp"
+#include "world/WorldSave.hpp"
+#include "world/passes/Drainage.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <glm/geometric.hpp>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <set>
+#include <string>
+#include <vector>
+
+//! Check that a save written by an older version of the game loads, and that saving and loading it again with the
+//! current version gives the same world. The fixtures are 64 by 64 tile worlds named "fixture", generated by the game
+//! at the version they are named after.
+static void CheckSaveFixture(const std::string& path) {
+
+    std::ifstream file(path, std::ios::binary);
+    TEST_CHECK(file.is_open());
+
+    std::unique_ptr<World::World> p_world = World::ReadWorld(file);
+    TEST_CHECK(p_world->GetParameters().GetName() == "fixture");
+    TEST_CHECK(p_world->GetSize() == World::Extent_t(64U, 64U));
+    TEST_CHECK(p_world->GetTiles().size() == 64U * 64U);
+    TEST_CHECK(!p_world->GetRegions().empty());
+
+    std::stringstream saveStream(std::ios::in | std::ios::out | std::ios::binary);
+    World::WriteWorld(saveStream, *p_world);
+    std::unique_ptr<World::World> p_resaved = World::ReadWorld(saveStream);
+
+    World::WorldDigest expected(*p_world);
+    World::WorldDigest actual(*p_resaved);
+    for (size_t part = 0U; part < World::WorldDigest::NUM_PARTS; part++) {
+        TEST_CHECK(expected.FindFirstDifference(actual, static_cast<World::WorldPart>(part)) ==
+                   World::WorldDigest::NO_DIFFERENCE);
+    }
+}
+
+//! Check that a generated world fits its height encoding to its heights, and that a save keeps it.
+static void CheckHeightEncoding() {
+
+    World::WorldParams params;
+    params.SetName("encoding");
+    params.SetSeedAscii("encoding");
+    params.SetDimension(64U);
+    params.SetNumContinents(2U);
+    params.SetPercentLand(40.0F);
+    params.SetRegionSize(16U);
+    std::unique_ptr<World::World> p_world = World::WorldGenerator::Generate(params);
+
+    const World::HeightEncoding& encoding = p_world->GetHeightEncoding();
+    TEST_CHECK(encoding.GetScale() < World::HeightEncoding::DEFAULT_SCALE);
+
+    std::vector<float> heights;
+    p_world->GetTileHeights(heights);
+    const float maxHeight = encoding.Decode(World::HeightEncoding::MAX_VALUE);
+    for (float height : heights) {
+        TEST_CHECK((height >= encoding.GetOffset()) && (height <= maxHeight));
+    }
+
+    std::stringstream saveStream(std::ios::in | std::ios::out | std::ios::binary);
+    World::WriteWorld(saveStream, *p_world);
+    std::unique_ptr<World::World> p_loaded = World::ReadWorld(saveStream);
+    TEST_CHECK(p_loaded->GetHeightEncoding().GetOffset() == encoding.GetOffset());
+    TEST_CHECK(p_loaded->GetHeightEncoding().GetScale() == encoding.GetScale());
+
+    std::vector<float> loadedHeights;
+    p_loaded->GetTileHeights(loadedHeights);
+    TEST_CHECK(loadedHeights == heights);
+
+    // a const world hands out tiles that can only be read, and that see changes made through the mutable world.
+    const World::World& constWorld = *p_world;
+    static_assert(std::is_same_v<decltype(constWorld.GetTile(0U)), World::ConstTile>);
+    static_assert(std::is_same_v<decltype(*constWorld.GetTiles().begin()), World::ConstTile>);
+    p_world->GetTile(1U).SetEncodedHeight(static_cast<uint16_t>(World::HeightEncoding::MAX_VALUE));
+    TEST_CHECK(constWorld.GetTile(1U).GetAbsoluteHeight() == maxHeight);
+    TEST_CHECK(constWorld.GetTiles()[1U].GetEncodedHeight() == World::HeightEncoding::MAX_VALUE);
+}
+
+//! Check that the tiles of an out of core world are kept in a file in the directory it was given, which is removed
+//! with the world, and that the world is generated the same as one kept in memory.
+static void CheckOutOfCoreDirectory() {
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "SimulationGameOutOfCore";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    World::WorldParams params;
+    params.SetName("outOfCore");
+    params.SetSeedAscii("outOfCore");
+    params.SetDimension(64U);
+    params.SetNumContinents(2U);
+    params.SetPercentLand(40.0F);
+    params.SetRegionSize(16U);
+    std::unique_ptr<World::World> p_inCore = World::WorldGenerator::Generate(params);
+    TEST_CHECK(!p_inCore->GetTileColumns().GetIsOutOfCore());
+
+    params.SetOutOfCore(true);
+    params.SetOutOfCoreDirectory(directory.string());
+    std::unique_ptr<World::World> p_outOfCore = World::WorldGenerator::Generate(params);
+    TEST_CHECK(p_outOfCore->GetTileColumns().GetIsOutOfCore());
+    World::WorldDigest expected(*p_inCore);
+    World::WorldDigest actual(*p_outOfCore);
+    for (size_t part = 0U; part < World::WorldDigest::NUM_PARTS; part++) {
+        TEST_CHECK(expected.FindFirstDifference(actual, static_cast<World::WorldPart>(part)) ==
+                   World::WorldDigest::NO_DIFFERENCE);
+    }
+    p_outOfCore.reset();
+    TEST_CHECK(std::filesystem::is_empty(directory));
+
+    // a directory that does not exist is reported, rather than falling back to memory.
+    params.SetOutOfCoreDirectory((directory / "missing").string());
+    bool threw = false;
+    try {
+        World::WorldGenerator::Generate(params);
+    }
+    catch (const std::exception&) {
+        threw = true;
+    }
+    TEST_CHECK(threw);
+
+    std::filesystem::remove_all(directory);
+}
+
+//! Check that water crosses a flat to the tile it drains out of, and that a flat with no way out is left as a pit.
+static void CheckDrainageAcrossFlats() {
+
+    // a flat of height 5 that drains out of its east end into a pit, and a flat of height 2 walled in by 9.
+    const World::Extent_t extent(8U, 3U);
+    const std::vector<uint16_t> surface = {
+        9, 9, 9, 9, 9, 9, 9, 9,
+        5, 5, 5, 5, 1, 9, 2, 2,
+        9, 9, 9, 9, 9, 9, 9, 9};
+    const std::vector<World::TileId_t> receivers = World::Passes::FindDrainageReceivers(surface, extent);
+
+    TEST_CHECK(receivers[8U] == 9U);
+    TEST_CHECK(receivers[9U] == 10U);
+    TEST_CHECK(receivers[10U] == 11U);
+    TEST_CHECK(receivers[11U] == 12U);
+    TEST_CHECK(receivers[12U] == 12U);
+    TEST_CHECK(receivers[14U] == 14U);
+    TEST_CHECK(receivers[15U] == 15U);
+}
+
+//! Generate the small world that the query tests run against.
+static std::unique_ptr<World::World> GenerateQueryWorld() {
+
+    World::WorldParams params;
+    params.SetName("query");
+    params.SetSeedAscii("query");
+    params.SetDimension(64U);
+    params.SetNumContinents(2U);
+    params.SetPercentLand(50.0F);
+    params.SetRegionSize(16U);
+    return World::WorldGenerator::Generate(params);
+}
+
+//! Get the position of the center of a tile, in meters.
+static glm::vec2 GetTileCenter(const World::World& world, World::TileId_t tile_id) {
+    const World::Coordinate_t coordinate = world.TileIdToCoordinate(tile_id);
+    return (glm::vec2(coordinate) + glm::vec2(0.5F)) / World::TILE_PER_METER_F32;
+}
+
+//! Check the point, radius and rectangle queries against a scan over every tile.
+static void CheckWorldQueryShapes() {
+
+    std::unique_ptr<World::World> p_world = GenerateQueryWorld();
+    const World::World& world = *p_world;
+    const World::WorldQuery query(world);
+    const World::TileId_t numTiles = static_cast<World::TileId_t>(world.GetTiles().size());
+
+    for (World::TileId_t tileId = 0U; tileId < numTiles; tileId++) {
+        const glm::vec2 center = GetTileCenter(world, tileId);
+        TEST_CHECK(query.GetTileAt(center) == tileId);
+        TEST_CHECK(query.GetRegionAt(center) == world.GetTile(tileId).GetRegionId());
+    }
+    TEST_CHECK(query.GetTileAt(glm::vec2(-1.0F, 0.0F)) == World::INVALID_TILE_ID);
+    TEST_CHECK(query.GetRegionAt(glm::vec2(0.0F, 65.0F / World::TILE_PER_METER_F32)) == World::INVALID_REGION_ID);
+
+    // tiles and regions found by a query, as found by testing the center of every tile.
+    auto scan = [&](auto is_inside, std::vector<World::TileId_t>& tiles, std::set<World::RegionId_t>& regions) {
+        for (World::TileId_t tileId = 0U; tileId < numTiles; tileId++) {
+            if (is_inside(GetTileCenter(world, tileId))) {
+                tiles.push_back(tileId);
+                regions.insert(world.GetTile(tileId).GetRegionId());
+            }
+        }
+    };
+
+    // circles and rectangles inside of the world, and across its edges.
+    const float tileSize = 1.0F / World::TILE_PER_METER_F32;
+    const std::vector<std::pair<glm::vec2, float>> circles = {
+        {glm::vec2(32.0F, 32.0F) * tileSize, 5.5F * tileSize},
+        {glm::vec2(2.3F, 60.1F) * tileSize, 9.0F * tileSize},
+        {glm::vec2(-3.0F, 10.0F) * tileSize, 4.0F * tileSize},
+        {glm::vec2(40.5F, 20.5F) * tileSize, 0.25F * tileSize}};
+    for (const auto& [center, radius] : circles) {
+
+        std::vector<World::TileId_t> expectedTiles;
+        std::set<World::RegionId_t> expectedRegions;
+        scan([&](glm::vec2 position) { return glm::dot(position - center, position - center) <= radius * radius; },
+             expectedTiles, expectedRegions);
+
+        TEST_CHECK(!expectedTiles.empty());
+        TEST_CHECK(query.FindTilesInRadius(center, radius) == expectedTiles);
+        std::vector<World::RegionId_t> regions = query.FindRegionsInRadius(center, radius);
+        TEST_CHECK(std::set<World::RegionId_t>(regions.begin(), regions.end()) == expectedRegions);
+        TEST_CHECK(regions.size() == expectedRegions.size());
+    }
+
+    const std::vector<Math::Box> rects = {
+        Math::Box(glm::vec2(10.0F, 12.0F) * tileSize, glm::vec2(7.0F, 3.0F) * tileSize),
+        Math::Box(glm::vec2(50.25F, -4.0F) * tileSize, glm::vec2(30.0F, 9.5F) * tileSize),
+        Math::Box(glm::vec2(0.0F, 0.0F), glm::vec2(64.0F, 64.0F) * tileSize)};
+    for (const Math::Box& rect : rects) {
+
+        std::vector<World::TileId_t> expectedTiles;
+        std::set<World::RegionId_t> expectedRegions;
+        scan([&](glm::vec2 position) {
+                 return (position.x >= rect.GetLeft()) && (position.x < rect.GetRight()) &&
+                        (position.y >= rect.GetTop()) && (position.y < rect.GetBottom());
+             },
+             expectedTiles, expectedRegions);
+
+        TEST_CHECK(!expectedTiles.empty());
+        TEST_CHECK(query.FindTilesInRect(rect) == expectedTiles);
+        std::vector<World::RegionId_t> regions = query.FindRegionsInRect(rect);
+        TEST_CHECK(std::set<World::RegionId_t>(regions.begin(), regions.end()) == expectedRegions);
+        TEST_CHECK(regions.size() == expectedRegions.size());
+    }
+}
+
+//! Check that the nearest river and coast found for every tile is as close as the closest one found by a scan.
+static void CheckWorldQueryNearest() {
+
+    std::unique_ptr<World::World> p_world = GenerateQueryWorld();
+    const World::World& world = *p_world;
+    const World::WorldQuery query(world);
+    const World::Extent_t extent = world.GetSize();
+    const World::TileId_t numTiles = static_cast<World::TileId_t>(world.GetTiles().size());
+
+    auto isOcean = [&world](uint32_t x_coord, uint32_t y_coord) {
+        const auto tile = world.GetTile(world.CoordinateToTileId({x_coord, y_coord}));
+        return tile.GetIsWater() && !tile.GetIsLake();
+    };
+    auto isCoast = [&](World::TileId_t tile_id) {
+        const World::Coordinate_t coordinate = world.TileIdToCoordinate(tile_id);
+        return !world.GetTile(tile_id).GetIsWater() &&
+               (((coordinate.x > 0U) && isOcean(coordinate.x - 1U, coordinate.y)) ||
+                ((coordinate.y > 0U) && isOcean(coordinate.x, coordinate.y - 1U)) ||
+                ((coordinate.x + 1U < extent.x) && isOcean(coordinate.x + 1U, coordinate.y)) ||
+                ((coordinate.y + 1U < extent.y) && isOcean(coordinate.x, coordinate.y + 1U)));
+    };
+    auto isRiver = [&world](World::TileId_t tile_id) { return world.GetTile(tile_id).GetIsRiver(); };
+
+    auto distance = [&world](World::TileId_t lhs, World::TileId_t rhs) {
+        const glm::ivec2 offset = glm::ivec2(world.TileIdToCoordinate(lhs)) - glm::ivec2(world.TileIdToCoordinate(rhs));
+        return std::abs(offset.x) + std::abs(offset.y);
+    };
+
+    auto check = [&](World::WorldQuery::Feature feature, auto has_feature) {
+
+        std::vector<World::TileId_t> featureTiles;
+        for (World::TileId_t tileId = 0U; tileId < numTiles; tileId++) {
+            if (has_feature(tileId)) {
+                featureTiles.push_back(tileId);
+            }
+        }
+        TEST_CHECK(!featureTiles.empty());
+
+        for (World::TileId_t tileId = 0U; tileId < numTiles; tileId++) {
+
+            int32_t closest = std::numeric_limits<int32_t>::max();
+            for (World::TileId_t featureId : featureTiles) {
+                closest = std::min(closest, distance(tileId, featureId));
+            }
+
+            const World::TileId_t found = query.FindNearest(feature, GetTileCenter(world, tileId));
+            TEST_CHECK(found != World::INVALID_TILE_ID);
+            TEST_CHECK(has_feature(found));
+            TEST_CHECK(distance(tileId, found) == closest);
+        }
+    };
+
+    check(World::WorldQuery::Feature::RIVER, isRiver);
+    check(World::WorldQuery::Feature::COAST, isCoast);
+}
+
+//! Determine if two chunks hold the same blocks.
+static bool IsSameChunk(const World::Chunk& lhs, const World::Chunk& rhs) {
+
+    for (uint16_t yCoord = 0U; yCoord < World::CHUNK_HEIGHT; yCoord++) {
+        for (uint16_t zCoord = 0U; zCoord < World::CHUNK_LENGTH; zCoord++) {
+            for (uint16_t xCoord = 0U; xCoord < World::CHUNK_WIDTH; xCoord++) {
+                if (lhs.GetBlock(xCoord, zCoord, yCoord) != rhs.GetBlock(xCoord, zCoord, yCoord)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return lhs.GetCoordinate() == rhs.GetCoordinate();
+}
+
+//! Get a position on the surface of a world, in meters, at the center of the column of blocks at the center of a
+//! tile. (x: east, y: up, z: south)
+static glm::vec3 GetSurfacePosition(const World::ChunkGenerator& generator, World::Coordinate_t coordinate) {
+    const glm::vec2 position = ((glm::vec2(coordinate) + glm::vec2(0.5F)) / World::TILE_PER_METER_F32) + 0.5F;
+    return {position.x, generator.GetSurfaceHeight(position), position.y};
+}
+
+//! Check that chunks are solid up to the surface and empty above it, and that generation is repeatable.
+static void CheckChunkGeneration() {
+
+    std::unique_ptr<World::World> p_world = GenerateQueryWorld();
+    const World::World& world = *p_world;
+    const World::ChunkGenerator generator(world);
+
+    for (uint32_t yCoord = 8U; yCoord < 64U; yCoord += 16U) {
+        for (uint32_t xCoord = 8U; xCoord < 64U; xCoord += 16U) {
+
+            const glm::vec3 surface = GetSurfacePosition(generator, {xCoord, yCoord});
+            const World::ChunkCoordinate_t coordinate = World::ChunkStreamer::PositionToChunkCoordinate(surface);
+            std::unique_ptr<World::Chunk> p_chunk = generator.Generate(coordinate);
+            TEST_CHECK(IsSameChunk(*p_chunk, *generator.Generate(coordinate)));
+
+            // the column under the surface position is solid below it, and not solid above it.
+            const glm::ivec3 block(
+                static_cast<int32_t>(std::floor(surface.x)) - (coordinate.x * World::CHUNK_WIDTH),
+                static_cast<int32_t>(std::floor(surface.y)) - (coordinate.y * World::CHUNK_HEIGHT),
+                static_cast<int32_t>(std::floor(surface.z)) - (coordinate.z * World::CHUNK_LENGTH));
+            auto getBlock = [&](int32_t y_coord) {
+                return p_chunk->GetBlock(
+                    static_cast<uint16_t>(block.x), static_cast<uint16_t>(block.z), static_cast<uint16_t>(y_coord));
+            };
+            auto isSolid = [](World::BlockType type) {
+                return (type != World::BlockType::AIR) && (type != World::BlockType::WATER) &&
+                       (type != World::BlockType::ICE);
+            };
+            TEST_CHECK(isSolid(getBlock(block.y)));
+            if (block.y > 0) {
+                TEST_CHECK(isSolid(getBlock(block.y - 1)));
+            }
+            if (block.y + 1 < static_cast<int32_t>(World::CHUNK_HEIGHT)) {
+                TEST_CHECK(!isSolid(getBlock(block.y + 1)));
+            }
+
+            // chunks far above and below the surface do not allocate blocks.
+            std::unique_ptr<World::Chunk> p_sky = generator.Generate(coordinate + World::ChunkCoordinate_t(0, 40, 0));
+            TEST_CHECK(p_sky->IsUniform() && (p_sky->GetBlock(0U, 0U, 0U) == World::BlockType::AIR));
+        }
+    }
+
+    std::unique_ptr<World::Chunk> p_outside = generator.Generate(World::ChunkCoordinate_t(-1, 0, 0));
+    TEST_CHECK(p_outside->IsUniform() && (p_outside->GetBlock(0U, 0U, 0U) == World::BlockType::AIR));
+}
+
+//! Call ChunkStreamer::Update() until it has loaded a number of chunks, or a few seconds have passed.
+static void WaitForChunks(World::ChunkStreamer& streamer, size_t count) {
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    streamer.Update();
+    while ((streamer.GetLoadedCount() < count) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        streamer.Update();
+    }
+}
+
+//! Check that the streamer loads the chunks around its focus on the pool, keeps them within its budget, and evicts
+//! the least recently wanted ones when the focus moves.
+static void CheckChunkStreaming() {
+
+    std::unique_ptr<World::World> p_world = GenerateQueryWorld();
+    const World::World& world = *p_world;
+    const World::ChunkGenerator generator(world);
+    Core::ThreadPool pool(3U);
+
+    const glm::vec3 focus = GetSurfacePosition(generator, {32U, 32U});
+    const World::ChunkCoordinate_t focusChunk = World::ChunkStreamer::PositionToChunkCoordinate(focus);
+    TEST_CHECK(focusChunk.y > 0);
+
+    // a radius of 2 covers 13 columns of chunks, and 3 layers of them.
+    const size_t numWanted = 13U * 3U;
+    {
+        World::ChunkStreamer streamer(world, pool, 2, 1, std::numeric_limits<size_t>::max(), 4U);
+        streamer.SetFocus(focus);
+        WaitForChunks(streamer, numWanted);
+        TEST_CHECK(streamer.GetLoadedCount() == numWanted);
+
+        for (int32_t yOffset = -1; yOffset <= 1; yOffset++) {
+            for (int32_t zOffset = -2; zOffset <= 2; zOffset++) {
+                for (int32_t xOffset = -2; xOffset <= 2; xOffset++) {
+
+                    const World::ChunkCoordinate_t coordinate = focusChunk + glm::ivec3(xOffset, yOffset, zOffset);
+                    const World::Chunk* p_chunk = streamer.GetChunk(coordinate);
+                    if ((xOffset * xOffset) + (zOffset * zOffset) > 4) {
+                        TEST_CHECK(p_chunk == nullptr);
+                        continue;
+                    }
+                    TEST_CHECK(p_chunk != nullptr);
+                    TEST_CHECK(IsSameChunk(*p_chunk, *generator.Generate(coordinate)));
+                }
+            }
+        }
+
+        // with no limit on memory, moving away keeps the chunks that were loaded.
+        streamer.SetFocus(focus + glm::vec3(200.0F, 0.0F, 0.0F));
+        WaitForChunks(streamer, 2U * numWanted);
+        TEST_CHECK(streamer.GetLoadedCount() == 2U * numWanted);
+        TEST_CHECK(streamer.GetChunk(focusChunk) != nullptr);
+    }
+
+    // a budget of 5 chunks with blocks only keeps the nearest chunks, and evicts them once the focus moves away.
+    const size_t budget = 5U * (sizeof(World::Chunk) + World::NUM_BLOCKS);
+    {
+        World::ChunkStreamer streamer(world, pool, 2, 0, budget, 4U);
+        streamer.SetFocus(focus);
+        WaitForChunks(streamer, 5U);
+        TEST_CHECK(streamer.GetMemoryUsage() <= budget);
+        TEST_CHECK(streamer.GetChunk(focusChunk) != nullptr);
+
+        const glm::vec3 farFocus = focus + glm::vec3(200.0F, 0.0F, 0.0F);
+        streamer.SetFocus(farFocus);
+        for (int32_t frame = 0; (frame < 30000) &&
+             (streamer.GetChunk(World::ChunkStreamer::PositionToChunkCoordinate(farFocus)) == nullptr); frame++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            streamer.Update();
+        }
+        TEST_CHECK(streamer.GetMemoryUsage() <= budget);
+        TEST_CHECK(streamer.GetChunk(World::ChunkStreamer::PositionToChunkCoordinate(farFocus)) != nullptr);
+        TEST_CHECK(streamer.GetChunk(focusChunk) == nullptr);
+    }
+
+    // destroying a streamer waits for the chunks it is generating.
+    {
+        World::ChunkStreamer streamer(world, pool, 4, 2, std::numeric_limits<size_t>::max(), 8U);
+        streamer.SetFocus(focus);
+        streamer.Update();
+    }
+    pool.WaitIdle();
+}
+
+//! Check that paths step between neighboring land tiles from start to goal, that a path is found exactly when the goal
+//! can be reached, and that batched queries on several workers find the same paths.
+static void CheckPathFinding() {
+
+    std::unique_ptr<World::World> p_world = GenerateQueryWorld();
+    const World::World& world = *p_world;
+    const World::PathFinder pathFinder(world);
+    const World::Extent_t extent = world.GetSize();
+    const World::TileId_t numTiles = static_cast<World::TileId_t>(world.GetTiles().size());
+
+    auto isLand = [&](int32_t x_coord, int32_t y_coord) {
+        return (x_coord >= 0) && (y_coord >= 0) && (x_coord < static_cast<int32_t>(extent.x)) &&
+               (y_coord < static_cast<int32_t>(extent.y)) &&
+               !world.GetTile(world.CoordinateToTileId(
+                   {static_cast<uint32_t>(x_coord), static_cast<uint32_t>(y_coord)})).GetIsWater();
+    };
+
+    // label each land tile with the area it can reach. Diagonal steps may not cut the corner of a water tile.
+    std::vector<int32_t> areas(numTiles, -1);
+    int32_t numAreas = 0;
+    for (World::TileId_t seed = 0U; seed < numTiles; seed++) {
+
+        const glm::ivec2 seedCoordinate(world.TileIdToCoordinate(seed));
+        if ((areas[seed] >= 0) || !isLand(seedCoordinate.x, seedCoordinate.y)) {
+            continue;
+        }
+
+        std::vector<World::TileId_t> frontier = {seed};
+        areas[seed] = numAreas;
+        for (size_t head = 0U; head < frontier.size(); head++) {
+            const glm::ivec2 current(world.TileIdToCoordinate(frontier[head]));
+            for (int32_t offsetY = -1; offsetY <= 1; offsetY++) {
+                for (int32_t offsetX = -1; offsetX <= 1; offsetX++) {
+                    const glm::ivec2 next = current + glm::ivec2(offsetX, offsetY);
+                    if (!isLand(next.x, next.y) || !isLand(next.x, current.y) || !isLand(current.x, next.y)) {
+                        continue;
+                    }
+                    const World::TileId_t nextId =
+                        world.CoordinateToTileId({static_cast<uint32_t>(next.x), static_cast<uint32_t>(next.y)});
+                    if (areas[nextId] < 0) {
+                        areas[nextId] = numAreas;
+                        frontier.push_back(nextId);
+                    }
+                }
+            }
+        }
+        numAreas++;
+    }
+
+    std::vector<World::PathRequest> requests;
+    for (World::TileId_t index = 0U; index < 200U; index++) {
+        requests.push_back({(index * 7919U) % numTiles, (index * 104729U + 17U) % numTiles});
+    }
+
+    size_t numFound = 0U;
+    for (const World::PathRequest& request : requests) {
+
+        const World::Path path = pathFinder.FindPath(request);
+        const bool isReachable = (areas[request.start] >= 0) && (areas[request.start] == areas[request.goal]);
+        TEST_CHECK(path.tiles.empty() != isReachable);
+        if (path.tiles.empty()) {
+            continue;
+        }
+        numFound++;
+
+        TEST_CHECK((path.tiles.front() == request.start) && (path.tiles.back() == request.goal));
+        float length = 0.0F;
+        for (size_t step = 1U; step < path.tiles.size(); step++) {
+            const glm::ivec2 from(world.TileIdToCoordinate(path.tiles[step - 1U]));
+            const glm::ivec2 to(world.TileIdToCoordinate(path.tiles[step]));
+            const glm::ivec2 offset = to - from;
+            TEST_CHECK((std::abs(offset.x) <= 1) && (std::abs(offset.y) <= 1) && (offset != glm::ivec2(0)));
+            TEST_CHECK(isLand(to.x, to.y) && isLand(to.x, from.y) && isLand(from.x, to.y));
+            length += ((offset.x != 0) && (offset.y != 0)) ? std::sqrt(2.0F) : 1.0F;
+        }
+        TEST_CHECK(path.cost >= length - 0.001F);
+    }
+    TEST_CHECK(numFound > 10U);
+
+    // region paths start and end in the regions asked for, and step between neighbors.
+    const World::RegionId_t startRegion = world.GetTile(requests[1].start).GetRegionId();
+    const World::RegionId_t goalRegion = world.GetTile(requests[1].goal).GetRegionId();
+    const std::vector<World::RegionId_t> regionPath = pathFinder.FindRegionPath(startRegion, goalRegion);
+    TEST_CHECK(regionPath == pathFinder.FindRegionPath(startRegion, goalRegion));
+    if (!regionPath.empty()) {
+        TEST_CHECK((regionPath.front() == startRegion) && (regionPath.back() == goalRegion));
+        for (size_t step = 1U; step < regionPath.size(); step++) {
+            const std::vector<World::RegionId_t>& neighbors = world.GetRegion(regionPath[step - 1U]).GetNeighbors();
+            TEST_CHECK(std::find(neighbors.begin(), neighbors.end(), regionPath[step]) != neighbors.end());
+        }
+    }
+
+    // a batch on several workers, and a path finder with a cache too small to hold the region paths, agree.
+    Core::ThreadPool pool(3U);
+    Core::ThreadPool::ScopedInstance scopedPool(pool);
+    const World::PathFinder uncached(world, 1U);
+    const std::vector<World::Path> batch = pathFinder.FindPaths(requests);
+    const std::vector<World::Path> uncachedBatch = uncached.FindPaths(requests);
+    TEST_CHECK(batch.size() == requests.size());
+    for (size_t index = 0U; index < requests.size(); index++) {
+        const World::Path expected = pathFinder.FindPath(requests[index]);
+        TEST_CHECK(batch[index].tiles == expected.tiles);
+        TEST_CHECK(uncachedBatch[index].tiles == expected.tiles);
+    }
+}
+
+//! Usage: WorldTests <path to world_digests.txt> <directory of save fixtures>
+int main(int argc, char** argv) {
+
+    if (argc != 3) {
+        Core::Logger::Error("Usage: WorldTests <digest file> <fixture directory>");
+        return 1;
+    }
+
+    const std::string digestPath = argv[1];   // NOLINT
+    const std::string fixtureDir = argv[2];   // NOLINT
+
+    return Test::Run({
+        {"generation matches the recorded digests", [&]() {
+            TEST_CHECK(World::RunGenerationCheck(digestPath, false));
+        }},
+        {"height encoding is fit to the world and saved", CheckHeightEncoding},
+        {"out of core tiles are kept in the given directory", CheckOutOfCoreDirectory},
+        {"drainage crosses flats to their outlet", CheckDrainageAcrossFlats},
+        {"world query finds tiles and regions in shapes", CheckWorldQueryShapes},
+        {"world query finds the nearest river and coast", CheckWorldQueryNearest},
+        {"chunks are generated from the heightfield", CheckChunkGeneration},
+        {"chunks are streamed around the focus within the budget", CheckChunkStreaming},
+        {"paths are found over land, alone and in batches", CheckPathFinding},
+        {"version 1 save loads and saves again", [&]() {
+            CheckSaveFixture(fixtureDir + "/world_v1.bin");
+        }},
+        {"version 3 save loads and saves again", [&]() {
+            CheckSaveFixture(fixtureDir + "/world_v3.bin");
+        }},
+    });
+}